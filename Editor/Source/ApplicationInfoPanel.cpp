@@ -41,6 +41,24 @@ namespace Lumos
                     ImGui::TreePop();
                 }
 
+                if(ImGui::TreeNode("Assets"))
+                {
+                    auto AssetStats = [](const char* name, const auto& stats)
+                    {
+                        const float megabyte = 1024.0f * 1024.0f;
+                        if(stats.memoryBudget > 0)
+                            ImGui::Text("%s : %u, %.2f / %.2f MB", name, stats.resourceCount, stats.residentBytes / megabyte, stats.memoryBudget / megabyte);
+                        else
+                            ImGui::Text("%s : %u, %.2f MB", name, stats.resourceCount, stats.residentBytes / megabyte);
+                    };
+
+                    AssetStats("Textures", Application::Get().GetTextureLibrary()->GetStats());
+                    AssetStats("Meshes", Application::Get().GetMeshLibrary()->GetStats());
+                    AssetStats("Materials", Application::Get().GetMaterialLibrary()->GetStats());
+                    AssetStats("Sounds", Application::Get().GetSoundLibrary()->GetStats());
+                    ImGui::TreePop();
+                }
+
                 ImGui::NewLine();
                 ImGui::Text("FPS : %5.2i", Engine::Get().Statistics().FramesPerSecond);
                 ImGui::Text("UPS : %5.2i", Engine::Get().Statistics().UpdatesPerSecond);
@@ -52,29 +70,29 @@ namespace Lumos
                 {
                     if(ImGui::TreeNode("Colour Texture"))
                     {
-                        ImGuiHelpers::Image(Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(Graphics::SCREENTEX_COLOUR), Maths::Vector2(128.0f, 128.0f));
-                        ImGuiHelpers::Tooltip(Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(Graphics::SCREENTEX_COLOUR), Maths::Vector2(256.0f, 256.0f));
+                        ImGuiHelpers::Image(static_cast<Graphics::Texture2D*>(Application::Get().GetRenderGraph()->GetTexture(Graphics::RenderGraph::GBufferColour)), Maths::Vector2(128.0f, 128.0f));
+                        ImGuiHelpers::Tooltip(static_cast<Graphics::Texture2D*>(Application::Get().GetRenderGraph()->GetTexture(Graphics::RenderGraph::GBufferColour)), Maths::Vector2(256.0f, 256.0f));
 
                         ImGui::TreePop();
                     }
                     if(ImGui::TreeNode("Normal Texture"))
                     {
-                        ImGuiHelpers::Image(Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(Graphics::SCREENTEX_NORMALS), Maths::Vector2(128.0f, 128.0f));
-                        ImGuiHelpers::Tooltip(Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(Graphics::SCREENTEX_NORMALS), Maths::Vector2(256.0f, 256.0f));
+                        ImGuiHelpers::Image(static_cast<Graphics::Texture2D*>(Application::Get().GetRenderGraph()->GetTexture(Graphics::RenderGraph::GBufferNormals)), Maths::Vector2(128.0f, 128.0f));
+                        ImGuiHelpers::Tooltip(static_cast<Graphics::Texture2D*>(Application::Get().GetRenderGraph()->GetTexture(Graphics::RenderGraph::GBufferNormals)), Maths::Vector2(256.0f, 256.0f));
 
                         ImGui::TreePop();
                     }
                     if(ImGui::TreeNode("PBR Texture"))
                     {
-                        ImGuiHelpers::Image(Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(Graphics::SCREENTEX_PBR), Maths::Vector2(128.0f, 128.0f));
-                        ImGuiHelpers::Tooltip(Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(Graphics::SCREENTEX_PBR), Maths::Vector2(256.0f, 256.0f));
+                        ImGuiHelpers::Image(static_cast<Graphics::Texture2D*>(Application::Get().GetRenderGraph()->GetTexture(Graphics::RenderGraph::GBufferPBR)), Maths::Vector2(128.0f, 128.0f));
+                        ImGuiHelpers::Tooltip(static_cast<Graphics::Texture2D*>(Application::Get().GetRenderGraph()->GetTexture(Graphics::RenderGraph::GBufferPBR)), Maths::Vector2(256.0f, 256.0f));
 
                         ImGui::TreePop();
                     }
                     if(ImGui::TreeNode("Position Texture"))
                     {
-                        ImGuiHelpers::Image(Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(Graphics::SCREENTEX_POSITION), Maths::Vector2(128.0f, 128.0f));
-                        ImGuiHelpers::Tooltip(Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(Graphics::SCREENTEX_POSITION), Maths::Vector2(256.0f, 256.0f));
+                        ImGuiHelpers::Image(static_cast<Graphics::Texture2D*>(Application::Get().GetRenderGraph()->GetTexture(Graphics::RenderGraph::GBufferPosition)), Maths::Vector2(128.0f, 128.0f));
+                        ImGuiHelpers::Tooltip(static_cast<Graphics::Texture2D*>(Application::Get().GetRenderGraph()->GetTexture(Graphics::RenderGraph::GBufferPosition)), Maths::Vector2(256.0f, 256.0f));
 
                         ImGui::TreePop();
                     }
@@ -20,6 +20,7 @@
 #include <Lumos/Audio/AudioManager.h>
 #include <Lumos/Scene/Scene.h>
 #include <Lumos/Scene/SceneManager.h>
+#include <Lumos/Scene/SceneFile.h>
 #include <Lumos/Scene/Entity.h>
 #include <Lumos/Scene/EntityManager.h>
 #include <Lumos/Events/ApplicationEvent.h>
@@ -345,6 +346,11 @@ namespace Lumos
                     openReloadScenePopup = true;
                 }
 
+                if(ImGui::MenuItem("Convert Scene Files"))
+                {
+                    ConvertSceneFiles();
+                }
+
                 ImGui::Separator();
 
                 if(ImGui::BeginMenu("Style"))
@@ -774,6 +780,7 @@ namespace Lumos
             if(ImGui::Button("OK", ImVec2(120, 0)))
             {
                 Application::Get().GetSceneManager()->GetCurrentScene()->Serialise(m_ProjectRoot + "Assets/Scenes/", false);
+                SceneFile::Write(Application::Get().GetSceneManager()->GetCurrentScene(), m_ProjectRoot + "Assets/Scenes/");
                 ImGui::CloseCurrentPopup();
             }
             ImGui::SetItemDefaultFocus();
@@ -793,6 +800,7 @@ namespace Lumos
             if(ImGui::Button("Save Current Scene Changes"))
             {
                 Application::Get().GetSceneManager()->GetCurrentScene()->Serialise(ROOT_DIR "/ExampleProject/Assets/Scenes/", false);
+                SceneFile::Write(Application::Get().GetSceneManager()->GetCurrentScene(), ROOT_DIR "/ExampleProject/Assets/Scenes/");
             }
 
             ImGui::Text("Create New Scene?\n\n");
@@ -1306,6 +1314,7 @@ namespace Lumos
                 if(Input::Get().GetKeyPressed(InputCode::Key::S) && Application::Get().GetSceneActive())
                 {
                     Application::Get().GetSceneManager()->GetCurrentScene()->Serialise(ROOT_DIR "/ExampleProject/Assets/scenes/", false);
+                    SceneFile::Write(Application::Get().GetSceneManager()->GetCurrentScene(), ROOT_DIR "/ExampleProject/Assets/scenes/");
                 }
 
                 if(Input::Get().GetKeyPressed(InputCode::Key::O))
@@ -1381,6 +1390,17 @@ namespace Lumos
 #endif
     }
 
+    void Editor::ConvertSceneFiles()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        for(auto& name : Application::Get().GetSceneManager()->GetSceneNames())
+        {
+            // Loaded into a scratch scene, so the open scene keeps any unsaved changes
+            Scene scene(name);
+            SceneFile::Convert(&scene, m_ProjectRoot + "Assets/Scenes/", false);
+        }
+    }
+
     void Editor::DebugDraw()
     {
         LUMOS_PROFILE_FUNCTION();
@@ -1399,7 +1419,7 @@ namespace Lumos
                 {
                     if(mesh->GetActive())
                     {
-                        auto& worldTransform = trans.GetWorldMatrix();
+                        auto& worldTransform = trans.GetAffineWorldMatrix();
                         auto bbCopy = mesh->GetBoundingBox()->Transformed(worldTransform);
                         DebugRenderer::DebugDraw(bbCopy, selectedColour, true);
                     }
@@ -1416,10 +1436,10 @@ namespace Lumos
                 const auto& [sprite, trans] = group.get<Graphics::Sprite, Maths::Transform>(entity);
 
                 {
-                    auto& worldTransform = trans.GetWorldMatrix();
+                    auto& worldTransform = trans.GetAffineWorldMatrix();
 
                     auto bb = Maths::BoundingBox(Maths::Rect(sprite.GetPosition(), sprite.GetPosition() + sprite.GetScale()));
-                    bb.Transform(trans.GetWorldMatrix());
+                    bb.Transform(trans.GetAffineWorldMatrix());
                     DebugRenderer::DebugDraw(bb, selectedColour, true);
                 }
             }
@@ -1451,7 +1471,7 @@ namespace Lumos
                 {
                     if(mesh->GetActive())
                     {
-                        auto& worldTransform = transform->GetWorldMatrix();
+                        auto& worldTransform = transform->GetAffineWorldMatrix();
                         auto bbCopy = mesh->GetBoundingBox()->Transformed(worldTransform);
                         DebugRenderer::DebugDraw(bbCopy, selectedColour, true);
                     }
@@ -1462,7 +1482,7 @@ namespace Lumos
             if(transform && sprite)
             {
                 {
-                    auto& worldTransform = transform->GetWorldMatrix();
+                    auto& worldTransform = transform->GetAffineWorldMatrix();
 
                     auto bb = Maths::BoundingBox(
                         Maths::Rect(sprite->GetPosition(), sprite->GetPosition() + sprite->GetScale()));
@@ -1475,7 +1495,7 @@ namespace Lumos
             if(transform && animSprite)
             {
                 {
-                    auto& worldTransform = transform->GetWorldMatrix();
+                    auto& worldTransform = transform->GetAffineWorldMatrix();
 
                     auto bb = Maths::BoundingBox(Maths::Rect(animSprite->GetPosition(), animSprite->GetPosition() + animSprite->GetScale()));
                     bb.Transform(worldTransform);
@@ -1525,7 +1545,7 @@ namespace Lumos
             {
                 if(mesh->GetActive())
                 {
-                    auto& worldTransform = trans.GetWorldMatrix();
+                    auto& worldTransform = trans.GetAffineWorldMatrix();
 
                     auto bbCopy = mesh->GetBoundingBox()->Transformed(worldTransform);
                     float dist = ray.HitDistance(bbCopy);
@@ -1571,9 +1591,9 @@ namespace Lumos
         {
             const auto& [sprite, trans] = spriteGroup.get<Graphics::Sprite, Maths::Transform>(entity);
 
-            auto& worldTransform = trans.GetWorldMatrix();
+            auto& worldTransform = trans.GetAffineWorldMatrix();
             auto bb = Maths::BoundingBox(Maths::Rect(sprite.GetPosition(), sprite.GetPosition() + sprite.GetScale()));
-            bb.Transform(trans.GetWorldMatrix());
+            bb.Transform(trans.GetAffineWorldMatrix());
             float dist = ray.HitDistance(bb);
 
             if(dist < Maths::M_INFINITY)
@@ -1592,9 +1612,9 @@ namespace Lumos
         {
             const auto& [sprite, trans] = animSpriteGroup.get<Graphics::AnimatedSprite, Maths::Transform>(entity);
 
-            auto& worldTransform = trans.GetWorldMatrix();
+            auto& worldTransform = trans.GetAffineWorldMatrix();
             auto bb = Maths::BoundingBox(Maths::Rect(sprite.GetPosition(), sprite.GetPosition() + sprite.GetScale()));
-            bb.Transform(trans.GetWorldMatrix());
+            bb.Transform(trans.GetAffineWorldMatrix());
             float dist = ray.HitDistance(bb);
 
             if(dist < Maths::M_INFINITY)
@@ -1729,7 +1749,7 @@ namespace Lumos
         {
             std::string physicalPath;
             Lumos::VFS::Get()->ResolvePhysicalPath(filePath, physicalPath);
-            auto sound = Sound::Create(physicalPath, StringUtilities::GetFilePathExtension(filePath));
+            auto sound = Application::Get().GetSoundLibrary()->GetResource(physicalPath);
 
             auto soundNode = SharedRef<SoundNode>(SoundNode::Create());
             soundNode->SetSound(sound);
@@ -1756,9 +1776,7 @@ namespace Lumos
             auto entity = Application::Get().GetSceneManager()->GetCurrentScene()->CreateEntity("Sprite");
             auto& sprite = entity.AddComponent<Graphics::Sprite>();
             entity.GetOrAddComponent<Maths::Transform>();
-
-            SharedRef<Graphics::Texture2D> texture = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(filePath, filePath));
-            sprite.SetTexture(texture);
+            sprite.SetTextureFromFile(filePath);
         }
     }
 
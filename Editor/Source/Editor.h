@@ -158,6 +158,9 @@ namespace Lumos
         void FocusCamera(const Maths::Vector3& point, float distance, float speed = 1.0f);
 
         void RecompileShaders();
+
+        // Writes a .lscn scene file next to the .lsn of every scene in the project
+        void ConvertSceneFiles();
         void DebugDraw();
         void SelectObject(const Maths::Ray& ray);
 
@@ -796,7 +796,7 @@ end
                     {
                         std::string physicalPath;
                         Lumos::VFS::Get()->ResolvePhysicalPath(filePath, physicalPath);
-                        auto newSound = Lumos::Sound::Create(physicalPath, Lumos::StringUtilities::GetFilePathExtension(filePath));
+                        auto newSound = Lumos::Application::Get().GetSoundLibrary()->GetResource(physicalPath);
 
                         soundNode->SetSound(newSound);
                     }
@@ -970,6 +970,11 @@ end
             ImGui::AlignTextToFramePadding();
             auto tex = sprite.GetTexture();
 
+            // Only show the sprite's region when its texture is an atlas page
+            const auto& uvs = sprite.GetUVs();
+            const ImVec2 uvMin = ImVec2(uvs[3].x, flipImage ? uvs[1].y : uvs[3].y);
+            const ImVec2 uvMax = ImVec2(uvs[1].x, flipImage ? uvs[3].y : uvs[1].y);
+
             auto imageButtonSize = ImVec2(64, 64) * Application::Get().GetWindowDPI();
             auto callback = std::bind(&Lumos::Graphics::Sprite::SetTextureFromFile, &sprite, std::placeholders::_1);
             const ImGuiPayload* payload = ImGui::GetDragDropPayload();
@@ -980,7 +985,7 @@ end
             bool showTexture = !(hoveringButton && (payload != NULL && payload->IsDataType("AssetFile")));
             if(tex && showTexture)
             {
-                if(ImGui::ImageButton(tex->GetHandle(), imageButtonSize, ImVec2(0.0f, flipImage ? 1.0f : 0.0f), ImVec2(1.0f, flipImage ? 0.0f : 1.0f)))
+                if(ImGui::ImageButton(tex->GetHandle(), imageButtonSize, uvMin, uvMax))
                 {
                     Lumos::Editor::GetEditor()->GetFileBrowserWindow().Open();
                     Lumos::Editor::GetEditor()->GetFileBrowserWindow().SetCallback(callback);
@@ -989,7 +994,7 @@ end
                 if(ImGui::IsItemHovered() && tex)
                 {
                     ImGui::BeginTooltip();
-                    ImGui::Image(tex->GetHandle(), ImVec2(256, 256), ImVec2(0.0f, flipImage ? 1.0f : 0.0f), ImVec2(1.0f, flipImage ? 0.0f : 1.0f));
+                    ImGui::Image(tex->GetHandle(), ImVec2(256, 256), uvMin, uvMax);
                     ImGui::EndTooltip();
                 }
             }
@@ -1030,10 +1035,10 @@ end
 
             ImGui::NextColumn();
             ImGui::PushItemWidth(-1);
-            ImGui::TextUnformatted(tex ? tex->GetFilepath().c_str() : "No Texture");
+            ImGui::TextUnformatted(tex ? sprite.GetTexturePath().c_str() : "No Texture");
             if(tex)
             {
-                ImGuiHelpers::Tooltip(tex->GetFilepath());
+                ImGuiHelpers::Tooltip(sprite.GetTexturePath());
                 ImGui::Text("%u x %u", tex->GetWidth(), tex->GetHeight());
                 ImGui::Text("Mip Levels : %u", tex->GetMipMapLevels());
             }
@@ -1694,6 +1699,9 @@ end
         ImGui::Separator();
         ImGui::PopStyleVar();
 
+        if(primitiveType == Lumos::Graphics::PrimitiveType::File && !meshes.empty())
+            ImGui::TextDisabled("Materials are shared by every model using this file");
+
         int matIndex = 0;
 
         for(auto mesh : meshes)
@@ -292,6 +292,7 @@ namespace Lumos
                 ImGui::Text("Num Rendered Objects %u", stats.NumRenderedObjects);
                 ImGui::Text("Num Shadow Objects %u", stats.NumShadowObjects);
                 ImGui::Text("Num Draw Calls  %u", stats.NumDrawCalls);
+                ImGui::Text("Binds : Pipeline %u | Material %u | Mesh %u", stats.NumPipelineBinds, stats.NumMaterialBinds, stats.NumMeshBinds);
                 ImGui::Text("Used GPU Memory : %.1f mb | Total : %.1f mb", stats.UsedGPUMemory * 0.000001f, stats.TotalGPUMemory * 0.000001f);
 
                 if(ImGui::BeginPopupContextWindow())
@@ -0,0 +1,62 @@
+-- Spawns a large number of moving point lights over a field of spheres.
+-- Used to profile clustered light culling, see the Deferred Renderer section of the renderer settings
+
+local LIGHT_COUNT = 1000
+local LIGHT_RADIUS = 6.0
+local FIELD_SIZE = 80.0
+local SPHERE_GRID = 10
+
+local entityManager = {}
+local lights = {}
+local time = 0.0
+
+function CreateSpheres()
+    local spacing = FIELD_SIZE / SPHERE_GRID
+    for x = 0, SPHERE_GRID - 1, 1 do
+        for z = 0, SPHERE_GRID - 1, 1 do
+            local sphere = entityManager:Create()
+            sphere:GetOrAddTransform():SetLocalPosition(Vector3.new((x + 0.5) * spacing - FIELD_SIZE / 2.0, 1.0, (z + 0.5) * spacing - FIELD_SIZE / 2.0))
+            sphere:AddModel("//Meshes/sphere.obj")
+        end
+    end
+end
+
+function CreateLight(index)
+    local entity = entityManager:Create()
+    local centre = Vector3.new(Rand(-FIELD_SIZE / 2.0, FIELD_SIZE / 2.0), Rand(0.5, 3.0), Rand(-FIELD_SIZE / 2.0, FIELD_SIZE / 2.0))
+    entity:GetOrAddTransform():SetLocalPosition(centre)
+
+    local light = entity:AddLight()
+    light.Type = 2.0
+    light.Radius = LIGHT_RADIUS
+    light.Intensity = 1.0
+    light.Colour = Vector4.new(Rand(0.2, 1.0), Rand(0.2, 1.0), Rand(0.2, 1.0), 1.0)
+
+    lights[index] = { entity = entity, centre = centre, orbit = Rand(1.0, 4.0), speed = Rand(0.5, 2.0), phase = Rand(0.0, 6.28) }
+end
+
+function OnInit()
+    entityManager = scene:GetEntityManager()
+
+    CreateSpheres()
+
+    for i = 1, LIGHT_COUNT, 1 do
+        CreateLight(i)
+    end
+end
+
+function OnUpdate(dt)
+    time = time + dt
+
+    -- Every light moves each frame so the clusters are rebuilt from scratch
+    for i = 1, LIGHT_COUNT, 1 do
+        local light = lights[i]
+        local angle = time * light.speed + light.phase
+        local position = Vector3.new(light.centre.x + math.cos(angle) * light.orbit, light.centre.y, light.centre.z + math.sin(angle) * light.orbit)
+        light.entity:GetTransform():SetLocalPosition(position)
+    end
+end
+
+function OnCleanUp()
+    lights = {}
+end
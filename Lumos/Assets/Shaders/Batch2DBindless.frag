@@ -0,0 +1,25 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_ARB_shading_language_420pack : enable
+#extension GL_EXT_nonuniform_qualifier : require
+layout (location = 0) out vec4 colour;
+
+layout (location = 0) in DATA
+{
+	vec3 position;
+	vec2 uv;
+	float tid;
+	vec4 colour;
+} fs_in;
+
+// Used when the device supports descriptor indexing. Must match MAX_BINDLESS_TEXTURES in Renderer2D.h
+layout(set = 1, binding = 0) uniform sampler2D textures[1024];
+
+void main()
+{
+	vec4 texColor = fs_in.colour;
+	if (fs_in.tid > 0.0)
+		texColor *= texture(textures[nonuniformEXT(int(fs_in.tid - 0.5))], fs_in.uv);
+
+	colour = texColor;
+}
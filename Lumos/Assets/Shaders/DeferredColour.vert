@@ -2,14 +2,21 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
+#define MAX_INSTANCES 256
+
 layout(set = 0,binding = 0) uniform UniformBufferObject 
 {    
 	mat4 projView;
 } ubo;
 
+layout(set = 2,binding = 7) uniform InstanceBufferObject
+{
+	mat4 transforms[MAX_INSTANCES];
+} instances;
+
 layout(push_constant) uniform PushConsts
 {
-	mat4 transform;
+	uint instanceOffset;
 } pushConsts;
 
 layout(location = 0) in vec3 inPosition;
@@ -31,11 +38,12 @@ out gl_PerVertex
 
 void main() 
 {
-	fragPosition = vec4(inPosition, 1.0) * pushConsts.transform;
+	uint instance = pushConsts.instanceOffset + uint(gl_InstanceIndex);
+	fragPosition = vec4(inPosition, 1.0) * instances.transforms[instance];
     gl_Position = fragPosition * ubo.projView;
     
     fragColor = inColor.xyz;
 	fragTexCoord = inTexCoord;
-    fragNormal = normalize(inNormal) * transpose(inverse(mat3(pushConsts.transform)));
+    fragNormal = normalize(inNormal) * transpose(inverse(mat3(instances.transforms[instance])));
     fragTangent = inTangent;
 }
\ No newline at end of file
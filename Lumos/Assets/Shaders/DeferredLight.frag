@@ -19,6 +19,11 @@ layout(set = 1, binding = 8) uniform sampler2D uDepthSampler;
 #define GAMMA 2.2
 #define MAX_LIGHTS 32
 #define MAX_SHADOWMAPS 4
+#define MAX_CLUSTERED_LIGHTS 1024
+#define MAX_LIGHT_INDICES 32768
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
 
 const int NumPCFSamples = 16;
 const int numBlockerSearchSamples = 16;
@@ -51,7 +56,7 @@ struct Material
 
 layout(std140, binding = 0) uniform UniformBufferLight
 {
-	Light lights[MAX_LIGHTS]; //64 bytes * 32
+	Light lights[MAX_LIGHTS]; //64 bytes * 32, lights that reach every fragment
 	mat4 uShadowTransform[MAX_SHADOWMAPS]; //64 * 4 = 256
 
 	mat4 viewMatrix; //64
@@ -63,13 +68,31 @@ layout(std140, binding = 0) uniform UniformBufferLight
 	float maxShadowDistance;
 	float shadowFade;
 	float cascadeTransitionFade;
-	int lightCount; //4
+	int lightCount; //4, lights in lights[]
 	int shadowCount; // 4
 	int mode; // 4
 	int cubemapMipLevels; // 4
 	float initialBias;
 } ubo;
 
+// Point and spot lights, binned on the CPU into view space clusters
+layout(std140, binding = 1) uniform UniformBufferLights
+{
+	Light lights[MAX_CLUSTERED_LIGHTS];
+} lightData;
+
+layout(std140, binding = 2) uniform UniformBufferClusters
+{
+	mat4 clusterProjection;
+	vec4 clusterDepth; // slice = log(depth) * x + y
+	uvec4 clusters[CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z / 4]; // light index offset in the low 16 bits, count in the high 16 bits
+} clusterData;
+
+layout(std140, binding = 3) uniform UniformBufferLightIndices
+{
+	uvec4 lightIndices[MAX_LIGHT_INDICES / 8]; // 16 bit indices into lightData.lights
+} lightIndexData;
+
 // Constant normal incidence Fresnel factor for all dielectrics.
 const vec3 Fdielectric = vec3(0.04);
 
@@ -405,13 +428,46 @@ float CalculateShadow(vec3 wsPos, int cascadeIndex, float bias, vec3 lightDirect
 	}
 }
 
+uint ClusterIndex(vec3 wsPos)
+{
+	vec4 viewPos = vec4(wsPos, 1.0) * ubo.viewMatrix;
+	vec4 clipPos = viewPos * clusterData.clusterProjection;
+	vec2 tile = clamp((clipPos.xy / clipPos.w * 0.5 + 0.5) * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y), vec2(0.0), vec2(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1));
+	float slice = clamp(log(max(-viewPos.z, 0.0001)) * clusterData.clusterDepth.x + clusterData.clusterDepth.y, 0.0, float(CLUSTER_GRID_Z - 1));
+	return uint(tile.x) + CLUSTER_GRID_X * (uint(tile.y) + CLUSTER_GRID_Y * uint(slice));
+}
+
+uint ClusterLightIndex(uint i)
+{
+	uint word = lightIndexData.lightIndices[i >> 3][(i >> 1) & 3];
+	return (word >> ((i & 1) * 16)) & 0xFFFF;
+}
+
+// Fades to zero at the light's radius, so a light is only needed in the clusters its radius touches
+float RangeWindow(float dist, float radius)
+{
+	float ratio = dist / radius;
+	ratio *= ratio;
+	float window = clamp(1.0 - ratio * ratio, 0.0, 1.0);
+	return window * window;
+}
+
 vec3 Lighting(vec3 F0, vec3 wsPos, Material material)
 {
 	vec3 result = vec3(0.0);
 
-	for(int i = 0; i < ubo.lightCount; i++)
+	uint cluster = ClusterIndex(wsPos);
+	uint clusterWord = clusterData.clusters[cluster >> 2][cluster & 3];
+	uint clusterOffset = clusterWord & 0xFFFF;
+	int lightCount = ubo.lightCount + int(clusterWord >> 16);
+
+	for(int i = 0; i < lightCount; i++)
 	{
-		Light light = ubo.lights[i];
+		Light light;
+		if(i < ubo.lightCount)
+			light = ubo.lights[i];
+		else
+			light = lightData.lights[ClusterLightIndex(clusterOffset + uint(i - ubo.lightCount))];
 
 		float value = 0.0;
 
@@ -426,7 +482,7 @@ vec3 Lighting(vec3 F0, vec3 wsPos, Material material)
 			L = normalize(L);
 
 			// Attenuation
-			float atten = light.radius / (pow(dist, 2.0) + 1.0);
+			float atten = light.radius / (pow(dist, 2.0) + 1.0) * RangeWindow(dist, light.radius);
 
 			value = atten;
 
@@ -441,7 +497,7 @@ vec3 Lighting(vec3 F0, vec3 wsPos, Material material)
 			float theta         = dot(L.xyz, light.direction.xyz);
 			float epsilon       = cutoffAngle - cutoffAngle * 0.9f;
 			float attenuation 	= ((theta - cutoffAngle) / epsilon); // atteunate when approaching the outer cone
-			attenuation         *= light.radius / (pow(dist, 2.0) + 1.0);//saturate(1.0f - dist / light.range);
+			attenuation         *= light.radius / (pow(dist, 2.0) + 1.0) * RangeWindow(dist, light.radius);//saturate(1.0f - dist / light.range);
 			//float intensity 	= attenuation * attenuation;
 			
 			
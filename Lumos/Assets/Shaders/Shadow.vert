@@ -2,9 +2,11 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
+#define MAX_INSTANCES 256
+
 layout(push_constant) uniform PushConsts
 {
-	mat4 transform;
+	uint instanceOffset;
 	uint cascadeIndex;
 } pushConsts;
 
@@ -13,6 +15,11 @@ layout(set = 0,binding = 0) uniform UniformBufferObject
     mat4 projView[16];
 } ubo;
 
+layout(set = 1,binding = 1) uniform InstanceBufferObject
+{
+	mat4 transforms[MAX_INSTANCES];
+} instances;
+
 out gl_PerVertex
 {
     vec4 gl_Position;
@@ -42,5 +49,5 @@ void main()
             proj = ubo.projView[3];
             break;
     }
-    gl_Position = vec4(inPosition, 1.0) * pushConsts.transform * proj; 
+    gl_Position = vec4(inPosition, 1.0) * instances.transforms[pushConsts.instanceOffset + uint(gl_InstanceIndex)] * proj; 
 }
\ No newline at end of file
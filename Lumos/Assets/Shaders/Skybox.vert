@@ -2,7 +2,7 @@
 #extension GL_ARB_separate_shader_objects : enable
 #extension GL_ARB_shading_language_420pack : enable
 
-layout(set = 0,binding = 0) uniform UniformBufferObject
+layout(set = 0,binding = 0) uniform UniformBufferObjectDynamic
 {
 	mat4 invprojview;
 } ubo;
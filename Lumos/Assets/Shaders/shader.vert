@@ -9,7 +9,7 @@ layout(set = 0,binding = 0) uniform UniformBufferObject
 
 } ubo;
 
-layout(set = 0,binding = 1) uniform UniformBufferObject2 
+layout(set = 0,binding = 1) uniform UniformBufferObjectDynamic
 {
     mat4 model;
 } ubo2;
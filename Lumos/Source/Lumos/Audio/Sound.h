@@ -11,6 +11,12 @@ namespace Lumos
 
     public:
         static Sound* Create(const std::string& name, const std::string& extension);
+
+        // Creates the sound from samples decoded by LoadData, the sound takes ownership of them
+        static Sound* Create(const std::string& name, const AudioData& data);
+
+        // Decodes a wav or ogg file. Creates no audio resources, so it can run on a worker thread
+        static AudioData LoadData(const std::string& filePath, const std::string& extension);
         virtual ~Sound();
 
         unsigned char* GetData() const
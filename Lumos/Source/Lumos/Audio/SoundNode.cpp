@@ -1,5 +1,6 @@
 #include "Precompiled.h"
 #include "SoundNode.h"
+#include "Core/Application.h"
 
 #ifdef LUMOS_OPENAL
 #include "Platform/OpenAL/ALSoundNode.h"
@@ -21,7 +22,7 @@ namespace Lumos
         Reset();
     }
 
-    SoundNode::SoundNode(Sound* s)
+    SoundNode::SoundNode(const SharedRef<Sound>& s)
     {
         Reset();
         SetSound(s);
@@ -35,6 +36,7 @@ namespace Lumos
         m_TimeLeft = 0.0f;
         m_IsLooping = true;
         m_Sound = nullptr;
+        m_StreamedSound = nullptr;
         m_Paused = false;
         m_StreamPos = 0;
         m_IsGlobal = false;
@@ -48,12 +50,38 @@ namespace Lumos
     {
     }
 
-    void SoundNode::SetSound(Sound* s)
+    void SoundNode::SetSound(const SharedRef<Sound>& s)
     {
+        m_StreamedSound = nullptr;
         m_Sound = s;
         if(m_Sound)
         {
             m_TimeLeft = m_Sound->GetLength();
         }
     }
+
+    void SoundNode::LoadSound(const std::string& filePath)
+    {
+        SetSound(Application::Get().GetSoundLibrary()->GetResource(filePath));
+    }
+
+    void SoundNode::StreamSound(const std::string& filePath)
+    {
+        SetSound(nullptr);
+        m_StreamedSound = AssetStreamer::Get().LoadSound(filePath);
+    }
+
+    void SoundNode::UpdateStreaming()
+    {
+        if(!m_StreamedSound)
+            return;
+
+        if(!m_StreamedSound->IsFinished())
+        {
+            m_StreamedSound->SetPosition(m_Position);
+            return;
+        }
+
+        SetSound(m_StreamedSound->GetSound());
+    }
 }
@@ -4,6 +4,7 @@
 #include "Maths/Maths.h"
 #include "Core/StringUtilities.h"
 #include "Core/VFS.h"
+#include "Utilities/AssetStreamer.h"
 #include <cereal/cereal.hpp>
 
 namespace Lumos
@@ -13,12 +14,12 @@ namespace Lumos
     public:
         static SoundNode* Create();
         SoundNode();
-        SoundNode(Sound* s);
+        SoundNode(const SharedRef<Sound>& s);
         virtual ~SoundNode();
 
         void Reset();
 
-        Sound* GetSound() const { return m_Sound; }
+        const SharedRef<Sound>& GetSound() const { return m_Sound; }
 
         void SetVelocity(const Maths::Vector3& vel) { m_Velocity = vel; }
         Maths::Vector3 GetVelocity() const { return m_Velocity; }
@@ -59,13 +60,20 @@ namespace Lumos
         virtual void Pause() = 0;
         virtual void Resume() = 0;
         virtual void Stop() = 0;
-        virtual void SetSound(Sound* s);
+        virtual void SetSound(const SharedRef<Sound>& s);
+
+        // Shares the sound through the application's SoundLibrary
+        void LoadSound(const std::string& filePath);
+
+        // Loads the sound through the AssetStreamer, UpdateStreaming sets it once it is ready
+        void StreamSound(const std::string& filePath);
+        void UpdateStreaming();
 
         template <typename Archive>
         void save(Archive& archive) const
         {
             std::string path;
-            VFS::Get()->AbsoulePathToVFS(m_Sound ? m_Sound->GetFilePath() : "", path);
+            VFS::Get()->AbsoulePathToVFS(m_Sound ? m_Sound->GetFilePath() : m_StreamedSound ? m_StreamedSound->GetFilePath() : "", path);
 
             archive(cereal::make_nvp("Position", m_Position), cereal::make_nvp("Radius", m_Radius), cereal::make_nvp("Pitch", m_Pitch), cereal::make_nvp("Volume", m_Volume), cereal::make_nvp("Velocity", m_Velocity), cereal::make_nvp("Looping", m_IsLooping), cereal::make_nvp("Paused", m_Paused), cereal::make_nvp("ReferenceDistance", m_ReferenceDistance), cereal::make_nvp("Global", m_IsGlobal), cereal::make_nvp("TimeLeft", m_TimeLeft), cereal::make_nvp("Stationary", m_Stationary),
                 cereal::make_nvp("SoundNodePath", path), cereal::make_nvp("RollOffFactor", m_RollOffFactor));
@@ -80,12 +88,13 @@ namespace Lumos
 
             if(!soundFilePath.empty())
             {
-                SetSound(Sound::Create(soundFilePath, StringUtilities::GetFilePathExtension(soundFilePath)));
+                StreamSound(soundFilePath);
             }
         }
 
     protected:
-        Sound* m_Sound;
+        SharedRef<Sound> m_Sound;
+        SharedRef<StreamedSound> m_StreamedSound;
         Maths::Vector3 m_Position;
         Maths::Vector3 m_Velocity;
         float m_Volume;
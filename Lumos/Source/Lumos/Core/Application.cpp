@@ -10,6 +10,8 @@
 #include "Graphics/Renderers/RenderGraph.h"
 #include "Graphics/Camera/Camera.h"
 #include "Graphics/Material.h"
+#include "Graphics/SpriteAtlas.h"
+#include "Utilities/AssetStreamer.h"
 #include "Graphics/Renderers/DebugRenderer.h"
 #include "Graphics/Renderers/Renderer2D.h"
 #include "Graphics/Renderers/DeferredRenderer.h"
@@ -207,6 +209,10 @@ namespace Lumos
         m_ImGuiManager = CreateUniqueRef<ImGuiManager>(false);
         m_ImGuiManager->OnInit();
         m_ShaderLibrary = CreateSharedRef<ShaderLibrary>();
+        m_TextureLibrary = CreateSharedRef<TextureLibrary>();
+        m_MeshLibrary = CreateSharedRef<MeshLibrary>();
+        m_MaterialLibrary = CreateSharedRef<MaterialLibrary>();
+        m_SoundLibrary = CreateSharedRef<SoundLibrary>();
 
         m_RenderGraph = CreateUniqueRef<Graphics::RenderGraph>(screenWidth, screenHeight);
 
@@ -228,13 +234,19 @@ namespace Lumos
     {
         LUMOS_PROFILE_FUNCTION();
         Serialise();
+        AssetStreamer::Release();
         Graphics::Material::ReleaseDefaultTexture();
         Engine::Release();
         Input::Release();
 
         m_ShaderLibrary.reset();
+        m_TextureLibrary.reset();
+        m_MeshLibrary.reset();
+        m_MaterialLibrary.reset();
+        m_SoundLibrary.reset();
         m_SceneManager.reset();
         m_RenderGraph.reset();
+        Graphics::SpriteAtlas::Release();
         m_SystemManager.reset();
         m_ImGuiManager.reset();
 
@@ -377,6 +389,8 @@ namespace Lumos
             m_SceneManager->GetCurrentScene()->OnUpdate(dt);
         }
 
+        UpdateStreaming(m_SceneManager->GetCurrentScene());
+
         if(!m_Minimized)
         {
             m_RenderGraph->OnUpdate(dt, m_SceneManager->GetCurrentScene());
@@ -390,6 +404,28 @@ namespace Lumos
             Graphics::Framebuffer::DeleteUnusedCache();
         }
         m_ShaderLibrary->Update(dt.GetElapsedMillis());
+        m_TextureLibrary->Update(dt.GetElapsedMillis());
+        m_MeshLibrary->Update(dt.GetElapsedMillis());
+        m_MaterialLibrary->Update(dt.GetElapsedMillis());
+        m_SoundLibrary->Update(dt.GetElapsedMillis());
+    }
+
+    void Application::UpdateStreaming(Scene* scene)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        Maths::Transform* cameraTransform = m_RenderGraph->GetOverrideCameraTransform();
+
+        if(scene)
+        {
+            scene->UpdateStreaming();
+
+            auto& registry = scene->GetRegistry();
+            auto cameraView = registry.view<Camera>();
+            if(!cameraTransform && !cameraView.empty())
+                cameraTransform = registry.try_get<Maths::Transform>(cameraView.front());
+        }
+
+        AssetStreamer::Get().Update(cameraTransform ? cameraTransform->GetWorldPosition() : Maths::Vector3(0.0f));
     }
 
     void Application::OnEvent(Event& e)
@@ -427,6 +463,10 @@ namespace Lumos
     }
 
     SharedRef<ShaderLibrary>& Application::GetShaderLibrary() { return m_ShaderLibrary; }
+    SharedRef<TextureLibrary>& Application::GetTextureLibrary() { return m_TextureLibrary; }
+    SharedRef<MeshLibrary>& Application::GetMeshLibrary() { return m_MeshLibrary; }
+    SharedRef<MaterialLibrary>& Application::GetMaterialLibrary() { return m_MaterialLibrary; }
+    SharedRef<SoundLibrary>& Application::GetSoundLibrary() { return m_SoundLibrary; }
 
     void Application::OnExitScene()
     {
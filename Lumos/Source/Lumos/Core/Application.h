@@ -133,6 +133,10 @@ namespace Lumos
         float GetWindowDPI() const;
 
         SharedRef<ShaderLibrary>& GetShaderLibrary();
+        SharedRef<TextureLibrary>& GetTextureLibrary();
+        SharedRef<MeshLibrary>& GetMeshLibrary();
+        SharedRef<MaterialLibrary>& GetMaterialLibrary();
+        SharedRef<SoundLibrary>& GetSoundLibrary();
 
         static Application& Get()
         {
@@ -271,6 +275,9 @@ namespace Lumos
     private:
         bool OnWindowClose(WindowCloseEvent& e);
 
+        // Updates streaming priorities from the scene and starts or finishes asset streaming, nearest the camera first
+        void UpdateStreaming(Scene* scene);
+
         //Start proj saving
         uint32_t Width, Height;
         bool Fullscreen;
@@ -298,6 +305,10 @@ namespace Lumos
         UniqueRef<ImGuiManager> m_ImGuiManager;
         UniqueRef<Timer> m_Timer;
         SharedRef<ShaderLibrary> m_ShaderLibrary;
+        SharedRef<TextureLibrary> m_TextureLibrary;
+        SharedRef<MeshLibrary> m_MeshLibrary;
+        SharedRef<MaterialLibrary> m_MaterialLibrary;
+        SharedRef<SoundLibrary> m_SoundLibrary;
 
         AppState m_CurrentState = AppState::Loading;
         EditorState m_EditorState = EditorState::Preview;
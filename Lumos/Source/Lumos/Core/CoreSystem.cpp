@@ -3,6 +3,7 @@
 #include "VFS.h"
 #include "JobSystem.h"
 #include "Scripting/Lua/LuaManager.h"
+#include "Physics/LumosPhysicsEngine/LumosPhysicsEngine.h"
 #include "Core/Version.h"
 #include "Core/CommandLine.h"
 
@@ -28,6 +29,8 @@ namespace Lumos
             float oFloat = 0.f;
             bool oBool = false;
             bool oPrintHelp = false;
+            bool oBenchmarkJobs = false;
+            bool oBenchmarkPhysics = false;
 
             // First configure all possible command line options.
             args.AddArgument({ "-s", "--string" }, &oString, "A string value");
@@ -36,6 +39,8 @@ namespace Lumos
             args.AddArgument({ "-d", "--double" }, &oDouble, "A float value");
             args.AddArgument({ "-f", "--float" }, &oFloat, "A double value");
             args.AddArgument({ "-b", "--bool" }, &oBool, "A bool value");
+            args.AddArgument({ "-bj", "--benchmark-jobs" }, &oBenchmarkJobs, "Log JobSystem dispatch overhead on startup");
+            args.AddArgument({ "-bp", "--benchmark-physics" }, &oBenchmarkPhysics, "Log physics step timings for a pile of boxes on startup");
             args.AddArgument({ "-h", "--help" }, &oPrintHelp,
                 "Print this help. This help message is actually so long "
                 "that it requires a line break!");
@@ -49,6 +54,11 @@ namespace Lumos
             }
 
             System::JobSystem::OnInit();
+            if(oBenchmarkJobs)
+                System::JobSystem::Benchmark();
+            if(oBenchmarkPhysics)
+                LumosPhysicsEngine::Benchmark();
+
             LUMOS_LOG_INFO("Initialising System");
             VFS::OnInit();
             LuaManager::Get().OnInit();
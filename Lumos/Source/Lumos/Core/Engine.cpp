@@ -12,4 +12,28 @@ namespace Lumos
     Engine::~Engine()
     {
     }
+
+    static thread_local Engine::Stats* s_ThreadStats = nullptr;
+
+    Engine::Stats& Engine::Statistics()
+    {
+        return s_ThreadStats ? *s_ThreadStats : m_Stats;
+    }
+
+    Engine::Stats* Engine::SetThreadStatistics(Stats* stats)
+    {
+        Stats* previous = s_ThreadStats;
+        s_ThreadStats = stats;
+        return previous;
+    }
+
+    void Engine::AddStatistics(const Stats& stats)
+    {
+        m_Stats.NumRenderedObjects += stats.NumRenderedObjects;
+        m_Stats.NumShadowObjects += stats.NumShadowObjects;
+        m_Stats.NumDrawCalls += stats.NumDrawCalls;
+        m_Stats.NumPipelineBinds += stats.NumPipelineBinds;
+        m_Stats.NumMaterialBinds += stats.NumMaterialBinds;
+        m_Stats.NumMeshBinds += stats.NumMeshBinds;
+    }
 }
@@ -26,6 +26,9 @@ namespace Lumos
             uint32_t NumRenderedObjects = 0;
             uint32_t NumShadowObjects = 0;
             uint32_t NumDrawCalls = 0;
+            uint32_t NumPipelineBinds = 0;
+            uint32_t NumMaterialBinds = 0;
+            uint32_t NumMeshBinds = 0;
             float FrameTime = 0.0f;
             float UsedGPUMemory = 0.0f;
             float UsedRam = 0.0f;
@@ -40,10 +43,20 @@ namespace Lumos
             m_Stats.UsedGPUMemory = 0.0f;
             m_Stats.UsedRam = 0.0f;
             m_Stats.NumDrawCalls = 0;
+            m_Stats.NumPipelineBinds = 0;
+            m_Stats.NumMaterialBinds = 0;
+            m_Stats.NumMeshBinds = 0;
             m_Stats.TotalGPUMemory = 0.0f;
         }
 
-        Stats& Statistics() { return m_Stats; }
+        Stats& Statistics();
+
+        // Redirects Statistics() on the calling thread to stats, so jobs can count without racing the main thread.
+        // Pass nullptr to restore the engine's own. Returns the previous redirect
+        static Stats* SetThreadStatistics(Stats* stats);
+
+        // Adds the per frame render counters of stats
+        void AddStatistics(const Stats& stats);
 
     private:
         Stats m_Stats;
@@ -1,6 +1,7 @@
 #include "Precompiled.h"
 #include "JobSystem.h"
 #include "Maths/Maths.h"
+#include "Utilities/Timer.h"
 
 #include <atomic>
 #include <thread>
@@ -25,53 +26,81 @@ namespace Lumos
 {
     namespace System
     {
-        // Fixed size very simple thread safe ring buffer
+        // Fixed size lock free work stealing deque (Chase-Lev)
+        //	Only the owning thread may call push_back / pop_back
+        //	Any thread may call steal
         template <typename T, size_t capacity>
-        class ThreadSafeRingBuffer
+        class WorkStealingDeque
         {
+            static_assert((capacity & (capacity - 1)) == 0, "WorkStealingDeque capacity must be a power of two");
+
         public:
-            // Push an item to the end if there is free space
+            // Push an item to the bottom if there is free space
             //	Returns true if succesful
             //	Returns false if there is not enough space
-            inline bool push_back(const T& item)
+            inline bool push_back(T* item)
             {
-                LUMOS_PROFILE_FUNCTION();
-                bool result = false;
-                lock.lock();
-                size_t next = (head + 1) % capacity;
-                if(next != tail)
+                int64_t b = bottom.load(std::memory_order_relaxed);
+                int64_t t = top.load(std::memory_order_acquire);
+                if(b - t >= (int64_t)capacity)
+                    return false;
+
+                data[b & (capacity - 1)].store(item, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return true;
+            }
+
+            // Take the most recently pushed item
+            //	Returns nullptr if there are no items
+            inline T* pop_back()
+            {
+                int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+                bottom.store(b, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t t = top.load(std::memory_order_relaxed);
+
+                T* item = nullptr;
+                if(t <= b)
                 {
-                    data[head] = item;
-                    head = next;
-                    result = true;
+                    item = data[b & (capacity - 1)].load(std::memory_order_relaxed);
+                    if(t == b)
+                    {
+                        // Last item, race against stealers
+                        if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                            item = nullptr;
+                        bottom.store(b + 1, std::memory_order_relaxed);
+                    }
+                }
+                else
+                {
+                    bottom.store(b + 1, std::memory_order_relaxed);
                 }
-                lock.unlock();
-                return result;
+                return item;
             }
 
-            // Get an item if there are any
-            //	Returns true if succesful
-            //	Returns false if there are no items
-            inline bool pop_front(T& item)
+            // Take the oldest item
+            //	Returns nullptr if there are no items or another thread won the race
+            inline T* steal()
             {
-                LUMOS_PROFILE_FUNCTION();
-                bool result = false;
-                lock.lock();
-                if(tail != head)
+                int64_t t = top.load(std::memory_order_acquire);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                int64_t b = bottom.load(std::memory_order_acquire);
+
+                if(t < b)
                 {
-                    item = data[tail];
-                    tail = (tail + 1) % capacity;
-                    result = true;
+                    T* item = data[t & (capacity - 1)].load(std::memory_order_relaxed);
+                    if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                        return nullptr;
+                    return item;
                 }
-                lock.unlock();
-                return result;
+                return nullptr;
             }
 
         private:
-            T data[capacity];
-            size_t head = 0;
-            size_t tail = 0;
-            std::mutex lock;
+            alignas(64) std::atomic<int64_t> top { 0 };
+            alignas(64) std::atomic<int64_t> bottom { 0 };
+            std::atomic<T*> data[capacity];
         };
 
         namespace JobSystem
@@ -79,49 +108,167 @@ namespace Lumos
             struct Job
             {
                 Context* ctx;
-                std::function<void(JobDispatchArgs)> task;
+                JobFunction task;
                 uint32_t groupID;
                 uint32_t groupJobOffset;
                 uint32_t groupJobEnd;
                 uint32_t sharedmemory_size;
             };
 
+            static const uint32_t InvalidQueueIndex = ~0u;
+
             uint32_t numThreads = 0;
-            ThreadSafeRingBuffer<Job, 256> jobQueue;
+
+            // One deque per worker plus one for the thread that called OnInit (main thread)
+            std::vector<std::unique_ptr<WorkStealingDeque<Job, 4096>>> jobQueues;
+
+            // Unbounded overflow for full deques and for threads that don't own a deque
+            std::deque<Job*> overflowQueue;
+            std::mutex overflowMutex;
+            std::atomic<uint32_t> overflowCount { 0 };
+
+            std::atomic<uint32_t> pendingJobs { 0 };
+            std::atomic<uint32_t> sleepingThreads { 0 };
             std::condition_variable wakeCondition;
             std::mutex wakeMutex;
 
-            inline bool work()
+            thread_local uint32_t threadQueueIndex = InvalidQueueIndex;
+
+            // Finished jobs are recycled instead of deleted. Each thread keeps a small local free list
+            // and exchanges whole batches with the shared pool, so the shared lock is rarely taken.
+            // The pool only grows while warming up, after that submitting a job never allocates.
+            static const size_t JobBatchSize = 64;
+            thread_local std::vector<Job*> localFreeJobs;
+            std::vector<Job*> sharedFreeJobs;
+            std::mutex sharedFreeJobsMutex;
+
+            inline Job* AllocateJob()
             {
-                LUMOS_PROFILE_FUNCTION();
-                Job job;
-                if(jobQueue.pop_front(job))
+                if(localFreeJobs.empty())
                 {
-                    JobDispatchArgs args;
-                    args.groupID = job.groupID;
-                    if(job.sharedmemory_size > 0)
-                    {
-                        args.sharedmemory = alloca(job.sharedmemory_size);
-                    }
-                    else
+                    localFreeJobs.reserve(JobBatchSize * 2);
+
+                    std::lock_guard<std::mutex> lock(sharedFreeJobsMutex);
+                    size_t count = std::min(JobBatchSize, sharedFreeJobs.size());
+                    localFreeJobs.insert(localFreeJobs.end(), sharedFreeJobs.end() - count, sharedFreeJobs.end());
+                    sharedFreeJobs.resize(sharedFreeJobs.size() - count);
+                }
+
+                if(localFreeJobs.empty())
+                    return new Job();
+
+                Job* job = localFreeJobs.back();
+                localFreeJobs.pop_back();
+                return job;
+            }
+
+            inline void FreeJob(Job* job)
+            {
+                job->task.Reset();
+
+                if(localFreeJobs.size() >= JobBatchSize * 2)
+                {
+                    std::lock_guard<std::mutex> lock(sharedFreeJobsMutex);
+                    sharedFreeJobs.insert(sharedFreeJobs.end(), localFreeJobs.end() - JobBatchSize, localFreeJobs.end());
+                    localFreeJobs.resize(localFreeJobs.size() - JobBatchSize);
+                }
+
+                localFreeJobs.push_back(job);
+            }
+
+            inline void wake(uint32_t count)
+            {
+                if(sleepingThreads.load() == 0)
+                    return;
+
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                if(count > 1)
+                    wakeCondition.notify_all();
+                else
+                    wakeCondition.notify_one();
+            }
+
+            inline void submit(Job* job)
+            {
+                pendingJobs.fetch_add(1);
+
+                if(threadQueueIndex == InvalidQueueIndex || !jobQueues[threadQueueIndex]->push_back(job))
+                {
+                    std::lock_guard<std::mutex> lock(overflowMutex);
+                    overflowQueue.push_back(job);
+                    overflowCount.fetch_add(1);
+                }
+            }
+
+            inline Job* find()
+            {
+                Job* job = nullptr;
+
+                if(threadQueueIndex != InvalidQueueIndex)
+                    job = jobQueues[threadQueueIndex]->pop_back();
+
+                if(!job && overflowCount.load(std::memory_order_relaxed) > 0)
+                {
+                    std::lock_guard<std::mutex> lock(overflowMutex);
+                    if(!overflowQueue.empty())
                     {
-                        args.sharedmemory = nullptr;
+                        job = overflowQueue.front();
+                        overflowQueue.pop_front();
+                        overflowCount.fetch_sub(1);
                     }
+                }
 
-                    for(uint32_t i = job.groupJobOffset; i < job.groupJobEnd; ++i)
+                if(!job)
+                {
+                    const uint32_t queueCount = static_cast<uint32_t>(jobQueues.size());
+                    const uint32_t start = threadQueueIndex == InvalidQueueIndex ? 0 : threadQueueIndex + 1;
+                    for(uint32_t i = 0; i < queueCount && !job; ++i)
                     {
-                        LUMOS_PROFILE_SCOPE("Group Loop");
-                        args.jobIndex = i;
-                        args.groupIndex = i - job.groupJobOffset;
-                        args.isFirstJobInGroup = (i == job.groupJobOffset);
-                        args.isLastJobInGroup = (i == job.groupJobEnd - 1);
-                        job.task(args);
+                        uint32_t victim = (start + i) % queueCount;
+                        if(victim != threadQueueIndex)
+                            job = jobQueues[victim]->steal();
                     }
+                }
+
+                if(job)
+                    pendingJobs.fetch_sub(1);
+
+                return job;
+            }
 
-                    job.ctx->counter.fetch_sub(1);
-                    return true;
+            inline bool work()
+            {
+                LUMOS_PROFILE_FUNCTION();
+                Job* job = find();
+                if(!job)
+                    return false;
+
+                JobDispatchArgs args;
+                args.groupID = job->groupID;
+                if(job->sharedmemory_size > 0)
+                {
+                    args.sharedmemory = alloca(job->sharedmemory_size);
                 }
-                return false;
+                else
+                {
+                    args.sharedmemory = nullptr;
+                }
+
+                for(uint32_t i = job->groupJobOffset; i < job->groupJobEnd; ++i)
+                {
+                    LUMOS_PROFILE_SCOPE("Group Loop");
+                    args.jobIndex = i;
+                    args.groupIndex = i - job->groupJobOffset;
+                    args.isFirstJobInGroup = (i == job->groupJobOffset);
+                    args.isLastJobInGroup = (i == job->groupJobEnd - 1);
+                    job->task(args);
+                }
+
+                // Release the payload before signalling, captures may reference the waiting thread's stack
+                Context* ctx = job->ctx;
+                FreeJob(job);
+                ctx->counter.fetch_sub(1);
+                return true;
             }
 
             void OnInit()
@@ -132,6 +279,13 @@ namespace Lumos
                 // Calculate the actual number of worker threads we want:
                 numThreads = Lumos::Maths::Max(1U, numCores - 1);
 
+                jobQueues.reserve(numThreads + 1);
+                for(uint32_t i = 0; i < numThreads + 1; ++i)
+                    jobQueues.emplace_back(new WorkStealingDeque<Job, 4096>());
+
+                // The initialising thread owns the last queue
+                threadQueueIndex = numThreads;
+
                 for(uint32_t threadID = 0; threadID < numThreads; ++threadID)
                 {
                     std::thread worker([threadID]
@@ -139,6 +293,7 @@ namespace Lumos
                             std::stringstream ss;
                             ss << "JobSystem_" << threadID;
                             LUMOS_PROFILE_SETTHREADNAME(ss.str().c_str());
+                            threadQueueIndex = threadID;
 
 #ifdef LUMOS_PLATFORM_MACOS
                             setpriority(PRIO_PROCESS, 0, -10);
@@ -149,7 +304,10 @@ namespace Lumos
                                 {
                                     // no job, put thread to sleep
                                     std::unique_lock<std::mutex> lock(wakeMutex);
-                                    wakeCondition.wait(lock);
+                                    sleepingThreads.fetch_add(1);
+                                    wakeCondition.wait(lock, []
+                                        { return pendingJobs.load() > 0; });
+                                    sleepingThreads.fetch_sub(1);
                                 }
                             }
                         });
@@ -197,31 +355,26 @@ namespace Lumos
                 return numThreads;
             }
 
-            void Execute(Context& ctx, const std::function<void(JobDispatchArgs)>& task)
+            void Internal::Execute(Context& ctx, const JobFunction& task)
             {
                 // Context state is updated:
                 ctx.counter.fetch_add(1);
 
-                Job job;
-                job.ctx = &ctx;
-                job.task = task;
-                job.groupID = 0;
-                job.groupJobOffset = 0;
-                job.groupJobEnd = 1;
-                job.sharedmemory_size = 0;
+                Job* job = AllocateJob();
+                job->ctx = &ctx;
+                job->task = task;
+                job->groupID = 0;
+                job->groupJobOffset = 0;
+                job->groupJobEnd = 1;
+                job->sharedmemory_size = 0;
 
-                // Try to push a new job until it is pushed successfully:
-                while(!jobQueue.push_back(job))
-                {
-                    wakeCondition.notify_all();
-                    work();
-                }
+                submit(job);
 
                 // Wake any one thread that might be sleeping:
-                wakeCondition.notify_one();
+                wake(1);
             }
 
-            void Dispatch(Context& ctx, uint32_t jobCount, uint32_t groupSize, const std::function<void(JobDispatchArgs)>& task, size_t sharedmemory_size)
+            void Internal::Dispatch(Context& ctx, uint32_t jobCount, uint32_t groupSize, const JobFunction& task, size_t sharedmemory_size)
             {
                 LUMOS_PROFILE_FUNCTION();
                 if(jobCount == 0 || groupSize == 0)
@@ -234,25 +387,21 @@ namespace Lumos
                 // Context state is updated:
                 ctx.counter.fetch_add(groupCount);
 
-                Job job;
-                job.ctx = &ctx;
-                job.task = task;
-                job.sharedmemory_size = (uint32_t)sharedmemory_size;
-
                 for(uint32_t groupID = 0; groupID < groupCount; ++groupID)
                 {
                     // For each group, generate one real job:
-                    job.groupID = groupID;
-                    job.groupJobOffset = groupID * groupSize;
-                    job.groupJobEnd = std::min(job.groupJobOffset + groupSize, jobCount);
-
-                    // Try to push a new job until it is pushed successfully:
-                    while(!jobQueue.push_back(job))
-                    {
-                        wakeCondition.notify_all();
-                        work();
-                    }
+                    Job* job = AllocateJob();
+                    job->ctx = &ctx;
+                    job->task = task;
+                    job->sharedmemory_size = (uint32_t)sharedmemory_size;
+                    job->groupID = groupID;
+                    job->groupJobOffset = groupID * groupSize;
+                    job->groupJobEnd = std::min(job->groupJobOffset + groupSize, jobCount);
+
+                    submit(job);
                 }
+
+                wake(groupCount);
             }
 
             uint32_t DispatchGroupCount(uint32_t jobCount, uint32_t groupSize)
@@ -269,8 +418,57 @@ namespace Lumos
 
             void Wait(const Context& ctx)
             {
-                wakeCondition.notify_all();
-                while(IsBusy(ctx)) { work(); }
+                LUMOS_PROFILE_FUNCTION();
+                // Help out with any queued jobs while waiting, only yield when there is nothing left to take
+                while(IsBusy(ctx))
+                {
+                    if(!work())
+                        std::this_thread::yield();
+                }
+            }
+
+            void Benchmark()
+            {
+                LUMOS_PROFILE_FUNCTION();
+                LUMOS_LOG_INFO("JobSystem Benchmark - {0} threads", numThreads);
+
+                // Large enough capture that std::function has to heap allocate, like most engine lambdas
+                struct Payload
+                {
+                    std::atomic<uint32_t>* counter;
+                    uint64_t padding[5];
+                };
+
+                std::atomic<uint32_t> counter { 0 };
+                Payload payload = {};
+                payload.counter = &counter;
+
+                for(uint32_t jobCount = 1000; jobCount <= 1000000; jobCount *= 10)
+                {
+                    Context ctx;
+
+                    // Warm the job pool so neither run measures its growth
+                    Dispatch(ctx, jobCount, 1, [](JobDispatchArgs args) {});
+                    Wait(ctx);
+
+                    counter = 0;
+                    TimeStamp start = Timer::Now();
+                    Dispatch(ctx, jobCount, 1, [payload](JobDispatchArgs args)
+                        { payload.counter->fetch_add(1, std::memory_order_relaxed); });
+                    Wait(ctx);
+                    float inlineTime = Timer::Duration(start, Timer::Now(), 1000.0f);
+
+                    counter = 0;
+                    start = Timer::Now();
+                    std::function<void(JobDispatchArgs)> function = [payload](JobDispatchArgs args)
+                    { payload.counter->fetch_add(1, std::memory_order_relaxed); };
+                    Dispatch(ctx, jobCount, 1, function);
+                    Wait(ctx);
+                    float functionTime = Timer::Duration(start, Timer::Now(), 1000.0f);
+
+                    LUMOS_LOG_INFO("{0} jobs : inline payload {1:.3f}ms ({2:.1f}ns/job), std::function payload {3:.3f}ms ({4:.1f}ns/job)",
+                        jobCount, inlineTime, inlineTime * 1000000.0f / jobCount, functionTime, functionTime * 1000000.0f / jobCount);
+                }
             }
         }
     }
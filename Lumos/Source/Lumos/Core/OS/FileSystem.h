@@ -13,9 +13,13 @@ namespace Lumos
         static bool ReadFile(const std::string& path, void* buffer, int64_t size = -1);
         static std::string ReadTextFile(const std::string& path);
 
-        static bool WriteFile(const std::string& path, uint8_t* buffer);
+        static bool WriteFile(const std::string& path, uint8_t* buffer, uint32_t size);
         static bool WriteTextFile(const std::string& path, const std::string& text);
 
+        // Maps the whole file read only, returns null on failure. Release with UnmapFile
+        static uint8_t* MapFile(const std::string& path, int64_t& size);
+        static void UnmapFile(uint8_t* data, int64_t size);
+
         static bool IsRelativePath(const char* path)
         {
             if(!path || path[0] == '/' || path[0] == '\\')
@@ -50,7 +54,7 @@ namespace Lumos
         static bool (*ReadFileBufferFunc)(const std::string&, void*, int64_t);
         static std::string (*ReadTextFileFunc)(const std::string&);
 
-        static bool (*WriteFileFunc)(const std::string&, uint8_t*);
+        static bool (*WriteFileFunc)(const std::string&, uint8_t*, uint32_t);
         static bool (*WriteTextFileFunc)(const std::string&, const std::string&);
     };
 
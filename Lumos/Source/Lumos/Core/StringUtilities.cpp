@@ -181,6 +181,11 @@ namespace Lumos
             return string.find(start) == 0;
         }
 
+        bool EndsWith(const std::string& string, const std::string& end)
+        {
+            return string.size() >= end.size() && string.compare(string.size() - end.size(), end.size(), end) == 0;
+        }
+
         int32_t NextInt(const std::string& string)
         {
             for(uint32_t i = 0; i < string.size(); i++)
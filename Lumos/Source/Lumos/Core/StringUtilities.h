@@ -56,6 +56,7 @@ namespace Lumos
 
         bool StringContains(const std::string& string, const std::string& chars);
         bool StartsWith(const std::string& string, const std::string& start);
+        bool EndsWith(const std::string& string, const std::string& end);
         int32_t NextInt(const std::string& string);
 
         bool StringEquals(const std::string& string1, const std::string& string2);
@@ -0,0 +1,284 @@
+#include "Precompiled.h"
+#include "TaskGraph.h"
+#include "Maths/Maths.h"
+
+#include <imgui/imgui.h>
+
+namespace Lumos
+{
+    namespace System
+    {
+        TaskGraph::TaskGraph(const std::string& name)
+            : m_Name(name)
+        {
+        }
+
+        TaskGraph::~TaskGraph()
+        {
+            Wait();
+        }
+
+        TaskGraph::TaskID TaskGraph::AddTask(const std::string& name, const std::function<void()>& task)
+        {
+            LUMOS_ASSERT(!m_Executing, "Modifying TaskGraph while executing");
+
+            auto newTask = CreateUniqueRef<Task>();
+            newTask->Name = name;
+            newTask->Function = task;
+
+            m_Tasks.push_back(std::move(newTask));
+            m_Sorted = false;
+            return static_cast<TaskID>(m_Tasks.size() - 1);
+        }
+
+        TaskGraph::TaskID TaskGraph::AddParallelTask(const std::string& name, const std::function<uint32_t()>& jobCount, uint32_t groupSize, const std::function<void(JobDispatchArgs)>& task)
+        {
+            LUMOS_ASSERT(!m_Executing, "Modifying TaskGraph while executing");
+
+            auto newTask = CreateUniqueRef<Task>();
+            newTask->Name = name;
+            newTask->ParallelFunction = task;
+            newTask->JobCount = jobCount;
+            newTask->GroupSize = Maths::Max(1U, groupSize);
+
+            m_Tasks.push_back(std::move(newTask));
+            m_Sorted = false;
+            return static_cast<TaskID>(m_Tasks.size() - 1);
+        }
+
+        void TaskGraph::AddDependency(TaskID before, TaskID after)
+        {
+            LUMOS_ASSERT(!m_Executing, "Modifying TaskGraph while executing");
+            LUMOS_ASSERT(before < m_Tasks.size() && after < m_Tasks.size() && before != after, "Invalid TaskGraph dependency");
+
+            m_Tasks[before]->Successors.push_back(after);
+            m_Tasks[after]->DependencyCount++;
+            m_Sorted = false;
+        }
+
+        void TaskGraph::Execute()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            LUMOS_ASSERT(!m_Executing, "TaskGraph already executing");
+
+            if(!m_Sorted)
+                SortTasks();
+
+            m_StartTime = Timer::Now();
+            m_Executing = true;
+
+            // Reset every counter before scheduling anything, tasks can finish while roots are still being scheduled
+            for(auto& task : m_Tasks)
+                task->RemainingDependencies.store(task->DependencyCount);
+
+            // Keeps the context busy until every root has been scheduled
+            m_Context.counter.fetch_add(1);
+
+            for(TaskID id = 0; id < m_Tasks.size(); id++)
+            {
+                if(m_Tasks[id]->DependencyCount == 0)
+                    Schedule(id);
+            }
+
+            m_Context.counter.fetch_sub(1);
+        }
+
+        void TaskGraph::Wait()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            if(!m_Executing)
+                return;
+
+            JobSystem::Wait(m_Context);
+            m_Executing = false;
+            CalculateCriticalPath();
+
+            if(m_DebugDump && !m_CriticalPath.empty())
+            {
+                std::stringstream ss;
+                for(size_t i = 0; i < m_CriticalPath.size(); i++)
+                {
+                    const Task& task = *m_Tasks[m_CriticalPath[i]];
+                    ss << (i > 0 ? " -> " : "") << task.Name << " (" << Timer::Duration(task.Start, task.End, 1000.0f) << "ms)";
+                }
+
+                LUMOS_LOG_INFO("{0} : {1:.3f}ms critical path {2:.3f}ms : {3}", m_Name, m_TotalTime, m_CriticalPathTime, ss.str());
+            }
+        }
+
+        bool TaskGraph::IsBusy() const
+        {
+            return m_Executing && JobSystem::IsBusy(m_Context);
+        }
+
+        void TaskGraph::Clear()
+        {
+            Wait();
+            m_Tasks.clear();
+            m_SortedTasks.clear();
+            m_CriticalPath.clear();
+            m_Sorted = true;
+        }
+
+        void TaskGraph::Schedule(TaskID id)
+        {
+            Task& task = *m_Tasks[id];
+
+            if(task.ParallelFunction)
+            {
+                task.Start = Timer::Now();
+
+                const uint32_t jobCount = task.JobCount ? task.JobCount() : 0;
+                if(jobCount == 0)
+                {
+                    Finish(id);
+                    return;
+                }
+
+                task.RemainingGroups.store(JobSystem::DispatchGroupCount(jobCount, task.GroupSize));
+                JobSystem::Dispatch(m_Context, jobCount, task.GroupSize, [this, id](JobDispatchArgs args)
+                    {
+                        Task& task = *m_Tasks[id];
+                        task.ParallelFunction(args);
+
+                        // Last group to finish runs the continuations
+                        if(args.isLastJobInGroup && task.RemainingGroups.fetch_sub(1) == 1)
+                            Finish(id);
+                    });
+            }
+            else
+            {
+                JobSystem::Execute(m_Context, [this, id](JobDispatchArgs args)
+                    {
+                        LUMOS_PROFILE_SCOPE("TaskGraph Task");
+                        Task& task = *m_Tasks[id];
+                        task.Start = Timer::Now();
+                        if(task.Function)
+                            task.Function();
+                        Finish(id);
+                    });
+            }
+        }
+
+        void TaskGraph::Finish(TaskID id)
+        {
+            Task& task = *m_Tasks[id];
+            task.End = Timer::Now();
+
+            // Scheduled before this job returns, so the context can't reach zero while continuations are pending
+            for(TaskID successor : task.Successors)
+            {
+                if(m_Tasks[successor]->RemainingDependencies.fetch_sub(1) == 1)
+                    Schedule(successor);
+            }
+        }
+
+        void TaskGraph::SortTasks()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            // Kahn's algorithm, used to walk the graph in dependency order when finding the critical path
+            std::vector<uint32_t> dependencies(m_Tasks.size());
+            m_SortedTasks.clear();
+            m_SortedTasks.reserve(m_Tasks.size());
+
+            for(TaskID id = 0; id < m_Tasks.size(); id++)
+            {
+                dependencies[id] = m_Tasks[id]->DependencyCount;
+                if(dependencies[id] == 0)
+                    m_SortedTasks.push_back(id);
+            }
+
+            for(size_t i = 0; i < m_SortedTasks.size(); i++)
+            {
+                for(TaskID successor : m_Tasks[m_SortedTasks[i]]->Successors)
+                {
+                    if(--dependencies[successor] == 0)
+                        m_SortedTasks.push_back(successor);
+                }
+            }
+
+            LUMOS_ASSERT(m_SortedTasks.size() == m_Tasks.size(), "TaskGraph contains a cycle");
+            m_Sorted = true;
+        }
+
+        void TaskGraph::CalculateCriticalPath()
+        {
+            m_CriticalPath.clear();
+            m_CriticalPathTime = 0.0f;
+            m_TotalTime = 0.0f;
+
+            if(m_Tasks.empty())
+                return;
+
+            std::vector<float> pathTime(m_Tasks.size(), 0.0f);
+            std::vector<TaskID> previous(m_Tasks.size(), InvalidTask);
+            TaskID last = InvalidTask;
+
+            for(TaskID id : m_SortedTasks)
+            {
+                const Task& task = *m_Tasks[id];
+                pathTime[id] += Timer::Duration(task.Start, task.End, 1000.0f);
+                m_TotalTime = Maths::Max(m_TotalTime, Timer::Duration(m_StartTime, task.End, 1000.0f));
+
+                for(TaskID successor : task.Successors)
+                {
+                    if(previous[successor] == InvalidTask || pathTime[id] > pathTime[successor])
+                    {
+                        pathTime[successor] = pathTime[id];
+                        previous[successor] = id;
+                    }
+                }
+            }
+
+            for(TaskID id : m_SortedTasks)
+            {
+                if(last == InvalidTask || pathTime[id] > pathTime[last])
+                    last = id;
+            }
+
+            m_CriticalPathTime = pathTime[last];
+            for(TaskID id = last; id != InvalidTask; id = previous[id])
+                m_CriticalPath.push_back(id);
+
+            std::reverse(m_CriticalPath.begin(), m_CriticalPath.end());
+        }
+
+        void TaskGraph::OnImGui()
+        {
+            ImGui::Text("Total : %.3fms  Critical Path : %.3fms", m_TotalTime, m_CriticalPathTime);
+            ImGui::Checkbox("Log Critical Path", &m_DebugDump);
+
+            ImGui::Columns(3);
+            ImGui::Separator();
+            ImGui::TextUnformatted("Task");
+            ImGui::NextColumn();
+            ImGui::TextUnformatted("Start (ms)");
+            ImGui::NextColumn();
+            ImGui::TextUnformatted("Duration (ms)");
+            ImGui::NextColumn();
+            ImGui::Separator();
+
+            for(TaskID id : m_SortedTasks)
+            {
+                const Task& task = *m_Tasks[id];
+                const bool critical = std::find(m_CriticalPath.begin(), m_CriticalPath.end(), id) != m_CriticalPath.end();
+
+                if(critical)
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.6f, 0.2f, 1.0f));
+
+                ImGui::TextUnformatted(task.Name.c_str());
+                ImGui::NextColumn();
+                ImGui::Text("%.3f", Timer::Duration(m_StartTime, task.Start, 1000.0f));
+                ImGui::NextColumn();
+                ImGui::Text("%.3f", Timer::Duration(task.Start, task.End, 1000.0f));
+                ImGui::NextColumn();
+
+                if(critical)
+                    ImGui::PopStyleColor();
+            }
+
+            ImGui::Columns(1);
+            ImGui::Separator();
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "Core/JobSystem.h"
+#include "Utilities/Timer.h"
+
+namespace Lumos
+{
+    namespace System
+    {
+        // Graph of tasks executed on the JobSystem.
+        // Tasks only start once every task they depend on has finished, and finishing a task
+        // schedules its continuations directly from the worker that ran it, so independent
+        // branches of the graph overlap instead of waiting on a barrier between each stage.
+        // The graph is built once and can be executed any number of times.
+        class LUMOS_EXPORT TaskGraph
+        {
+        public:
+            typedef uint32_t TaskID;
+            static const TaskID InvalidTask = ~0u;
+
+            TaskGraph(const std::string& name = "TaskGraph");
+            ~TaskGraph();
+
+            // Add a task that runs once on any thread
+            TaskID AddTask(const std::string& name, const std::function<void()>& task);
+
+            // Add a task that is split into multiple jobs, see JobSystem::Dispatch.
+            //	jobCount	: queried when the task becomes ready, so it can depend on the output of earlier tasks
+            TaskID AddParallelTask(const std::string& name, const std::function<uint32_t()>& jobCount, uint32_t groupSize, const std::function<void(JobDispatchArgs)>& task);
+
+            // 'after' will only start once 'before' has finished
+            void AddDependency(TaskID before, TaskID after);
+
+            // Start every task with no dependencies, returns immediately
+            void Execute();
+
+            // Wait until every task has finished, executing queued jobs on the calling thread in the meantime
+            void Wait();
+
+            void Run()
+            {
+                Execute();
+                Wait();
+            }
+
+            bool IsBusy() const;
+            void Clear();
+
+            uint32_t GetTaskCount() const { return static_cast<uint32_t>(m_Tasks.size()); }
+            const std::string& GetTaskName(TaskID id) const { return m_Tasks[id]->Name; }
+            const std::string& GetName() const { return m_Name; }
+
+            // Longest chain of dependent tasks from the last execution, ordered from first to last
+            const std::vector<TaskID>& GetCriticalPath() const { return m_CriticalPath; }
+            float GetCriticalPathTime() const { return m_CriticalPathTime; }
+            float GetTotalTime() const { return m_TotalTime; }
+            float GetTaskTime(TaskID id) const { return Timer::Duration(m_Tasks[id]->Start, m_Tasks[id]->End, 1000.0f); }
+
+            // Log the critical path every time the graph finishes
+            void SetDebugDump(bool dump) { m_DebugDump = dump; }
+            bool GetDebugDump() const { return m_DebugDump; }
+
+            void OnImGui();
+
+        private:
+            struct Task
+            {
+                std::string Name;
+                std::function<void()> Function;
+                std::function<void(JobDispatchArgs)> ParallelFunction;
+                std::function<uint32_t()> JobCount;
+                uint32_t GroupSize = 1;
+
+                std::vector<TaskID> Successors;
+                uint32_t DependencyCount = 0;
+                std::atomic<uint32_t> RemainingDependencies { 0 };
+                std::atomic<uint32_t> RemainingGroups { 0 };
+
+                TimeStamp Start;
+                TimeStamp End;
+            };
+
+            void Schedule(TaskID id);
+            void Finish(TaskID id);
+            void SortTasks();
+            void CalculateCriticalPath();
+
+            std::string m_Name;
+            std::vector<UniqueRef<Task>> m_Tasks;
+            std::vector<TaskID> m_SortedTasks;
+            std::vector<TaskID> m_CriticalPath;
+            JobSystem::Context m_Context;
+
+            TimeStamp m_StartTime;
+            float m_CriticalPathTime = 0.0f;
+            float m_TotalTime = 0.0f;
+            bool m_Executing = false;
+            bool m_Sorted = true;
+            bool m_DebugDump = false;
+        };
+    }
+}
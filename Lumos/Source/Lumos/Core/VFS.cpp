@@ -75,11 +75,11 @@ namespace Lumos
         return ResolvePhysicalPath(path, physicalPath) ? FileSystem::ReadTextFile(physicalPath) : nullptr;
     }
 
-    bool VFS::WriteFile(const std::string& path, uint8_t* buffer)
+    bool VFS::WriteFile(const std::string& path, uint8_t* buffer, uint32_t size)
     {
         LUMOS_ASSERT(s_Instance, "");
         std::string physicalPath;
-        return ResolvePhysicalPath(path, physicalPath) ? FileSystem::WriteFile(physicalPath, buffer) : false;
+        return ResolvePhysicalPath(path, physicalPath) ? FileSystem::WriteFile(physicalPath, buffer, size) : false;
     }
 
     bool VFS::WriteTextFile(const std::string& path, const std::string& text)
@@ -28,6 +28,13 @@ namespace Lumos::Graphics
         m_UVs = GetAnimatedUVs();
     }
 
+    void AnimatedSprite::SetTextureFromFile(const std::string& filePath)
+    {
+        auto texture = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(filePath, filePath));
+        if(texture)
+            SetTexture(texture);
+    }
+
     const std::array<Maths::Vector2, 4>& AnimatedSprite::GetAnimatedUVs()
     {
         LUMOS_PROFILE_FUNCTION();
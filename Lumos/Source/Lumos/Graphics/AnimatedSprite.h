@@ -38,6 +38,9 @@ namespace Lumos::Graphics
 
         void OnUpdate(float dt);
 
+        // Frames are laid out relative to the whole texture, so sprite sheets are not packed into the atlas
+        void SetTextureFromFile(const std::string& filePath) override;
+
         const std::array<Maths::Vector2, 4>& GetAnimatedUVs();
 
         void AddState(const std::vector<Maths::Vector2>& frames, float frameDuration, const std::string& stateName);
@@ -16,11 +16,6 @@ namespace Lumos
 
         GBuffer::~GBuffer()
         {
-            for(auto& m_Texture : m_ScreenTex)
-            {
-                delete m_Texture;
-            }
-
             delete m_DepthTexture;
         }
 
@@ -34,11 +29,6 @@ namespace Lumos
 
         void GBuffer::Init()
         {
-            for(auto& texture : m_ScreenTex)
-            {
-                texture = nullptr;
-            }
-
             m_DepthTexture = nullptr;
 
             BuildTextures();
@@ -46,15 +36,8 @@ namespace Lumos
 
         void GBuffer::BuildTextures()
         {
-            if(!m_ScreenTex[0])
-            {
-                for(auto& m_Texture : m_ScreenTex)
-                {
-                    m_Texture = Texture2D::Create();
-                }
-
+            if(!m_DepthTexture)
                 m_DepthTexture = TextureDepth::Create(m_Width, m_Height);
-            }
 
 #ifdef LUMOS_PLATFORM_IOS
             //Unless all render targets were rgba32 there were visual glitches on ios
@@ -71,12 +54,6 @@ namespace Lumos
             m_Formats[4] = TextureFormat::RGBA8;
 #endif
 
-            m_ScreenTex[SCREENTEX_COLOUR]->BuildTexture(m_Formats[0], m_Width, m_Height, false, false, false);
-            m_ScreenTex[SCREENTEX_POSITION]->BuildTexture(m_Formats[1], m_Width, m_Height, false, false, false);
-            m_ScreenTex[SCREENTEX_NORMALS]->BuildTexture(m_Formats[2], m_Width, m_Height, false, false, false);
-            m_ScreenTex[SCREENTEX_PBR]->BuildTexture(m_Formats[3], m_Width, m_Height, false, false, false);
-            m_ScreenTex[SCREENTEX_OFFSCREEN0]->BuildTexture(m_Formats[4], m_Width, m_Height, false, false, false);
-
             m_DepthTexture->Resize(m_Width, m_Height);
         }
 
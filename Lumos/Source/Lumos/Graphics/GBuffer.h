@@ -37,7 +37,7 @@ namespace Lumos
             inline uint32_t GetWidth() const { return m_Width; }
             inline uint32_t GetHeight() const { return m_Height; }
 
-            inline Texture2D* GetTexture(uint32_t index) const { return m_ScreenTex[index]; }
+            // The colour targets are transient textures created by the render graph, see RenderGraph::GBufferColour
             inline TextureDepth* GetDepthTexture() const { return m_DepthTexture; };
             inline TextureFormat GetTextureFormat(uint32_t index) const { return m_Formats[index]; };
 
@@ -45,7 +45,6 @@ namespace Lumos
             void Init();
 
         private:
-            Texture2D* m_ScreenTex[ScreenTextures::SCREENTEX_MAX] {};
             TextureDepth* m_DepthTexture {};
             TextureFormat m_Formats[ScreenTextures::SCREENTEX_MAX];
             uint32_t m_Width, m_Height;
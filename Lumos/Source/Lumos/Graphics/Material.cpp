@@ -6,6 +6,7 @@
 #include "Graphics/RHI/Pipeline.h"
 #include "Graphics/RHI/UniformBuffer.h"
 #include "Graphics/RHI/GraphicsContext.h"
+#include "Utilities/AssetStreamer.h"
 #include "Core/OS/FileSystem.h"
 #include "Core/VFS.h"
 #include "Core/Application.h"
@@ -65,6 +66,7 @@ namespace Lumos::Graphics
     void Material::SetTextures(const PBRMataterialTextures& textures)
     {
         LUMOS_PROFILE_FUNCTION();
+        m_StreamingTextures.clear();
         m_PBRMaterialTextures.albedo = textures.albedo;
         m_PBRMaterialTextures.normal = textures.normal;
         m_PBRMaterialTextures.roughness = textures.roughness;
@@ -89,37 +91,38 @@ namespace Lumos::Graphics
 
         m_Name = name;
         m_PBRMaterialTextures = PBRMataterialTextures();
+        m_StreamingTextures.clear();
         auto params = Graphics::TextureParameters(Graphics::TextureFormat::RGBA8, Graphics::TextureFilter::LINEAR, Graphics::TextureFilter::LINEAR, Graphics::TextureWrap::CLAMP_TO_EDGE);
 
         auto filePath = path + "/" + name + "/albedo" + extension;
 
         if(FileExists(filePath))
-            m_PBRMaterialTextures.albedo = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(name, path + "/" + name + "/albedo" + extension, params));
+            m_PBRMaterialTextures.albedo = Application::Get().GetTextureLibrary()->GetTexture(path + "/" + name + "/albedo" + extension, params);
 
         filePath = path + "/" + name + "/normal" + extension;
 
         if(FileExists(filePath))
-            m_PBRMaterialTextures.normal = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(name, path + "/" + name + "/normal" + extension, params));
+            m_PBRMaterialTextures.normal = Application::Get().GetTextureLibrary()->GetTexture(path + "/" + name + "/normal" + extension, params);
 
         filePath = path + "/" + name + "/roughness" + extension;
 
         if(FileExists(filePath))
-            m_PBRMaterialTextures.roughness = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(name, path + "/" + name + "/roughness" + extension, params));
+            m_PBRMaterialTextures.roughness = Application::Get().GetTextureLibrary()->GetTexture(path + "/" + name + "/roughness" + extension, params);
 
         filePath = path + "/" + name + "/metallic" + extension;
 
         if(FileExists(filePath))
-            m_PBRMaterialTextures.metallic = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(name, path + "/" + name + "/metallic" + extension, params));
+            m_PBRMaterialTextures.metallic = Application::Get().GetTextureLibrary()->GetTexture(path + "/" + name + "/metallic" + extension, params);
 
         filePath = path + "/" + name + "/ao" + extension;
 
         if(FileExists(filePath))
-            m_PBRMaterialTextures.ao = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(name, path + "/" + name + "/ao" + extension, params));
+            m_PBRMaterialTextures.ao = Application::Get().GetTextureLibrary()->GetTexture(path + "/" + name + "/ao" + extension, params);
 
         filePath = path + "/" + name + "/emissive" + extension;
 
         if(FileExists(filePath))
-            m_PBRMaterialTextures.emissive = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(name, path + "/" + name + "/emissive" + extension, params));
+            m_PBRMaterialTextures.emissive = Application::Get().GetTextureLibrary()->GetTexture(path + "/" + name + "/emissive" + extension, params);
     }
 
     void Material::LoadMaterial(const std::string& name, const std::string& path)
@@ -128,7 +131,8 @@ namespace Lumos::Graphics
 
         m_Name = name;
         m_PBRMaterialTextures = PBRMataterialTextures();
-        m_PBRMaterialTextures.albedo = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(name, path));
+        m_StreamingTextures.clear();
+        m_PBRMaterialTextures.albedo = Application::Get().GetTextureLibrary()->GetResource(path);
         m_PBRMaterialTextures.normal = nullptr;
         m_PBRMaterialTextures.roughness = nullptr;
         m_PBRMaterialTextures.metallic = nullptr;
@@ -317,6 +321,9 @@ namespace Lumos::Graphics
     {
         LUMOS_PROFILE_FUNCTION();
 
+        if(!m_StreamingTextures.empty())
+            UpdateStreamingTextures();
+
         if(m_DescriptorSet == nullptr || GetTexturesUpdated())
         {
             CreateDescriptorSet(1);
@@ -347,8 +354,9 @@ namespace Lumos::Graphics
     void Material::SetAlbedoTexture(const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
+        StopStreaming(&PBRMataterialTextures::albedo);
 
-        auto tex = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(path, path));
+        auto tex = Application::Get().GetTextureLibrary()->GetResource(path);
         if(tex)
         {
             m_PBRMaterialTextures.albedo = tex;
@@ -359,8 +367,9 @@ namespace Lumos::Graphics
     void Material::SetNormalTexture(const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
+        StopStreaming(&PBRMataterialTextures::normal);
 
-        auto tex = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(path, path));
+        auto tex = Application::Get().GetTextureLibrary()->GetResource(path);
         if(tex)
         {
             m_PBRMaterialTextures.normal = tex;
@@ -371,8 +380,9 @@ namespace Lumos::Graphics
     void Material::SetRoughnessTexture(const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
+        StopStreaming(&PBRMataterialTextures::roughness);
 
-        auto tex = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(path, path));
+        auto tex = Application::Get().GetTextureLibrary()->GetResource(path);
         if(tex)
         {
             m_PBRMaterialTextures.roughness = tex;
@@ -383,8 +393,9 @@ namespace Lumos::Graphics
     void Material::SetMetallicTexture(const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
+        StopStreaming(&PBRMataterialTextures::metallic);
 
-        auto tex = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(path, path));
+        auto tex = Application::Get().GetTextureLibrary()->GetResource(path);
         if(tex)
         {
             m_PBRMaterialTextures.metallic = tex;
@@ -395,8 +406,9 @@ namespace Lumos::Graphics
     void Material::SetAOTexture(const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
+        StopStreaming(&PBRMataterialTextures::ao);
 
-        auto tex = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(path, path));
+        auto tex = Application::Get().GetTextureLibrary()->GetResource(path);
         if(tex)
         {
             m_PBRMaterialTextures.ao = tex;
@@ -407,12 +419,87 @@ namespace Lumos::Graphics
     void Material::SetEmissiveTexture(const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
+        StopStreaming(&PBRMataterialTextures::emissive);
 
-        auto tex = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(path, path));
+        auto tex = Application::Get().GetTextureLibrary()->GetResource(path);
         if(tex)
         {
             m_PBRMaterialTextures.emissive = tex;
             m_TexturesUpdated = true;
         }
     }
+    void Material::SetStreamingPosition(const Maths::Vector3& position)
+    {
+        for(auto& texture : m_StreamingTextures)
+            texture.request->SetPosition(position);
+    }
+
+    void Material::StreamTexture(TextureSlot slot, TextureFlag usingMap, const std::string& filePath)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        StopStreaming(slot);
+
+        if(filePath.empty())
+            return;
+
+        m_PBRMaterialTextures.*slot = nullptr;
+        m_StreamingTextures.push_back({ slot, usingMap, m_MaterialProperties->*usingMap, AssetStreamer::Get().LoadTexture(filePath) });
+    }
+
+    void Material::StopStreaming(TextureSlot slot)
+    {
+        for(auto texture = m_StreamingTextures.begin(); texture != m_StreamingTextures.end(); texture++)
+        {
+            if(texture->slot == slot)
+            {
+                m_MaterialProperties->*texture->usingMap = texture->usingMapValue;
+                m_StreamingTextures.erase(texture);
+                return;
+            }
+        }
+    }
+
+    void Material::UpdateStreamingTextures()
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        auto finished = std::remove_if(m_StreamingTextures.begin(), m_StreamingTextures.end(), [this](const StreamingTexture& texture)
+            {
+                if(!texture.request->IsFinished())
+                    return false;
+
+                // Failed textures leave the slot empty, as a missing file did before
+                if(texture.request->IsReady())
+                {
+                    m_PBRMaterialTextures.*texture.slot = texture.request->GetTexture();
+                    m_MaterialProperties->*texture.usingMap = texture.usingMapValue;
+                    m_TexturesUpdated = true;
+                }
+                return true;
+            });
+
+        m_StreamingTextures.erase(finished, m_StreamingTextures.end());
+    }
+
+    std::string Material::GetTextureFilePath(TextureSlot slot) const
+    {
+        for(auto& texture : m_StreamingTextures)
+        {
+            if(texture.slot == slot)
+                return texture.request->GetFilePath();
+        }
+
+        const auto& texture = m_PBRMaterialTextures.*slot;
+        return texture ? texture->GetFilepath() : "";
+    }
+
+    MaterialProperties Material::GetSavedProperties() const
+    {
+        MaterialProperties properties = *m_MaterialProperties;
+
+        for(auto& texture : m_StreamingTextures)
+            properties.*texture.usingMap = texture.usingMapValue;
+
+        return properties;
+    }
 }
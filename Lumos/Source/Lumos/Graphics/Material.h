@@ -11,6 +11,7 @@ namespace Lumos
     {
         class DescriptorSet;
         class UniformBuffer;
+        class StreamedTexture;
 
         const float PBR_WORKFLOW_SEPARATE_TEXTURES = 0.0f;
         const float PBR_WORKFLOW_METALLIC_ROUGHNESS = 1.0f;
@@ -141,23 +142,25 @@ namespace Lumos
                     VFS::Get()->AbsoulePathToVFS(path, shaderPath);
                 }
 
-                archive(cereal::make_nvp("Albedo", m_PBRMaterialTextures.albedo ? m_PBRMaterialTextures.albedo->GetFilepath() : ""),
-                    cereal::make_nvp("Normal", m_PBRMaterialTextures.normal ? m_PBRMaterialTextures.normal->GetFilepath() : ""),
-                    cereal::make_nvp("Metallic", m_PBRMaterialTextures.metallic ? m_PBRMaterialTextures.metallic->GetFilepath() : ""),
-                    cereal::make_nvp("Roughness", m_PBRMaterialTextures.roughness ? m_PBRMaterialTextures.roughness->GetFilepath() : ""),
-                    cereal::make_nvp("Ao", m_PBRMaterialTextures.ao ? m_PBRMaterialTextures.ao->GetFilepath() : ""),
-                    cereal::make_nvp("Emissive", m_PBRMaterialTextures.emissive ? m_PBRMaterialTextures.emissive->GetFilepath() : ""),
-                    cereal::make_nvp("albedoColour", m_MaterialProperties->albedoColour),
-                    cereal::make_nvp("roughnessColour", m_MaterialProperties->roughnessColour),
-                    cereal::make_nvp("metallicColour", m_MaterialProperties->metallicColour),
-                    cereal::make_nvp("emissiveColour", m_MaterialProperties->emissiveColour),
-                    cereal::make_nvp("usingAlbedoMap", m_MaterialProperties->usingAlbedoMap),
-                    cereal::make_nvp("usingMetallicMap", m_MaterialProperties->usingMetallicMap),
-                    cereal::make_nvp("usingRoughnessMap", m_MaterialProperties->usingRoughnessMap),
-                    cereal::make_nvp("usingNormalMap", m_MaterialProperties->usingNormalMap),
-                    cereal::make_nvp("usingAOMap", m_MaterialProperties->usingAOMap),
-                    cereal::make_nvp("usingEmissiveMap", m_MaterialProperties->usingEmissiveMap),
-                    cereal::make_nvp("workflow", m_MaterialProperties->workflow),
+                const MaterialProperties properties = GetSavedProperties();
+
+                archive(cereal::make_nvp("Albedo", GetTextureFilePath(&PBRMataterialTextures::albedo)),
+                    cereal::make_nvp("Normal", GetTextureFilePath(&PBRMataterialTextures::normal)),
+                    cereal::make_nvp("Metallic", GetTextureFilePath(&PBRMataterialTextures::metallic)),
+                    cereal::make_nvp("Roughness", GetTextureFilePath(&PBRMataterialTextures::roughness)),
+                    cereal::make_nvp("Ao", GetTextureFilePath(&PBRMataterialTextures::ao)),
+                    cereal::make_nvp("Emissive", GetTextureFilePath(&PBRMataterialTextures::emissive)),
+                    cereal::make_nvp("albedoColour", properties.albedoColour),
+                    cereal::make_nvp("roughnessColour", properties.roughnessColour),
+                    cereal::make_nvp("metallicColour", properties.metallicColour),
+                    cereal::make_nvp("emissiveColour", properties.emissiveColour),
+                    cereal::make_nvp("usingAlbedoMap", properties.usingAlbedoMap),
+                    cereal::make_nvp("usingMetallicMap", properties.usingMetallicMap),
+                    cereal::make_nvp("usingRoughnessMap", properties.usingRoughnessMap),
+                    cereal::make_nvp("usingNormalMap", properties.usingNormalMap),
+                    cereal::make_nvp("usingAOMap", properties.usingAOMap),
+                    cereal::make_nvp("usingEmissiveMap", properties.usingEmissiveMap),
+                    cereal::make_nvp("workflow", properties.workflow),
                     cereal::make_nvp("shader", shaderPath));
             }
 
@@ -194,18 +197,13 @@ namespace Lumos
                 if(!shaderFilePath.empty())
                     SetShader(shaderFilePath);
 
-                if(!albedoFilePath.empty())
-                    m_PBRMaterialTextures.albedo = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile("albedo", albedoFilePath));
-                if(!normalFilePath.empty())
-                    m_PBRMaterialTextures.normal = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile("roughness", normalFilePath));
-                if(!metallicFilePath.empty())
-                    m_PBRMaterialTextures.metallic = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile("metallic", metallicFilePath));
-                if(!roughnessFilePath.empty())
-                    m_PBRMaterialTextures.roughness = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile("roughness", roughnessFilePath));
-                if(!emissiveFilePath.empty())
-                    m_PBRMaterialTextures.emissive = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile("emissive", emissiveFilePath));
-                if(!aoFilePath.empty())
-                    m_PBRMaterialTextures.ao = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile("ao", aoFilePath));
+                // Textures stream in, the material renders without them until they are ready
+                StreamTexture(&PBRMataterialTextures::albedo, &MaterialProperties::usingAlbedoMap, albedoFilePath);
+                StreamTexture(&PBRMataterialTextures::normal, &MaterialProperties::usingNormalMap, normalFilePath);
+                StreamTexture(&PBRMataterialTextures::metallic, &MaterialProperties::usingMetallicMap, metallicFilePath);
+                StreamTexture(&PBRMataterialTextures::roughness, &MaterialProperties::usingRoughnessMap, roughnessFilePath);
+                StreamTexture(&PBRMataterialTextures::emissive, &MaterialProperties::usingEmissiveMap, emissiveFilePath);
+                StreamTexture(&PBRMataterialTextures::ao, &MaterialProperties::usingAOMap, aoFilePath);
             }
 
             uint32_t GetFlags() const { return m_Flags; };
@@ -224,7 +222,29 @@ namespace Lumos
 
             static SharedRef<Texture2D> GetDefaultTexture() { return s_DefaultTexture; }
 
+            // Textures closest to the camera stream in first
+            void SetStreamingPosition(const Maths::Vector3& position);
+            bool IsStreaming() const { return !m_StreamingTextures.empty(); }
+
         private:
+            typedef SharedRef<Texture2D> PBRMataterialTextures::*TextureSlot;
+            typedef float MaterialProperties::*TextureFlag;
+
+            struct StreamingTexture
+            {
+                TextureSlot slot;
+                TextureFlag usingMap;
+                float usingMapValue; // Restored once the texture is ready, the descriptor set clears it while the slot is empty
+                SharedRef<StreamedTexture> request;
+            };
+
+            void StreamTexture(TextureSlot slot, TextureFlag usingMap, const std::string& filePath);
+            void StopStreaming(TextureSlot slot);
+            void UpdateStreamingTextures();
+
+            std::string GetTextureFilePath(TextureSlot slot) const;
+            MaterialProperties GetSavedProperties() const;
+
             PBRMataterialTextures m_PBRMaterialTextures;
             SharedRef<Shader> m_Shader;
             DescriptorSet* m_DescriptorSet;
@@ -235,6 +255,7 @@ namespace Lumos
             std::string m_Name;
             bool m_TexturesUpdated = false;
             uint32_t m_Flags;
+            std::vector<StreamingTexture> m_StreamingTextures;
 
             static SharedRef<Texture2D> s_DefaultTexture;
         };
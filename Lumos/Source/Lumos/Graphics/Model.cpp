@@ -3,6 +3,7 @@
 #include "Mesh.h"
 #include "Core/StringUtilities.h"
 #include "Core/VFS.h"
+#include "Core/Application.h"
 
 namespace Lumos::Graphics
 {
@@ -30,6 +31,31 @@ namespace Lumos::Graphics
     void Model::LoadModel(const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
+        m_StreamedModel = nullptr;
+
+        std::string physicalPath;
+        if(!Lumos::VFS::Get()->ResolvePhysicalPath(path, physicalPath))
+        {
+            LUMOS_LOG_INFO("Failed to load Model - {0}", path);
+            return;
+        }
+
+        if(LoadFromLibrary(physicalPath))
+            return;
+
+        auto file = ParseFile(physicalPath);
+        if(file)
+            CreateMeshes(*file, physicalPath);
+
+        LUMOS_LOG_INFO("Loaded Model - {0}", path);
+    }
+
+    void Model::StreamModel(const std::string& path)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        m_Meshes.clear();
+        m_StreamedModel = nullptr;
+
         std::string physicalPath;
         if(!Lumos::VFS::Get()->ResolvePhysicalPath(path, physicalPath))
         {
@@ -37,19 +63,97 @@ namespace Lumos::Graphics
             return;
         }
 
-        std::string resolvedPath = physicalPath;
+        if(LoadFromLibrary(physicalPath))
+            return;
+
+        m_StreamedModel = AssetStreamer::Get().LoadModel(physicalPath);
+    }
+
+    void Model::SetStreamingPosition(const Maths::Vector3& position)
+    {
+        if(m_StreamedModel)
+            m_StreamedModel->SetPosition(position);
+    }
+
+    void Model::UpdateStreaming()
+    {
+        if(!m_StreamedModel || !m_StreamedModel->IsFinished())
+            return;
+
+        m_Meshes = m_StreamedModel->GetMeshes();
+        m_StreamedModel = nullptr;
+    }
+
+    bool Model::LoadFromLibrary(const std::string& physicalPath)
+    {
+        // Models loaded from the same file hold the resident meshes, so the library only evicts them once no model
+        // uses them. The meshes' materials are shared too, editing one changes every model of the file
+        auto meshLibrary = Application::Get().GetMeshLibrary();
+        const uint32_t cachedMeshCount = meshLibrary->GetModelMeshCount(physicalPath);
+        for(uint32_t i = 0; i < cachedMeshCount; i++)
+        {
+            auto mesh = meshLibrary->FindResource(MeshLibrary::GetModelMeshID(physicalPath, i));
+            if(!mesh)
+                break;
+
+            m_Meshes.push_back(mesh);
+        }
+
+        if(cachedMeshCount > 0 && m_Meshes.size() == cachedMeshCount)
+            return true;
+
+        // Some of the meshes were evicted
+        m_Meshes.clear();
+        return false;
+    }
 
-        const std::string fileExtension = StringUtilities::GetFilePathExtension(path);
+    UniqueRef<ModelFile> Model::ParseFile(const std::string& physicalPath)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const std::string fileExtension = StringUtilities::GetFilePathExtension(physicalPath);
 
+        UniqueRef<ModelFile> file;
         if(fileExtension == "obj")
-            LoadOBJ(resolvedPath);
+            file = ParseOBJ(physicalPath);
         else if(fileExtension == "gltf" || fileExtension == "glb")
-            LoadGLTF(resolvedPath);
+            file = ParseGLTF(physicalPath);
         else if(fileExtension == "fbx" || fileExtension == "FBX")
-            LoadFBX(resolvedPath);
+            file = ParseFBX(physicalPath);
         else
             LUMOS_LOG_ERROR("Unsupported File Type : {0}", fileExtension);
 
-        LUMOS_LOG_INFO("Loaded Model - {0}", path);
+        if(file.get() != nullptr)
+            file->FilePath = physicalPath;
+
+        return file;
+    }
+
+    void Model::CreateMeshes(ModelFile& file, const std::string& physicalPath)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const std::string fileExtension = StringUtilities::GetFilePathExtension(physicalPath);
+
+        if(fileExtension == "obj")
+            LoadOBJ(file);
+        else if(fileExtension == "gltf" || fileExtension == "glb")
+            LoadGLTF(file);
+        else
+            LoadFBX(file);
+
+        auto meshLibrary = Application::Get().GetMeshLibrary();
+        meshLibrary->SetModelMeshCount(physicalPath, static_cast<uint32_t>(m_Meshes.size()));
+
+        for(uint32_t i = 0; i < m_Meshes.size(); i++)
+            meshLibrary->AddResource(MeshLibrary::GetModelMeshID(physicalPath, i), m_Meshes[i]);
+    }
+
+    SharedRef<Material> Model::FindFileMaterial(const ModelFile& file, uint32_t index)
+    {
+        return Application::Get().GetMaterialLibrary()->FindResource(MaterialLibrary::GetModelMaterialID(file.FilePath, index));
+    }
+
+    SharedRef<Material> Model::AddFileMaterial(const ModelFile& file, uint32_t index, const SharedRef<Material>& material)
+    {
+        return Application::Get().GetMaterialLibrary()->AddResource(MaterialLibrary::GetModelMaterialID(file.FilePath, index), material);
     }
 }
@@ -4,12 +4,38 @@
 #include "Mesh.h"
 #include "Material.h"
 #include "Core/VFS.h"
+#include "Utilities/AssetStreamer.h"
 #include <cereal/cereal.hpp>
 
 namespace Lumos
 {
     namespace Graphics
     {
+        // A model file parsed by one of the loaders. Parsing creates no GPU resources,
+        // so the AssetStreamer runs it on a worker thread
+        class ModelFile
+        {
+        public:
+            // A texture file its materials load through the TextureLibrary
+            struct TextureFile
+            {
+                std::string FilePath;
+                TextureParameters Parameters;
+                TextureLoadOptions LoadOptions;
+            };
+
+            virtual ~ModelFile() = default;
+
+            // Bytes of vertex and index data its meshes will upload
+            virtual uint64_t GetSize() const = 0;
+
+            // Collected while parsing so the AssetStreamer can decode them on the same worker.
+            // Empty for formats whose images are decoded with the file
+            std::vector<TextureFile> Textures;
+
+            std::string FilePath; // Physical path it was parsed from
+        };
+
         class Model
         {
         public:
@@ -20,6 +46,7 @@ namespace Lumos
 
             ~Model() = default;
 
+            // Meshes loaded from a file, and their materials, are shared with every model of that file
             std::vector<SharedRef<Mesh>>& GetMeshes() { return m_Meshes; }
             const std::vector<SharedRef<Mesh>>& GetMeshes() const { return m_Meshes; }
             void AddMesh(SharedRef<Mesh> mesh) { m_Meshes.push_back(mesh); }
@@ -27,12 +54,13 @@ namespace Lumos
             template <typename Archive>
             void save(Archive& archive) const
             {
-                if(m_Meshes.size() > 0)
+                // A model still streaming in has no meshes yet, its file path is saved all the same
+                if(m_Meshes.size() > 0 || IsStreaming())
                 {
                     std::string newPath;
                     VFS::Get()->AbsoulePathToVFS(m_FilePath, newPath);
 
-                    auto material = std::unique_ptr<Material>(m_Meshes.front()->GetMaterial().get());
+                    auto material = std::unique_ptr<Material>(m_Meshes.empty() ? nullptr : m_Meshes.front()->GetMaterial().get());
                     archive(cereal::make_nvp("PrimitiveType", m_PrimitiveType), cereal::make_nvp("FilePath", newPath), cereal::make_nvp("Material", material));
                     material.release();
                 }
@@ -46,6 +74,7 @@ namespace Lumos
                 archive(cereal::make_nvp("PrimitiveType", m_PrimitiveType), cereal::make_nvp("FilePath", m_FilePath), cereal::make_nvp("Material", material));
 
                 m_Meshes.clear();
+                m_StreamedModel = nullptr;
 
                 if(m_PrimitiveType != PrimitiveType::File)
                 {
@@ -55,7 +84,7 @@ namespace Lumos
                 }
                 else
                 {
-                    LoadModel(m_FilePath);
+                    StreamModel(m_FilePath);
                 }
             }
 
@@ -63,17 +92,45 @@ namespace Lumos
             PrimitiveType GetPrimitiveType() { return m_PrimitiveType; }
             void SetPrimitiveType(PrimitiveType type) { m_PrimitiveType = type; }
 
+            // Streamed models have no meshes until the AssetStreamer has loaded the file
+            bool IsStreaming() const { return m_StreamedModel != nullptr; }
+            void SetStreamingPosition(const Maths::Vector3& position);
+            void UpdateStreaming();
+
         private:
             PrimitiveType m_PrimitiveType;
             std::vector<SharedRef<Mesh>> m_Meshes;
             std::string m_FilePath;
+            SharedRef<StreamedModel> m_StreamedModel;
+
+            bool LoadFromLibrary(const std::string& physicalPath);
 
-            void LoadOBJ(const std::string& path);
-            void LoadGLTF(const std::string& path);
-            void LoadFBX(const std::string& path);
+            static UniqueRef<ModelFile> ParseOBJ(const std::string& path);
+            static UniqueRef<ModelFile> ParseGLTF(const std::string& path);
+            static UniqueRef<ModelFile> ParseFBX(const std::string& path);
+
+            void LoadOBJ(ModelFile& file);
+            void LoadGLTF(ModelFile& file);
+            void LoadFBX(ModelFile& file);
 
         public:
             void LoadModel(const std::string& path);
+
+            // Loads the file through the AssetStreamer, the meshes are added by UpdateStreaming once it is ready
+            void StreamModel(const std::string& path);
+
+            // Parses a model file on the calling thread without touching the GPU
+            static UniqueRef<ModelFile> ParseFile(const std::string& physicalPath);
+
+            // Creates the meshes of a parsed file and shares them through the mesh and material libraries
+            void CreateMeshes(ModelFile& file, const std::string& physicalPath);
+
+            // The loaders look up each of the file's materials, by the file's own material index, before creating it.
+            // A model loading the file again while its materials are resident shares them instead of making copies
+            static SharedRef<Material> FindFileMaterial(const ModelFile& file, uint32_t index);
+
+            // Returns the resident material if another load of the file registered one first
+            static SharedRef<Material> AddFileMaterial(const ModelFile& file, uint32_t index, const SharedRef<Material>& material);
         };
     }
 }
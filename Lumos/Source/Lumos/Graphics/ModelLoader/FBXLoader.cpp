@@ -138,48 +138,52 @@ namespace Lumos::Graphics
         return Maths::Quaternion(float(quat.x), float(quat.y), float(quat.z), float(quat.w));
     }
 
-    Graphics::Texture2D* LoadTexture(const ofbx::Material* material, ofbx::Texture::TextureType type)
+    // Empty if the texture file can't be found next to the model
+    std::string FindTexturePath(const ofbx::Material* material, ofbx::Texture::TextureType type, const std::string& directory)
     {
         const ofbx::Texture* ofbxTexture = material->getTexture(type);
-        Graphics::Texture2D* texture2D = nullptr;
-        if(ofbxTexture)
-        {
-            std::string stringFilepath;
-            ofbx::DataView filename = ofbxTexture->getRelativeFileName();
-            if(filename == "")
-                filename = ofbxTexture->getFileName();
+        if(!ofbxTexture)
+            return "";
 
-            char filePath[MAX_PATH_LENGTH];
-            filename.toString(filePath);
+        std::string stringFilepath;
+        ofbx::DataView filename = ofbxTexture->getRelativeFileName();
+        if(filename == "")
+            filename = ofbxTexture->getFileName();
 
-            stringFilepath = std::string(filePath);
-            stringFilepath = m_FBXModelDirectory + "/" + StringUtilities::BackSlashesToSlashes(stringFilepath);
+        char filePath[MAX_PATH_LENGTH];
+        filename.toString(filePath);
 
-            bool fileFound = false;
+        stringFilepath = std::string(filePath);
+        stringFilepath = directory + "/" + StringUtilities::BackSlashesToSlashes(stringFilepath);
 
-            fileFound = FileSystem::FileExists(stringFilepath);
+        bool fileFound = false;
 
-            if(!fileFound)
-            {
-                stringFilepath = StringUtilities::GetFileName(stringFilepath);
-                stringFilepath = m_FBXModelDirectory + "/" + stringFilepath;
-                fileFound = FileSystem::FileExists(stringFilepath);
-            }
+        fileFound = FileSystem::FileExists(stringFilepath);
 
-            if(!fileFound)
-            {
-                stringFilepath = StringUtilities::GetFileName(stringFilepath);
-                stringFilepath = m_FBXModelDirectory + "/textures/" + stringFilepath;
-                fileFound = FileSystem::FileExists(stringFilepath);
-            }
+        if(!fileFound)
+        {
+            stringFilepath = StringUtilities::GetFileName(stringFilepath);
+            stringFilepath = directory + "/" + stringFilepath;
+            fileFound = FileSystem::FileExists(stringFilepath);
+        }
 
-            if(fileFound)
-            {
-                texture2D = Graphics::Texture2D::CreateFromFile(stringFilepath, stringFilepath);
-            }
+        if(!fileFound)
+        {
+            stringFilepath = StringUtilities::GetFileName(stringFilepath);
+            stringFilepath = directory + "/textures/" + stringFilepath;
+            fileFound = FileSystem::FileExists(stringFilepath);
         }
 
-        return texture2D;
+        return fileFound ? stringFilepath : "";
+    }
+
+    SharedRef<Graphics::Texture2D> LoadTexture(const ofbx::Material* material, ofbx::Texture::TextureType type)
+    {
+        std::string filePath = FindTexturePath(material, type, m_FBXModelDirectory);
+        if(filePath.empty())
+            return nullptr;
+
+        return Application::Get().GetTextureLibrary()->GetResource(filePath);
     }
 
     SharedRef<Material> LoadMaterial(const ofbx::Material* material, bool animated)
@@ -251,37 +255,91 @@ namespace Lumos::Graphics
         return transform;
     }
 
-    void Model::LoadFBX(const std::string& path)
+    struct FBXFile : public ModelFile
+    {
+        ofbx::IScene* Scene = nullptr;
+        std::string Directory;
+
+        ~FBXFile()
+        {
+            if(Scene)
+                Scene->destroy();
+        }
+
+        uint64_t GetSize() const override
+        {
+            uint64_t size = 0;
+            for(int i = 0; i < Scene->getMeshCount(); i++)
+            {
+                auto geom = Scene->getMesh(i)->getGeometry();
+                size += uint64_t(geom->getVertexCount()) * sizeof(Graphics::Vertex) + uint64_t(geom->getIndexCount()) * sizeof(uint32_t);
+            }
+            return size;
+        }
+    };
+
+    UniqueRef<ModelFile> Model::ParseFBX(const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
-        std::string err;
+        auto file = CreateUniqueRef<FBXFile>();
+
         std::string pathCopy = path;
         pathCopy = StringUtilities::BackSlashesToSlashes(pathCopy);
-        m_FBXModelDirectory = pathCopy.substr(0, pathCopy.find_last_of('/'));
-
-        std::string name = m_FBXModelDirectory.substr(m_FBXModelDirectory.find_last_of('/') + 1);
+        file->Directory = pathCopy.substr(0, pathCopy.find_last_of('/'));
 
-        std::string ext = StringUtilities::GetFilePathExtension(path);
         int64_t size = FileSystem::GetFileSize(path);
         auto data = FileSystem::ReadFile(path);
 
         if(data == nullptr)
         {
             LUMOS_LOG_WARN("Failed to load fbx file");
-            return;
+            return nullptr;
         }
         const bool ignoreGeometry = false;
         const uint64_t flags = ignoreGeometry ? (uint64_t)ofbx::LoadFlags::IGNORE_GEOMETRY : (uint64_t)ofbx::LoadFlags::TRIANGULATE;
 
-        ofbx::IScene* scene = ofbx::load(data, uint32_t(size), flags);
+        // The scene keeps its own copy of the file
+        file->Scene = ofbx::load(data, uint32_t(size), flags);
+        delete[] data;
 
-        err = ofbx::getError();
+        std::string err = ofbx::getError();
 
-        if(!err.empty() || !scene)
+        if(!err.empty() || !file->Scene)
         {
             LUMOS_LOG_CRITICAL(err);
         }
 
+        if(!file->Scene)
+            return nullptr;
+
+        // The same maps LoadMaterial fetches from the TextureLibrary
+        const ofbx::Texture::TextureType textureTypes[] = { ofbx::Texture::TextureType::DIFFUSE, ofbx::Texture::TextureType::NORMAL, ofbx::Texture::TextureType::SPECULAR,
+            ofbx::Texture::TextureType::SHININESS, ofbx::Texture::TextureType::EMISSIVE, ofbx::Texture::TextureType::AMBIENT };
+
+        for(int i = 0; i < file->Scene->getMeshCount(); i++)
+        {
+            const ofbx::Mesh* fbx_mesh = file->Scene->getMesh(i);
+            if(fbx_mesh->getMaterialCount() == 0)
+                continue;
+
+            for(auto type : textureTypes)
+            {
+                std::string texturePath = FindTexturePath(fbx_mesh->getMaterial(0), type, file->Directory);
+                if(!texturePath.empty())
+                    file->Textures.push_back({ texturePath, TextureParameters(), TextureLoadOptions() });
+            }
+        }
+
+        return UniqueRef<ModelFile>(file.release());
+    }
+
+    void Model::LoadFBX(ModelFile& file)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        auto& fbxFile = static_cast<FBXFile&>(file);
+        const ofbx::IScene* scene = fbxFile.Scene;
+        m_FBXModelDirectory = fbxFile.Directory;
+
         const ofbx::GlobalSettings* settings = scene->getGlobalSettings();
         switch(settings->UpAxis)
         {
@@ -374,7 +432,10 @@ namespace Lumos::Graphics
                 SharedRef<Material> pbrMaterial;
                 if(material)
                 {
-                    pbrMaterial = LoadMaterial(material, false);
+                    // Keyed by the mesh, each mesh loads its own material
+                    pbrMaterial = FindFileMaterial(fbxFile, i);
+                    if(!pbrMaterial)
+                        pbrMaterial = AddFileMaterial(fbxFile, i, LoadMaterial(material, false));
                 }
 
                 auto mesh = CreateSharedRef<Graphics::Mesh>(vb, ib, boundingBox);
@@ -96,7 +96,7 @@ namespace Lumos::Graphics
         }
     }
 
-    std::vector<SharedRef<Material>> LoadMaterials(tinygltf::Model& gltfModel)
+    std::vector<SharedRef<Material>> LoadMaterials(const ModelFile& file, tinygltf::Model& gltfModel, const std::string& directory)
     {
         LUMOS_PROFILE_FUNCTION();
         std::vector<SharedRef<Graphics::Texture2D>> loadedTextures;
@@ -104,6 +104,21 @@ namespace Lumos::Graphics
         loadedTextures.reserve(gltfModel.textures.size());
         loadedMaterials.reserve(gltfModel.materials.size());
 
+        // Every material is still resident from another load of the file, so its textures aren't needed either
+        for(uint32_t i = 0; i < static_cast<uint32_t>(gltfModel.materials.size()); i++)
+        {
+            auto resident = Model::FindFileMaterial(file, i);
+            if(!resident)
+                break;
+
+            loadedMaterials.push_back(resident);
+        }
+
+        if(loadedMaterials.size() == gltfModel.materials.size())
+            return loadedMaterials;
+
+        loadedMaterials.clear();
+
         for(tinygltf::Texture& gltfTexture : gltfModel.textures)
         {
             GLTFTexture imageAndSampler {};
@@ -124,8 +139,21 @@ namespace Lumos::Graphics
                 if(gltfTexture.sampler != -1)
                     params = Graphics::TextureParameters(GetFilter(imageAndSampler.Sampler->minFilter), GetFilter(imageAndSampler.Sampler->magFilter), GetWrapMode(imageAndSampler.Sampler->wrapS));
 
-                Graphics::Texture2D* texture2D = Graphics::Texture2D::CreateFromSource(imageAndSampler.Image->width, imageAndSampler.Image->height, imageAndSampler.Image->image.data(), params);
-                loadedTextures.push_back(SharedRef<Graphics::Texture2D>(texture2D ? texture2D : nullptr));
+                tinygltf::Image* image = imageAndSampler.Image;
+                auto CreateTexture = [image, &params](const std::string& filePath, SharedRef<Graphics::Texture2D>& texture)
+                {
+                    texture = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromSource(image->width, image->height, image->image.data(), params));
+                    return texture != nullptr;
+                };
+
+                // Images stored in their own files are shared with other models, embedded ones belong to this model
+                SharedRef<Graphics::Texture2D> texture2D;
+                if(!image->uri.empty() && image->uri.find("data:") != 0)
+                    texture2D = Application::Get().GetTextureLibrary()->GetResource(directory + "/" + image->uri, CreateTexture);
+                else
+                    CreateTexture(image->uri, texture2D);
+
+                loadedTextures.push_back(texture2D);
             }
         }
 
@@ -144,6 +172,14 @@ namespace Lumos::Graphics
 
         for(tinygltf::Material& mat : gltfModel.materials)
         {
+            const uint32_t materialIndex = static_cast<uint32_t>(loadedMaterials.size());
+            auto resident = Model::FindFileMaterial(file, materialIndex);
+            if(resident)
+            {
+                loadedMaterials.push_back(resident);
+                continue;
+            }
+
             //TODO : if(isAnimated) Load deferredColourAnimated;
             auto shader = Application::Get().GetShaderLibrary()->GetResource("//CoreShaders/DeferredColour.shader");
 
@@ -229,7 +265,7 @@ namespace Lumos::Graphics
             if(mat.doubleSided)
                 pbrMaterial->SetFlag(Graphics::Material::RenderFlags::TWOSIDED);
 
-            loadedMaterials.push_back(pbrMaterial);
+            loadedMaterials.push_back(Model::AddFileMaterial(file, materialIndex, pbrMaterial));
         }
 
         return loadedMaterials;
@@ -448,11 +484,28 @@ namespace Lumos::Graphics
         }
     }
 
-    void Model::LoadGLTF(const std::string& path)
+    struct GLTFFile : public ModelFile
+    {
+        tinygltf::Model Data;
+        std::string Path;
+
+        uint64_t GetSize() const override
+        {
+            uint64_t size = 0;
+            for(auto& buffer : Data.buffers)
+                size += buffer.data.size();
+            for(auto& image : Data.images)
+                size += image.image.size();
+            return size;
+        }
+    };
+
+    UniqueRef<ModelFile> Model::ParseGLTF(const std::string& path)
     {
         LUMOS_PROFILE_FUNCTION();
-        tinygltf::Model model;
-        tinygltf::TinyGLTF loader;
+        auto file = CreateUniqueRef<GLTFFile>();
+        file->Path = path;
+
         std::string err;
         std::string warn;
 
@@ -466,12 +519,12 @@ namespace Lumos::Graphics
         if(ext == "glb") // assume binary glTF.
         {
             LUMOS_PROFILE_SCOPE(".glb binary loading");
-            ret = tinygltf::TinyGLTF().LoadBinaryFromFile(&model, &err, &warn, path);
+            ret = tinygltf::TinyGLTF().LoadBinaryFromFile(&file->Data, &err, &warn, path);
         }
         else // assume ascii glTF.
         {
             LUMOS_PROFILE_SCOPE(".gltf loading");
-            ret = tinygltf::TinyGLTF().LoadASCIIFromFile(&model, &err, &warn, path);
+            ret = tinygltf::TinyGLTF().LoadASCIIFromFile(&file->Data, &err, &warn, path);
         }
 
         if(!err.empty())
@@ -487,20 +540,28 @@ namespace Lumos::Graphics
         if(!ret)
         {
             LUMOS_LOG_ERROR("Failed to parse glTF");
+            return nullptr;
         }
-        {
-            LUMOS_PROFILE_SCOPE("Parse GLTF Model");
 
-            auto LoadedMaterials = LoadMaterials(model);
+        return UniqueRef<ModelFile>(file.release());
+    }
 
-            std::string name = path.substr(path.find_last_of('/') + 1);
+    void Model::LoadGLTF(ModelFile& file)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        auto& gltfFile = static_cast<GLTFFile&>(file);
+        tinygltf::Model& model = gltfFile.Data;
+        const std::string& path = gltfFile.Path;
 
-            auto meshes = std::vector<std::vector<Graphics::Mesh*>>();
-            const tinygltf::Scene& gltfScene = model.scenes[Lumos::Maths::Max(0, model.defaultScene)];
-            for(size_t i = 0; i < gltfScene.nodes.size(); i++)
-            {
-                LoadNode(this, gltfScene.nodes[i], Maths::Matrix4(), model, LoadedMaterials, meshes);
-            }
+        auto LoadedMaterials = LoadMaterials(file, model, path.substr(0, path.find_last_of('/')));
+
+        std::string name = path.substr(path.find_last_of('/') + 1);
+
+        auto meshes = std::vector<std::vector<Graphics::Mesh*>>();
+        const tinygltf::Scene& gltfScene = model.scenes[Lumos::Maths::Max(0, model.defaultScene)];
+        for(size_t i = 0; i < gltfScene.nodes.size(); i++)
+        {
+            LoadNode(this, gltfScene.nodes[i], Maths::Matrix4(), model, LoadedMaterials, meshes);
         }
     }
 }
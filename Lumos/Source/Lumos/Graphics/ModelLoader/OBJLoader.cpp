@@ -14,49 +14,77 @@
 namespace Lumos
 {
     std::string m_Directory;
-    std::vector<SharedRef<Graphics::Texture2D>> m_Textures;
 
-    SharedRef<Graphics::Texture2D> LoadMaterialTextures(const std::string& typeName, std::vector<SharedRef<Graphics::Texture2D>>& textures_loaded, const std::string& name, const std::string& directory, Graphics::TextureParameters format)
+    SharedRef<Graphics::Texture2D> LoadMaterialTextures(const std::string& name, const std::string& directory, Graphics::TextureParameters format)
     {
-        for(uint32_t j = 0; j < textures_loaded.size(); j++)
-        {
-            if(std::strcmp(textures_loaded[j]->GetFilepath().c_str(), (directory + "/" + name).c_str()) == 0)
-            {
-                return textures_loaded[j];
-            }
-        }
+        Graphics::TextureLoadOptions options(false, true);
+        return Application::Get().GetTextureLibrary()->GetTexture(directory + "/" + name, format, options);
+    }
 
-        { // If texture hasn't been loaded already, load it
-            Graphics::TextureLoadOptions options(false, true);
-            auto texture = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(typeName, directory + "/" + name, format, options));
-            textures_loaded.push_back(texture); // Store it as texture loaded for entire model, to ensure we won't unnecessary load duplicate textures.
+    void AddTextureFile(Graphics::ModelFile& file, const std::string& name, const std::string& directory, const tinyobj::texture_option_t& option)
+    {
+        if(name.empty())
+            return;
 
-            return texture;
-        }
+        Graphics::TextureParameters format(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, option.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT);
+        file.Textures.push_back({ directory + "/" + name, format, Graphics::TextureLoadOptions(false, true) });
     }
 
-    void Graphics::Model::LoadOBJ(const std::string& path)
+    struct OBJFile : public Graphics::ModelFile
     {
-        LUMOS_PROFILE_FUNCTION();
-        std::string resolvedPath = path;
-        tinyobj::attrib_t attrib;
-        std::string error;
+        tinyobj::attrib_t Attrib;
+        std::vector<tinyobj::shape_t> Shapes;
+        std::vector<tinyobj::material_t> Materials;
+        std::string Directory;
 
-        std::vector<tinyobj::shape_t> shapes;
-        std::vector<tinyobj::material_t> materials;
-
-        m_Directory = resolvedPath.substr(0, resolvedPath.find_last_of('/'));
+        uint64_t GetSize() const override
+        {
+            uint64_t size = 0;
+            for(auto& shape : Shapes)
+                size += shape.mesh.indices.size() * (sizeof(Graphics::Vertex) + sizeof(uint32_t));
+            return size;
+        }
+    };
 
-        std::string name = m_Directory.substr(m_Directory.find_last_of('/') + 1);
+    UniqueRef<Graphics::ModelFile> Graphics::Model::ParseOBJ(const std::string& path)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        auto file = CreateUniqueRef<OBJFile>();
+        file->Directory = path.substr(0, path.find_last_of('/'));
 
+        std::string error;
         bool ok = tinyobj::LoadObj(
-            &attrib, &shapes, &materials, &error, (resolvedPath).c_str(), (m_Directory + "/").c_str());
+            &file->Attrib, &file->Shapes, &file->Materials, &error, path.c_str(), (file->Directory + "/").c_str());
 
         if(!ok)
         {
             LUMOS_LOG_CRITICAL(error);
+            return nullptr;
+        }
+
+        // The same maps LoadOBJ fetches from the TextureLibrary
+        for(auto& material : file->Materials)
+        {
+            AddTextureFile(*file, material.diffuse_texname, file->Directory, material.diffuse_texopt);
+            AddTextureFile(*file, material.bump_texname, file->Directory, material.bump_texopt);
+            AddTextureFile(*file, material.roughness_texname, file->Directory, material.roughness_texopt);
+            AddTextureFile(*file, material.metallic_texname, file->Directory, material.metallic_texopt);
+            AddTextureFile(*file, material.specular_highlight_texname, file->Directory, material.specular_texopt);
         }
 
+        return UniqueRef<ModelFile>(file.release());
+    }
+
+    void Graphics::Model::LoadOBJ(ModelFile& file)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        auto& objFile = static_cast<OBJFile&>(file);
+        const tinyobj::attrib_t& attrib = objFile.Attrib;
+        const std::vector<tinyobj::shape_t>& shapes = objFile.Shapes;
+        std::vector<tinyobj::material_t>& materials = objFile.Materials;
+
+        m_Directory = objFile.Directory;
+
         bool singleMesh = shapes.size() == 1;
 
         for(const auto& shape : shapes)
@@ -127,55 +155,65 @@ namespace Lumos
 
             Graphics::Mesh::GenerateTangents(vertices, vertexCount, indices, numIndices);
 
-            //TODO : if(isAnimated) Load deferredColourAnimated;
-            auto shader = Application::Get().GetShaderLibrary()->GetResource("//CoreShaders/DeferredColour.shader");
-
-            SharedRef<Material> pbrMaterial = CreateSharedRef<Material>(shader);
+            // Shapes using the same file material share it, as do models of the same file while it is resident
+            const int materialIndex = shape.mesh.material_ids[0];
+            SharedRef<Material> pbrMaterial = materialIndex >= 0 ? FindFileMaterial(objFile, materialIndex) : nullptr;
 
-            PBRMataterialTextures textures;
-
-            if(shape.mesh.material_ids[0] >= 0)
+            if(!pbrMaterial)
             {
-                tinyobj::material_t* mp = &materials[shape.mesh.material_ids[0]];
+                //TODO : if(isAnimated) Load deferredColourAnimated;
+                auto shader = Application::Get().GetShaderLibrary()->GetResource("//CoreShaders/DeferredColour.shader");
 
-                if(mp->diffuse_texname.length() > 0)
-                {
-                    SharedRef<Graphics::Texture2D> texture = LoadMaterialTextures("Albedo", m_Textures, mp->diffuse_texname, m_Directory, Graphics::TextureParameters(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->diffuse_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
-                    if(texture)
-                        textures.albedo = texture;
-                }
+                pbrMaterial = CreateSharedRef<Material>(shader);
 
-                if(mp->bump_texname.length() > 0)
-                {
-                    SharedRef<Graphics::Texture2D> texture = LoadMaterialTextures("Normal", m_Textures, mp->bump_texname, m_Directory, Graphics::TextureParameters(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->bump_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
-                    if(texture)
-                        textures.normal = texture; //pbrMaterial->SetNormalMap(texture);
-                }
+                PBRMataterialTextures textures;
 
-                if(mp->roughness_texname.length() > 0)
+                if(materialIndex >= 0)
                 {
-                    SharedRef<Graphics::Texture2D> texture = LoadMaterialTextures("Roughness", m_Textures, mp->roughness_texname.c_str(), m_Directory, Graphics::TextureParameters(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->roughness_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
-                    if(texture)
-                        textures.roughness = texture;
+                    tinyobj::material_t* mp = &materials[materialIndex];
+
+                    if(mp->diffuse_texname.length() > 0)
+                    {
+                        SharedRef<Graphics::Texture2D> texture = LoadMaterialTextures(mp->diffuse_texname, m_Directory, Graphics::TextureParameters(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->diffuse_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
+                        if(texture)
+                            textures.albedo = texture;
+                    }
+
+                    if(mp->bump_texname.length() > 0)
+                    {
+                        SharedRef<Graphics::Texture2D> texture = LoadMaterialTextures(mp->bump_texname, m_Directory, Graphics::TextureParameters(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->bump_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
+                        if(texture)
+                            textures.normal = texture; //pbrMaterial->SetNormalMap(texture);
+                    }
+
+                    if(mp->roughness_texname.length() > 0)
+                    {
+                        SharedRef<Graphics::Texture2D> texture = LoadMaterialTextures(mp->roughness_texname.c_str(), m_Directory, Graphics::TextureParameters(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->roughness_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
+                        if(texture)
+                            textures.roughness = texture;
+                    }
+
+                    if(mp->metallic_texname.length() > 0)
+                    {
+                        SharedRef<Graphics::Texture2D> texture = LoadMaterialTextures(mp->metallic_texname, m_Directory, Graphics::TextureParameters(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->metallic_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
+                        if(texture)
+                            textures.metallic = texture;
+                    }
+
+                    if(mp->specular_highlight_texname.length() > 0)
+                    {
+                        SharedRef<Graphics::Texture2D> texture = LoadMaterialTextures(mp->specular_highlight_texname, m_Directory, Graphics::TextureParameters(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->specular_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
+                        if(texture)
+                            textures.metallic = texture;
+                    }
                 }
 
-                if(mp->metallic_texname.length() > 0)
-                {
-                    SharedRef<Graphics::Texture2D> texture = LoadMaterialTextures("Metallic", m_Textures, mp->metallic_texname, m_Directory, Graphics::TextureParameters(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->metallic_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
-                    if(texture)
-                        textures.metallic = texture;
-                }
+                pbrMaterial->SetTextures(textures);
 
-                if(mp->specular_highlight_texname.length() > 0)
-                {
-                    SharedRef<Graphics::Texture2D> texture = LoadMaterialTextures("Metallic", m_Textures, mp->specular_highlight_texname, m_Directory, Graphics::TextureParameters(Graphics::TextureFilter::NEAREST, Graphics::TextureFilter::NEAREST, mp->specular_texopt.clamp ? Graphics::TextureWrap::CLAMP_TO_EDGE : Graphics::TextureWrap::REPEAT));
-                    if(texture)
-                        textures.metallic = texture;
-                }
+                if(materialIndex >= 0)
+                    pbrMaterial = AddFileMaterial(objFile, materialIndex, pbrMaterial);
             }
 
-            pbrMaterial->SetTextures(textures);
-
             SharedRef<VertexBuffer> vb = SharedRef<VertexBuffer>(VertexBuffer::Create(BufferUsage::STATIC));
             vb->SetData(sizeof(Graphics::Vertex) * numVertices, vertices);
 
@@ -186,8 +224,6 @@ namespace Lumos
             mesh->SetMaterial(pbrMaterial);
             m_Meshes.push_back(mesh);
 
-            m_Textures.clear();
-
             delete[] vertices;
             delete[] indices;
         }
@@ -24,6 +24,10 @@ namespace Lumos
             static CommandBuffer* Create();
 
             virtual bool Init(bool primary) = 0;
+
+            // Allocates from a command pool owned by this buffer, so it can be recorded on a worker thread
+            // while other buffers are recorded elsewhere
+            virtual bool InitWithOwnPool(bool primary) { return Init(primary); }
             virtual void Unload() = 0;
             virtual void BeginRecording() = 0;
             virtual void BeginRecordingSecondary(RenderPass* renderPass, Framebuffer* framebuffer) = 0;
@@ -20,6 +20,15 @@ namespace Lumos
             RENDERER_BUFFER_STENCIL = BIT(2)
         };
 
+        // How a pass accesses a resource, barriers wait for the earlier usage before the later one starts
+        enum ResourceUsage
+        {
+            RESOURCE_USAGE_NONE = 0,
+            RESOURCE_USAGE_COLOUR_ATTACHMENT = BIT(0),
+            RESOURCE_USAGE_DEPTH_ATTACHMENT = BIT(1),
+            RESOURCE_USAGE_SHADER_READ = BIT(2)
+        };
+
         enum class DrawType
         {
             POINT,
@@ -83,6 +92,9 @@ namespace Lumos
             float MaxAnisotropy = 0.0f;
             int MaxTextureUnits = 0;
             int UniformBufferOffsetAlignment = 0;
+
+            // Samplers a shader can index non-uniformly from one array, zero without descriptor indexing
+            uint32_t MaxBindlessTextures = 0;
         };
 
         class LUMOS_EXPORT Renderer
@@ -108,9 +120,13 @@ namespace Lumos
 
             virtual const std::string& GetTitleInternal() const = 0;
             virtual void DrawIndexedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start) const = 0;
+            virtual void DrawIndexedInstancedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start) const = 0;
             virtual void DrawInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, DataType datayType, void* indices) const = 0;
             virtual Graphics::Swapchain* GetSwapchainInternal() const = 0;
 
+            // Recorded outside of render passes. Drivers that track hazards themselves don't need one
+            virtual void ResourceBarrierInternal(CommandBuffer* commandBuffer, uint32_t srcUsage, uint32_t dstUsage) { }
+
             inline static void Present()
             {
                 s_Instance->PresentInternal();
@@ -131,6 +147,16 @@ namespace Lumos
             {
                 s_Instance->DrawIndexedInternal(commandBuffer, type, count, start);
             }
+            // Instances are numbered from 0 in gl_InstanceIndex
+            inline static void DrawIndexedInstanced(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start = 0)
+            {
+                s_Instance->DrawIndexedInstancedInternal(commandBuffer, type, count, instanceCount, start);
+            }
+            // srcUsage and dstUsage are ResourceUsage flags
+            inline static void ResourceBarrier(CommandBuffer* commandBuffer, uint32_t srcUsage, uint32_t dstUsage)
+            {
+                s_Instance->ResourceBarrierInternal(commandBuffer, srcUsage, dstUsage);
+            }
             inline static const std::string& GetTitle()
             {
                 return s_Instance->GetTitleInternal();
@@ -22,6 +22,9 @@ namespace Lumos
 
         struct PushConstant
         {
+            // Smallest maxPushConstantsSize a Vulkan device may report
+            static const uint32_t MaxSize = 128;
+
             uint32_t size;
             ShaderType shaderStage;
             uint8_t* data;
@@ -46,6 +49,16 @@ namespace Lumos
             {
                 memcpy(data, value, size);
             }
+
+            const BufferMemberInfo* GetMember(const std::string& name) const
+            {
+                for(auto& member : m_Members)
+                {
+                    if(member.name == name)
+                        return &member;
+                }
+                return nullptr;
+            }
         };
 
         struct ShaderEnumClassHash
@@ -87,6 +100,9 @@ namespace Lumos
             virtual std::vector<PushConstant>& GetPushConstants() = 0;
             virtual PushConstant* GetPushConstant(uint32_t index) { return nullptr; }
             virtual void BindPushConstants(Graphics::CommandBuffer* cmdBuffer, Graphics::Pipeline* pipeline) = 0;
+
+            // Binds push constant block index from data instead of the block's own storage, for draws recorded on worker threads
+            virtual void BindPushConstant(Graphics::CommandBuffer* cmdBuffer, Graphics::Pipeline* pipeline, uint32_t index, const uint8_t* data) = 0;
             virtual DescriptorSet* CreateDescriptorSet(uint32_t index) { return nullptr; };
             virtual DescriptorSetInfo GetDescriptorInfo(uint32_t index) { return DescriptorSetInfo(); }
 
@@ -35,6 +35,10 @@ namespace Lumos
                 return 3;
             case TextureFormat::RGBA8:
                 return 4;
+            case TextureFormat::RGBA16:
+                return 8;
+            case TextureFormat::RGBA32:
+                return 16;
             default:
                 return 0;
             }
@@ -56,6 +60,8 @@ namespace Lumos
                 return TextureFormat::RGB16;
             case 64:
                 return TextureFormat::RGBA16;
+            case 128:
+                return TextureFormat::RGBA32;
             default:
                 LUMOS_ASSERT(false, "[Texture] Unsupported image bit-depth! ({0})", bits);
                 return TextureFormat::RGB8;
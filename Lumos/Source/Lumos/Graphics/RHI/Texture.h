@@ -142,6 +142,7 @@ namespace Lumos
             virtual void Unbind(uint32_t slot = 0) const = 0;
 
             virtual void SetName(const std::string& name) {};
+            virtual void SetFilepath(const std::string& filePath) {};
             virtual const std::string& GetName() const = 0;
             virtual const std::string& GetFilepath() const = 0;
 
@@ -181,8 +182,12 @@ namespace Lumos
         public:
             virtual void SetData(const void* pixels) = 0;
 
+            // Rewrites the width x height region at x, y. Rows of pixels are rowLength texels apart
+            virtual void SetData(const void* pixels, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t rowLength) = 0;
+
             virtual uint32_t GetWidth() const = 0;
             virtual uint32_t GetHeight() const = 0;
+            virtual TextureFormat GetFormat() const = 0;
 
         public:
             static Texture2D* Create();
@@ -13,7 +13,9 @@ namespace Lumos
 
             virtual void Init(uint32_t size, const void* data) = 0;
             virtual void SetData(uint32_t size, const void* data) = 0;
-            virtual void SetDynamicData(uint32_t size, uint32_t typeSize, const void* data) = 0;
+
+            // Writes size bytes at offset. typeSize is the range bound at each dynamic offset
+            virtual void SetDynamicData(uint32_t size, uint32_t typeSize, const void* data, uint32_t offset = 0) = 0;
 
             virtual uint8_t* GetBuffer() const = 0;
 
@@ -30,6 +30,7 @@
 #define MAX_LIGHTS 32
 #define MAX_SHADOWMAPS 16
 #define MAX_BONES 100
+#define INSTANCE_DESCRIPTORSET_ID 2
 
 namespace Lumos
 {
@@ -73,6 +74,7 @@ namespace Lumos
             m_AnimatedShader = Application::Get().GetShaderLibrary()->GetResource("//CoreShaders/DeferredColourAnim.shader");
 
             m_DefaultMaterial = new Material(m_Shader);
+            m_InstanceBuffer = CreateUniqueRef<InstanceBuffer>(m_Shader.get(), INSTANCE_DESCRIPTORSET_ID);
 
             Graphics::MaterialProperties properties;
             properties.albedoColour = Maths::Vector4(1.0f);
@@ -137,13 +139,16 @@ namespace Lumos
             m_DefaultMaterial->CreateDescriptorSet(1);
 
             m_ClearColour = Maths::Vector4(0.1f, 0.1f, 0.1f, 1.0f);
-            m_CurrentDescriptorSets.resize(2);
+            m_CurrentDescriptorSets.resize(3);
         }
 
         void DeferredOffScreenRenderer::RenderScene()
         {
             LUMOS_PROFILE_FUNCTION();
 
+            if(m_Framebuffers.empty())
+                return;
+
             if(m_CommandQueue.empty())
             {
                 m_HasRendered = false;
@@ -161,7 +166,7 @@ namespace Lumos
         void DeferredOffScreenRenderer::Begin()
         {
             LUMOS_PROFILE_FUNCTION();
-            m_RenderPass->BeginRenderpass(Renderer::GetSwapchain()->GetCurrentCommandBuffer(), Maths::Vector4(0.0f), m_Framebuffers.front().get(), Graphics::INLINE, m_ScreenBufferWidth, m_ScreenBufferHeight);
+            m_RenderPass->BeginRenderpass(Renderer::GetSwapchain()->GetCurrentCommandBuffer(), Maths::Vector4(0.0f), m_Framebuffers.front().get(), m_Recorder.GetSubPassContents(), m_ScreenBufferWidth, m_ScreenBufferHeight);
         }
 
         void DeferredOffScreenRenderer::BeginScene(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform)
@@ -186,36 +191,19 @@ namespace Lumos
                 memcpy(m_VSSystemUniformBuffer + m_VSSystemUniformBufferOffsets[VSSystemUniformIndex_ProjectionViewMatrix], &projView, sizeof(Maths::Matrix4));
 
                 m_Frustum = m_Camera->GetFrustum(view);
+
+                m_CameraPosition = m_CameraTransform->GetWorldPosition();
+                m_InvCameraFar = 1.0f / m_Camera->GetFar();
             }
 
             {
-                auto& registry = scene->GetRegistry();
-                auto group = registry.group<Model>(entt::get<Maths::Transform>);
+                // Culled once per frame by the render graph
+                const RenderVisibility& visibility = Application::Get().GetRenderGraph()->GetVisibility();
 
-                for(auto entity : group)
+                for(uint32_t index : visibility.GetVisibleMeshes(RenderVisibility::CameraView))
                 {
-                    const auto& [model, trans] = group.get<Model, Maths::Transform>(entity);
-                    const auto& meshes = model.GetMeshes();
-
-                    for(auto& mesh : meshes)
-                    {
-                        if(mesh->GetActive())
-                        {
-                            auto& worldTransform = trans.GetWorldMatrix();
-                            Maths::Intersection inside;
-                            {
-                                LUMOS_PROFILE_SCOPE("Frustum Check");
-
-                                inside = m_Frustum.IsInsideFast(mesh->GetBoundingBox()->Transformed(worldTransform));
-                            }
-
-                            if(inside == Maths::Intersection::OUTSIDE)
-                                continue;
-
-                            auto textureMatrixTransform = registry.try_get<TextureMatrixComponent>(entity);
-                            SubmitMesh(mesh.get(), mesh->GetMaterial().get(), worldTransform, textureMatrixTransform ? textureMatrixTransform->GetMatrix() : Maths::Matrix4());
-                        }
-                    }
+                    const auto& item = visibility.GetMesh(index);
+                    SubmitMesh(item.mesh, item.mesh->GetMaterial().get(), item.transform->ToMatrix4(), item.textureMatrix);
                 }
             }
         }
@@ -234,6 +222,11 @@ namespace Lumos
             command.material = material ? material : m_DefaultMaterial;
             command.transform = transform;
             command.textureMatrix = textureMatrix;
+
+            const float depth = (transform.Translation() - m_CameraPosition).Length() * m_InvCameraFar;
+            const uint32_t pipelineFlags = (command.material->GetFlag(Material::RenderFlags::TWOSIDED) ? 1 : 0) | (command.material->GetFlag(Material::RenderFlags::ALPHABLEND) ? 2 : 0);
+            command.sortKey = RenderSortKey::Make(command.material->GetShader().get(), pipelineFlags, command.material, mesh, depth);
+
             Submit(command);
         }
 
@@ -259,48 +252,215 @@ namespace Lumos
         {
             LUMOS_PROFILE_FUNCTION();
 
-            for(uint32_t i = 0; i < static_cast<uint32_t>(m_CommandQueue.size()); i++)
+            m_CommandSorter.Sort(m_CommandQueue);
+
+            // Sorted commands sharing a mesh and material become one instanced draw.
+            // Only the deferred shader reads the instance buffer, materials with other shaders draw one command at a time
+            {
+                LUMOS_PROFILE_SCOPE("Build Instance Batches");
+                m_InstanceBuffer->Reset();
+                m_Batches.clear();
+
+                const uint32_t commandCount = static_cast<uint32_t>(m_CommandQueue.size());
+                for(uint32_t first = 0; first < commandCount;)
+                {
+                    const auto& command = m_CommandQueue[first];
+                    uint32_t last = first + 1;
+
+                    if(!command.material || command.material->GetShader() != m_Shader)
+                    {
+                        m_Batches.push_back({ first, InstanceBuffer::Range() });
+                        first = last;
+                        continue;
+                    }
+
+                    while(last < commandCount && m_CommandQueue[last].mesh == command.mesh && m_CommandQueue[last].material == command.material)
+                        last++;
+
+                    m_InstanceBuffer->AddBatches(m_CommandQueue, first, last, m_Batches);
+                    first = last;
+                }
+
+                m_InstanceBuffer->Upload();
+            }
+
+            // Pipeline creation and descriptor set updates aren't thread safe, so they happen before recording
+            {
+                LUMOS_PROFILE_SCOPE("Resolve Batch Pipelines");
+                m_BatchPipelines.resize(m_Batches.size());
+
+                Pipeline* pipeline = nullptr;
+                Graphics::PipelineDesc pipelineDesc {};
+                Material* boundMaterial = nullptr;
+
+                for(size_t i = 0; i < m_Batches.size(); i++)
+                {
+                    Material* material = m_CommandQueue[m_Batches[i].command].material;
+                    m_BatchPipelines[i] = nullptr;
+
+                    if(!material || !material->GetShader())
+                        continue;
+
+                    const Graphics::PipelineDesc desc = GetMaterialPipelineDesc(material);
+                    if(!pipeline || pipelineDesc.shader != desc.shader || pipelineDesc.cullMode != desc.cullMode || pipelineDesc.transparencyEnabled != desc.transparencyEnabled)
+                    {
+                        pipelineDesc = desc;
+                        pipeline = Graphics::Pipeline::Get(pipelineDesc).get();
+                    }
+
+                    if(material != boundMaterial)
+                    {
+                        material->Bind();
+                        boundMaterial = material;
+                    }
+
+                    m_BatchPipelines[i] = pipeline;
+                }
+            }
+
+            m_Recorder.Reset();
+            m_Recorder.AddPass(m_RenderPass.get(), m_Framebuffers.front().get(), m_ScreenBufferWidth, m_ScreenBufferHeight, static_cast<uint32_t>(m_Batches.size()));
+            m_Recorder.Record([this](CommandBuffer* commandBuffer, uint32_t pass, uint32_t first, uint32_t last)
+                              { RecordBatches(commandBuffer, first, last); });
+            m_Recorder.Execute(0, Renderer::GetSwapchain()->GetCurrentCommandBuffer());
+        }
+
+        void DeferredOffScreenRenderer::RecordBatches(CommandBuffer* commandBuffer, uint32_t firstBatch, uint32_t lastBatch)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            auto& stats = Engine::Get().Statistics();
+
+            // State bound by the previous draw. Commands are sorted by pipeline, material then mesh,
+            // so each is only rebound when it changes. A pipeline change rebinds everything after it
+            Pipeline* pipeline = nullptr;
+            Material* boundMaterial = nullptr;
+            DescriptorSet* boundInstances = nullptr;
+            Mesh* boundMesh = nullptr;
+
+            // Shaders share their push constant storage, so each range writes its own copy
+            uint8_t pushConstantData[PushConstant::MaxSize];
+            Shader* pushConstantShader = nullptr;
+
+            std::vector<DescriptorSet*> descriptorSets(m_CurrentDescriptorSets.size());
+
+            for(uint32_t i = firstBatch; i < lastBatch; i++)
             {
-                Engine::Get().Statistics().NumRenderedObjects++;
+                const auto& batch = m_Batches[i];
+                const auto& command = m_CommandQueue[batch.command];
+                const bool instanced = batch.instances.descriptorSet != nullptr;
+                stats.NumRenderedObjects += instanced ? batch.instances.count : 1;
 
-                auto command = m_CommandQueue[i];
                 Mesh* mesh = command.mesh;
+                Material* material = command.material;
 
-                if(!command.material || !command.material->GetShader())
+                if(!m_BatchPipelines[i])
                     continue;
 
-                auto commandBuffer = Renderer::GetSwapchain()->GetCurrentCommandBuffer();
+                if(m_BatchPipelines[i] != pipeline)
+                {
+                    pipeline = m_BatchPipelines[i];
+                    pipeline->Bind(commandBuffer);
+                    stats.NumPipelineBinds++;
 
-                Graphics::PipelineDesc pipelineCreateInfo {};
-                pipelineCreateInfo.shader = command.material->GetShader();
-                pipelineCreateInfo.renderpass = m_RenderPass;
-                pipelineCreateInfo.polygonMode = Graphics::PolygonMode::FILL;
-                pipelineCreateInfo.cullMode = command.material->GetFlag(Material::RenderFlags::TWOSIDED) ? Graphics::CullMode::NONE : Graphics::CullMode::BACK;
-                pipelineCreateInfo.transparencyEnabled = command.material->GetFlag(Material::RenderFlags::ALPHABLEND);
+                    boundMaterial = nullptr;
+                    if(boundMesh)
+                    {
+                        boundMesh->GetVertexBuffer()->Unbind();
+                        boundMesh->GetIndexBuffer()->Unbind();
+                        boundMesh = nullptr;
+                    }
+                }
 
-                auto pipeline = Graphics::Pipeline::Get(pipelineCreateInfo);
+                if(material != boundMaterial || batch.instances.descriptorSet != boundInstances)
+                {
+                    if(material != boundMaterial)
+                        stats.NumMaterialBinds++;
 
-                pipeline->Bind(commandBuffer);
+                    descriptorSets[SCENE_DESCRIPTORSET_ID] = m_DescriptorSet[SCENE_DESCRIPTORSET_ID].get();
+                    descriptorSets[MATERIAL_DESCRIPTORSET_ID] = material->GetDescriptorSet();
+                    descriptorSets[INSTANCE_DESCRIPTORSET_ID] = batch.instances.descriptorSet;
 
-                command.material->Bind();
+                    Renderer::BindDescriptorSets(pipeline, commandBuffer, 0, descriptorSets);
+                    boundMaterial = material;
+                    boundInstances = batch.instances.descriptorSet;
+                }
 
-                m_CurrentDescriptorSets[SCENE_DESCRIPTORSET_ID] = m_DescriptorSet[SCENE_DESCRIPTORSET_ID].get();
-                m_CurrentDescriptorSets[MATERIAL_DESCRIPTORSET_ID] = command.material->GetDescriptorSet();
+                Shader* shader = material->GetShader().get();
+                const auto& pushConstant = shader->GetPushConstants()[0];
+                if(shader != pushConstantShader)
+                {
+                    LUMOS_ASSERT(pushConstant.size <= PushConstant::MaxSize, "Push constant block too large");
+                    memcpy(pushConstantData, pushConstant.data, pushConstant.size);
+                    pushConstantShader = shader;
+                }
+
+                if(auto member = pushConstant.GetMember(instanced ? "instanceOffset" : "transform"))
+                {
+                    if(instanced)
+                        memcpy(&pushConstantData[member->offset], &batch.instances.first, member->size);
+                    else
+                        memcpy(&pushConstantData[member->offset], &command.transform, member->size);
+                }
+
+                shader->BindPushConstant(commandBuffer, pipeline, 0, pushConstantData);
+
+                if(mesh != boundMesh)
+                {
+                    if(boundMesh)
+                    {
+                        boundMesh->GetVertexBuffer()->Unbind();
+                        boundMesh->GetIndexBuffer()->Unbind();
+                    }
+
+                    mesh->GetVertexBuffer()->Bind(commandBuffer, pipeline);
+                    mesh->GetIndexBuffer()->Bind(commandBuffer);
+                    stats.NumMeshBinds++;
+                    boundMesh = mesh;
+                }
+
+                if(instanced)
+                    Renderer::DrawIndexedInstanced(commandBuffer, DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount(), batch.instances.count);
+                else
+                    Renderer::DrawIndexed(commandBuffer, DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount());
+            }
 
-                auto trans = command.transform;
-                auto& pushConstants = command.material->GetShader()->GetPushConstants()[0];
-                pushConstants.SetValue("transform", (void*)&trans);
+            if(boundMesh)
+            {
+                boundMesh->GetVertexBuffer()->Unbind();
+                boundMesh->GetIndexBuffer()->Unbind();
+            }
+        }
 
-                command.material->GetShader()->BindPushConstants(commandBuffer, pipeline.get());
+        Graphics::PipelineDesc DeferredOffScreenRenderer::GetMaterialPipelineDesc(Material* material) const
+        {
+            Graphics::PipelineDesc pipelineDesc {};
+            pipelineDesc.shader = material->GetShader();
+            pipelineDesc.renderpass = m_RenderPass;
+            pipelineDesc.polygonMode = Graphics::PolygonMode::FILL;
+            pipelineDesc.cullMode = material->GetFlag(Material::RenderFlags::TWOSIDED) ? Graphics::CullMode::NONE : Graphics::CullMode::BACK;
+            pipelineDesc.transparencyEnabled = material->GetFlag(Material::RenderFlags::ALPHABLEND);
+            return pipelineDesc;
+        }
 
-                mesh->GetVertexBuffer()->Bind(commandBuffer, pipeline.get());
-                mesh->GetIndexBuffer()->Bind(commandBuffer);
+        void DeferredOffScreenRenderer::PrewarmPipelines(Scene* scene)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            if(!scene)
+                return;
 
-                Renderer::BindDescriptorSets(pipeline.get(), commandBuffer, 0, m_CurrentDescriptorSets);
-                Renderer::DrawIndexed(commandBuffer, DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount());
+            // Pipeline::Get caches by description, so materials sharing a shader and flags only create one
+            auto view = scene->GetRegistry().view<Model>();
+            for(auto entity : view)
+            {
+                for(auto& mesh : view.get<Model>(entity).GetMeshes())
+                {
+                    Material* material = mesh->GetMaterial().get();
+                    if(!material)
+                        material = m_DefaultMaterial;
 
-                mesh->GetVertexBuffer()->Unbind();
-                mesh->GetIndexBuffer()->Unbind();
+                    if(material->GetShader())
+                        Graphics::Pipeline::Get(GetMaterialPipelineDesc(material));
+                }
             }
         }
 
@@ -393,14 +553,23 @@ namespace Lumos
             bufferInfo.renderPass = m_RenderPass.get();
             bufferInfo.attachmentTypes = attachmentTypes;
 
+            auto renderGraph = Application::Get().GetRenderGraph();
+
             Texture* attachments[attachmentCount];
-            attachments[0] = Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(SCREENTEX_COLOUR);
-            attachments[1] = Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(SCREENTEX_POSITION);
-            attachments[2] = Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(SCREENTEX_NORMALS);
-            attachments[3] = Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(SCREENTEX_PBR);
-            attachments[4] = Application::Get().GetRenderGraph()->GetGBuffer()->GetDepthTexture();
+            attachments[0] = renderGraph->GetTexture(RenderGraph::GBufferColour);
+            attachments[1] = renderGraph->GetTexture(RenderGraph::GBufferPosition);
+            attachments[2] = renderGraph->GetTexture(RenderGraph::GBufferNormals);
+            attachments[3] = renderGraph->GetTexture(RenderGraph::GBufferPBR);
+            attachments[4] = renderGraph->GetGBuffer()->GetDepthTexture();
             bufferInfo.attachments = attachments;
 
+            // The GBuffer textures are created when the graph is compiled, OnGraphCompiled builds the framebuffer then
+            for(uint32_t i = 0; i < attachmentCount; i++)
+            {
+                if(!attachments[i])
+                    return;
+            }
+
             m_Framebuffers.push_back(SharedRef<Framebuffer>(Framebuffer::Get(bufferInfo)));
         }
 
@@ -414,6 +583,13 @@ namespace Lumos
             CreateFramebuffer();
         }
 
+        void DeferredOffScreenRenderer::OnGraphCompiled()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            m_Framebuffers.clear();
+            CreateFramebuffer();
+        }
+
         void DeferredOffScreenRenderer::OnImGui()
         {
             ImGui::TextUnformatted("Deferred Offscreen Renderer");
@@ -1,5 +1,7 @@
 #pragma once
 #include "IRenderer.h"
+#include "InstanceBuffer.h"
+#include "ParallelCommandRecorder.h"
 #include "Maths/Frustum.h"
 
 namespace Lumos
@@ -37,6 +39,7 @@ namespace Lumos
             void End() override;
             void Present() override;
             void OnResize(uint32_t width, uint32_t height) override;
+            void OnGraphCompiled() override;
             void PresentToScreen() override { }
 
             void CreatePipeline();
@@ -44,11 +47,16 @@ namespace Lumos
             void CreateFramebuffer();
 
             void OnImGui() override;
+            void PrewarmPipelines(Scene* scene) override;
 
             bool HadRendered() const { return m_HasRendered; }
 
         private:
             void SetSystemUniforms(Shader* shader);
+            PipelineDesc GetMaterialPipelineDesc(Material* material) const;
+
+            // Records batches [firstBatch, lastBatch), may run on a job system worker
+            void RecordBatches(CommandBuffer* commandBuffer, uint32_t firstBatch, uint32_t lastBatch);
 
             Material* m_DefaultMaterial;
 
@@ -67,6 +75,16 @@ namespace Lumos
 
             UniformBufferModel m_UBODataDynamic;
             bool m_HasRendered = false;
+
+            RenderCommandSorter m_CommandSorter;
+            UniqueRef<InstanceBuffer> m_InstanceBuffer;
+            std::vector<InstanceBuffer::Batch> m_Batches;
+
+            // Resolved on the main thread before recording, nullptr for batches that are skipped
+            std::vector<Pipeline*> m_BatchPipelines;
+            ParallelCommandRecorder m_Recorder;
+            Maths::Vector3 m_CameraPosition;
+            float m_InvCameraFar = 0.0f;
         };
     }
 }
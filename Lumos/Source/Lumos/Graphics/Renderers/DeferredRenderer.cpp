@@ -32,6 +32,7 @@
 
 #include <imgui/imgui.h>
 
+// Lights evaluated for every fragment, point and spot lights are clustered
 #define MAX_LIGHTS 32
 #define MAX_SHADOWMAPS 4
 
@@ -69,6 +70,9 @@ namespace Lumos
         {
             delete m_UniformBuffer;
             delete m_LightUniformBuffer;
+            delete m_ClusterLightUniformBuffer;
+            delete m_ClusterUniformBuffer;
+            delete m_LightIndexUniformBuffer;
             delete m_ScreenQuad;
             delete m_OffScreenRenderer;
 
@@ -115,8 +119,13 @@ namespace Lumos
             m_PreintegratedFG = UniqueRef<Texture2D>(Texture2D::CreateFromSource(BRDFTextureWidth, BRDFTextureHeight, (void*)BRDFTexture, param));
 
             m_LightUniformBuffer = nullptr;
+            m_ClusterLightUniformBuffer = nullptr;
+            m_ClusterUniformBuffer = nullptr;
+            m_LightIndexUniformBuffer = nullptr;
             m_UniformBuffer = nullptr;
 
+            m_ClusterLights.resize(LightClusterGrid::MaxLights);
+
             m_ScreenQuad = Graphics::CreateScreenQuad();
 
             // Pixel/fragment shader System uniforms
@@ -175,6 +184,47 @@ namespace Lumos
         }
 
         void DeferredRenderer::RenderScene()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            m_OffScreenRenderer->RenderScene();
+            RenderLighting();
+        }
+
+        void DeferredRenderer::DeclarePasses(RenderGraphBuilder& builder)
+        {
+            // The GBuffer colour targets are only used until lighting. All four are live together, so they can't share memory
+            // with each other, only with a transient texture first used after DeferredLighting. No renderer creates one yet
+            auto gbuffer = Application::Get().GetRenderGraph()->GetGBuffer();
+            const char* gbufferTextures[] = { RenderGraph::GBufferColour, RenderGraph::GBufferPosition, RenderGraph::GBufferNormals, RenderGraph::GBufferPBR };
+            const ScreenTextures gbufferFormats[] = { SCREENTEX_COLOUR, SCREENTEX_POSITION, SCREENTEX_NORMALS, SCREENTEX_PBR };
+
+            for(uint32_t i = 0; i < 4; i++)
+            {
+                RenderGraphTextureDesc desc;
+                desc.format = gbuffer->GetTextureFormat(gbufferFormats[i]);
+                builder.CreateTexture(gbufferTextures[i], desc);
+            }
+
+            builder.AddPass("GBuffer", [this]()
+                { m_OffScreenRenderer->RenderScene(); });
+            builder.Write(RenderGraph::GBufferColour, RESOURCE_USAGE_COLOUR_ATTACHMENT);
+            builder.Write(RenderGraph::GBufferPosition, RESOURCE_USAGE_COLOUR_ATTACHMENT);
+            builder.Write(RenderGraph::GBufferNormals, RESOURCE_USAGE_COLOUR_ATTACHMENT);
+            builder.Write(RenderGraph::GBufferPBR, RESOURCE_USAGE_COLOUR_ATTACHMENT);
+            builder.Write(RenderGraph::SceneDepth, RESOURCE_USAGE_DEPTH_ATTACHMENT);
+
+            builder.AddPass("DeferredLighting", [this]()
+                { RenderLighting(); });
+            builder.Read(RenderGraph::GBufferColour);
+            builder.Read(RenderGraph::GBufferPosition);
+            builder.Read(RenderGraph::GBufferNormals);
+            builder.Read(RenderGraph::GBufferPBR);
+            builder.Read(RenderGraph::SceneDepth);
+            builder.Read(RenderGraph::ShadowMap);
+            builder.Write(RenderGraph::SceneColour, RESOURCE_USAGE_COLOUR_ATTACHMENT);
+        }
+
+        void DeferredRenderer::RenderLighting()
         {
             LUMOS_PROFILE_FUNCTION();
 
@@ -184,8 +234,6 @@ namespace Lumos
 
             //Renderer::GetRenderer()->ClearRenderTarget(m_RenderTexture ? m_RenderTexture : Renderer::GetSwapchain()->GetImage(commandBufferIndex), Renderer::GetSwapchain()->GetCurrentCommandBuffer());
 
-            m_OffScreenRenderer->RenderScene();
-
             //if(!m_OffScreenRenderer->HadRendered())
             //   return;
 
@@ -308,6 +356,8 @@ namespace Lumos
             auto group = registry.group<Graphics::Light>(entt::get<Maths::Transform>);
 
             uint32_t numLights = 0;
+            m_ClusterLightCount = 0;
+            m_DroppedClusterLightCount = 0;
 
             auto viewMatrix = m_CameraTransform->GetWorldMatrix().Inverse();
 
@@ -331,12 +381,31 @@ namespace Lumos
 
                 light.Direction = forward.Normalised();
 
-                memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_Lights] + sizeof(Graphics::Light) * numLights, &light, sizeof(Graphics::Light));
-                numLights++;
+                if(light.Type == float(LightType::DirectionalLight))
+                {
+                    if(numLights < MAX_LIGHTS)
+                    {
+                        memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_Lights] + sizeof(Graphics::Light) * numLights, &light, sizeof(Graphics::Light));
+                        numLights++;
+                    }
+                }
+                else if(m_ClusterLightCount < LightClusterGrid::MaxLights)
+                    m_ClusterLights[m_ClusterLightCount++] = light;
+                else
+                    m_DroppedClusterLightCount++;
             }
 
+            if(m_DroppedClusterLightCount > 0 && !m_DroppedClusterLightsWarned)
+            {
+                LUMOS_LOG_WARN("{0} point and spot lights in view exceed the clustered light limit of {1} and are not rendered", m_DroppedClusterLightCount, LightClusterGrid::MaxLights);
+                m_DroppedClusterLightsWarned = true;
+            }
+
+            m_LightClusters.Build(m_ClusterLights.data(), m_ClusterLightCount, viewMatrix, m_Camera->GetProjectionMatrix(), m_Camera->GetNear(), m_Camera->GetFar());
+
             Maths::Vector4 cameraPos = Maths::Vector4(m_CameraTransform->GetWorldPosition());
             memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_CameraPosition], &cameraPos, sizeof(Maths::Vector4));
+            memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ViewMatrix], &viewMatrix, sizeof(Maths::Matrix4));
 
             auto shadowRenderer = Application::Get().GetRenderGraph()->GetShadowRenderer();
             if(shadowRenderer)
@@ -345,7 +414,6 @@ namespace Lumos
                 Lumos::Maths::Vector4* uSplitDepth = shadowRenderer->GetSplitDepths();
                 const Maths::Matrix4& lightView = shadowRenderer->GetLightView();
 
-                memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ViewMatrix], &viewMatrix, sizeof(Maths::Matrix4));
                 memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_LightView], &lightView, sizeof(Maths::Matrix4));
 
                 memcpy(m_PSSystemUniformBuffer + m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_ShadowTransforms], shadowTransforms, sizeof(Maths::Matrix4) * MAX_SHADOWMAPS);
@@ -390,6 +458,11 @@ namespace Lumos
         {
             LUMOS_PROFILE_FUNCTION();
             m_LightUniformBuffer->SetData(m_PSSystemUniformBufferSize, *&m_PSSystemUniformBuffer);
+
+            // Uploaded whole, the blocks keep a fixed size however many lights are in view
+            m_ClusterLightUniformBuffer->SetData(sizeof(Light) * LightClusterGrid::MaxLights, m_ClusterLights.data());
+            m_ClusterUniformBuffer->SetData(sizeof(LightClusterGrid::ClusterData), &m_LightClusters.GetClusterData());
+            m_LightIndexUniformBuffer->SetData(sizeof(uint16_t) * LightClusterGrid::MaxLightIndices, m_LightClusters.GetLightIndices());
         }
 
         void DeferredRenderer::Present()
@@ -483,6 +556,26 @@ namespace Lumos
             ImGui::PopItemWidth();
             ImGui::NextColumn();
 
+            ImGui::AlignTextToFramePadding();
+            ImGui::TextUnformatted("Clustered Lights");
+            ImGui::NextColumn();
+            ImGui::PushItemWidth(-1);
+            ImGui::Text("%u / %u", m_ClusterLightCount, LightClusterGrid::MaxLights);
+            if(m_DroppedClusterLightCount > 0)
+                ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%u dropped", m_DroppedClusterLightCount);
+            ImGui::PopItemWidth();
+            ImGui::NextColumn();
+
+            ImGui::AlignTextToFramePadding();
+            ImGui::TextUnformatted("Cluster Light Indices");
+            ImGui::NextColumn();
+            ImGui::PushItemWidth(-1);
+            ImGui::Text("%u / %u", m_LightClusters.GetLightIndexCount(), LightClusterGrid::MaxLightIndices);
+            if(m_LightClusters.GetDroppedLightIndexCount() > 0)
+                ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%u dropped", m_LightClusters.GetDroppedLightIndexCount());
+            ImGui::PopItemWidth();
+            ImGui::NextColumn();
+
             ImGui::AlignTextToFramePadding();
             ImGui::TextUnformatted("Render Mode");
             ImGui::NextColumn();
@@ -551,6 +644,15 @@ namespace Lumos
 
                 uint32_t bufferSize = m_PSSystemUniformBufferSize;
                 m_LightUniformBuffer->Init(bufferSize, nullptr);
+
+                m_ClusterLightUniformBuffer = Graphics::UniformBuffer::Create();
+                m_ClusterLightUniformBuffer->Init(sizeof(Light) * LightClusterGrid::MaxLights, nullptr);
+
+                m_ClusterUniformBuffer = Graphics::UniformBuffer::Create();
+                m_ClusterUniformBuffer->Init(sizeof(LightClusterGrid::ClusterData), nullptr);
+
+                m_LightIndexUniformBuffer = Graphics::UniformBuffer::Create();
+                m_LightIndexUniformBuffer->Init(sizeof(uint16_t) * LightClusterGrid::MaxLightIndices, nullptr);
             }
 
             std::vector<Graphics::Descriptor> bufferInfos;
@@ -566,9 +668,32 @@ namespace Lumos
 
             bufferInfos.push_back(bufferInfo);
 
+            bufferInfo.name = "UniformBufferLights";
+            bufferInfo.buffer = m_ClusterLightUniformBuffer;
+            bufferInfo.size = sizeof(Light) * LightClusterGrid::MaxLights;
+            bufferInfo.binding = 1;
+            bufferInfos.push_back(bufferInfo);
+
+            bufferInfo.name = "UniformBufferClusters";
+            bufferInfo.buffer = m_ClusterUniformBuffer;
+            bufferInfo.size = sizeof(LightClusterGrid::ClusterData);
+            bufferInfo.binding = 2;
+            bufferInfos.push_back(bufferInfo);
+
+            bufferInfo.name = "UniformBufferLightIndices";
+            bufferInfo.buffer = m_LightIndexUniformBuffer;
+            bufferInfo.size = sizeof(uint16_t) * LightClusterGrid::MaxLightIndices;
+            bufferInfo.binding = 3;
+            bufferInfos.push_back(bufferInfo);
+
             m_DescriptorSet[0]->Update(bufferInfos);
         }
 
+        void DeferredRenderer::PrewarmPipelines(Scene* scene)
+        {
+            m_OffScreenRenderer->PrewarmPipelines(scene);
+        }
+
         void DeferredRenderer::OnResize(uint32_t width, uint32_t height)
         {
             LUMOS_PROFILE_FUNCTION();
@@ -587,30 +712,38 @@ namespace Lumos
             UpdateScreenDescriptorSet();
         }
 
+        void DeferredRenderer::OnGraphCompiled()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            m_OffScreenRenderer->OnGraphCompiled();
+            UpdateScreenDescriptorSet();
+        }
+
         void DeferredRenderer::UpdateScreenDescriptorSet()
         {
+            auto renderGraph = Application::Get().GetRenderGraph();
             std::vector<Graphics::Descriptor> bufferInfos;
 
             Graphics::Descriptor imageInfo = {};
-            imageInfo.texture = { Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(SCREENTEX_COLOUR) };
+            imageInfo.texture = { renderGraph->GetTexture(RenderGraph::GBufferColour) };
             imageInfo.binding = 0;
             imageInfo.type = DescriptorType::IMAGE_SAMPLER;
             imageInfo.name = "uColourSampler";
 
             Graphics::Descriptor imageInfo2 = {};
-            imageInfo2.texture = { Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(SCREENTEX_POSITION) };
+            imageInfo2.texture = { renderGraph->GetTexture(RenderGraph::GBufferPosition) };
             imageInfo2.binding = 1;
             imageInfo2.type = DescriptorType::IMAGE_SAMPLER;
             imageInfo2.name = "uPositionSampler";
 
             Graphics::Descriptor imageInfo3 = {};
-            imageInfo3.texture = { Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(SCREENTEX_NORMALS) };
+            imageInfo3.texture = { renderGraph->GetTexture(RenderGraph::GBufferNormals) };
             imageInfo3.binding = 2;
             imageInfo3.type = DescriptorType::IMAGE_SAMPLER;
             imageInfo3.name = "uNormalSampler";
 
             Graphics::Descriptor imageInfo4 = {};
-            imageInfo4.texture = { Application::Get().GetRenderGraph()->GetGBuffer()->GetTexture(SCREENTEX_PBR) };
+            imageInfo4.texture = { renderGraph->GetTexture(RenderGraph::GBufferPBR) };
             imageInfo4.binding = 3;
             imageInfo4.type = DescriptorType::IMAGE_SAMPLER;
             imageInfo4.name = "uPBRSampler";
@@ -636,7 +769,7 @@ namespace Lumos
             imageInfo7.name = "uIrradianceMap";
 
             Graphics::Descriptor imageInfo8 = {};
-            auto shadowRenderer = Application::Get().GetRenderGraph()->GetShadowRenderer();
+            auto shadowRenderer = renderGraph->GetShadowRenderer();
             if(shadowRenderer)
             {
                 imageInfo8.texture = { reinterpret_cast<Texture*>(shadowRenderer->GetTexture()) };
@@ -647,7 +780,7 @@ namespace Lumos
             }
 
             Graphics::Descriptor imageInfo9 = {};
-            imageInfo9.texture = { Application::Get().GetRenderGraph()->GetGBuffer()->GetDepthTexture() };
+            imageInfo9.texture = { renderGraph->GetGBuffer()->GetDepthTexture() };
             imageInfo9.binding = 8;
             imageInfo5.type = DescriptorType::IMAGE_SAMPLER;
             imageInfo9.textureType = TextureType::DEPTH;
@@ -665,7 +798,9 @@ namespace Lumos
             if(shadowRenderer)
                 bufferInfos.push_back(imageInfo8);
 
-            m_DescriptorSet[1]->Update(bufferInfos);
+            // The GBuffer textures are created when the graph is compiled, OnGraphCompiled updates the set then
+            if(imageInfo.texture)
+                m_DescriptorSet[1]->Update(bufferInfos);
 
             CreateLightBuffer();
         }
@@ -1,5 +1,6 @@
 #pragma once
 #include "IRenderer.h"
+#include "LightClusterGrid.h"
 
 namespace Lumos
 {
@@ -26,6 +27,10 @@ namespace Lumos
             ~DeferredRenderer() override;
 
             void RenderScene() override;
+            void DeclarePasses(RenderGraphBuilder& builder) override;
+
+            // Shades the GBuffer written by the offscreen renderer
+            void RenderLighting();
 
             void Init() override;
             void Begin() override {};
@@ -38,6 +43,7 @@ namespace Lumos
             void End() override;
             void Present() override;
             void OnResize(uint32_t width, uint32_t height) override;
+            void OnGraphCompiled() override;
             void PresentToScreen() override;
 
             void CreateDeferredPipeline();
@@ -48,6 +54,7 @@ namespace Lumos
             void SetRenderTarget(Texture* texture, bool rebuildFramebuffer) override;
 
             void OnImGui() override;
+            void PrewarmPipelines(Scene* scene) override;
 
         private:
             DeferredOffScreenRenderer* m_OffScreenRenderer;
@@ -61,6 +68,16 @@ namespace Lumos
 
             UniformBuffer* m_UniformBuffer;
             UniformBuffer* m_LightUniformBuffer;
+            UniformBuffer* m_ClusterLightUniformBuffer;
+            UniformBuffer* m_ClusterUniformBuffer;
+            UniformBuffer* m_LightIndexUniformBuffer;
+
+            // Point and spot lights in view, evaluated per cluster instead of for every fragment
+            std::vector<Light> m_ClusterLights;
+            uint32_t m_ClusterLightCount = 0;
+            uint32_t m_DroppedClusterLightCount = 0;
+            bool m_DroppedClusterLightsWarned = false;
+            LightClusterGrid m_LightClusters;
 
             CommandBuffer* m_DeferredCommandBuffers;
 
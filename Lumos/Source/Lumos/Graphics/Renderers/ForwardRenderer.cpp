@@ -42,10 +42,6 @@ namespace Lumos
             delete m_DefaultTexture;
             delete m_UniformBuffer;
 
-            Memory::AlignedFree(m_UBODataDynamic.model);
-
-            delete m_ModelUniformBuffer;
-
             delete[] m_VSSystemUniformBuffer;
             delete[] m_PSSystemUniformBuffer;
 
@@ -116,7 +112,6 @@ namespace Lumos
             m_PSSystemUniformBufferOffsets[PSSystemUniformIndex_Lights] = 0;
 
             m_UniformBuffer = Graphics::UniformBuffer::Create();
-            m_ModelUniformBuffer = Graphics::UniformBuffer::Create();
 
             Graphics::RenderPassDesc renderpassCI {};
 
@@ -157,19 +152,20 @@ namespace Lumos
             uint32_t bufferSize = static_cast<uint32_t>(sizeof(UniformBufferObject));
             m_UniformBuffer->Init(bufferSize, nullptr);
 
-            const size_t minUboAlignment = Graphics::GraphicsContext::GetContext()->GetMinUniformBufferOffsetAlignment();
-
-            m_DynamicAlignment = sizeof(Lumos::Maths::Matrix4);
-            if(minUboAlignment > 0)
-            {
-                m_DynamicAlignment = (m_DynamicAlignment + minUboAlignment - 1) & ~(minUboAlignment - 1);
-            }
+            const uint32_t modelAlignment = static_cast<uint32_t>(Maths::Max(Graphics::GraphicsContext::GetContext()->GetMinUniformBufferOffsetAlignment(), sizeof(Maths::Matrix4)));
+            m_ModelAllocator = CreateUniqueRef<UniformBufferAllocator>(MAX_OBJECTS * modelAlignment, static_cast<uint32_t>(sizeof(Maths::Matrix4)));
 
-            uint32_t bufferSize2 = static_cast<uint32_t>(MAX_OBJECTS * m_DynamicAlignment);
+            m_ClearColour = Maths::Vector4(0.4f, 0.4f, 0.4f, 1.0f);
 
-            m_UBODataDynamic.model = static_cast<Maths::Matrix4*>(Memory::AlignedAlloc(bufferSize2, m_DynamicAlignment));
+            m_DefaultTexture = Texture2D::CreateFromSource(CheckerboardTextureArrayWidth, CheckerboardTextureArrayHeight, (void*)(uint8_t*)CheckerboardTextureArray);
 
-            m_ModelUniformBuffer->Init(bufferSize2, nullptr);
+            Graphics::DescriptorDesc info {};
+            info.layoutIndex = 0;
+            info.shader = m_Shader.get();
+            m_DescriptorSet.resize(2);
+            m_DescriptorSet[0] = SharedRef<Graphics::DescriptorSet>(Graphics::DescriptorSet::Create(info));
+            info.layoutIndex = 1;
+            m_DescriptorSet[1] = SharedRef<Graphics::DescriptorSet>(Graphics::DescriptorSet::Create(info));
 
             std::vector<Graphics::Descriptor> bufferInfos;
 
@@ -181,28 +177,16 @@ namespace Lumos
             bufferInfo.binding = 0;
 
             Graphics::Descriptor bufferInfo2 = {};
-            bufferInfo2.buffer = m_ModelUniformBuffer;
+            bufferInfo2.buffer = m_ModelAllocator->GetBuffer();
             bufferInfo2.offset = 0;
-            bufferInfo2.size = sizeof(UniformBufferModel);
+            bufferInfo2.size = m_ModelAllocator->GetMaxAllocationSize();
             bufferInfo2.type = Graphics::DescriptorType::UNIFORM_BUFFER_DYNAMIC;
             bufferInfo2.binding = 1;
 
             bufferInfos.push_back(bufferInfo);
             bufferInfos.push_back(bufferInfo2);
 
-            m_DescriptorSet[0].get()->Update(bufferInfos);
-
-            m_ClearColour = Maths::Vector4(0.4f, 0.4f, 0.4f, 1.0f);
-
-            m_DefaultTexture = Texture2D::CreateFromSource(CheckerboardTextureArrayWidth, CheckerboardTextureArrayHeight, (void*)(uint8_t*)CheckerboardTextureArray);
-
-            Graphics::DescriptorDesc info {};
-            info.layoutIndex = 0;
-            info.shader = m_Shader.get();
-            m_DescriptorSet.resize(2);
-            m_DescriptorSet[0] = SharedRef<Graphics::DescriptorSet>(Graphics::DescriptorSet::Create(info));
-            info.layoutIndex = 1;
-            m_DescriptorSet[1] = SharedRef<Graphics::DescriptorSet>(Graphics::DescriptorSet::Create(info));
+            m_DescriptorSet[0]->Update(bufferInfos);
 
             std::vector<Graphics::Descriptor> bufferInfosDefault;
 
@@ -222,7 +206,7 @@ namespace Lumos
         {
             m_CurrentBufferID = 0;
 
-            m_RenderPass->BeginRenderpass(m_CommandBuffers[m_CurrentBufferID], m_ClearColour, m_Framebuffers[m_CurrentBufferID].get(), Graphics::INLINE, m_ScreenBufferWidth, m_ScreenBufferHeight);
+            m_RenderPass->BeginRenderpass(m_CommandBuffers[m_CurrentBufferID], m_ClearColour, m_Framebuffers[m_CurrentBufferID].get(), m_Recorder.GetSubPassContents(), m_ScreenBufferWidth, m_ScreenBufferHeight);
         }
 
         void ForwardRenderer::BeginScene(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform)
@@ -253,39 +237,13 @@ namespace Lumos
 
             m_CommandQueue.clear();
 
-            auto group = registry.group<Model>(entt::get<Maths::Transform>);
+            // Culled once per frame by the render graph
+            const RenderVisibility& visibility = Application::Get().GetRenderGraph()->GetVisibility();
 
-            for(auto entity : group)
+            for(uint32_t index : visibility.GetVisibleMeshes(RenderVisibility::CameraView))
             {
-                const auto& [model, trans] = group.get<Model, Maths::Transform>(entity);
-
-                const auto& meshes = model.GetMeshes();
-
-                for(auto mesh : meshes)
-                {
-                    if(mesh->GetActive())
-                    {
-                        auto& worldTransform = trans.GetWorldMatrix();
-
-                        auto bb = mesh->GetBoundingBox();
-                        auto bbCopy = bb->Transformed(worldTransform);
-                        auto inside = m_Frustum.IsInsideFast(bbCopy);
-
-                        if(inside == Maths::Intersection::OUTSIDE)
-                            continue;
-
-                        auto meshPtr = mesh;
-
-                        auto textureMatrixTransform = registry.try_get<TextureMatrixComponent>(entity);
-                        Maths::Matrix4 textureMatrix;
-                        if(textureMatrixTransform)
-                            textureMatrix = textureMatrixTransform->GetMatrix();
-                        else
-                            textureMatrix = Maths::Matrix4();
-
-                        SubmitMesh(meshPtr.get(), meshPtr->GetMaterial().get(), worldTransform, textureMatrix);
-                    }
-                }
+                const auto& item = visibility.GetMesh(index);
+                SubmitMesh(item.mesh, item.mesh->GetMaterial().get(), item.transform->ToMatrix4(), item.textureMatrix);
             }
         }
 
@@ -323,49 +281,48 @@ namespace Lumos
                 m_CommandBuffers[m_CurrentBufferID]->Execute(true);
         }
 
-        void ForwardRenderer::SetSystemUniforms(Shader* shader) const
+        void ForwardRenderer::SetSystemUniforms(Shader* shader)
         {
             m_UniformBuffer->SetData(sizeof(UniformBufferObject), *&m_VSSystemUniformBuffer);
 
-            int index = 0;
+            m_ModelAllocator->BeginFrame();
+            m_ModelOffsets.resize(m_CommandQueue.size());
 
-            for(auto& command : m_CommandQueue)
-            {
-                Maths::Matrix4* modelMat = reinterpret_cast<Maths::Matrix4*>((reinterpret_cast<uint64_t>(m_UBODataDynamic.model) + (index * m_DynamicAlignment)));
-                *modelMat = command.transform;
-                index++;
-            }
+            for(size_t i = 0; i < m_CommandQueue.size(); i++)
+                m_ModelOffsets[i] = m_ModelAllocator->Push(m_CommandQueue[i].transform).offset;
 
-            m_ModelUniformBuffer->SetDynamicData(static_cast<uint32_t>(index * m_DynamicAlignment), sizeof(Maths::Matrix4), &*m_UBODataDynamic.model);
+            m_ModelAllocator->Flush();
         }
 
         void ForwardRenderer::Present()
         {
-            int index = 0;
-
-            for(auto& command : m_CommandQueue)
-            {
-                Mesh* mesh = command.mesh;
+            m_Recorder.Reset();
+            m_Recorder.AddPass(m_RenderPass.get(), m_Framebuffers[m_CurrentBufferID].get(), m_ScreenBufferWidth, m_ScreenBufferHeight, static_cast<uint32_t>(m_CommandQueue.size()));
+            m_Recorder.Record([this](CommandBuffer* commandBuffer, uint32_t pass, uint32_t first, uint32_t last)
+                              { RecordCommands(commandBuffer, first, last); });
+            m_Recorder.Execute(0, m_CommandBuffers[m_CurrentBufferID]);
+        }
 
-                Graphics::CommandBuffer* currentCMDBuffer = m_CommandBuffers[m_CurrentBufferID];
+        void ForwardRenderer::RecordCommands(CommandBuffer* commandBuffer, uint32_t first, uint32_t last)
+        {
+            std::vector<DescriptorSet*> descriptorSets = { m_DescriptorSet[0].get(), m_DescriptorSet[1].get() };
 
-                m_Pipeline->Bind(currentCMDBuffer);
+            for(uint32_t index = first; index < last; index++)
+            {
+                Mesh* mesh = m_CommandQueue[index].mesh;
 
-                uint32_t dynamicOffset = index * static_cast<uint32_t>(m_DynamicAlignment);
+                m_Pipeline->Bind(commandBuffer);
 
-                m_CurrentDescriptorSets[0] = m_DescriptorSet[0].get();
-                m_CurrentDescriptorSets[1] = m_DescriptorSet[1].get();
+                uint32_t dynamicOffset = m_ModelOffsets[index];
 
-                mesh->GetVertexBuffer()->Bind(currentCMDBuffer, m_Pipeline.get());
-                mesh->GetIndexBuffer()->Bind(currentCMDBuffer);
+                mesh->GetVertexBuffer()->Bind(commandBuffer, m_Pipeline.get());
+                mesh->GetIndexBuffer()->Bind(commandBuffer);
 
-                Renderer::BindDescriptorSets(m_Pipeline.get(), currentCMDBuffer, dynamicOffset, m_CurrentDescriptorSets);
-                Renderer::DrawIndexed(currentCMDBuffer, DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount());
+                Renderer::BindDescriptorSets(m_Pipeline.get(), commandBuffer, dynamicOffset, descriptorSets);
+                Renderer::DrawIndexed(commandBuffer, DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount());
 
                 mesh->GetVertexBuffer()->Unbind();
                 mesh->GetIndexBuffer()->Unbind();
-
-                index++;
             }
         }
 
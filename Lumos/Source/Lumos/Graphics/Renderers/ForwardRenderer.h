@@ -2,6 +2,8 @@
 
 #include "IRenderer.h"
 #include "Maths/Frustum.h"
+#include "ParallelCommandRecorder.h"
+#include "UniformBufferAllocator.h"
 
 namespace Lumos
 {
@@ -42,23 +44,23 @@ namespace Lumos
                 Lumos::Maths::Matrix4 view;
             };
 
-            struct UniformBufferModel
-            {
-                Lumos::Maths::Matrix4* model;
-            };
-
-            void SetSystemUniforms(Shader* shader) const;
+            void SetSystemUniforms(Shader* shader);
 
         private:
+            // Records commands [first, last), may run on a job system worker
+            void RecordCommands(CommandBuffer* commandBuffer, uint32_t first, uint32_t last);
+
             Texture2D* m_DefaultTexture;
 
             UniformBuffer* m_UniformBuffer;
-            UniformBuffer* m_ModelUniformBuffer;
 
             std::vector<Lumos::Graphics::CommandBuffer*> m_CommandBuffers;
 
-            size_t m_DynamicAlignment;
-            UniformBufferModel m_UBODataDynamic;
+            // Model matrices, one allocation per command
+            UniqueRef<UniformBufferAllocator> m_ModelAllocator;
+            std::vector<uint32_t> m_ModelOffsets;
+
+            ParallelCommandRecorder m_Recorder;
 
             uint32_t m_CurrentBufferID = 0;
             bool m_DepthTest = false;
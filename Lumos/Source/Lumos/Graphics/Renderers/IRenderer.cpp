@@ -1,5 +1,6 @@
 #include "Precompiled.h"
 #include "IRenderer.h"
+#include "RenderGraph.h"
 
 //#include "Graphics/RHI/Shader.h"
 //#include "Graphics/RHI/Framebuffer.h"
@@ -14,4 +15,11 @@ namespace Lumos
     Graphics::IRenderer::~IRenderer()
     {
     }
+
+    void Graphics::IRenderer::DeclarePasses(RenderGraphBuilder& builder)
+    {
+        builder.AddPass("Renderer", [this]()
+            { RenderScene(); });
+        builder.Write(RenderGraph::SceneColour, RESOURCE_USAGE_COLOUR_ATTACHMENT);
+    }
 }
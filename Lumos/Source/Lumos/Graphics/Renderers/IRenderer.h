@@ -24,6 +24,7 @@ namespace Lumos
         class Texture;
         class Shader;
         class Material;
+        class RenderGraphBuilder;
 
         typedef std::vector<RenderCommand> CommandQueue;
 
@@ -44,6 +45,16 @@ namespace Lumos
             virtual void OnResize(uint32_t width, uint32_t height) = 0;
             virtual void OnImGui() {};
 
+            // Creates the pipelines drawing this scene needs, so they are not built the first time they are drawn
+            virtual void PrewarmPipelines(Scene* scene) {};
+
+            // Adds this renderer's passes to the render graph. By default RenderScene is one pass drawing to the screen
+            virtual void DeclarePasses(RenderGraphBuilder& builder);
+
+            // Called after the render graph is compiled. Transient textures may have been reassigned, so framebuffers
+            // and descriptor sets using them are rebuilt from RenderGraph::GetTexture
+            virtual void OnGraphCompiled() {};
+
             virtual void SetScreenBufferSize(uint32_t width, uint32_t height)
             {
                 LUMOS_ASSERT(width != 0 && height != 0, "Width or Height 0!");
@@ -0,0 +1,117 @@
+#include "Precompiled.h"
+#include "InstanceBuffer.h"
+#include "Graphics/RHI/Shader.h"
+#include "Graphics/RHI/DescriptorSet.h"
+#include "Graphics/RHI/UniformBuffer.h"
+
+namespace Lumos::Graphics
+{
+    InstanceBuffer::InstanceBuffer(Shader* shader, uint32_t setIndex)
+        : m_Shader(shader)
+        , m_SetIndex(setIndex)
+    {
+    }
+
+    InstanceBuffer::~InstanceBuffer()
+    {
+        for(auto& page : m_Pages)
+            delete page.buffer;
+    }
+
+    void InstanceBuffer::Reset()
+    {
+        m_CurrentPage = 0;
+        m_CurrentPageCount = 0;
+        m_FirstDirtyPage = 0;
+    }
+
+    InstanceBuffer::Range InstanceBuffer::Allocate(uint32_t count)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(m_CurrentPageCount == MaxInstancesPerPage)
+        {
+            m_CurrentPage++;
+            m_CurrentPageCount = 0;
+        }
+
+        if(m_CurrentPage == m_Pages.size())
+            AddPage();
+
+        auto& page = m_Pages[m_CurrentPage];
+
+        Range range;
+        range.descriptorSet = page.descriptorSet.get();
+        range.first = m_CurrentPageCount;
+        range.count = Maths::Min(count, MaxInstancesPerPage - m_CurrentPageCount);
+        range.transforms = &page.transforms[range.first];
+
+        m_CurrentPageCount += range.count;
+        return range;
+    }
+
+    void InstanceBuffer::AddBatches(const std::vector<RenderCommand>& commands, uint32_t first, uint32_t last, std::vector<Batch>& batches)
+    {
+        while(first < last)
+        {
+            const Range range = Allocate(last - first);
+            for(uint32_t i = 0; i < range.count; i++)
+                range.transforms[i] = commands[first + i].transform;
+
+            batches.push_back({ first, range });
+            first += range.count;
+        }
+    }
+
+    void InstanceBuffer::Upload()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(m_Pages.empty())
+            return;
+
+        // The current page may still be appended to, it is uploaded again next time with the new instances
+        for(uint32_t i = m_FirstDirtyPage; i <= m_CurrentPage; i++)
+            m_Pages[i].buffer->SetData(sizeof(Maths::Matrix4) * MaxInstancesPerPage, m_Pages[i].transforms.data());
+
+        m_FirstDirtyPage = m_CurrentPage;
+    }
+
+    void InstanceBuffer::AddPage()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const uint32_t pageSize = sizeof(Maths::Matrix4) * MaxInstancesPerPage;
+
+        Page page;
+        page.transforms.resize(MaxInstancesPerPage);
+        page.buffer = UniformBuffer::Create();
+        page.buffer->Init(pageSize, nullptr);
+
+        DescriptorDesc info {};
+        info.layoutIndex = m_SetIndex;
+        info.shader = m_Shader;
+        page.descriptorSet = SharedRef<DescriptorSet>(DescriptorSet::Create(info));
+
+        // Binding and block name come from the shader so passes can place the block wherever it fits
+        std::vector<Descriptor> bufferInfos;
+        for(auto& descriptor : m_Shader->GetDescriptorInfo(m_SetIndex).descriptors)
+        {
+            if(descriptor.type != DescriptorType::UNIFORM_BUFFER)
+                continue;
+
+            Descriptor bufferInfo = {};
+            bufferInfo.buffer = page.buffer;
+            bufferInfo.offset = 0;
+            bufferInfo.size = pageSize;
+            bufferInfo.type = DescriptorType::UNIFORM_BUFFER;
+            bufferInfo.binding = descriptor.binding;
+            bufferInfo.shaderType = ShaderType::VERTEX;
+            bufferInfo.name = descriptor.name;
+            bufferInfos.push_back(bufferInfo);
+            break;
+        }
+
+        LUMOS_ASSERT(!bufferInfos.empty(), "Shader has no instance buffer");
+        page.descriptorSet->Update(bufferInfos);
+
+        m_Pages.push_back(std::move(page));
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "Maths/Maths.h"
+#include "RenderCommand.h"
+
+namespace Lumos
+{
+    namespace Graphics
+    {
+        class Shader;
+        class DescriptorSet;
+        class UniformBuffer;
+
+        // Per frame store of instance transforms for shaders declaring an InstanceBufferObject block.
+        // Transforms are packed into fixed size uniform buffer pages, each with its own descriptor set.
+        // A draw binds the page holding its instances and passes the index of the first one as a push constant
+        class LUMOS_EXPORT InstanceBuffer
+        {
+        public:
+            // Matches MAX_INSTANCES in the shaders. 16KB is the largest uniform block every device supports
+            static const uint32_t MaxInstancesPerPage = 256;
+
+            struct Range
+            {
+                DescriptorSet* descriptorSet = nullptr;
+                Maths::Matrix4* transforms = nullptr; // Written by the caller before Upload
+                uint32_t first = 0;
+                uint32_t count = 0;
+            };
+
+            // One instanced draw of the command at index command
+            struct Batch
+            {
+                uint32_t command;
+                Range instances;
+            };
+
+            // Pages are bound with descriptor sets created from shader's set setIndex
+            InstanceBuffer(Shader* shader, uint32_t setIndex);
+            ~InstanceBuffer();
+
+            // Called once per frame, before any Allocate
+            void Reset();
+
+            // Reserves up to count consecutive instances in one page.
+            // Fewer are returned when the current page fills up, callers allocate again for the rest
+            Range Allocate(uint32_t count);
+
+            // Copies the transforms of commands [first, last), which are drawn as instances of commands[first],
+            // and appends a batch for every page they span
+            void AddBatches(const std::vector<RenderCommand>& commands, uint32_t first, uint32_t last, std::vector<Batch>& batches);
+
+            // Copies pages written since the last upload to the GPU
+            void Upload();
+
+        private:
+            struct Page
+            {
+                UniformBuffer* buffer = nullptr;
+                SharedRef<DescriptorSet> descriptorSet;
+                std::vector<Maths::Matrix4> transforms;
+            };
+
+            void AddPage();
+
+            Shader* m_Shader;
+            uint32_t m_SetIndex;
+
+            std::vector<Page> m_Pages;
+            uint32_t m_CurrentPage = 0;
+            uint32_t m_CurrentPageCount = 0;
+            uint32_t m_FirstDirtyPage = 0;
+        };
+    }
+}
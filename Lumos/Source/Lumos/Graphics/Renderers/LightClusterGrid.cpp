@@ -0,0 +1,210 @@
+#include "Precompiled.h"
+#include "LightClusterGrid.h"
+#include "Core/JobSystem.h"
+
+namespace Lumos::Graphics
+{
+    static_assert(sizeof(LightClusterGrid::ClusterData) == 80 + LightClusterGrid::ClusterCount * sizeof(uint32_t), "ClusterData must match UniformBufferClusters");
+    static_assert(LightClusterGrid::MaxLights <= 0xFFFF && LightClusterGrid::MaxLightIndices <= 0xFFFF + 1, "Cluster entries are packed in 16 bits");
+
+    LightClusterGrid::LightClusterGrid()
+    {
+        m_ClusterData = {};
+        memset(m_ClusterCounts, 0, sizeof(m_ClusterCounts));
+        m_LightIndices.resize(MaxLightIndices);
+    }
+
+    void LightClusterGrid::Build(const Light* lights, uint32_t count, const Maths::Matrix4& view, const Maths::Matrix4& projection, float nearPlane, float farPlane)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        LUMOS_ASSERT(count <= MaxLights, "Too many clustered lights");
+
+        // Orthographic cameras can have a near plane at or behind the camera, slices start just in front of it
+        m_Near = Maths::Max(nearPlane, 0.01f);
+        m_Far = Maths::Max(farPlane, m_Near + 0.01f);
+
+        const float logRange = log(m_Far / m_Near);
+        m_ClusterData.projection = projection;
+        m_ClusterData.depthParams = Maths::Vector4(float(GridZ) / logRange, -float(GridZ) * log(m_Near) / logRange, 0.0f, 0.0f);
+
+        m_LightBounds.clear();
+        for(uint32_t i = 0; i < count; i++)
+        {
+            const Light& light = lights[i];
+            const Maths::Vector4 center = view * Maths::Vector4(light.Position.ToVector3(), 1.0f);
+            const float depth = -center.z;
+
+            LightBounds bounds;
+            bounds.center = Maths::Vector3(center.x, center.y, center.z);
+            bounds.radius = light.Radius;
+
+            if(depth + bounds.radius < m_Near || depth - bounds.radius > m_Far)
+            {
+                // Skipped lights still take a slot so indices match the uploaded light array
+                bounds.minSlice = 1;
+                bounds.maxSlice = 0;
+            }
+            else
+            {
+                bounds.minSlice = SliceOf(depth - bounds.radius);
+                bounds.maxSlice = SliceOf(depth + bounds.radius);
+            }
+
+            m_LightBounds.push_back(bounds);
+        }
+
+        {
+            LUMOS_PROFILE_SCOPE("Bin Slices");
+            System::JobSystem::Context ctx;
+            System::JobSystem::Dispatch(ctx, GridZ, 1, [this](JobDispatchArgs args)
+                { BinSlice(args.jobIndex); });
+            System::JobSystem::Wait(ctx);
+        }
+
+        // Slices were binned independently, their lists are appended in slice order
+        uint32_t offset = 0;
+        {
+            LUMOS_PROFILE_SCOPE("Merge Slices");
+            m_DroppedLightIndexCount = 0;
+
+            for(uint32_t slice = 0; slice < GridZ; slice++)
+            {
+                const auto& sliceIndices = m_SliceIndices[slice];
+                const uint32_t sliceCount = static_cast<uint32_t>(sliceIndices.size());
+                const uint32_t copyCount = Maths::Min(sliceCount, MaxLightIndices - offset);
+
+                if(copyCount > 0)
+                    memcpy(&m_LightIndices[offset], sliceIndices.data(), copyCount * sizeof(uint16_t));
+
+                const uint32_t firstCluster = slice * GridX * GridY;
+                for(uint32_t cluster = firstCluster; cluster < firstCluster + GridX * GridY; cluster++)
+                {
+                    const uint32_t clusterCount = Maths::Min(m_ClusterCounts[cluster], MaxLightIndices - offset);
+                    m_ClusterData.clusters[cluster] = (offset & 0xFFFF) | (clusterCount << 16);
+                    offset += clusterCount;
+                }
+
+                m_DroppedLightIndexCount += sliceCount - copyCount;
+            }
+        }
+
+        m_LightIndexCount = offset;
+    }
+
+    void LightClusterGrid::BinSlice(uint32_t slice)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const float nearDepth = slice == 0 ? m_Near : SliceDepth(slice);
+        const float farDepth = slice == GridZ - 1 ? m_Far : SliceDepth(slice + 1);
+
+        auto& sliceLights = m_SliceLights[slice];
+        auto& sliceIndices = m_SliceIndices[slice];
+        uint32_t* counts = &m_ClusterCounts[slice * GridX * GridY];
+
+        sliceLights.clear();
+        sliceIndices.clear();
+        memset(counts, 0, sizeof(uint32_t) * GridX * GridY);
+
+        // Count the lights in each cluster, then write every cluster's indices contiguously
+        for(uint32_t i = 0; i < static_cast<uint32_t>(m_LightBounds.size()); i++)
+        {
+            const LightBounds& bounds = m_LightBounds[i];
+            if(slice < bounds.minSlice || slice > bounds.maxSlice)
+                continue;
+
+            SliceLight sliceLight;
+            sliceLight.light = static_cast<uint16_t>(i);
+            if(!TileRange(bounds, nearDepth, farDepth, sliceLight))
+                continue;
+
+            for(uint32_t y = sliceLight.minY; y <= sliceLight.maxY; y++)
+                for(uint32_t x = sliceLight.minX; x <= sliceLight.maxX; x++)
+                    counts[y * GridX + x]++;
+
+            sliceLights.push_back(sliceLight);
+        }
+
+        uint32_t offsets[GridX * GridY];
+        uint32_t total = 0;
+        for(uint32_t tile = 0; tile < GridX * GridY; tile++)
+        {
+            offsets[tile] = total;
+            total += counts[tile];
+        }
+
+        sliceIndices.resize(total);
+        for(const SliceLight& sliceLight : sliceLights)
+        {
+            for(uint32_t y = sliceLight.minY; y <= sliceLight.maxY; y++)
+                for(uint32_t x = sliceLight.minX; x <= sliceLight.maxX; x++)
+                    sliceIndices[offsets[y * GridX + x]++] = sliceLight.light;
+        }
+    }
+
+    bool LightClusterGrid::TileRange(const LightBounds& bounds, float nearDepth, float farDepth, SliceLight& sliceLight) const
+    {
+        const float depth = -bounds.center.z;
+        const float minDepth = Maths::Max(nearDepth, depth - bounds.radius);
+        const float maxDepth = Maths::Min(farDepth, depth + bounds.radius);
+        if(minDepth > maxDepth)
+            return false;
+
+        // Half size of the sphere's widest cross section inside the slice
+        float extent = bounds.radius;
+        if(depth < minDepth || depth > maxDepth)
+        {
+            const float offset = depth < minDepth ? minDepth - depth : depth - maxDepth;
+            extent = sqrt(Maths::Max(bounds.radius * bounds.radius - offset * offset, 0.0f));
+        }
+
+        // The projected rectangle of a view space box is bounded by its projected corners
+        Maths::Vector2 minNDC(Maths::M_INFINITY);
+        Maths::Vector2 maxNDC(-Maths::M_INFINITY);
+        for(uint32_t corner = 0; corner < 8; corner++)
+        {
+            const Maths::Vector4 position(bounds.center.x + (corner & 1 ? extent : -extent),
+                bounds.center.y + (corner & 2 ? extent : -extent),
+                corner & 4 ? -maxDepth : -minDepth,
+                1.0f);
+
+            const Maths::Vector4 clip = m_ClusterData.projection * position;
+            if(clip.w <= 0.0f)
+            {
+                minNDC = Maths::Vector2(-1.0f);
+                maxNDC = Maths::Vector2(1.0f);
+                break;
+            }
+
+            const Maths::Vector2 ndc(clip.x / clip.w, clip.y / clip.w);
+            minNDC = Maths::Vector2(Maths::Min(minNDC.x, ndc.x), Maths::Min(minNDC.y, ndc.y));
+            maxNDC = Maths::Vector2(Maths::Max(maxNDC.x, ndc.x), Maths::Max(maxNDC.y, ndc.y));
+        }
+
+        if(maxNDC.x < -1.0f || maxNDC.y < -1.0f || minNDC.x > 1.0f || minNDC.y > 1.0f)
+            return false;
+
+        // Same mapping as the shader, which truncates the clamped tile coordinate
+        auto toTile = [](float ndc, uint32_t gridSize)
+        {
+            const float tile = Maths::Clamp((ndc * 0.5f + 0.5f) * float(gridSize), 0.0f, float(gridSize - 1));
+            return static_cast<uint8_t>(tile);
+        };
+
+        sliceLight.minX = toTile(minNDC.x, GridX);
+        sliceLight.maxX = toTile(maxNDC.x, GridX);
+        sliceLight.minY = toTile(minNDC.y, GridY);
+        sliceLight.maxY = toTile(maxNDC.y, GridY);
+        return true;
+    }
+
+    uint32_t LightClusterGrid::SliceOf(float depth) const
+    {
+        const float slice = log(Maths::Max(depth, 0.0001f)) * m_ClusterData.depthParams.x + m_ClusterData.depthParams.y;
+        return static_cast<uint32_t>(Maths::Clamp(slice, 0.0f, float(GridZ - 1)));
+    }
+
+    float LightClusterGrid::SliceDepth(uint32_t slice) const
+    {
+        return m_Near * pow(m_Far / m_Near, float(slice) / float(GridZ));
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "Maths/Maths.h"
+#include "Graphics/Light.h"
+
+namespace Lumos
+{
+    namespace Graphics
+    {
+        // Bins point and spot lights into view space froxels so the lighting pass only evaluates the lights that
+        // can reach each fragment. The screen is split into GridX * GridY tiles and the view depth into GridZ
+        // exponential slices. Each slice is binned by its own job, then the per slice lists are merged into one
+        // index list that is uploaded with the cluster table.
+        class LUMOS_EXPORT LightClusterGrid
+        {
+        public:
+            // Must match CLUSTER_GRID_X/Y/Z, MAX_CLUSTERED_LIGHTS and MAX_LIGHT_INDICES in DeferredLight.frag.
+            // Both light blocks are 64KB, the uniform block limit of desktop GPUs
+            static const uint32_t GridX = 16;
+            static const uint32_t GridY = 9;
+            static const uint32_t GridZ = 24;
+            static const uint32_t ClusterCount = GridX * GridY * GridZ;
+            static const uint32_t MaxLights = 1024;
+            static const uint32_t MaxLightIndices = 32768;
+
+            // Layout of the UniformBufferClusters block
+            struct ClusterData
+            {
+                Maths::Matrix4 projection;
+                Maths::Vector4 depthParams; // Slice of a view depth is log(depth) * x + y
+                uint32_t clusters[ClusterCount]; // Offset into the light index list in the low 16 bits, light count in the high 16 bits
+            };
+
+            LightClusterGrid();
+            ~LightClusterGrid() = default;
+
+            // Bins lights[0, count) for the camera, lights are referenced by their position in the array
+            void Build(const Light* lights, uint32_t count, const Maths::Matrix4& view, const Maths::Matrix4& projection, float nearPlane, float farPlane);
+
+            const ClusterData& GetClusterData() const { return m_ClusterData; }
+
+            // 16 bit light indices, MaxLightIndices long so the block can always be uploaded whole
+            const uint16_t* GetLightIndices() const { return m_LightIndices.data(); }
+            uint32_t GetLightIndexCount() const { return m_LightIndexCount; }
+
+            // Indices that did not fit in the index list this frame, those lights are missing from their clusters
+            uint32_t GetDroppedLightIndexCount() const { return m_DroppedLightIndexCount; }
+
+        private:
+            struct LightBounds
+            {
+                Maths::Vector3 center; // View space
+                float radius;
+                uint32_t minSlice;
+                uint32_t maxSlice;
+            };
+
+            // Light overlapping one slice and the tiles it covers there
+            struct SliceLight
+            {
+                uint16_t light;
+                uint8_t minX, maxX, minY, maxY;
+            };
+
+            void BinSlice(uint32_t slice);
+            bool TileRange(const LightBounds& bounds, float nearDepth, float farDepth, SliceLight& sliceLight) const;
+            uint32_t SliceOf(float depth) const;
+            float SliceDepth(uint32_t slice) const;
+
+            ClusterData m_ClusterData;
+            float m_Near = 0.1f;
+            float m_Far = 1000.0f;
+
+            std::vector<LightBounds> m_LightBounds;
+
+            // Written by the slice jobs, each owns its slice's entries
+            std::vector<SliceLight> m_SliceLights[GridZ];
+            std::vector<uint16_t> m_SliceIndices[GridZ];
+            uint32_t m_ClusterCounts[ClusterCount];
+
+            std::vector<uint16_t> m_LightIndices;
+            uint32_t m_LightIndexCount = 0;
+            uint32_t m_DroppedLightIndexCount = 0;
+        };
+    }
+}
@@ -0,0 +1,141 @@
+#include "Precompiled.h"
+#include "ParallelCommandRecorder.h"
+#include "Graphics/RHI/CommandBuffer.h"
+#include "Graphics/RHI/GraphicsContext.h"
+#include "Graphics/RHI/Renderer.h"
+#include "Graphics/RHI/Swapchain.h"
+#include "Core/JobSystem.h"
+
+namespace Lumos::Graphics
+{
+    ParallelCommandRecorder::ParallelCommandRecorder(uint32_t minItemsPerRange)
+        : m_MinItemsPerRange(Maths::Max(minItemsPerRange, 1u))
+    {
+    }
+
+    ParallelCommandRecorder::~ParallelCommandRecorder()
+    {
+        for(auto& commandBuffers : m_CommandBuffers)
+        {
+            for(auto commandBuffer : commandBuffers)
+                delete commandBuffer;
+        }
+    }
+
+    bool ParallelCommandRecorder::IsParallel() const
+    {
+        // OpenGL contexts are current on the main thread only
+        return GraphicsContext::GetRenderAPI() == RenderAPI::VULKAN;
+    }
+
+    void ParallelCommandRecorder::Reset()
+    {
+        m_Passes.clear();
+        m_Ranges.clear();
+        m_Record = nullptr;
+    }
+
+    uint32_t ParallelCommandRecorder::AddPass(RenderPass* renderPass, Framebuffer* framebuffer, uint32_t width, uint32_t height, uint32_t itemCount)
+    {
+        Pass pass;
+        pass.renderPass = renderPass;
+        pass.framebuffer = framebuffer;
+        pass.width = width;
+        pass.height = height;
+        pass.itemCount = itemCount;
+        pass.firstRange = static_cast<uint32_t>(m_Ranges.size());
+        pass.rangeCount = 0;
+
+        const uint32_t passIndex = static_cast<uint32_t>(m_Passes.size());
+
+        if(IsParallel() && itemCount > 0)
+        {
+            // One range per worker at most, smaller ones cost more to begin and execute than they save
+            const uint32_t maxRanges = Maths::Max(System::JobSystem::GetThreadCount(), 1u);
+            pass.rangeCount = Maths::Min((itemCount + m_MinItemsPerRange - 1) / m_MinItemsPerRange, maxRanges);
+
+            const uint32_t itemsPerRange = (itemCount + pass.rangeCount - 1) / pass.rangeCount;
+            for(uint32_t first = 0; first < itemCount; first += itemsPerRange)
+            {
+                Range range {};
+                range.pass = passIndex;
+                range.first = first;
+                range.last = Maths::Min(first + itemsPerRange, itemCount);
+                m_Ranges.push_back(range);
+            }
+
+            pass.rangeCount = static_cast<uint32_t>(m_Ranges.size()) - pass.firstRange;
+        }
+
+        m_Passes.push_back(pass);
+        return passIndex;
+    }
+
+    void ParallelCommandRecorder::Record(const RecordFunction& record)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        m_Record = record;
+
+        if(m_Ranges.empty())
+            return;
+
+        const uint32_t bufferIndex = Renderer::GetSwapchain()->GetCurrentBufferIndex();
+        if(m_CommandBuffers.size() <= bufferIndex)
+            m_CommandBuffers.resize(Maths::Max(static_cast<uint32_t>(Renderer::GetSwapchain()->GetSwapchainBufferCount()), bufferIndex + 1));
+
+        auto& commandBuffers = m_CommandBuffers[bufferIndex];
+        while(commandBuffers.size() < m_Ranges.size())
+        {
+            CommandBuffer* commandBuffer = CommandBuffer::Create();
+            commandBuffer->InitWithOwnPool(false);
+            commandBuffers.push_back(commandBuffer);
+        }
+
+        for(size_t i = 0; i < m_Ranges.size(); i++)
+        {
+            m_Ranges[i].commandBuffer = commandBuffers[i];
+            m_Ranges[i].stats = Engine::Stats();
+        }
+
+        System::JobSystem::Context ctx;
+        System::JobSystem::Dispatch(ctx, static_cast<uint32_t>(m_Ranges.size()), 1, [this](JobDispatchArgs args)
+                                    { RecordRange(m_Ranges[args.jobIndex]); });
+        System::JobSystem::Wait(ctx);
+
+        for(auto& range : m_Ranges)
+            Engine::Get().AddStatistics(range.stats);
+    }
+
+    void ParallelCommandRecorder::RecordRange(Range& range)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const Pass& pass = m_Passes[range.pass];
+
+        // Counters go to the range and are added to the frame's once every range is recorded
+        Engine::Stats* previousStats = Engine::SetThreadStatistics(&range.stats);
+
+        // Dynamic state is not inherited from the primary buffer
+        range.commandBuffer->BeginRecordingSecondary(pass.renderPass, pass.framebuffer);
+        range.commandBuffer->UpdateViewport(pass.width, pass.height);
+        m_Record(range.commandBuffer, range.pass, range.first, range.last);
+        range.commandBuffer->EndRecording();
+
+        Engine::SetThreadStatistics(previousStats);
+    }
+
+    void ParallelCommandRecorder::Execute(uint32_t passIndex, CommandBuffer* primaryCmdBuffer)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const Pass& pass = m_Passes[passIndex];
+
+        if(!IsParallel())
+        {
+            if(pass.itemCount > 0)
+                m_Record(primaryCmdBuffer, passIndex, 0, pass.itemCount);
+            return;
+        }
+
+        for(uint32_t i = 0; i < pass.rangeCount; i++)
+            m_Ranges[pass.firstRange + i].commandBuffer->ExecuteSecondary(primaryCmdBuffer);
+    }
+}
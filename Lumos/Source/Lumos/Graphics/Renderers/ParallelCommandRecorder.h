@@ -0,0 +1,80 @@
+#pragma once
+#include "Core/Engine.h"
+#include "Graphics/RHI/RenderPass.h"
+
+#include <functional>
+
+namespace Lumos
+{
+    namespace Graphics
+    {
+        class CommandBuffer;
+        class Framebuffer;
+
+        // Records the draws of one or more render passes on job system workers.
+        // Each pass's items are split into consecutive ranges, every range is recorded into a secondary command buffer
+        // with its own command pool, and the ranges are executed in order into the primary buffer inside the pass.
+        // Only Vulkan records in parallel, other APIs record every pass into the primary buffer when it is executed
+        class LUMOS_EXPORT ParallelCommandRecorder
+        {
+        public:
+            // Records items [first, last) of pass into commandBuffer. Bound state does not carry over between calls
+            typedef std::function<void(CommandBuffer* commandBuffer, uint32_t pass, uint32_t first, uint32_t last)> RecordFunction;
+
+            // Passes are not split into ranges of fewer than minItemsPerRange items
+            ParallelCommandRecorder(uint32_t minItemsPerRange = 64);
+            ~ParallelCommandRecorder();
+
+            ParallelCommandRecorder(ParallelCommandRecorder const&) = delete;
+            ParallelCommandRecorder& operator=(ParallelCommandRecorder const&) = delete;
+
+            bool IsParallel() const;
+
+            // Passes executed by this recorder must be begun with these contents
+            SubPassContents GetSubPassContents() const { return IsParallel() ? SECONDARY : INLINE; }
+
+            // Called once per frame, before any AddPass
+            void Reset();
+
+            // Returns the index of the pass
+            uint32_t AddPass(RenderPass* renderPass, Framebuffer* framebuffer, uint32_t width, uint32_t height, uint32_t itemCount);
+
+            // Records every added pass and waits for the workers. record must stay valid until the passes are executed
+            void Record(const RecordFunction& record);
+
+            // Called between beginning and ending pass on primaryCmdBuffer
+            void Execute(uint32_t pass, CommandBuffer* primaryCmdBuffer);
+
+        private:
+            struct Pass
+            {
+                RenderPass* renderPass;
+                Framebuffer* framebuffer;
+                uint32_t width;
+                uint32_t height;
+                uint32_t itemCount;
+                uint32_t firstRange;
+                uint32_t rangeCount;
+            };
+
+            struct Range
+            {
+                uint32_t pass;
+                uint32_t first;
+                uint32_t last;
+                CommandBuffer* commandBuffer;
+                Engine::Stats stats;
+            };
+
+            void RecordRange(Range& range);
+
+            uint32_t m_MinItemsPerRange;
+            std::vector<Pass> m_Passes;
+            std::vector<Range> m_Ranges;
+            RecordFunction m_Record;
+
+            // Per swapchain buffer, buffers in use by a frame are not recorded again until it comes around
+            std::vector<std::vector<CommandBuffer*>> m_CommandBuffers;
+        };
+    }
+}
@@ -0,0 +1,75 @@
+#include "Precompiled.h"
+#include "RenderCommand.h"
+
+namespace Lumos::Graphics
+{
+    namespace
+    {
+        uint64_t HashPointer16(const void* pointer)
+        {
+            // Fibonacci hashing, the top bits of the product depend on every bit of the address
+            const uint64_t value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer));
+            return (value * 0x9E3779B97F4A7C15ull) >> 48;
+        }
+    }
+
+    uint64_t RenderSortKey::Make(const Shader* shader, uint32_t pipelineFlags, const Material* material, const Mesh* mesh, float depth)
+    {
+        const uint64_t pipelineBits = (HashPointer16(shader) & ~0x3ull) | (pipelineFlags & 0x3u);
+        const uint64_t materialBits = HashPointer16(material);
+        const uint64_t meshBits = HashPointer16(mesh);
+        const uint64_t depthBits = static_cast<uint64_t>(Maths::Clamp(depth, 0.0f, 1.0f) * 65535.0f);
+
+        return (pipelineBits << 48) | (materialBits << 32) | (meshBits << 16) | depthBits;
+    }
+
+    void RenderCommandSorter::Sort(std::vector<RenderCommand>& commands)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const uint32_t count = static_cast<uint32_t>(commands.size());
+        if(count < 2)
+            return;
+
+        m_Items.resize(count);
+        m_Scratch.resize(count);
+
+        uint64_t differingBits = 0;
+        for(uint32_t i = 0; i < count; i++)
+        {
+            m_Items[i] = { commands[i].sortKey, i };
+            differingBits |= commands[i].sortKey ^ commands[0].sortKey;
+        }
+
+        if(differingBits == 0)
+            return;
+
+        for(uint32_t shift = 0; shift < 64; shift += 8)
+        {
+            if(((differingBits >> shift) & 0xff) == 0)
+                continue;
+
+            uint32_t offsets[256] = {};
+            for(const SortItem& item : m_Items)
+                offsets[(item.key >> shift) & 0xff]++;
+
+            uint32_t total = 0;
+            for(uint32_t& offset : offsets)
+            {
+                const uint32_t bucketCount = offset;
+                offset = total;
+                total += bucketCount;
+            }
+
+            for(const SortItem& item : m_Items)
+                m_Scratch[offsets[(item.key >> shift) & 0xff]++] = item;
+
+            m_Items.swap(m_Scratch);
+        }
+
+        m_Sorted.resize(count);
+        for(uint32_t i = 0; i < count; i++)
+            m_Sorted[i] = commands[m_Items[i].index];
+
+        commands.swap(m_Sorted);
+    }
+}
@@ -17,6 +17,37 @@ namespace Lumos
             Maths::Matrix4 transform;
             Maths::Matrix4 textureMatrix;
             bool animated = false;
+            uint64_t sortKey = 0; // See RenderSortKey
+        };
+
+        // 64 bit draw order key, from most to least significant: pipeline state, material, mesh, depth.
+        // Sorting by it groups draws sharing state so redundant binds can be skipped, front to back within a group.
+        // Each field is a 16 bit hash, a collision only costs an extra bind since submission compares the real state
+        namespace RenderSortKey
+        {
+            // pipelineFlags holds the low 2 bits of render state not captured by the shader (cull mode, blending).
+            // depth is 0 at the camera and 1 at the far plane
+            LUMOS_EXPORT uint64_t Make(const Shader* shader, uint32_t pipelineFlags, const Material* material, const Mesh* mesh, float depth);
+        }
+
+        // Stable LSD radix sort of render commands by sortKey.
+        // Sorts key/index pairs a byte at a time, skipping bytes every key shares, then moves each command once.
+        // Buffers are kept between frames so sorting does not allocate once the queue size settles
+        class LUMOS_EXPORT RenderCommandSorter
+        {
+        public:
+            void Sort(std::vector<RenderCommand>& commands);
+
+        private:
+            struct SortItem
+            {
+                uint64_t key;
+                uint32_t index;
+            };
+
+            std::vector<SortItem> m_Items;
+            std::vector<SortItem> m_Scratch;
+            std::vector<RenderCommand> m_Sorted;
         };
     }
 }
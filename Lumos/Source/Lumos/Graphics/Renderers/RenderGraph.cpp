@@ -3,9 +3,16 @@
 #include "Graphics/GBuffer.h"
 #include "Graphics/Renderers/IRenderer.h"
 #include "Graphics/Renderers/DebugRenderer.h"
+#include "Graphics/Renderers/ShadowRenderer.h"
+#include "Graphics/Camera/Camera.h"
+#include "Graphics/RHI/Swapchain.h"
+#include "Graphics/RHI/GraphicsContext.h"
+#include "Maths/Transform.h"
 
 #include "Events/ApplicationEvent.h"
 
+#include <imgui/imgui.h>
+
 namespace Lumos::Graphics
 {
     RenderGraph::RenderGraph(uint32_t width, uint32_t height)
@@ -19,6 +26,9 @@ namespace Lumos::Graphics
 
     RenderGraph::~RenderGraph()
     {
+        for(auto& transient : m_TransientTextures)
+            delete transient.texture;
+
         delete m_GBuffer;
         for(auto renderer : m_Renderers)
         {
@@ -33,6 +43,20 @@ namespace Lumos::Graphics
         LUMOS_PROFILE_FUNCTION();
         SetScreenBufferSize(width, height);
         m_GBuffer->UpdateTextureSize(width, height);
+
+        // Screen sized transient textures are rebuilt in place, so renderers resizing after this see the new size
+        for(auto& transient : m_TransientTextures)
+        {
+            if(transient.desc.width != 0 && transient.desc.height != 0)
+                continue;
+
+            if(transient.desc.depth)
+                static_cast<TextureDepth*>(transient.texture)->Resize(m_ScreenBufferWidth, m_ScreenBufferHeight);
+            else
+                static_cast<Texture2D*>(transient.texture)->BuildTexture(transient.desc.format, m_ScreenBufferWidth, m_ScreenBufferHeight, false, false, false);
+        }
+
+        UpdateTransientMemory();
     }
 
     void RenderGraph::EnableDebugRenderer(bool enable)
@@ -48,14 +72,64 @@ namespace Lumos::Graphics
         LUMOS_PROFILE_FUNCTION();
         DebugRenderer::Reset();
 
-        for(auto renderer : m_Renderers)
+        if(!m_Compiled)
+            Compile();
+
+        UpdateVisibility(scene);
+
+        for(size_t i = 0; i < m_Renderers.size(); i++)
         {
-            renderer->BeginScene(scene, m_OverrideCamera, m_OverrideCameraTransform);
+            // Renderers whose passes were all culled have nothing to submit to
+            if(!m_RendererCulled[i])
+                m_Renderers[i]->BeginScene(scene, m_OverrideCamera, m_OverrideCameraTransform);
         }
 
         DebugRenderer::BeginScene(scene, m_OverrideCamera, m_OverrideCameraTransform);
     }
 
+    void RenderGraph::UpdateVisibility(Scene* scene)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        m_Visibility.Gather(scene);
+
+        if(!scene)
+            return;
+
+        Camera* camera = m_OverrideCamera;
+        Maths::Transform* cameraTransform = m_OverrideCameraTransform;
+
+        if(!camera)
+        {
+            auto& registry = scene->GetRegistry();
+            auto cameraView = registry.view<Camera>();
+            if(!cameraView.empty())
+            {
+                camera = &cameraView.get<Camera>(cameraView.front());
+                cameraTransform = registry.try_get<Maths::Transform>(cameraView.front());
+            }
+        }
+
+        if(!camera || !cameraTransform)
+            return;
+
+        m_Visibility.SetView(RenderVisibility::CameraView, camera->GetFrustum(cameraTransform->GetWorldMatrix().Inverse()));
+
+        static_assert(RenderVisibility::FirstShadowView + SHADOWMAP_MAX <= RenderVisibility::MaxViews, "Not enough visibility views for every shadow cascade");
+
+        // Cascades need their matrices before culling, so the shadow renderer prepares them ahead of BeginScene
+        if(m_ShadowRenderer && m_ShadowRenderer->PrepareCascades(scene, m_OverrideCamera, m_OverrideCameraTransform))
+        {
+            for(uint32_t i = 0; i < m_ShadowRenderer->GetShadowMapNum(); i++)
+            {
+                Maths::Frustum frustum;
+                frustum.Define(m_ShadowRenderer->GetShadowProjView()[i]);
+                m_Visibility.SetView(RenderVisibility::FirstShadowView + i, frustum);
+            }
+        }
+
+        m_Visibility.Cull();
+    }
+
     void RenderGraph::SetRenderTarget(Graphics::Texture* texture, bool onlyIfTargetsScreen, bool rebuildFramebuffer)
     {
         LUMOS_PROFILE_FUNCTION();
@@ -71,12 +145,453 @@ namespace Lumos::Graphics
     void RenderGraph::OnRender()
     {
         LUMOS_PROFILE_FUNCTION();
+        if(!m_Compiled)
+            Compile();
+
+        auto commandBuffer = Renderer::GetSwapchain()->GetCurrentCommandBuffer();
+
+        for(auto& pass : m_Passes)
+        {
+            if(pass.culled)
+                continue;
+
+            if(pass.barrierSrcUsage)
+                Renderer::ResourceBarrier(commandBuffer, pass.barrierSrcUsage, pass.barrierDstUsage);
+
+            pass.execute();
+        }
+    }
+
+    Texture* RenderGraph::GetTexture(const std::string& name) const
+    {
+        auto it = m_ResourceIndices.find(name);
+        return it != m_ResourceIndices.end() ? m_Resources[it->second].texture : nullptr;
+    }
+
+    uint32_t RenderGraph::GetResourceIndex(const std::string& name)
+    {
+        auto it = m_ResourceIndices.find(name);
+        if(it != m_ResourceIndices.end())
+            return it->second;
+
+        const uint32_t index = static_cast<uint32_t>(m_Resources.size());
+        m_Resources.emplace_back();
+        m_Resources.back().name = name;
+        m_ResourceIndices[name] = index;
+        return index;
+    }
+
+    void RenderGraph::Compile()
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        // Transient textures can be reassigned or released, frames in flight may still use them
+        if(!m_TransientTextures.empty())
+            GraphicsContext::GetContext()->WaitIdle();
+
+        m_Passes.clear();
+        m_Resources.clear();
+        m_ResourceIndices.clear();
+
+        m_Resources.reserve(16);
+        m_Resources[GetResourceIndex(SceneColour)].output = true;
+        m_Resources[GetResourceIndex(SceneDepth)].texture = reinterpret_cast<Texture*>(m_GBuffer->GetDepthTexture());
+
+        for(auto renderer : m_Renderers)
+        {
+            RenderGraphBuilder builder(this, renderer);
+            renderer->DeclarePasses(builder);
+        }
+
+        CullPasses();
+        ComputeBarriers();
+        AllocateTransientTextures();
+
+        m_RendererCulled.assign(m_Renderers.size(), true);
+        for(auto& pass : m_Passes)
+        {
+            if(pass.culled)
+                continue;
+
+            for(size_t i = 0; i < m_Renderers.size(); i++)
+            {
+                if(m_Renderers[i] == pass.renderer)
+                    m_RendererCulled[i] = false;
+            }
+        }
+
+        m_Compiled = true;
+
         for(auto renderer : m_Renderers)
+            renderer->OnGraphCompiled();
+    }
+
+    void RenderGraph::CullPasses()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        for(uint32_t i = 0; i < m_Passes.size(); i++)
+        {
+            for(auto& access : m_Passes[i].accesses)
+            {
+                if(access.write)
+                {
+                    m_Passes[i].refCount++;
+                    m_Resources[access.resource].writers.push_back(i);
+                }
+                else
+                    m_Resources[access.resource].refCount++;
+            }
+        }
+
+        // Passes that write nothing and resources nothing reads start the walk back from the outputs
+        std::vector<uint32_t> unreferenced;
+        for(uint32_t i = 0; i < m_Resources.size(); i++)
+        {
+            if(m_Resources[i].output)
+                m_Resources[i].refCount++;
+
+            if(m_Resources[i].refCount == 0)
+                unreferenced.push_back(i);
+        }
+
+        auto cullPass = [&](Pass& pass)
+        {
+            pass.culled = true;
+            for(auto& access : pass.accesses)
+            {
+                if(!access.write && --m_Resources[access.resource].refCount == 0)
+                    unreferenced.push_back(access.resource);
+            }
+        };
+
+        for(auto& pass : m_Passes)
+        {
+            if(pass.refCount == 0 && !pass.sideEffect)
+                cullPass(pass);
+        }
+
+        while(!unreferenced.empty())
+        {
+            const uint32_t resource = unreferenced.back();
+            unreferenced.pop_back();
+
+            for(uint32_t writer : m_Resources[resource].writers)
+            {
+                Pass& pass = m_Passes[writer];
+                if(!pass.culled && --pass.refCount == 0 && !pass.sideEffect)
+                    cullPass(pass);
+            }
+        }
+    }
+
+    void RenderGraph::ComputeBarriers()
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        // Per resource, the usage of its last write and the reads since that have already waited for it
+        std::vector<uint32_t> writeUsage(m_Resources.size(), 0);
+        std::vector<uint32_t> readUsage(m_Resources.size(), 0);
+
+        for(int32_t i = 0; i < static_cast<int32_t>(m_Passes.size()); i++)
         {
-            renderer->RenderScene();
+            Pass& pass = m_Passes[i];
+            if(pass.culled)
+                continue;
+
+            for(auto& access : pass.accesses)
+            {
+                Resource& resource = m_Resources[access.resource];
+                if(resource.firstPass < 0)
+                    resource.firstPass = i;
+                resource.lastPass = i;
+
+                if(access.write)
+                {
+                    // Earlier writes and reads have to finish before it is written again
+                    if(writeUsage[access.resource] || readUsage[access.resource])
+                    {
+                        pass.barrierSrcUsage |= writeUsage[access.resource] | readUsage[access.resource];
+                        pass.barrierDstUsage |= access.usage;
+                    }
+
+                    writeUsage[access.resource] = access.usage;
+                    readUsage[access.resource] = 0;
+                }
+                else if(writeUsage[access.resource] && (readUsage[access.resource] & access.usage) != access.usage)
+                {
+                    pass.barrierSrcUsage |= writeUsage[access.resource];
+                    pass.barrierDstUsage |= access.usage;
+                    readUsage[access.resource] |= access.usage;
+                }
+            }
         }
     }
 
+    void RenderGraph::AllocateTransientTextures()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        for(auto& transient : m_TransientTextures)
+        {
+            transient.used = false;
+            transient.lastPass = -1;
+        }
+
+        std::vector<Resource*> transients;
+        for(auto& resource : m_Resources)
+        {
+            if(!resource.transient || resource.firstPass < 0)
+                continue;
+
+            transients.push_back(&resource);
+        }
+
+        std::sort(transients.begin(), transients.end(), [](const Resource* a, const Resource* b)
+            { return a->firstPass < b->firstPass; });
+
+        for(auto resource : transients)
+        {
+            // Reuse a texture of the same size and format whose last user runs before this one's first
+            TransientTexture* match = nullptr;
+            for(auto& transient : m_TransientTextures)
+            {
+                const auto& desc = transient.desc;
+                if(transient.lastPass < resource->firstPass && desc.format == resource->desc.format && desc.width == resource->desc.width && desc.height == resource->desc.height && desc.depth == resource->desc.depth)
+                {
+                    match = &transient;
+                    break;
+                }
+            }
+
+            if(!match)
+            {
+                TransientTexture transient;
+                transient.desc = resource->desc;
+
+                const auto desc = GetResolvedDesc(resource->desc);
+                if(desc.depth)
+                    transient.texture = TextureDepth::Create(desc.width, desc.height);
+                else
+                {
+                    Texture2D* texture = Texture2D::Create();
+                    texture->BuildTexture(desc.format, desc.width, desc.height, false, false, false);
+                    transient.texture = texture;
+                }
+
+                m_TransientTextures.push_back(transient);
+                match = &m_TransientTextures.back();
+            }
+
+            match->used = true;
+            match->lastPass = resource->lastPass;
+            resource->texture = match->texture;
+        }
+
+        // Textures no resource was assigned this time are released
+        for(size_t i = 0; i < m_TransientTextures.size();)
+        {
+            if(!m_TransientTextures[i].used)
+            {
+                delete m_TransientTextures[i].texture;
+                m_TransientTextures.erase(m_TransientTextures.begin() + i);
+                continue;
+            }
+
+            i++;
+        }
+
+        UpdateTransientMemory();
+    }
+
+    void RenderGraph::UpdateTransientMemory()
+    {
+        m_TransientMemoryRequested = 0;
+        for(auto& resource : m_Resources)
+        {
+            if(resource.transient && resource.texture)
+                m_TransientMemoryRequested += GetTextureMemory(GetResolvedDesc(resource.desc));
+        }
+
+        m_TransientMemoryAllocated = 0;
+        for(auto& transient : m_TransientTextures)
+            m_TransientMemoryAllocated += GetTextureMemory(GetResolvedDesc(transient.desc));
+    }
+
+    RenderGraphTextureDesc RenderGraph::GetResolvedDesc(const RenderGraphTextureDesc& desc) const
+    {
+        RenderGraphTextureDesc resolved = desc;
+        if(resolved.width == 0 || resolved.height == 0)
+        {
+            resolved.width = m_ScreenBufferWidth;
+            resolved.height = m_ScreenBufferHeight;
+        }
+        return resolved;
+    }
+
+    static std::string ResourceUsageToString(uint32_t usage)
+    {
+        std::string result;
+        if(usage & RESOURCE_USAGE_COLOUR_ATTACHMENT)
+            result += "Colour ";
+        if(usage & RESOURCE_USAGE_DEPTH_ATTACHMENT)
+            result += "Depth ";
+        if(usage & RESOURCE_USAGE_SHADER_READ)
+            result += "Shader ";
+        return result.empty() ? "None" : result;
+    }
+
+    void RenderGraph::OnImGuiGraph()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(!ImGui::TreeNode("Compiled Graph"))
+            return;
+
+        const float toMB = 1.0f / (1024.0f * 1024.0f);
+        ImGui::Text("Transient memory : %.2f MB requested, %.2f MB allocated, %.2f MB saved by aliasing",
+            m_TransientMemoryRequested * toMB,
+            m_TransientMemoryAllocated * toMB,
+            (m_TransientMemoryRequested - m_TransientMemoryAllocated) * toMB);
+
+        if(ImGui::Button("Recompile"))
+            m_Compiled = false;
+
+        if(ImGui::TreeNodeEx("Passes", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            for(auto& pass : m_Passes)
+            {
+                ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(pass.culled ? ImGuiCol_TextDisabled : ImGuiCol_Text));
+                const bool open = ImGui::TreeNode(&pass, "%s%s", pass.name.c_str(), pass.culled ? " (culled)" : "");
+                ImGui::PopStyleColor();
+
+                if(!open)
+                    continue;
+
+                if(pass.barrierSrcUsage)
+                    ImGui::Text("Barrier : %s-> %s", ResourceUsageToString(pass.barrierSrcUsage).c_str(), ResourceUsageToString(pass.barrierDstUsage).c_str());
+
+                for(auto& access : pass.accesses)
+                    ImGui::BulletText("%s %s (%s)", access.write ? "Writes" : "Reads", m_Resources[access.resource].name.c_str(), ResourceUsageToString(access.usage).c_str());
+
+                ImGui::TreePop();
+            }
+            ImGui::TreePop();
+        }
+
+        if(ImGui::TreeNode("Resources"))
+        {
+            ImGui::Columns(3);
+            ImGui::TextUnformatted("Name");
+            ImGui::NextColumn();
+            ImGui::TextUnformatted("Lifetime");
+            ImGui::NextColumn();
+            ImGui::TextUnformatted("Storage");
+            ImGui::NextColumn();
+            ImGui::Separator();
+
+            for(auto& resource : m_Resources)
+            {
+                ImGui::TextUnformatted(resource.name.c_str());
+                ImGui::NextColumn();
+
+                if(resource.firstPass < 0)
+                    ImGui::TextUnformatted("Unused");
+                else
+                    ImGui::Text("%s - %s", m_Passes[resource.firstPass].name.c_str(), m_Passes[resource.lastPass].name.c_str());
+                ImGui::NextColumn();
+
+                if(!resource.transient)
+                    ImGui::TextUnformatted(resource.output ? "Imported, output" : "Imported");
+                else if(resource.texture)
+                {
+                    const auto desc = GetResolvedDesc(resource.desc);
+                    ImGui::Text("Transient %ux%u, %.2f MB, texture %p", desc.width, desc.height, GetTextureMemory(desc) * toMB, (void*)resource.texture);
+                }
+                else
+                    ImGui::TextUnformatted("Transient, not allocated");
+                ImGui::NextColumn();
+            }
+
+            ImGui::Columns(1);
+            ImGui::TreePop();
+        }
+
+        ImGui::TreePop();
+    }
+
+    uint64_t RenderGraph::GetTextureMemory(const RenderGraphTextureDesc& desc) const
+    {
+        uint32_t bytesPerPixel = 4;
+        switch(desc.format)
+        {
+        case TextureFormat::R8:
+        case TextureFormat::STENCIL:
+            bytesPerPixel = 1;
+            break;
+        case TextureFormat::RG8:
+            bytesPerPixel = 2;
+            break;
+        case TextureFormat::RGB16:
+        case TextureFormat::RGBA16:
+            bytesPerPixel = 8;
+            break;
+        case TextureFormat::RGB32:
+        case TextureFormat::RGBA32:
+            bytesPerPixel = 16;
+            break;
+        default:
+            break;
+        }
+
+        return uint64_t(desc.width) * desc.height * (desc.depth ? 4 : bytesPerPixel);
+    }
+
+    RenderGraphBuilder::RenderGraphBuilder(RenderGraph* graph, IRenderer* renderer)
+        : m_Graph(graph)
+        , m_Renderer(renderer)
+    {
+    }
+
+    void RenderGraphBuilder::AddPass(const std::string& name, const std::function<void()>& execute)
+    {
+        m_Pass = static_cast<int32_t>(m_Graph->m_Passes.size());
+        m_Graph->m_Passes.emplace_back();
+
+        auto& pass = m_Graph->m_Passes.back();
+        pass.name = name;
+        pass.execute = execute;
+        pass.renderer = m_Renderer;
+    }
+
+    void RenderGraphBuilder::CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+    {
+        auto& resource = m_Graph->m_Resources[m_Graph->GetResourceIndex(name)];
+        LUMOS_ASSERT(!resource.texture, "Transient texture declared with the name of an imported one");
+        resource.transient = true;
+        resource.desc = desc;
+    }
+
+    void RenderGraphBuilder::Import(const std::string& name, Texture* texture)
+    {
+        m_Graph->m_Resources[m_Graph->GetResourceIndex(name)].texture = texture;
+    }
+
+    void RenderGraphBuilder::Read(const std::string& name, uint32_t usage)
+    {
+        LUMOS_ASSERT(m_Pass >= 0, "Resource read declared before AddPass");
+        m_Graph->m_Passes[m_Pass].accesses.push_back({ m_Graph->GetResourceIndex(name), usage, false });
+    }
+
+    void RenderGraphBuilder::Write(const std::string& name, uint32_t usage)
+    {
+        LUMOS_ASSERT(m_Pass >= 0, "Resource write declared before AddPass");
+        m_Graph->m_Passes[m_Pass].accesses.push_back({ m_Graph->GetResourceIndex(name), usage, true });
+    }
+
+    void RenderGraphBuilder::SetSideEffect()
+    {
+        LUMOS_ASSERT(m_Pass >= 0, "SetSideEffect called before AddPass");
+        m_Graph->m_Passes[m_Pass].sideEffect = true;
+    }
+
     void RenderGraph::OnUpdate(const TimeStep& timeStep, Scene* scene)
     {
     }
@@ -104,6 +619,8 @@ namespace Lumos::Graphics
     void RenderGraph::OnImGui()
     {
         LUMOS_PROFILE_FUNCTION();
+        OnImGuiGraph();
+
         for(auto renderer : m_Renderers)
         {
             renderer->OnImGui();
@@ -112,6 +629,14 @@ namespace Lumos::Graphics
 
     void RenderGraph::OnNewScene(Scene* scene)
     {
+        LUMOS_PROFILE_FUNCTION();
+        if(!m_PrewarmPipelines)
+            return;
+
+        for(auto renderer : m_Renderers)
+        {
+            renderer->PrewarmPipelines(scene);
+        }
     }
 
     void RenderGraph::Reset()
@@ -124,6 +649,7 @@ namespace Lumos::Graphics
     void RenderGraph::AddRenderer(Graphics::IRenderer* renderer)
     {
         m_Renderers.push_back(renderer);
+        m_Compiled = false;
         //SortRenderers();
     }
 
@@ -131,6 +657,7 @@ namespace Lumos::Graphics
     {
         renderer->SetRenderPriority(renderPriority);
         m_Renderers.push_back(renderer);
+        m_Compiled = false;
         //SortRenderers();
     }
 
@@ -139,5 +666,6 @@ namespace Lumos::Graphics
         LUMOS_PROFILE_FUNCTION();
         std::sort(m_Renderers.begin(), m_Renderers.end(), [](Graphics::IRenderer* a, Graphics::IRenderer* b)
             { return a->GetRenderPriority() > b->GetRenderPriority(); });
+        m_Compiled = false;
     }
 }
@@ -1,5 +1,10 @@
 #pragma once
 #include "Scene/Scene.h"
+#include "RenderVisibility.h"
+#include "Graphics/RHI/Renderer.h"
+#include "Graphics/RHI/Texture.h"
+
+#include <functional>
 
 namespace Lumos
 {
@@ -28,10 +33,66 @@ namespace Lumos
         class TextureDepthArray;
         class ShadowRenderer;
         class SkyboxRenderer;
+        class RenderGraph;
+
+        struct RenderGraphTextureDesc
+        {
+            TextureFormat format = TextureFormat::RGBA8;
+
+            // Zero follows the graph's screen size, the texture is rebuilt in place when the graph is resized
+            uint32_t width = 0;
+            uint32_t height = 0;
+            bool depth = false;
+        };
+
+        // Passed to IRenderer::DeclarePasses when the graph is compiled
+        class LUMOS_EXPORT RenderGraphBuilder
+        {
+        public:
+            RenderGraphBuilder(RenderGraph* graph, IRenderer* renderer);
+
+            // Starts a pass, the calls that follow declare the resources it uses.
+            // Passes run in the order they are added
+            void AddPass(const std::string& name, const std::function<void()>& execute);
+
+            // A texture owned by the graph that only lives between the first and last pass using it.
+            // Transient textures whose lifetimes don't overlap share the same texture, fetch it with RenderGraph::GetTexture
+            void CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+
+            // A texture or buffer owned elsewhere. texture can be nullptr for resources only used to order passes
+            void Import(const std::string& name, Texture* texture = nullptr);
+
+            // Usage is a combination of ResourceUsage flags. Undeclared resources are imported on first use
+            void Read(const std::string& name, uint32_t usage = RESOURCE_USAGE_SHADER_READ);
+            void Write(const std::string& name, uint32_t usage);
+
+            // The pass is kept even if nothing reads what it writes
+            void SetSideEffect();
+
+        private:
+            RenderGraph* m_Graph;
+            IRenderer* m_Renderer;
+            int32_t m_Pass = -1;
+        };
 
+        // Renderers declare their passes and the resources each reads and writes.
+        // Compiling the graph culls passes whose writes are never read, works out the barriers needed between passes
+        // and assigns transient textures to shared allocations
         class RenderGraph
         {
+            friend class RenderGraphBuilder;
+
         public:
+            // Resources imported by the graph itself. SceneColour is the graph's output.
+            // The GBuffer colour targets are transient, created by the deferred renderer
+            static constexpr const char* SceneColour = "SceneColour";
+            static constexpr const char* SceneDepth = "SceneDepth";
+            static constexpr const char* GBufferColour = "GBufferColour";
+            static constexpr const char* GBufferPosition = "GBufferPosition";
+            static constexpr const char* GBufferNormals = "GBufferNormals";
+            static constexpr const char* GBufferPBR = "GBufferPBR";
+            static constexpr const char* ShadowMap = "ShadowMap";
+
             RenderGraph(uint32_t width, uint32_t height);
             ~RenderGraph();
 
@@ -59,10 +120,15 @@ namespace Lumos
 
             void SetReflectSkyBox(bool reflect) { m_ReflectSkyBox = reflect; }
             void SetUseShadowMap(bool shadow) { m_UseShadowMap = shadow; }
+
+            // Build every pipeline a scene needs when it is loaded instead of on first draw
+            bool GetPrewarmPipelines() const { return m_PrewarmPipelines; }
+            void SetPrewarmPipelines(bool prewarm) { m_PrewarmPipelines = prewarm; }
             void SetNumShadowMaps(uint32_t num) { m_NumShadowMaps = num; }
             void SetTextureDepthArray(TextureDepthArray* texture) { m_ShadowTexture = texture; }
 
             ShadowRenderer* GetShadowRenderer() const { return m_ShadowRenderer; };
+            const RenderVisibility& GetVisibility() const { return m_Visibility; }
             void SetShadowRenderer(ShadowRenderer* renderer) { m_ShadowRenderer = renderer; }
 
             void SetScreenBufferSize(uint32_t width, uint32_t height)
@@ -83,14 +149,91 @@ namespace Lumos
                 m_OverrideCameraTransform = overrideCameraTransform;
             }
 
+            Maths::Transform* GetOverrideCameraTransform() const { return m_OverrideCameraTransform; }
+
             bool OnwindowResizeEvent(WindowResizeEvent& e);
             uint32_t GetCount() const { return (uint32_t)m_Renderers.size(); }
 
+            // Recompiled before the next frame, call when a renderer's passes or resources change
+            void Invalidate() { m_Compiled = false; }
+
+            // Imported or transient texture, transient ones are only valid after the graph is compiled
+            Texture* GetTexture(const std::string& name) const;
+
         private:
+            struct ResourceAccess
+            {
+                uint32_t resource;
+                uint32_t usage;
+                bool write;
+            };
+
+            struct Pass
+            {
+                std::string name;
+                std::function<void()> execute;
+                IRenderer* renderer = nullptr;
+                std::vector<ResourceAccess> accesses;
+                uint32_t refCount = 0;
+                bool sideEffect = false;
+                bool culled = false;
+
+                // Waited for before the pass executes
+                uint32_t barrierSrcUsage = 0;
+                uint32_t barrierDstUsage = 0;
+            };
+
+            struct Resource
+            {
+                std::string name;
+                Texture* texture = nullptr;
+                RenderGraphTextureDesc desc;
+                bool transient = false;
+                bool output = false;
+                uint32_t refCount = 0;
+                int32_t firstPass = -1;
+                int32_t lastPass = -1;
+                std::vector<uint32_t> writers;
+            };
+
+            // Texture shared by transient resources
+            struct TransientTexture
+            {
+                RenderGraphTextureDesc desc;
+                Texture* texture = nullptr;
+                int32_t lastPass = -1;
+                bool used = false;
+            };
+
+            void UpdateVisibility(Scene* scene);
+
+            void Compile();
+            void CullPasses();
+            void ComputeBarriers();
+            void AllocateTransientTextures();
+            uint32_t GetResourceIndex(const std::string& name);
+            RenderGraphTextureDesc GetResolvedDesc(const RenderGraphTextureDesc& desc) const;
+            uint64_t GetTextureMemory(const RenderGraphTextureDesc& desc) const;
+            void UpdateTransientMemory();
+            void OnImGuiGraph();
+
             std::vector<Graphics::IRenderer*> m_Renderers;
 
+            std::vector<Pass> m_Passes;
+            std::vector<Resource> m_Resources;
+            std::unordered_map<std::string, uint32_t> m_ResourceIndices;
+            std::vector<TransientTexture> m_TransientTextures;
+            std::vector<bool> m_RendererCulled;
+            bool m_Compiled = false;
+
+            // Memory the transient resources would use without aliasing, and what they use after.
+            // The only transient textures are the GBuffer targets, which overlap, so both are equal for now
+            uint64_t m_TransientMemoryRequested = 0;
+            uint64_t m_TransientMemoryAllocated = 0;
+
             bool m_ReflectSkyBox = false;
             bool m_UseShadowMap = false;
+            bool m_PrewarmPipelines = true;
             uint32_t m_NumShadowMaps = 4;
             TextureDepthArray* m_ShadowTexture = nullptr;
             Texture* m_ScreenTexture = nullptr;
@@ -98,6 +241,7 @@ namespace Lumos
             GBuffer* m_GBuffer = nullptr;
 
             ShadowRenderer* m_ShadowRenderer = nullptr;
+            RenderVisibility m_Visibility;
 
             Camera* m_OverrideCamera = nullptr;
             Maths::Transform* m_OverrideCameraTransform = nullptr;
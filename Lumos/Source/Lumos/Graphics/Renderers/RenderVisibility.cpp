@@ -0,0 +1,227 @@
+#include "Precompiled.h"
+#include "RenderVisibility.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/Model.h"
+#include "Graphics/Sprite.h"
+#include "Graphics/AnimatedSprite.h"
+#include "Scene/Scene.h"
+#include "Scene/Component/TextureMatrixComponent.h"
+#include "Maths/Transform.h"
+#include "Core/JobSystem.h"
+
+namespace Lumos::Graphics
+{
+    namespace
+    {
+        // Bounds per job, a multiple of 4 so each job owns whole SIMD lanes
+        const uint32_t BoundsPerJob = 256;
+    }
+
+    void RenderVisibility::Gather(Scene* scene)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        m_Meshes.clear();
+        m_Sprites.clear();
+        m_SpriteLocalBounds.clear();
+        m_ViewCount = 0;
+
+        for(uint32_t view = 0; view < MaxViews; view++)
+        {
+            m_VisibleMeshes[view].clear();
+            m_VisibleSprites[view].clear();
+        }
+
+        if(!scene)
+            return;
+
+        auto& registry = scene->GetRegistry();
+
+        auto group = registry.group<Model>(entt::get<Maths::Transform>);
+        for(auto entity : group)
+        {
+            const auto& [model, trans] = group.get<Model, Maths::Transform>(entity);
+            const auto& meshes = model.GetMeshes();
+
+            auto textureMatrixTransform = registry.try_get<TextureMatrixComponent>(entity);
+            const Maths::Matrix4 textureMatrix = textureMatrixTransform ? textureMatrixTransform->GetMatrix() : Maths::Matrix4();
+
+            for(auto& mesh : meshes)
+            {
+                if(!mesh->GetActive())
+                    continue;
+
+                m_Meshes.push_back({ mesh.get(), &trans.GetAffineWorldMatrix(), textureMatrix });
+            }
+        }
+
+        auto spriteGroup = registry.group<Graphics::Sprite>(entt::get<Maths::Transform>);
+        for(auto entity : spriteGroup)
+        {
+            const auto& [sprite, trans] = spriteGroup.get<Graphics::Sprite, Maths::Transform>(entity);
+            m_Sprites.push_back({ &sprite, &trans.GetAffineWorldMatrix() });
+            m_SpriteLocalBounds.emplace_back(Maths::Rect(sprite.GetPosition(), sprite.GetPosition() + sprite.GetScale()));
+        }
+
+        auto animatedSpriteGroup = registry.group<Graphics::AnimatedSprite>(entt::get<Maths::Transform>);
+        for(auto entity : animatedSpriteGroup)
+        {
+            const auto& [sprite, trans] = animatedSpriteGroup.get<Graphics::AnimatedSprite, Maths::Transform>(entity);
+            m_Sprites.push_back({ &sprite, &trans.GetAffineWorldMatrix() });
+            m_SpriteLocalBounds.emplace_back(Maths::Rect(sprite.GetPosition(), sprite.GetPosition() + sprite.GetScale()));
+        }
+    }
+
+    void RenderVisibility::SetView(uint32_t view, const Maths::Frustum& frustum)
+    {
+        LUMOS_ASSERT(view < MaxViews, "Invalid visibility view");
+        m_Views[view] = frustum;
+        m_ViewCount = Maths::Max(m_ViewCount, view + 1);
+    }
+
+    void RenderVisibility::Cull()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const uint32_t count = GetMeshCount() + GetSpriteCount();
+        const uint32_t paddedCount = (count + 3) & ~3u;
+
+        for(auto* array : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ })
+            array->resize(paddedCount);
+        m_ViewMask.resize(paddedCount);
+
+        // Padding lanes are culled like any other box, their masks are never read
+        for(uint32_t i = count; i < paddedCount; i++)
+        {
+            m_CenterX[i] = m_CenterY[i] = m_CenterZ[i] = 0.0f;
+            m_ExtentX[i] = m_ExtentY[i] = m_ExtentZ[i] = 0.0f;
+        }
+
+        if(count > 0)
+        {
+            System::JobSystem::Context ctx;
+            const uint32_t jobCount = (paddedCount + BoundsPerJob - 1) / BoundsPerJob;
+            System::JobSystem::Dispatch(ctx, jobCount, 1, [this, paddedCount](JobDispatchArgs args)
+                {
+                    const uint32_t first = args.jobIndex * BoundsPerJob;
+                    const uint32_t last = Maths::Min(first + BoundsPerJob, paddedCount);
+                    ComputeBounds(first, last);
+                    CullBounds(first, last);
+                });
+            System::JobSystem::Wait(ctx);
+        }
+
+        {
+            LUMOS_PROFILE_SCOPE("Build Visible Lists");
+            const uint32_t meshCount = GetMeshCount();
+            for(uint32_t view = 0; view < m_ViewCount; view++)
+            {
+                const uint32_t bit = 1u << view;
+                for(uint32_t i = 0; i < meshCount; i++)
+                {
+                    if(m_ViewMask[i] & bit)
+                        m_VisibleMeshes[view].push_back(i);
+                }
+
+                for(uint32_t i = meshCount; i < count; i++)
+                {
+                    if(m_ViewMask[i] & bit)
+                        m_VisibleSprites[view].push_back(i - meshCount);
+                }
+            }
+        }
+    }
+
+    void RenderVisibility::ComputeBounds(uint32_t first, uint32_t last)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const uint32_t meshCount = GetMeshCount();
+        const uint32_t count = Maths::Min(last, meshCount + GetSpriteCount());
+
+        for(uint32_t i = first; i < count; i++)
+        {
+            Maths::BoundingBox box;
+            if(i < meshCount)
+                box = m_Meshes[i].mesh->GetBoundingBox()->Transformed(*m_Meshes[i].transform);
+            else
+                box = m_SpriteLocalBounds[i - meshCount].Transformed(*m_Sprites[i - meshCount].transform);
+
+            const Maths::Vector3 center = box.Center();
+            const Maths::Vector3 extent = center - box.min_;
+
+            m_CenterX[i] = center.x;
+            m_CenterY[i] = center.y;
+            m_CenterZ[i] = center.z;
+            m_ExtentX[i] = extent.x;
+            m_ExtentY[i] = extent.y;
+            m_ExtentZ[i] = extent.z;
+        }
+    }
+
+    void RenderVisibility::CullBounds(uint32_t first, uint32_t last)
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        // Same test as Frustum::IsInsideFast, four boxes at a time against each plane of every view
+        for(uint32_t i = first; i < last; i += 4)
+        {
+#ifdef LUMOS_SSE
+            const __m128 centerX = _mm_loadu_ps(&m_CenterX[i]);
+            const __m128 centerY = _mm_loadu_ps(&m_CenterY[i]);
+            const __m128 centerZ = _mm_loadu_ps(&m_CenterZ[i]);
+            const __m128 extentX = _mm_loadu_ps(&m_ExtentX[i]);
+            const __m128 extentY = _mm_loadu_ps(&m_ExtentY[i]);
+            const __m128 extentZ = _mm_loadu_ps(&m_ExtentZ[i]);
+
+            uint32_t masks[4] = { 0, 0, 0, 0 };
+            for(uint32_t view = 0; view < m_ViewCount; view++)
+            {
+                __m128 outside = _mm_setzero_ps();
+                for(const Maths::Plane& plane : m_Views[view].planes_)
+                {
+                    const __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.normal_.x), centerX), _mm_mul_ps(_mm_set1_ps(plane.normal_.y), centerY)),
+                        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.normal_.z), centerZ), _mm_set1_ps(plane.d_)));
+                    const __m128 absDist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.absNormal_.x), extentX), _mm_mul_ps(_mm_set1_ps(plane.absNormal_.y), extentY)),
+                        _mm_mul_ps(_mm_set1_ps(plane.absNormal_.z), extentZ));
+
+                    // dist < -absDist
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, absDist), _mm_setzero_ps()));
+                }
+
+                const int outsideBits = _mm_movemask_ps(outside);
+                for(uint32_t lane = 0; lane < 4; lane++)
+                {
+                    if(!(outsideBits & (1 << lane)))
+                        masks[lane] |= 1u << view;
+                }
+            }
+
+            for(uint32_t lane = 0; lane < 4; lane++)
+                m_ViewMask[i + lane] = masks[lane];
+#else
+            for(uint32_t lane = i; lane < i + 4; lane++)
+            {
+                uint32_t mask = 0;
+                for(uint32_t view = 0; view < m_ViewCount; view++)
+                {
+                    bool outside = false;
+                    for(const Maths::Plane& plane : m_Views[view].planes_)
+                    {
+                        const float dist = plane.normal_.x * m_CenterX[lane] + plane.normal_.y * m_CenterY[lane] + plane.normal_.z * m_CenterZ[lane] + plane.d_;
+                        const float absDist = plane.absNormal_.x * m_ExtentX[lane] + plane.absNormal_.y * m_ExtentY[lane] + plane.absNormal_.z * m_ExtentZ[lane];
+
+                        if(dist < -absDist)
+                        {
+                            outside = true;
+                            break;
+                        }
+                    }
+
+                    if(!outside)
+                        mask |= 1u << view;
+                }
+
+                m_ViewMask[lane] = mask;
+            }
+#endif
+        }
+    }
+}
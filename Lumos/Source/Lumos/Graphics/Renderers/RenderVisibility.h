@@ -0,0 +1,78 @@
+#pragma once
+#include "Maths/Maths.h"
+
+namespace Lumos
+{
+    class Scene;
+
+    namespace Graphics
+    {
+        class Mesh;
+        class Renderable2D;
+
+        // Visibility shared by every renderer for one frame.
+        // Active meshes and sprites are gathered once, their world AABBs computed once into a structure of arrays,
+        // then culled against the camera and all shadow cascades in a single SIMD pass spread over the JobSystem.
+        // Renderers build their command queues from the resulting per view lists instead of walking the registry.
+        class LUMOS_EXPORT RenderVisibility
+        {
+        public:
+            static const uint32_t MaxViews = 32;
+            static const uint32_t CameraView = 0;
+            static const uint32_t FirstShadowView = 1; // Shadow cascade i is view FirstShadowView + i
+
+            struct MeshItem
+            {
+                Mesh* mesh;
+                const Maths::Matrix3x4* transform; // Owned by the entity's Transform component, widened when submitted
+                Maths::Matrix4 textureMatrix;
+            };
+
+            struct SpriteItem
+            {
+                Renderable2D* sprite;
+                const Maths::Matrix3x4* transform;
+            };
+
+            RenderVisibility() = default;
+            ~RenderVisibility() = default;
+
+            // Collects every active mesh and sprite in the scene, clears all views and visible lists
+            void Gather(Scene* scene);
+
+            void SetView(uint32_t view, const Maths::Frustum& frustum);
+            uint32_t GetViewCount() const { return m_ViewCount; }
+
+            // Computes world AABBs and tests them against every view, then builds the visible lists
+            void Cull();
+
+            const std::vector<uint32_t>& GetVisibleMeshes(uint32_t view) const { return m_VisibleMeshes[view]; }
+            const std::vector<uint32_t>& GetVisibleSprites(uint32_t view) const { return m_VisibleSprites[view]; }
+
+            const MeshItem& GetMesh(uint32_t index) const { return m_Meshes[index]; }
+            const SpriteItem& GetSprite(uint32_t index) const { return m_Sprites[index]; }
+
+            uint32_t GetMeshCount() const { return static_cast<uint32_t>(m_Meshes.size()); }
+            uint32_t GetSpriteCount() const { return static_cast<uint32_t>(m_Sprites.size()); }
+
+        private:
+            void ComputeBounds(uint32_t first, uint32_t last);
+            void CullBounds(uint32_t first, uint32_t last);
+
+            std::vector<MeshItem> m_Meshes;
+            std::vector<SpriteItem> m_Sprites;
+            std::vector<Maths::BoundingBox> m_SpriteLocalBounds;
+
+            // World space bounds of meshes followed by sprites, padded to a multiple of 4
+            std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+            std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+            std::vector<uint32_t> m_ViewMask; // Bit n set when visible in view n
+
+            Maths::Frustum m_Views[MaxViews];
+            uint32_t m_ViewCount = 0;
+
+            std::vector<uint32_t> m_VisibleMeshes[MaxViews];
+            std::vector<uint32_t> m_VisibleSprites[MaxViews];
+        };
+    }
+}
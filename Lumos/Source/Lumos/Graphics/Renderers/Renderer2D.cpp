@@ -14,6 +14,7 @@
 #include "Graphics/GBuffer.h"
 #include "Graphics/Sprite.h"
 #include "Graphics/AnimatedSprite.h"
+#include "Graphics/SpriteAtlas.h"
 #include "Scene/Scene.h"
 #include "Core/Application.h"
 #include "RenderGraph.h"
@@ -62,7 +63,9 @@ namespace Lumos
         void Renderer2D::Init()
         {
             LUMOS_PROFILE_FUNCTION();
-            m_Shader = Application::Get().GetShaderLibrary()->GetResource("//CoreShaders/Batch2D.shader");
+            m_Bindless = Renderer::GetCapabilities().MaxBindlessTextures >= MAX_BINDLESS_TEXTURES;
+            m_Limits.MaxTextures = m_Bindless ? MAX_BINDLESS_TEXTURES : MAX_BOUND_TEXTURES;
+            m_Shader = Application::Get().GetShaderLibrary()->GetResource(m_Bindless ? "//CoreShaders/Batch2DBindless.shader" : "//CoreShaders/Batch2D.shader");
 
             m_TransformationStack.emplace_back(Maths::Matrix4());
             m_TransformationBack = &m_TransformationStack.back();
@@ -119,10 +122,8 @@ namespace Lumos
             Graphics::DescriptorDesc info {};
             info.layoutIndex = 0;
             info.shader = m_Shader.get();
-            m_DescriptorSet.resize(2);
+            m_DescriptorSet.resize(1);
             m_DescriptorSet[0] = SharedRef<Graphics::DescriptorSet>(Graphics::DescriptorSet::Create(info));
-            info.layoutIndex = 1;
-            m_DescriptorSet[1] = SharedRef<Graphics::DescriptorSet>(Graphics::DescriptorSet::Create(info));
             m_DescriptorSet[0]->Update(bufferInfos);
 
             m_VertexBuffers.resize(m_Limits.MaxBatchDrawCalls);
@@ -280,35 +281,17 @@ namespace Lumos
             m_Frustum = m_Camera->GetFrustum(view);
             m_CommandQueue2D.clear();
 
-            auto group = registry.group<Graphics::Sprite>(entt::get<Maths::Transform>);
-            for(auto entity : group)
-            {
-                const auto& [sprite, trans] = group.get<Graphics::Sprite, Maths::Transform>(entity);
-
-                auto bb = Maths::BoundingBox(Maths::Rect(sprite.GetPosition(), sprite.GetPosition() + sprite.GetScale()));
-                bb.Transform(trans.GetWorldMatrix());
-                auto inside = m_Frustum.IsInside(bb);
+            // Sprites packed since the last frame
+            SpriteAtlas::Get().UploadPages();
 
-                if(inside == Maths::Intersection::OUTSIDE)
-                    continue;
-
-                Submit(&sprite, trans.GetWorldMatrix());
-            };
+            // Culled once per frame by the render graph
+            const RenderVisibility& visibility = Application::Get().GetRenderGraph()->GetVisibility();
 
-            auto group2 = registry.group<Graphics::AnimatedSprite>(entt::get<Maths::Transform>);
-            for(auto entity : group2)
+            for(uint32_t index : visibility.GetVisibleSprites(RenderVisibility::CameraView))
             {
-                const auto& [sprite, trans] = group2.get<Graphics::AnimatedSprite, Maths::Transform>(entity);
-
-                auto bb = Maths::BoundingBox(Maths::Rect(sprite.GetPosition(), sprite.GetPosition() + sprite.GetScale()));
-                bb.Transform(trans.GetWorldMatrix());
-                auto inside = m_Frustum.IsInside(bb);
-
-                if(inside == Maths::Intersection::OUTSIDE)
-                    continue;
-
-                Submit(&sprite, trans.GetWorldMatrix());
-            };
+                const auto& item = visibility.GetSprite(index);
+                Submit(item.sprite, item.transform->ToMatrix4());
+            }
         }
 
         void Renderer2D::Present()
@@ -330,7 +313,7 @@ namespace Lumos
             m_Pipeline->Bind(currentCMDBuffer);
 
             m_CurrentDescriptorSets[0] = m_DescriptorSet[0].get();
-            m_CurrentDescriptorSets[1] = m_TextureCount > 0 ? m_DescriptorSet[1].get() : nullptr;
+            m_CurrentDescriptorSets[1] = m_TextureCount > 0 ? m_BatchDescriptorSets[m_BatchDrawCallIndex].get() : nullptr;
 
             m_IndexBuffer->SetCount(m_IndexCount);
             m_IndexBuffer->Bind(currentCMDBuffer);
@@ -360,8 +343,24 @@ namespace Lumos
             m_BatchDrawCallIndex = 0;
         }
 
+        void Renderer2D::SortQueue()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            std::stable_sort(m_CommandQueue2D.begin(), m_CommandQueue2D.end(), [](const RenderCommand2D& a, const RenderCommand2D& b)
+                {
+                    const float layerA = a.transform.Translation().z;
+                    const float layerB = b.transform.Translation().z;
+                    if(layerA != layerB)
+                        return layerA < layerB;
+
+                    return a.renderable->GetTexture() < b.renderable->GetTexture();
+                });
+        }
+
         void Renderer2D::SubmitQueue()
         {
+            SortQueue();
+
             for(auto& command : m_CommandQueue2D)
             {
                 Engine::Get().Statistics().NumRenderedObjects++;
@@ -415,6 +414,16 @@ namespace Lumos
             }
         }
 
+        void Renderer2D::DeclarePasses(RenderGraphBuilder& builder)
+        {
+            builder.AddPass("2D", [this]()
+                { RenderScene(); });
+
+            if(m_RenderToDepthTexture)
+                builder.Read(RenderGraph::SceneDepth, RESOURCE_USAGE_DEPTH_ATTACHMENT);
+            builder.Write(RenderGraph::SceneColour, RESOURCE_USAGE_COLOUR_ATTACHMENT);
+        }
+
         void Renderer2D::RenderScene()
         {
             LUMOS_PROFILE_FUNCTION();
@@ -530,14 +539,23 @@ namespace Lumos
             if(m_TextureCount == 0)
                 return;
 
-            if(m_TextureCount != m_PreviousFrameTextureCount)
+            if(m_BatchDescriptorSets.size() <= m_BatchDrawCallIndex)
+            {
+                m_BatchDescriptorSets.resize(m_BatchDrawCallIndex + 1);
+                m_BatchTextureCounts.resize(m_BatchDrawCallIndex + 1, 0);
+            }
+
+            auto& descriptorSet = m_BatchDescriptorSets[m_BatchDrawCallIndex];
+
+            // Bindless arrays are partially bound, so a set is written up to the textures in use and never recreated
+            if(!descriptorSet || (!m_Bindless && m_TextureCount != m_BatchTextureCounts[m_BatchDrawCallIndex]))
             {
                 // When previous frame texture count was less then than the previous frame
                 // and the texture previously used was deleted, there was a crash - maybe moltenvk only
                 Graphics::DescriptorDesc info {};
                 info.layoutIndex = 1;
                 info.shader = m_Shader.get();
-                m_DescriptorSet[1] = Graphics::DescriptorSet::Create(info);
+                descriptorSet = SharedRef<Graphics::DescriptorSet>(Graphics::DescriptorSet::Create(info));
             }
 
             std::vector<Graphics::Descriptor> imageInfos;
@@ -555,9 +573,9 @@ namespace Lumos
 
             imageInfos.push_back(imageInfo);
 
-            m_DescriptorSet[1]->Update(imageInfos);
+            descriptorSet->Update(imageInfos);
 
-            m_PreviousFrameTextureCount = m_TextureCount;
+            m_BatchTextureCounts[m_BatchDrawCallIndex] = m_TextureCount;
         }
 
         void Renderer2D::SetRenderTarget(Texture* texture, bool rebuildFramebuffer)
@@ -6,6 +6,8 @@
 #include "Maths/Transform.h"
 
 #define MAX_BOUND_TEXTURES 16
+// Sampler array size of Batch2DBindless.frag, used when the device supports descriptor indexing
+#define MAX_BINDLESS_TEXTURES 1024
 #define MAP_VERTEX_ARRAY 1
 namespace Lumos
 {
@@ -82,6 +84,7 @@ namespace Lumos
             virtual void OnResize(uint32_t width, uint32_t height) override;
             virtual void SetRenderTarget(Texture* texture, bool rebuildFrameBuffer = true) override;
             virtual void RenderScene() override;
+            void DeclarePasses(RenderGraphBuilder& builder) override;
 
             virtual void SubmitTriangle(const Maths::Vector3& p1, const Maths::Vector3& p2, const Maths::Vector3& p3, const Maths::Vector4& colour);
             virtual void Submit(Renderable2D* renderable, const Maths::Matrix4& transform);
@@ -108,6 +111,9 @@ namespace Lumos
             void SubmitInternal(const TriangleInfo& triangle);
             void SubmitQueue();
 
+            // Orders the queue back to front, then by texture within a layer so sprites sharing a texture share a batch
+            void SortQueue();
+
             CommandQueue2D m_CommandQueue2D;
             std::vector<CommandBuffer*> m_SecondaryCommandBuffers;
             std::vector<VertexBuffer*> m_VertexBuffers;
@@ -127,7 +133,7 @@ namespace Lumos
             std::vector<Maths::Matrix4> m_TransformationStack;
             const Maths::Matrix4* m_TransformationBack {};
 
-            Texture* m_Textures[MAX_BOUND_TEXTURES];
+            Texture* m_Textures[MAX_BINDLESS_TEXTURES];
             uint32_t m_TextureCount;
 
             uint32_t m_CurrentBufferID = 0;
@@ -140,7 +146,12 @@ namespace Lumos
             bool m_Empty = false;
             bool m_TriangleIndicies = false;
 
-            uint32_t m_PreviousFrameTextureCount = 0;
+            // Batches index up to MAX_BINDLESS_TEXTURES textures instead of switching over MAX_BOUND_TEXTURES
+            bool m_Bindless = false;
+
+            // Texture set of each batch drawn in a frame, so a set is not rewritten while an earlier batch still uses it
+            std::vector<SharedRef<DescriptorSet>> m_BatchDescriptorSets;
+            std::vector<uint32_t> m_BatchTextureCounts;
         };
     }
 }
@@ -30,6 +30,8 @@
 #include "Core/JobSystem.h"
 #endif
 
+#define INSTANCE_DESCRIPTORSET_ID 1
+
 namespace Lumos
 {
     namespace Graphics
@@ -99,10 +101,12 @@ namespace Lumos
             m_DescriptorSet.resize(1);
             m_DescriptorSet[0] = SharedRef<Graphics::DescriptorSet>(Graphics::DescriptorSet::Create(info));
 
+            m_InstanceBuffer = CreateUniqueRef<InstanceBuffer>(m_Shader.get(), INSTANCE_DESCRIPTORSET_ID);
+
             CreateGraphicsPipeline();
             CreateUniformBuffer();
             CreateFramebuffers();
-            m_CurrentDescriptorSets.resize(1);
+            m_CurrentDescriptorSets.resize(2);
 
             m_CascadeCommandQueue[0].reserve(1000);
         }
@@ -116,7 +120,7 @@ namespace Lumos
             LUMOS_PROFILE_FUNCTION();
         }
 
-        void ShadowRenderer::BeginScene(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform)
+        bool ShadowRenderer::PrepareCascades(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform)
         {
             LUMOS_PROFILE_FUNCTION();
 
@@ -136,7 +140,7 @@ namespace Lumos
                 if(!light)
                 {
                     m_ShouldRender = false;
-                    return;
+                    return false;
                 }
             }
 
@@ -158,54 +162,41 @@ namespace Lumos
             if(!m_Camera || !m_CameraTransform)
             {
                 m_ShouldRender = false;
-                return;
+                return false;
             }
 
             UpdateCascades(scene, overrideCamera, overrideCameraTransform, light);
 
-            m_CascadeCommandQueue[0].clear();
-            m_CascadeCommandQueue[1].clear();
-            m_CascadeCommandQueue[2].clear();
-            m_CascadeCommandQueue[3].clear();
+            m_ShouldRender = true;
+            return true;
+        }
 
-            auto group = registry.group<Model>(entt::get<Maths::Transform>);
+        void ShadowRenderer::BeginScene(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform)
+        {
+            LUMOS_PROFILE_FUNCTION();
 
             for(uint32_t i = 0; i < m_ShadowMapNum; ++i)
-            {
-                LUMOS_PROFILE_SCOPE("Submit Meshes");
-                m_Layer = i;
-
-                Maths::Frustum f;
-                f.Define(m_ShadowProjView[i]);
+                m_CascadeCommandQueue[i].clear();
 
-                if(group.empty())
-                    continue;
+            // Shared by every cascade of the frame, each appends its instances after the previous one's
+            m_InstanceBuffer->Reset();
 
-                for(auto entity : group)
-                {
-                    const auto& [model, trans] = group.get<Model, Maths::Transform>(entity);
-                    const auto& meshes = model.GetMeshes();
-
-                    for(auto mesh : meshes)
-                    {
-                        if(mesh->GetActive())
-                        {
-                            auto& worldTransform = trans.GetWorldMatrix();
+            if(!m_ShouldRender)
+                return;
 
-                            auto bb = mesh->GetBoundingBox();
-                            auto bbCopy = bb->Transformed(worldTransform);
-                            auto inside = f.IsInsideFast(bbCopy);
+            // Cascades were culled by the render graph's visibility stage after PrepareCascades
+            const RenderVisibility& visibility = Application::Get().GetRenderGraph()->GetVisibility();
 
-                            if(inside == Maths::Intersection::OUTSIDE)
-                                continue;
+            for(uint32_t i = 0; i < m_ShadowMapNum; ++i)
+            {
+                LUMOS_PROFILE_SCOPE("Submit Meshes");
 
-                            SubmitMesh(mesh.get(), nullptr, worldTransform, Maths::Matrix4(), i);
-                        }
-                    }
+                for(uint32_t index : visibility.GetVisibleMeshes(RenderVisibility::FirstShadowView + i))
+                {
+                    const auto& item = visibility.GetMesh(index);
+                    SubmitMesh(item.mesh, nullptr, item.transform->ToMatrix4(), Maths::Matrix4(), i);
                 }
             }
-
-            m_ShouldRender = true;
         }
 
         void ShadowRenderer::EndScene()
@@ -220,41 +211,96 @@ namespace Lumos
         void ShadowRenderer::Present()
         {
             LUMOS_PROFILE_FUNCTION();
-            int index = 0;
 
-            m_RenderPass->BeginRenderpass(Renderer::GetSwapchain()->GetCurrentCommandBuffer(), Maths::Vector4(0.0f), m_ShadowFramebuffer[m_Layer].get(), Graphics::INLINE, m_ShadowMapSize, m_ShadowMapSize);
+            // Every caster uses the same pipeline, so copies of a mesh become one instanced draw
+            {
+                LUMOS_PROFILE_SCOPE("Build Instance Batches");
+                for(uint32_t cascade = 0; cascade < m_ShadowMapNum; cascade++)
+                {
+                    auto& commandQueue = m_CascadeCommandQueue[cascade];
+                    auto& batches = m_CascadeBatches[cascade];
 
-            m_Pipeline->Bind(Renderer::GetSwapchain()->GetCurrentCommandBuffer());
+                    m_CommandSorter.Sort(commandQueue);
+                    batches.clear();
 
-            for(auto& command : m_CascadeCommandQueue[m_Layer])
+                    const uint32_t commandCount = static_cast<uint32_t>(commandQueue.size());
+                    for(uint32_t first = 0; first < commandCount;)
+                    {
+                        uint32_t last = first + 1;
+                        while(last < commandCount && commandQueue[last].mesh == commandQueue[first].mesh)
+                            last++;
+
+                        m_InstanceBuffer->AddBatches(commandQueue, first, last, batches);
+                        first = last;
+                    }
+                }
+
+                m_InstanceBuffer->Upload();
+            }
+
+            // Cascades render to separate layers, so all of them are recorded at once
+            m_Recorder.Reset();
+            for(uint32_t cascade = 0; cascade < m_ShadowMapNum; cascade++)
+                m_Recorder.AddPass(m_RenderPass.get(), m_ShadowFramebuffer[cascade].get(), m_ShadowMapSize, m_ShadowMapSize, static_cast<uint32_t>(m_CascadeBatches[cascade].size()));
+
+            m_Recorder.Record([this](CommandBuffer* commandBuffer, uint32_t cascade, uint32_t first, uint32_t last)
+                              { RecordBatches(commandBuffer, cascade, first, last); });
+
+            auto commandBuffer = Renderer::GetSwapchain()->GetCurrentCommandBuffer();
+            for(uint32_t cascade = 0; cascade < m_ShadowMapNum; cascade++)
+            {
+                m_RenderPass->BeginRenderpass(commandBuffer, Maths::Vector4(0.0f), m_ShadowFramebuffer[cascade].get(), m_Recorder.GetSubPassContents(), m_ShadowMapSize, m_ShadowMapSize);
+                m_Recorder.Execute(cascade, commandBuffer);
+                m_RenderPass->EndRenderpass(commandBuffer);
+            }
+        }
+
+        void ShadowRenderer::RecordBatches(CommandBuffer* commandBuffer, uint32_t cascade, uint32_t firstBatch, uint32_t lastBatch)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            const auto& commandQueue = m_CascadeCommandQueue[cascade];
+            const auto& batches = m_CascadeBatches[cascade];
+
+            m_Pipeline->Bind(commandBuffer);
+
+            // The shader's push constant storage is shared by every cascade, so each range writes its own copy
+            const auto& pushConstant = m_Shader->GetPushConstants()[0];
+            LUMOS_ASSERT(pushConstant.size <= PushConstant::MaxSize, "Push constant block too large");
+
+            uint8_t pushConstantData[PushConstant::MaxSize];
+            memcpy(pushConstantData, pushConstant.data, pushConstant.size);
+            memcpy(pushConstantData + sizeof(uint32_t), &cascade, sizeof(uint32_t));
+
+            std::vector<DescriptorSet*> descriptorSets(m_CurrentDescriptorSets.size());
+            DescriptorSet* boundInstances = nullptr;
+
+            for(uint32_t i = firstBatch; i < lastBatch; i++)
             {
-                Engine::Get().Statistics().NumShadowObjects++;
+                const auto& batch = batches[i];
+                Engine::Get().Statistics().NumShadowObjects += batch.instances.count;
 
-                Mesh* mesh = command.mesh;
+                Mesh* mesh = commandQueue[batch.command].mesh;
 
-                m_CurrentDescriptorSets[0] = m_DescriptorSet[0].get();
+                if(batch.instances.descriptorSet != boundInstances)
+                {
+                    descriptorSets[0] = m_DescriptorSet[0].get();
+                    descriptorSets[INSTANCE_DESCRIPTORSET_ID] = batch.instances.descriptorSet;
 
-                mesh->GetVertexBuffer()->Bind(Renderer::GetSwapchain()->GetCurrentCommandBuffer(), m_Pipeline.get());
-                mesh->GetIndexBuffer()->Bind(Renderer::GetSwapchain()->GetCurrentCommandBuffer());
+                    Renderer::BindDescriptorSets(m_Pipeline.get(), commandBuffer, 0, descriptorSets);
+                    boundInstances = batch.instances.descriptorSet;
+                }
 
-                uint32_t layer = static_cast<uint32_t>(m_Layer);
-                auto trans = command.transform;
-                auto& pushConstants = m_Shader->GetPushConstants();
-                memcpy(pushConstants[0].data, &trans, sizeof(Maths::Matrix4));
-                memcpy(pushConstants[0].data + sizeof(Maths::Matrix4), &layer, sizeof(uint32_t));
+                mesh->GetVertexBuffer()->Bind(commandBuffer, m_Pipeline.get());
+                mesh->GetIndexBuffer()->Bind(commandBuffer);
 
-                m_Shader->BindPushConstants(Renderer::GetSwapchain()->GetCurrentCommandBuffer(), m_Pipeline.get());
+                memcpy(pushConstantData, &batch.instances.first, sizeof(uint32_t));
+                m_Shader->BindPushConstant(commandBuffer, m_Pipeline.get(), 0, pushConstantData);
 
-                Renderer::BindDescriptorSets(m_Pipeline.get(), Renderer::GetSwapchain()->GetCurrentCommandBuffer(), 0, m_CurrentDescriptorSets);
-                Renderer::DrawIndexed(Renderer::GetSwapchain()->GetCurrentCommandBuffer(), DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount());
+                Renderer::DrawIndexedInstanced(commandBuffer, DrawType::TRIANGLE, mesh->GetIndexBuffer()->GetCount(), batch.instances.count);
 
                 mesh->GetVertexBuffer()->Unbind();
                 mesh->GetIndexBuffer()->Unbind();
-
-                index++;
             }
-
-            m_RenderPass->EndRenderpass(Renderer::GetSwapchain()->GetCurrentCommandBuffer());
         }
 
         void ShadowRenderer::SetShadowMapNum(uint32_t num)
@@ -286,16 +332,19 @@ namespace Lumos
             memcpy(m_VSSystemUniformBuffer + m_VSSystemUniformBufferOffsets[VSSystemUniformIndex_ProjectionViewMatrix], m_ShadowProjView, sizeof(Maths::Matrix4) * SHADOWMAP_MAX);
 
             Begin();
-
-            for(uint32_t i = 0; i < m_ShadowMapNum; ++i)
-            {
-                m_Layer = i;
-                SetSystemUniforms(m_Shader.get());
-                Present();
-            }
+            SetSystemUniforms(m_Shader.get());
+            Present();
             End();
         }
 
+        void ShadowRenderer::DeclarePasses(RenderGraphBuilder& builder)
+        {
+            builder.AddPass("Shadows", [this]()
+                { RenderScene(); });
+            builder.Import(RenderGraph::ShadowMap, reinterpret_cast<Texture*>(m_ShadowTex));
+            builder.Write(RenderGraph::ShadowMap, RESOURCE_USAGE_DEPTH_ATTACHMENT);
+        }
+
         void ShadowRenderer::UpdateCascades(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform, Light* light)
         {
             LUMOS_PROFILE_FUNCTION();
@@ -530,6 +579,7 @@ namespace Lumos
             command.mesh = mesh;
             command.transform = transform;
             command.material = material;
+            command.sortKey = RenderSortKey::Make(nullptr, 0, nullptr, mesh, 0.0f);
             Submit(command, cascadeIndex);
         }
 
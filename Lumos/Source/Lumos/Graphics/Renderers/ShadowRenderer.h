@@ -2,6 +2,8 @@
 
 #include "Maths/Maths.h"
 #include "IRenderer.h"
+#include "InstanceBuffer.h"
+#include "ParallelCommandRecorder.h"
 
 #include <entt/entity/fwd.hpp>
 #define SHADOWMAP_MAX 16
@@ -39,6 +41,10 @@ namespace Lumos
 
             void Init() override;
             void BeginScene(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform) override;
+
+            // Finds the directional light and camera and builds the cascade matrices. Called by the render graph before
+            // visibility culling, returns false if there is nothing to render shadows for
+            bool PrepareCascades(Scene* scene, Camera* overrideCamera, Maths::Transform* overrideCameraTransform);
             void OnResize(uint32_t width, uint32_t height) override;
 
             void SetShadowMapNum(uint32_t num);
@@ -55,6 +61,7 @@ namespace Lumos
             void Present() override;
             void RenderScene() override;
             void PresentToScreen() override { }
+            void DeclarePasses(RenderGraphBuilder& builder) override;
 
             Maths::Vector4* GetSplitDepths()
             {
@@ -111,6 +118,9 @@ namespace Lumos
         protected:
             void SetSystemUniforms(Shader* shader);
 
+            // Records batches [firstBatch, lastBatch) of cascade, may run on a job system worker
+            void RecordBatches(CommandBuffer* commandBuffer, uint32_t cascade, uint32_t firstBatch, uint32_t lastBatch);
+
             TextureDepthArray* m_ShadowTex;
             uint32_t m_ShadowMapNum;
             uint32_t m_ShadowMapSize;
@@ -121,10 +131,13 @@ namespace Lumos
             Maths::Matrix4 m_LightMatrix;
 
             CommandQueue m_CascadeCommandQueue[SHADOWMAP_MAX];
+            RenderCommandSorter m_CommandSorter;
+            UniqueRef<InstanceBuffer> m_InstanceBuffer;
+            std::vector<InstanceBuffer::Batch> m_CascadeBatches[SHADOWMAP_MAX];
+            ParallelCommandRecorder m_Recorder;
 
             Lumos::Graphics::UniformBuffer* m_UniformBuffer;
 
-            uint32_t m_Layer = 0;
             float m_CascadeSplitLambda;
             float m_SceneRadiusMultiplier;
 
@@ -26,8 +26,7 @@ namespace Lumos
     namespace Graphics
     {
         SkyboxRenderer::SkyboxRenderer(uint32_t width, uint32_t height)
-            : m_UniformBuffer(nullptr)
-            , m_CubeMap(nullptr)
+            : m_CubeMap(nullptr)
         {
             m_Pipeline = nullptr;
 
@@ -37,13 +36,20 @@ namespace Lumos
 
         SkyboxRenderer::~SkyboxRenderer()
         {
-            delete m_UniformBuffer;
             delete m_Skybox;
             delete[] m_VSSystemUniformBuffer;
 
             m_Framebuffers.clear();
         }
 
+        void SkyboxRenderer::DeclarePasses(RenderGraphBuilder& builder)
+        {
+            builder.AddPass("Skybox", [this]()
+                { RenderScene(); });
+            builder.Read(RenderGraph::SceneDepth, RESOURCE_USAGE_DEPTH_ATTACHMENT);
+            builder.Write(RenderGraph::SceneColour, RESOURCE_USAGE_COLOUR_ATTACHMENT);
+        }
+
         void SkyboxRenderer::RenderScene()
         {
             LUMOS_PROFILE_FUNCTION();
@@ -63,7 +69,7 @@ namespace Lumos
             m_Skybox->GetVertexBuffer()->Bind(Renderer::GetSwapchain()->GetCurrentCommandBuffer(), m_Pipeline.get());
             m_Skybox->GetIndexBuffer()->Bind(Renderer::GetSwapchain()->GetCurrentCommandBuffer());
 
-            Renderer::BindDescriptorSets(m_Pipeline.get(), Renderer::GetSwapchain()->GetCurrentCommandBuffer(), 0, m_CurrentDescriptorSets);
+            Renderer::BindDescriptorSets(m_Pipeline.get(), Renderer::GetSwapchain()->GetCurrentCommandBuffer(), m_UniformOffset, m_CurrentDescriptorSets);
             Renderer::DrawIndexed(Renderer::GetSwapchain()->GetCurrentCommandBuffer(), DrawType::TRIANGLE, m_Skybox->GetIndexBuffer()->GetCount());
 
             m_Skybox->GetVertexBuffer()->Unbind();
@@ -115,6 +121,9 @@ namespace Lumos
             m_DescriptorSet[0] = SharedRef<Graphics::DescriptorSet>(Graphics::DescriptorSet::Create(info));
             m_CurrentDescriptorSets.resize(1);
 
+            const uint32_t uniformSize = static_cast<uint32_t>(sizeof(UniformBufferObject));
+            m_UniformAllocator = CreateUniqueRef<UniformBufferAllocator>(uniformSize, uniformSize);
+
             CreateGraphicsPipeline();
             UpdateUniformBuffer();
             CreateFramebuffers();
@@ -178,10 +187,19 @@ namespace Lumos
             m_RenderPass->EndRenderpass(Renderer::GetSwapchain()->GetCurrentCommandBuffer());
         }
 
-        void SkyboxRenderer::SetSystemUniforms(Shader* shader) const
+        void SkyboxRenderer::SetSystemUniforms(Shader* shader)
         {
             LUMOS_PROFILE_FUNCTION();
-            m_UniformBuffer->SetData(sizeof(UniformBufferObject), *&m_VSSystemUniformBuffer);
+            m_UniformAllocator->BeginFrame();
+
+            auto allocation = m_UniformAllocator->Allocate(sizeof(UniformBufferObject));
+            if(allocation.data)
+            {
+                memcpy(allocation.data, m_VSSystemUniformBuffer, sizeof(UniformBufferObject));
+                m_UniformOffset = allocation.offset;
+            }
+
+            m_UniformAllocator->Flush();
         }
 
         void SkyboxRenderer::OnResize(uint32_t width, uint32_t height)
@@ -212,20 +230,13 @@ namespace Lumos
         void SkyboxRenderer::UpdateUniformBuffer()
         {
             LUMOS_PROFILE_FUNCTION();
-            if(m_UniformBuffer == nullptr)
-            {
-                m_UniformBuffer = Graphics::UniformBuffer::Create();
-                uint32_t bufferSize = static_cast<uint32_t>(sizeof(UniformBufferObject));
-                m_UniformBuffer->Init(bufferSize, nullptr);
-            }
-
             std::vector<Graphics::Descriptor> bufferInfos;
 
             Graphics::Descriptor bufferInfo = {};
-            bufferInfo.buffer = m_UniformBuffer;
+            bufferInfo.buffer = m_UniformAllocator->GetBuffer();
             bufferInfo.offset = 0;
-            bufferInfo.size = sizeof(UniformBufferObject);
-            bufferInfo.type = Graphics::DescriptorType::UNIFORM_BUFFER;
+            bufferInfo.size = m_UniformAllocator->GetMaxAllocationSize();
+            bufferInfo.type = Graphics::DescriptorType::UNIFORM_BUFFER_DYNAMIC;
             bufferInfo.binding = 0;
             bufferInfo.shaderType = ShaderType::VERTEX;
 
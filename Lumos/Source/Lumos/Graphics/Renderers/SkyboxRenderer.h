@@ -1,6 +1,7 @@
 #pragma once
 
 #include "IRenderer.h"
+#include "UniformBufferAllocator.h"
 
 namespace Lumos
 {
@@ -30,6 +31,7 @@ namespace Lumos
             void End() override;
             void Present() override {};
             void RenderScene() override;
+            void DeclarePasses(RenderGraphBuilder& builder) override;
             void PresentToScreen() override { }
 
             void CreateFramebuffers();
@@ -44,9 +46,11 @@ namespace Lumos
             void OnImGui() override;
 
         private:
-            void SetSystemUniforms(Shader* shader) const;
+            void SetSystemUniforms(Shader* shader);
 
-            Lumos::Graphics::UniformBuffer* m_UniformBuffer;
+            // One region per swapchain image, so frames in flight keep their own matrix
+            UniqueRef<UniformBufferAllocator> m_UniformAllocator;
+            uint32_t m_UniformOffset = 0;
 
             uint32_t m_CurrentBufferID = 0;
 
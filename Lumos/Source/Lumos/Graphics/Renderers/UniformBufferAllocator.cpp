@@ -0,0 +1,78 @@
+#include "Precompiled.h"
+#include "UniformBufferAllocator.h"
+#include "Graphics/RHI/UniformBuffer.h"
+#include "Graphics/RHI/GraphicsContext.h"
+#include "Graphics/RHI/Renderer.h"
+#include "Graphics/RHI/Swapchain.h"
+
+namespace Lumos::Graphics
+{
+    UniformBufferAllocator::UniformBufferAllocator(uint32_t frameSize, uint32_t maxAllocationSize)
+    {
+        m_Alignment = Maths::Max(static_cast<uint32_t>(GraphicsContext::GetContext()->GetMinUniformBufferOffsetAlignment()), 16u);
+        m_MaxAllocationSize = (maxAllocationSize + m_Alignment - 1) & ~(m_Alignment - 1);
+        m_FrameSize = (Maths::Max(frameSize, m_MaxAllocationSize) + m_Alignment - 1) & ~(m_Alignment - 1);
+        m_FrameCount = Maths::Max(static_cast<uint32_t>(Renderer::GetSwapchain()->GetSwapchainBufferCount()), 1u);
+
+        m_Data = static_cast<uint8_t*>(Memory::AlignedAlloc(m_FrameSize, m_Alignment));
+        memset(m_Data, 0, m_FrameSize);
+
+        m_Buffer = UniformBuffer::Create();
+        m_Buffer->Init(m_FrameSize * m_FrameCount, nullptr);
+    }
+
+    UniformBufferAllocator::~UniformBufferAllocator()
+    {
+        delete m_Buffer;
+        Memory::AlignedFree(m_Data);
+    }
+
+    void UniformBufferAllocator::BeginFrame()
+    {
+        m_FrameIndex = Renderer::GetSwapchain()->GetCurrentBufferIndex() % m_FrameCount;
+        m_Head = 0;
+        m_FlushedHead = 0;
+    }
+
+    UniformBufferAllocator::Allocation UniformBufferAllocator::Allocate(uint32_t size)
+    {
+        LUMOS_ASSERT(size <= m_MaxAllocationSize, "Allocation larger than the descriptor range");
+
+        const uint32_t alignedSize = (size + m_Alignment - 1) & ~(m_Alignment - 1);
+        const uint32_t offset = m_Head.fetch_add(alignedSize);
+
+        Allocation allocation;
+
+        // The descriptor range read from the offset has to stay inside the region
+        if(offset + m_MaxAllocationSize > m_FrameSize)
+        {
+            if(!m_OverflowReported)
+            {
+                LUMOS_LOG_ERROR("Uniform buffer allocator full, {0} bytes per frame", m_FrameSize);
+                m_OverflowReported = true;
+            }
+            return allocation;
+        }
+
+        allocation.data = m_Data + offset;
+        allocation.offset = m_FrameIndex * m_FrameSize + offset;
+        return allocation;
+    }
+
+    void UniformBufferAllocator::Flush()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const uint32_t head = GetAllocatedSize();
+
+        if(head <= m_FlushedHead)
+            return;
+
+        m_Buffer->SetDynamicData(head - m_FlushedHead, m_MaxAllocationSize, m_Data + m_FlushedHead, m_FrameIndex * m_FrameSize + m_FlushedHead);
+        m_FlushedHead = head;
+    }
+
+    uint32_t UniformBufferAllocator::GetAllocatedSize() const
+    {
+        return Maths::Min(m_Head.load(), m_FrameSize);
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+
+namespace Lumos
+{
+    namespace Graphics
+    {
+        class UniformBuffer;
+
+        // Linear allocator for uniform data written every frame, e.g. per draw or per pass constants.
+        // One uniform buffer holds a region per swapchain image. Allocations are bumped from a CPU copy of the current
+        // region and Flush uploads only the bytes written, so frames still in flight keep reading their own region.
+        // Bind GetBuffer() as a UNIFORM_BUFFER_DYNAMIC descriptor of GetMaxAllocationSize() bytes and pass an
+        // allocation's offset as the dynamic offset
+        class LUMOS_EXPORT UniformBufferAllocator
+        {
+        public:
+            struct Allocation
+            {
+                // Null when the frame's region is full
+                uint8_t* data = nullptr;
+                uint32_t offset = 0;
+            };
+
+            UniformBufferAllocator(uint32_t frameSize, uint32_t maxAllocationSize);
+            ~UniformBufferAllocator();
+
+            UniformBufferAllocator(UniformBufferAllocator const&) = delete;
+            UniformBufferAllocator& operator=(UniformBufferAllocator const&) = delete;
+
+            // Called once per frame before any Allocate, switches to the current swapchain image's region
+            void BeginFrame();
+
+            // Safe to call from job system workers
+            Allocation Allocate(uint32_t size);
+
+            template <typename T>
+            Allocation Push(const T& value)
+            {
+                Allocation allocation = Allocate(sizeof(T));
+                if(allocation.data)
+                    memcpy(allocation.data, &value, sizeof(T));
+                return allocation;
+            }
+
+            // Uploads what was allocated since the last Flush. Called before the frame's command buffers are submitted
+            void Flush();
+
+            UniformBuffer* GetBuffer() const { return m_Buffer; }
+            uint32_t GetMaxAllocationSize() const { return m_MaxAllocationSize; }
+            uint32_t GetFrameSize() const { return m_FrameSize; }
+            uint32_t GetAllocatedSize() const;
+
+        private:
+            UniformBuffer* m_Buffer = nullptr;
+            uint8_t* m_Data = nullptr;
+
+            uint32_t m_Alignment = 0;
+            uint32_t m_FrameSize = 0;
+            uint32_t m_MaxAllocationSize = 0;
+            uint32_t m_FrameCount = 0;
+            uint32_t m_FrameIndex = 0;
+
+            std::atomic<uint32_t> m_Head = 0;
+            uint32_t m_FlushedHead = 0;
+            bool m_OverflowReported = false;
+        };
+    }
+}
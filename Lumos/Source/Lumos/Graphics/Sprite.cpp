@@ -1,5 +1,6 @@
 #include "Precompiled.h"
 #include "Sprite.h"
+#include "SpriteAtlas.h"
 #include "Graphics/Material.h"
 #include "Graphics/RHI/Texture.h"
 #include "Graphics/RHI/GraphicsContext.h"
@@ -36,6 +37,7 @@ namespace Lumos
         void Sprite::SetSpriteSheet(const SharedRef<Texture2D>& texture, const Maths::Vector2& index, const Maths::Vector2& cellSize, const Maths::Vector2& spriteSize)
         {
             m_Texture = texture;
+            m_TexturePath.clear();
             Maths::Vector2 min = { (index.x * cellSize.x) / texture->GetWidth(), (index.y * cellSize.y) / texture->GetHeight() };
             Maths::Vector2 max = { ((index.x + spriteSize.x) * cellSize.x) / texture->GetWidth(), ((index.y + spriteSize.y) * cellSize.y) / texture->GetHeight() };
 
@@ -44,10 +46,24 @@ namespace Lumos
 
         void Sprite::SetTextureFromFile(const std::string& filePath)
         {
+            SpriteAtlas::Region region;
+            if(SpriteAtlas::Get().GetRegion(filePath, region))
+            {
+                m_Texture = region.texture;
+                m_TexturePath = filePath;
+                m_UVs = GetUVs(region.uvMin, region.uvMax);
+                return;
+            }
+
             auto tex = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(filePath, filePath));
             if(tex)
             {
+                // Atlas UVs do not apply to a texture of its own
+                if(!m_TexturePath.empty())
+                    m_UVs = GetDefaultUVs();
+
                 m_Texture = tex;
+                m_TexturePath.clear();
             }
         }
     }
@@ -27,9 +27,17 @@ namespace Lumos
             void SetScale(const Maths::Vector2& scale) { m_Scale = scale; }
 
             void SetSpriteSheet(const SharedRef<Texture2D>& texture, const Maths::Vector2& index, const Maths::Vector2& cellSize, const Maths::Vector2& spriteSize);
-            void SetTexture(const SharedRef<Texture2D>& texture) { m_Texture = texture; }
+            void SetTexture(const SharedRef<Texture2D>& texture)
+            {
+                m_Texture = texture;
+                m_TexturePath.clear();
+            }
 
-            void SetTextureFromFile(const std::string& filePath);
+            // Packs the image into the sprite atlas when it is small enough
+            virtual void SetTextureFromFile(const std::string& filePath);
+
+            // File the texture was loaded from, the texture itself may be an atlas page
+            std::string GetTexturePath() const { return m_TexturePath.empty() && m_Texture ? m_Texture->GetFilepath() : m_TexturePath; }
 
             template <typename Archive>
             void save(Archive& archive) const
@@ -37,7 +45,7 @@ namespace Lumos
                 std::string newPath = "";
                 if(m_Texture)
                 {
-                    VFS::Get()->AbsoulePathToVFS(m_Texture->GetFilepath(), newPath);
+                    VFS::Get()->AbsoulePathToVFS(GetTexturePath(), newPath);
                 }
 
                 archive(cereal::make_nvp("TexturePath", newPath),
@@ -56,8 +64,11 @@ namespace Lumos
                     cereal::make_nvp("Colour", m_Colour));
 
                 if(!textureFilePath.empty())
-                    m_Texture = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile("sprite", textureFilePath));
+                    SetTextureFromFile(textureFilePath);
             }
+
+        private:
+            std::string m_TexturePath;
         };
     }
 }
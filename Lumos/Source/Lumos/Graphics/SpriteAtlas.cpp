@@ -0,0 +1,140 @@
+#include "Precompiled.h"
+#include "SpriteAtlas.h"
+#include "Graphics/RHI/Texture.h"
+#include "Graphics/RHI/GraphicsContext.h"
+#include "Utilities/LoadImage.h"
+
+namespace Lumos::Graphics
+{
+    SpriteAtlas::~SpriteAtlas()
+    {
+    }
+
+    bool SpriteAtlas::GetRegion(const std::string& filePath, Region& region)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto found = m_Regions.find(filePath);
+        if(found != m_Regions.end())
+        {
+            region = found->second;
+            return true;
+        }
+
+        if(m_Unpacked.find(filePath) != m_Unpacked.end())
+            return false;
+
+        // Rows are stored in the order each API's texture loader uses, so UVs match a texture loaded from the same file
+        const bool flipY = GraphicsContext::GetRenderAPI() == RenderAPI::OPENGL;
+
+        uint32_t width, height, bits;
+        bool isHDR = false;
+        uint8_t* pixels = LoadImageFromFile(filePath, &width, &height, &bits, &isHDR, flipY);
+
+        if(!pixels)
+            return false;
+
+        if(isHDR || width > MaxImageSize || height > MaxImageSize)
+        {
+            delete[] pixels;
+            m_Unpacked.insert(filePath);
+            return false;
+        }
+
+        uint32_t x = 0, y = 0;
+        Page* page = nullptr;
+
+        for(auto& existing : m_Pages)
+        {
+            if(Allocate(existing, width, height, x, y))
+            {
+                page = &existing;
+                break;
+            }
+        }
+
+        if(!page)
+        {
+            page = &m_Pages.emplace_back();
+            page->pixels.resize(PageSize * PageSize * 4, 0);
+            page->texture = SharedRef<Texture2D>(Texture2D::CreateFromSource(PageSize, PageSize, page->pixels.data(), TextureParameters(TextureFilter::NEAREST, TextureFilter::NEAREST, TextureWrap::CLAMP_TO_EDGE)));
+            page->texture->SetName("SpriteAtlas");
+            Allocate(*page, width, height, x, y);
+        }
+
+        Blit(*page, pixels, width, height, x, y);
+        delete[] pixels;
+
+        region.texture = page->texture;
+        region.uvMin = Maths::Vector2(float(x) / PageSize, float(y) / PageSize);
+        region.uvMax = Maths::Vector2(float(x + width) / PageSize, float(y + height) / PageSize);
+        m_Regions[filePath] = region;
+
+        return true;
+    }
+
+    void SpriteAtlas::UploadPages()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        for(auto& page : m_Pages)
+        {
+            if(page.dirtyMaxX <= page.dirtyMinX || page.dirtyMaxY <= page.dirtyMinY)
+                continue;
+
+            const uint8_t* pixels = &page.pixels[(page.dirtyMinY * PageSize + page.dirtyMinX) * 4];
+            page.texture->SetData(pixels, page.dirtyMinX, page.dirtyMinY, page.dirtyMaxX - page.dirtyMinX, page.dirtyMaxY - page.dirtyMinY, PageSize);
+
+            page.dirtyMinX = page.dirtyMinY = PageSize;
+            page.dirtyMaxX = page.dirtyMaxY = 0;
+        }
+    }
+
+    bool SpriteAtlas::Allocate(Page& page, uint32_t width, uint32_t height, uint32_t& x, uint32_t& y)
+    {
+        const uint32_t paddedWidth = width + Padding * 2;
+        const uint32_t paddedHeight = height + Padding * 2;
+
+        if(page.shelfX + paddedWidth > PageSize)
+        {
+            page.shelfY += page.shelfHeight;
+            page.shelfX = 0;
+            page.shelfHeight = 0;
+        }
+
+        if(page.shelfY + paddedHeight > PageSize)
+            return false;
+
+        x = page.shelfX + Padding;
+        y = page.shelfY + Padding;
+
+        page.shelfX += paddedWidth;
+        page.shelfHeight = Maths::Max(page.shelfHeight, paddedHeight);
+        return true;
+    }
+
+    void SpriteAtlas::Blit(Page& page, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t x, uint32_t y)
+    {
+        const int32_t padding = static_cast<int32_t>(Padding);
+
+        for(int32_t row = -padding; row < int32_t(height) + padding; row++)
+        {
+            const uint32_t srcRow = static_cast<uint32_t>(Maths::Clamp(row, 0, int32_t(height) - 1));
+            uint8_t* dst = &page.pixels[((y + row) * PageSize + x - Padding) * 4];
+
+            for(int32_t column = -padding; column < int32_t(width) + padding; column++)
+            {
+                const uint32_t srcColumn = static_cast<uint32_t>(Maths::Clamp(column, 0, int32_t(width) - 1));
+                memcpy(dst, &pixels[(srcRow * width + srcColumn) * 4], 4);
+                dst += 4;
+            }
+        }
+
+        page.dirtyMinX = Maths::Min(page.dirtyMinX, x - Padding);
+        page.dirtyMinY = Maths::Min(page.dirtyMinY, y - Padding);
+        page.dirtyMaxX = Maths::Max(page.dirtyMaxX, x + width + Padding);
+        page.dirtyMaxY = Maths::Max(page.dirtyMaxY, y + height + Padding);
+    }
+}
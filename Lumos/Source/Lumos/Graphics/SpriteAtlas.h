@@ -0,0 +1,74 @@
+#pragma once
+#include "Maths/Maths.h"
+#include "Utilities/TSingleton.h"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace Lumos
+{
+    namespace Graphics
+    {
+        class Texture2D;
+
+        // Packs sprite images into shared pages as they are loaded, so Renderer2D can draw sprites using different
+        // images from the same texture. Images larger than MaxImageSize keep their own texture
+        class LUMOS_EXPORT SpriteAtlas : public ThreadSafeSingleton<SpriteAtlas>
+        {
+            friend class TSingleton<SpriteAtlas>;
+            friend class ThreadSafeSingleton<SpriteAtlas>;
+
+        public:
+            static const uint32_t PageSize = 2048;
+            static const uint32_t MaxImageSize = 256;
+
+            // Border around each image, filled with its edge texels so filtering does not sample a neighbour
+            static const uint32_t Padding = 2;
+
+            struct Region
+            {
+                SharedRef<Texture2D> texture;
+                Maths::Vector2 uvMin;
+                Maths::Vector2 uvMax;
+            };
+
+            // Loads and packs the image the first time it is requested.
+            // Returns false if the image could not be loaded or is too large to pack
+            bool GetRegion(const std::string& filePath, Region& region);
+
+            // Uploads the pages images were packed into since the last call. Called once per frame before drawing
+            void UploadPages();
+
+            uint32_t GetPageCount() const { return static_cast<uint32_t>(m_Pages.size()); }
+
+        private:
+            SpriteAtlas() = default;
+            ~SpriteAtlas();
+
+            struct Page
+            {
+                SharedRef<Texture2D> texture;
+                std::vector<uint8_t> pixels;
+
+                // Images are placed left to right on shelves, a new shelf starts above the tallest image of the last
+                uint32_t shelfX = 0;
+                uint32_t shelfY = 0;
+                uint32_t shelfHeight = 0;
+
+                // Texels written since the last upload, only this rectangle is uploaded
+                uint32_t dirtyMinX = PageSize;
+                uint32_t dirtyMinY = PageSize;
+                uint32_t dirtyMaxX = 0;
+                uint32_t dirtyMaxY = 0;
+            };
+
+            bool Allocate(Page& page, uint32_t width, uint32_t height, uint32_t& x, uint32_t& y);
+            void Blit(Page& page, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t x, uint32_t y);
+
+            std::vector<Page> m_Pages;
+            std::unordered_map<std::string, Region> m_Regions;
+            std::unordered_set<std::string> m_Unpacked;
+            std::mutex m_Mutex;
+        };
+    }
+}
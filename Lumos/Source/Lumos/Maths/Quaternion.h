@@ -26,20 +26,8 @@ namespace Lumos::Maths
 #endif
         }
 
-        /// Copy-construct from another quaternion.
-        Quaternion(const Quaternion& quat) noexcept
-#if defined(LUMOS_SSE) && (!defined(_MSC_VER) || _MSC_VER >= 1700) /* Visual Studio 2012 and newer. VS2010 bug */
-        {
-            _mm_storeu_ps(&w, _mm_loadu_ps(&quat.w));
-        }
-#else
-            : w(quat.w)
-            , x(quat.x)
-            , y(quat.y)
-            , z(quat.z)
-        {
-        }
-#endif
+        /// Copy-construct from another quaternion. Defaulted so quaternions, and components holding them, stay trivially copyable.
+        Quaternion(const Quaternion& quat) noexcept = default;
 
         /// Construct from values.
         Quaternion(float pw, float px, float py, float pz) noexcept
@@ -119,18 +107,7 @@ namespace Lumos::Maths
 #endif
 
         /// Assign from another quaternion.
-        Quaternion& operator=(const Quaternion& rhs) noexcept
-        {
-#if defined(LUMOS_SSE)
-            _mm_storeu_ps(&w, _mm_loadu_ps(&rhs.w));
-#else
-            w = rhs.w;
-            x = rhs.x;
-            y = rhs.y;
-            z = rhs.z;
-#endif
-            return *this;
-        }
+        Quaternion& operator=(const Quaternion& rhs) noexcept = default;
 
         /// Add-assign a quaternion.
         Quaternion& operator+=(const Quaternion& rhs)
@@ -11,9 +11,9 @@ namespace Lumos
             m_LocalPosition = Vector3(0.0f, 0.0f, 0.0f);
             m_LocalOrientation = Quaternion::EulerAnglesToQuaternion(0.0f, 0.0f, 0.0f);
             m_LocalScale = Vector3(1.0f, 1.0f, 1.0f);
-            m_LocalMatrix = Matrix4();
-            m_WorldMatrix = Matrix4();
-            m_ParentMatrix = Matrix4();
+            m_LocalMatrix = Matrix3x4();
+            m_WorldMatrix = Matrix3x4();
+            m_ParentMatrix = Matrix3x4();
         }
 
         Transform::Transform(const Matrix4& matrix)
@@ -21,9 +21,9 @@ namespace Lumos
             m_LocalPosition = matrix.Translation();
             m_LocalOrientation = matrix.Rotation();
             m_LocalScale = matrix.Scale();
-            m_LocalMatrix = matrix;
-            m_WorldMatrix = matrix;
-            m_ParentMatrix = Matrix4();
+            m_LocalMatrix = Matrix3x4(matrix);
+            m_WorldMatrix = m_LocalMatrix;
+            m_ParentMatrix = Matrix3x4();
         }
 
         Transform::Transform(const Vector3& position)
@@ -31,17 +31,15 @@ namespace Lumos
             m_LocalPosition = position;
             m_LocalOrientation = Quaternion::EulerAnglesToQuaternion(0.0f, 0.0f, 0.0f);
             m_LocalScale = Vector3(1.0f, 1.0f, 1.0f);
-            m_LocalMatrix = Matrix4();
-            m_WorldMatrix = Matrix4();
-            m_ParentMatrix = Matrix4();
+            m_LocalMatrix = Matrix3x4();
+            m_WorldMatrix = Matrix3x4();
+            m_ParentMatrix = Matrix3x4();
             SetLocalPosition(position);
         }
 
-        Transform::~Transform() = default;
-
         void Transform::UpdateMatrices()
         {
-            m_LocalMatrix = Matrix4::Translation(m_LocalPosition) * m_LocalOrientation.RotationMatrix4() * Matrix4::Scale(m_LocalScale);
+            m_LocalMatrix = Matrix3x4(m_LocalPosition, m_LocalOrientation, m_LocalScale);
 
             m_WorldMatrix = m_ParentMatrix * m_LocalMatrix;
             m_Dirty = false;
@@ -56,6 +54,11 @@ namespace Lumos
         }
 
         void Transform::SetWorldMatrix(const Matrix4& mat)
+        {
+            SetWorldMatrix(Matrix3x4(mat));
+        }
+
+        void Transform::SetWorldMatrix(const Matrix3x4& mat)
         {
             if(m_Dirty)
                 UpdateMatrices();
@@ -65,7 +68,7 @@ namespace Lumos
 
         void Transform::SetLocalTransform(const Matrix4& localMat)
         {
-            m_LocalMatrix = localMat;
+            m_LocalMatrix = Matrix3x4(localMat);
             m_HasUpdated = true;
 
             ApplyTransform();
@@ -89,7 +92,17 @@ namespace Lumos
             m_LocalOrientation = quat;
         }
 
-        const Matrix4& Transform::GetWorldMatrix()
+        Matrix4 Transform::GetWorldMatrix()
+        {
+            return GetAffineWorldMatrix().ToMatrix4();
+        }
+
+        Matrix4 Transform::GetLocalMatrix()
+        {
+            return GetAffineLocalMatrix().ToMatrix4();
+        }
+
+        const Matrix3x4& Transform::GetAffineWorldMatrix()
         {
             if(m_Dirty)
                 UpdateMatrices();
@@ -97,7 +110,7 @@ namespace Lumos
             return m_WorldMatrix;
         }
 
-        const Matrix4& Transform::GetLocalMatrix()
+        const Matrix3x4& Transform::GetAffineLocalMatrix()
         {
             if(m_Dirty)
                 UpdateMatrices();
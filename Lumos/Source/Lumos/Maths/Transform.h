@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Maths/Maths.h"
+#include "Maths/Matrix3x4.h"
 
 #include <cereal/cereal.hpp>
 
@@ -14,9 +15,11 @@ namespace Lumos
             Transform();
             Transform(const Matrix4& matrix);
             Transform(const Vector3& position);
-            ~Transform();
+            ~Transform() = default;
 
+            // Sets the parent's world matrix and recomputes this transform's
             void SetWorldMatrix(const Matrix4& mat);
+            void SetWorldMatrix(const Matrix3x4& mat);
 
             void SetLocalTransform(const Matrix4& localMat);
 
@@ -24,8 +27,12 @@ namespace Lumos
             void SetLocalScale(const Vector3& localScale);
             void SetLocalOrientation(const Quaternion& quat);
 
-            const Matrix4& GetWorldMatrix();
-            const Matrix4& GetLocalMatrix();
+            // Widened to 4x4, prefer the affine versions when the result is only composed or used for bounds
+            Matrix4 GetWorldMatrix();
+            Matrix4 GetLocalMatrix();
+
+            const Matrix3x4& GetAffineWorldMatrix();
+            const Matrix3x4& GetAffineLocalMatrix();
 
             const Vector3 GetWorldPosition() const;
             const Quaternion GetWorldOrientation() const;
@@ -37,9 +44,13 @@ namespace Lumos
             //Updates Local Matrix from R,T and S vectors
             void UpdateMatrices();
 
+            // Set when the local matrix changes, cleared once the scene graph has updated the world matrix
             bool HasUpdated() const { return m_HasUpdated; }
             void SetHasUpdated(bool set) { m_HasUpdated = set; }
 
+            // Local position, orientation or scale changed since the local matrix was last built
+            bool IsDirty() const { return m_Dirty; }
+
             //Sets R,T and S vectors from Local Matrix
             void ApplyTransform();
 
@@ -77,12 +88,13 @@ namespace Lumos
                 m_Dirty = true;
             }
 
-            const Matrix4& GetParentMatrix() const { return m_ParentMatrix; }
+            const Matrix3x4& GetParentMatrix() const { return m_ParentMatrix; }
 
         protected:
-            Matrix4 m_LocalMatrix;
-            Matrix4 m_ParentMatrix;
-            Matrix4 m_WorldMatrix;
+            // Transforms never hold a projection, so the last row is implicit
+            Matrix3x4 m_LocalMatrix;
+            Matrix3x4 m_ParentMatrix;
+            Matrix3x4 m_WorldMatrix;
 
             Vector3 m_LocalPosition;
             Vector3 m_LocalScale;
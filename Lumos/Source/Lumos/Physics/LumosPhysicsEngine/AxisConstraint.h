@@ -31,6 +31,16 @@ namespace Lumos
         virtual void ApplyImpulse() override;
         virtual void DebugDraw() const override;
 
+        RigidBody3D* GetBodyA() const override
+        {
+            return m_pObj1;
+        }
+
+        RigidBody3D* GetBodyB() const override
+        {
+            return nullptr;
+        }
+
     protected:
         RigidBody3D* m_pObj1;
         Axes m_Axes;
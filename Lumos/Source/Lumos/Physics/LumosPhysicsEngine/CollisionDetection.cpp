@@ -52,45 +52,56 @@ namespace Lumos
         return true;
     }
 
-    void AddPossibleCollisionAxis(Maths::Vector3& axis, std::vector<Maths::Vector3>* possible_collision_axes)
+    namespace
     {
-        LUMOS_PROFILE_FUNCTION();
-        const float epsilon = 0.0001f;
+        // Candidate separating axes for one pair, kept on the stack so the narrowphase doesn't allocate.
+        // Once full, further axes are still tested, they just aren't checked for duplicates
+        struct CollisionAxisSet
+        {
+            static const uint32_t Capacity = 32;
 
-        if(axis.LengthSquared() < epsilon)
-            return;
+            Maths::Vector3 Axes[Capacity];
+            uint32_t Count = 0;
 
-        axis.Normalise();
+            // Normalises the axis, returns false if it is degenerate or parallel to one already added
+            bool Add(Maths::Vector3& axis)
+            {
+                const float epsilon = 0.0001f;
 
-        float value = (1.0f - epsilon);
-        auto& axes = *possible_collision_axes;
+                if(axis.LengthSquared() < epsilon)
+                    return false;
 
-        for(const Maths::Vector3& p_axis : axes)
-        {
-            if(abs(Maths::Vector3::Dot(axis, p_axis)) >= value)
-                return;
-        }
+                axis.Normalise();
 
-        possible_collision_axes->push_back(axis);
+                const float value = (1.0f - epsilon);
+                for(uint32_t i = 0; i < Count; i++)
+                {
+                    if(abs(Maths::Vector3::Dot(axis, Axes[i])) >= value)
+                        return false;
+                }
+
+                if(Count < Capacity)
+                    Axes[Count++] = axis;
+
+                return true;
+            }
+        };
     }
 
     bool CollisionDetection::CheckPolyhedronSphereCollision(RigidBody3D* obj1, RigidBody3D* obj2, CollisionShape* shape1, CollisionShape* shape2, CollisionData* out_coldata)
     {
         LUMOS_PROFILE_FUNCTION();
-        CollisionShape* complexShape;
         RigidBody3D* complexObj;
         RigidBody3D* sphereObj;
 
         if(obj1->GetCollisionShape()->GetType() == CollisionShapeType::CollisionSphere)
         {
             sphereObj = obj1;
-            complexShape = shape2;
             complexObj = obj2;
         }
         else
         {
             sphereObj = obj2;
-            complexShape = shape1;
             complexObj = obj1;
         }
 
@@ -98,23 +109,32 @@ namespace Lumos
         CollisionData best_colData;
         best_colData.penetration = -FLT_MAX;
 
-        std::vector<Maths::Vector3> possibleCollisionAxes = complexShape->GetCollisionAxes(complexObj);
-        std::vector<CollisionEdge>& complex_shape_edges = complexShape->GetEdges(complexObj);
-
-        Maths::Vector3 p = GetClosestPointOnEdges(sphereObj->GetPosition(), complex_shape_edges);
-        Maths::Vector3 p_t = sphereObj->GetPosition() - p;
-        p_t.Normalise();
-        AddPossibleCollisionAxis(p_t, &possibleCollisionAxes);
+        CollisionAxisSet possibleCollisionAxes;
 
-        for(const Maths::Vector3& axis : possibleCollisionAxes)
+        auto testAxis = [&](Maths::Vector3 axis)
         {
+            if(!possibleCollisionAxes.Add(axis))
+                return true;
+
             if(!CheckCollisionAxis(axis, obj1, obj2, shape1, shape2, &cur_colData))
                 return false;
 
             if(cur_colData.penetration > best_colData.penetration)
                 best_colData = cur_colData;
+
+            return true;
+        };
+
+        for(const Maths::Vector3& axis : complexObj->GetCollisionAxes())
+        {
+            if(!testAxis(axis))
+                return false;
         }
 
+        Maths::Vector3 p = GetClosestPointOnEdges(sphereObj->GetPosition(), complexObj->GetCollisionEdges());
+        if(!testAxis(sphereObj->GetPosition() - p))
+            return false;
+
         if(out_coldata)
             *out_coldata = best_colData;
 
@@ -128,36 +148,43 @@ namespace Lumos
         CollisionData best_colData;
         best_colData.penetration = -FLT_MAX;
 
-        std::vector<Maths::Vector3> possibleCollisionAxes = shape1->GetCollisionAxes(obj1);
-        std::vector<Maths::Vector3>& tempPossibleCollisionAxes = shape2->GetCollisionAxes(obj2);
+        // World space axes and edge directions were cached on each body before the narrowphase,
+        // so every axis is tested as it is generated and the first separating one exits early
+        CollisionAxisSet possibleCollisionAxes;
 
-        for(Maths::Vector3& temp : tempPossibleCollisionAxes)
-            AddPossibleCollisionAxis(temp, &possibleCollisionAxes);
+        auto testAxis = [&](Maths::Vector3 axis)
+        {
+            if(!possibleCollisionAxes.Add(axis))
+                return true;
 
-        std::vector<CollisionEdge>& shape1_edges = shape1->GetEdges(obj1);
-        std::vector<CollisionEdge>& shape2_edges = shape2->GetEdges(obj2);
+            if(!CheckCollisionAxis(axis, obj1, obj2, shape1, shape2, &cur_colData))
+                return false;
 
-        for(const CollisionEdge& edge1 : shape1_edges)
-        {
-            for(const CollisionEdge& edge2 : shape2_edges)
-            {
-                Maths::Vector3 e1 = edge1.posB - edge1.posA;
-                Maths::Vector3 e2 = edge2.posB - edge2.posA;
-                e1.Normalise();
-                e2.Normalise();
+            if(cur_colData.penetration >= best_colData.penetration)
+                best_colData = cur_colData;
 
-                Maths::Vector3 temp = e1.CrossProduct(e2);
-                AddPossibleCollisionAxis(temp, &possibleCollisionAxes);
-            }
+            return true;
+        };
+
+        for(const Maths::Vector3& axis : obj1->GetCollisionAxes())
+        {
+            if(!testAxis(axis))
+                return false;
         }
 
-        for(const Maths::Vector3& axis : possibleCollisionAxes)
+        for(const Maths::Vector3& axis : obj2->GetCollisionAxes())
         {
-            if(!CheckCollisionAxis(axis, obj1, obj2, shape1, shape2, &cur_colData))
+            if(!testAxis(axis))
                 return false;
+        }
 
-            if(cur_colData.penetration >= best_colData.penetration)
-                best_colData = cur_colData;
+        for(const Maths::Vector3& e1 : obj1->GetCollisionEdgeDirections())
+        {
+            for(const Maths::Vector3& e2 : obj2->GetCollisionEdgeDirections())
+            {
+                if(!testAxis(e1.CrossProduct(e2)))
+                    return false;
+            }
         }
 
         if(out_coldata)
@@ -349,13 +376,17 @@ namespace Lumos
         if(!output_polygon)
             return;
 
-        Maths::Vector3 ppPolygon1[8], ppPolygon2[8];
-        int inputCount = 0, outputCount = 0;
+        // Each clip plane adds at most one vertex to a convex polygon, so the buffers hold the input plus one
+        // vertex per plane. ReferencePolygon::Faces, which callers clip into, has the same capacity
+        const int maxPoints = static_cast<int>(ReferencePolygon::MaxClippedVertices);
+        LUMOS_ASSERT(input_polygon_count <= ReferencePolygon::MaxFaceVertices && num_clip_planes <= ReferencePolygon::MaxAdjacentPlanes, "Clipped polygon can exceed ReferencePolygon::MaxClippedVertices");
+
+        Maths::Vector3 ppPolygon1[maxPoints], ppPolygon2[maxPoints];
+        bool inPlane[maxPoints];
+        int inputCount = 0, outputCount = Maths::Min(input_polygon_count, maxPoints);
 
         Maths::Vector3 *input = ppPolygon1, *output = ppPolygon2;
-        inputCount = input_polygon_count;
-        output = input_polygon;
-        outputCount = inputCount;
+        std::copy(input_polygon, input_polygon + outputCount, output);
 
         for(int iterations = 0; iterations < num_clip_planes; ++iterations)
         {
@@ -367,14 +398,38 @@ namespace Lumos
             std::swap(input, output);
             inputCount = outputCount;
 
+            // Every point ending inside is kept and every edge crossing the plane adds its intersection
+            for(int i = 0; i < inputCount; i++)
+                inPlane[i] = plane.PointInPlane(input[i]);
+
+            int clippedCount = 0;
+            for(int i = 0; i < inputCount; i++)
+            {
+                const bool startInPlane = inPlane[(i + inputCount - 1) % inputCount];
+                if(inPlane[i])
+                    clippedCount++;
+                if(!removePoints && startInPlane != inPlane[i])
+                    clippedCount++;
+            }
+
+            // Points lying on the plane can classify inconsistently and make the polygon cross it more than
+            // twice. Rather than drop contact points, leave the polygon unclipped by this plane
+            if(clippedCount > maxPoints)
+            {
+                LUMOS_LOG_WARN("Skipping clip plane, clipping would produce {0} points", clippedCount);
+                std::swap(input, output);
+                outputCount = inputCount;
+                continue;
+            }
+
             outputCount = 0;
 
             Maths::Vector3 startPoint = input[inputCount - 1];
+            bool startInPlane = inPlane[inputCount - 1];
             for(int i = 0; i < inputCount; i++)
             {
                 const auto& endPoint = input[i];
-                bool startInPlane = plane.PointInPlane(startPoint);
-                bool endInPlane = plane.PointInPlane(endPoint);
+                const bool endInPlane = inPlane[i];
 
                 if(removePoints)
                 {
@@ -398,10 +453,11 @@ namespace Lumos
                 }
 
                 startPoint = endPoint;
+                startInPlane = endInPlane;
             }
         }
 
-        output_polygon = output;
         output_polygon_count = outputCount;
+        std::copy(output, output + output_polygon_count, output_polygon);
     }
 }
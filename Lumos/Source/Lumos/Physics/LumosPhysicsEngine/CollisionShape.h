@@ -10,8 +10,14 @@ namespace Lumos
 
     struct ReferencePolygon
     {
-        Maths::Vector3 Faces[8];
-        Maths::Plane AdjacentPlanes[8];
+        static const uint32_t MaxFaceVertices = 8;
+        static const uint32_t MaxAdjacentPlanes = 8;
+
+        // Faces is clipped in place against the adjacent planes, each plane adds at most one vertex
+        static const uint32_t MaxClippedVertices = MaxFaceVertices + MaxAdjacentPlanes;
+
+        Maths::Vector3 Faces[MaxClippedVertices];
+        Maths::Plane AdjacentPlanes[MaxAdjacentPlanes];
         Maths::Vector3 Normal;
         uint32_t FaceCount = 0;
         uint32_t PlaneCount = 0;
@@ -61,13 +67,14 @@ namespace Lumos
 
         //<----- USED BY COLLISION DETECTION ----->
         // Get all possible collision axes
-        //	- This is a list of all the face normals ignoring any duplicates and parallel vectors.
-        virtual std::vector<Maths::Vector3>& GetCollisionAxes(const RigidBody3D* currentObject) = 0;
+        //	- Appends all the world space face normals ignoring any duplicates and parallel vectors.
+        //    Shapes may be shared between bodies, so nothing is written to the shape itself.
+        virtual void GetCollisionAxes(const RigidBody3D* currentObject, std::vector<Maths::Vector3>& out_axes) const = 0;
 
         // Get all shape Edges
-        //	- Returns a list of all edges AB that form the convex hull of the collision shape. These are
+        //	- Appends all world space edges AB that form the convex hull of the collision shape. These are
         //    used to check edge/edge collisions aswell as finding the closest point to a sphere. */
-        virtual std::vector<CollisionEdge>& GetEdges(const RigidBody3D* currentObject) = 0;
+        virtual void GetEdges(const RigidBody3D* currentObject, std::vector<CollisionEdge>& out_edges) const = 0;
 
         // Get the min/max vertices along a given axis
         virtual void GetMinMaxVertexOnAxis(
@@ -109,7 +116,5 @@ namespace Lumos
     protected:
         CollisionShapeType m_Type;
         Maths::Matrix4 m_LocalTransform;
-        std::vector<CollisionEdge> m_Edges;
-        std::vector<Maths::Vector3> m_Axes;
     };
 }
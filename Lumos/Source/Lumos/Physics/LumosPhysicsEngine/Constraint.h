@@ -2,6 +2,7 @@
 
 namespace Lumos
 {
+    class RigidBody3D;
 
     class LUMOS_EXPORT Constraint
     {
@@ -21,5 +22,16 @@ namespace Lumos
         virtual void DebugDraw() const
         {
         }
+
+        //Bodies written by ApplyImpulse, used by the solver to batch constraints that can be solved in parallel
+        virtual RigidBody3D* GetBodyA() const
+        {
+            return nullptr;
+        }
+
+        virtual RigidBody3D* GetBodyB() const
+        {
+            return nullptr;
+        }
     };
 }
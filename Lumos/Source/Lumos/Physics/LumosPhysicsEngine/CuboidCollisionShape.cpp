@@ -17,9 +17,6 @@ namespace Lumos
         {
             ConstructCubeHull();
         }
-
-        m_Axes.resize(3);
-        m_Edges.resize(m_CubeHull->GetNumEdges());
     }
 
     CuboidCollisionShape::CuboidCollisionShape(const Maths::Vector3& halfdims)
@@ -32,9 +29,6 @@ namespace Lumos
         {
             ConstructCubeHull();
         }
-
-        m_Axes.resize(3);
-        m_Edges.resize(m_CubeHull->GetNumEdges());
     }
 
     CuboidCollisionShape::~CuboidCollisionShape()
@@ -56,22 +50,18 @@ namespace Lumos
         return inertia;
     }
 
-    std::vector<Maths::Vector3>& CuboidCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject)
+    void CuboidCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject, std::vector<Maths::Vector3>& out_axes) const
     {
         LUMOS_PROFILE_FUNCTION();
         {
-            m_Axes.resize(3);
-
             Maths::Matrix3 objOrientation = currentObject->GetOrientation().RotationMatrix();
-            m_Axes[0] = (objOrientation * Maths::Vector3(1.0f, 0.0f, 0.0f)); //X - Axis
-            m_Axes[1] = (objOrientation * Maths::Vector3(0.0f, 1.0f, 0.0f)); //Y - Axis
-            m_Axes[2] = (objOrientation * Maths::Vector3(0.0f, 0.0f, 1.0f)); //Z - Axis
+            out_axes.push_back(objOrientation * Maths::Vector3(1.0f, 0.0f, 0.0f)); //X - Axis
+            out_axes.push_back(objOrientation * Maths::Vector3(0.0f, 1.0f, 0.0f)); //Y - Axis
+            out_axes.push_back(objOrientation * Maths::Vector3(0.0f, 0.0f, 1.0f)); //Z - Axis
         }
-
-        return m_Axes;
     }
 
-    std::vector<CollisionEdge>& CuboidCollisionShape::GetEdges(const RigidBody3D* currentObject)
+    void CuboidCollisionShape::GetEdges(const RigidBody3D* currentObject, std::vector<CollisionEdge>& out_edges) const
     {
         LUMOS_PROFILE_FUNCTION();
         {
@@ -82,10 +72,9 @@ namespace Lumos
                 Maths::Vector3 A = transform * m_CubeHull->GetVertex(edge.vStart).pos;
                 Maths::Vector3 B = transform * m_CubeHull->GetVertex(edge.vEnd).pos;
 
-                m_Edges[i] = { A, B };
+                out_edges.emplace_back(A, B);
             }
         }
-        return m_Edges;
     }
 
     void CuboidCollisionShape::GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Maths::Vector3& axis, Maths::Vector3* out_min, Maths::Vector3* out_max) const
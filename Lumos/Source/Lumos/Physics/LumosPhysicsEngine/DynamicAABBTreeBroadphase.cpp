@@ -0,0 +1,530 @@
+#include "Precompiled.h"
+#include "DynamicAABBTreeBroadphase.h"
+#include "LumosPhysicsEngine.h"
+#include "Maths/Ray.h"
+#include "Graphics/Renderers/DebugRenderer.h"
+
+namespace Lumos
+{
+    namespace
+    {
+        float SurfaceArea(const Maths::BoundingBox& box)
+        {
+            const Maths::Vector3 size = box.Size();
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        Maths::BoundingBox Combine(const Maths::BoundingBox& a, const Maths::BoundingBox& b)
+        {
+            Maths::BoundingBox box = a;
+            box.Merge(b);
+            return box;
+        }
+
+        bool Overlaps(const Maths::BoundingBox& a, const Maths::BoundingBox& b)
+        {
+            return a.IsInsideFast(b) != Maths::OUTSIDE;
+        }
+
+        uint64_t PairKey(int32_t nodeA, int32_t nodeB)
+        {
+            if(nodeA > nodeB)
+                std::swap(nodeA, nodeB);
+            return (static_cast<uint64_t>(nodeA) << 32) | static_cast<uint32_t>(nodeB);
+        }
+
+        bool IsInactive(RigidBody3D* body)
+        {
+            return body->GetIsAtRest() || body->GetIsStatic();
+        }
+    }
+
+    DynamicAABBTreeBroadphase::DynamicAABBTreeBroadphase(float aabbMargin, float displacementMultiplier)
+        : m_AABBMargin(aabbMargin)
+        , m_DisplacementMultiplier(displacementMultiplier)
+    {
+    }
+
+    DynamicAABBTreeBroadphase::~DynamicAABBTreeBroadphase()
+    {
+    }
+
+    void DynamicAABBTreeBroadphase::FindPotentialCollisionPairs(RigidBody3D** objects, uint32_t objectCount, std::vector<CollisionPair>& collisionPairs)
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        m_Frame++;
+        m_MovedNodes.clear();
+        m_NewPairs.clear();
+        size_t seenCount = 0;
+
+        {
+            LUMOS_PROFILE_SCOPE("Update Proxies");
+            const float timeStep = LumosPhysicsEngine::GetDeltaTime() * m_DisplacementMultiplier;
+
+            for(uint32_t i = 0; i < objectCount; i++)
+            {
+                RigidBody3D* body = objects[i];
+                if(!body || !body->GetCollisionShape())
+                    continue;
+
+                auto it = m_Proxies.find(body);
+                seenCount++;
+                if(it == m_Proxies.end())
+                {
+                    m_Proxies[body] = { CreateProxy(body), m_Frame };
+                    continue;
+                }
+
+                Proxy& proxy = it->second;
+                proxy.LastSeen = m_Frame;
+
+                // Sleeping bodies can't have left their fat AABB
+                if(body->GetIsAtRest())
+                    continue;
+
+                if(MoveProxy(proxy.Node, body->GetWorldSpaceAABB(), body->GetLinearVelocity() * timeStep))
+                    m_MovedNodes.push_back(proxy.Node);
+            }
+        }
+
+        // Bodies that were removed from the scene or lost their collision shape
+        if(m_Proxies.size() > seenCount)
+        {
+            LUMOS_PROFILE_SCOPE("Remove Stale Proxies");
+            for(auto it = m_Proxies.begin(); it != m_Proxies.end();)
+            {
+                if(it->second.LastSeen != m_Frame)
+                {
+                    DestroyProxy(it->second.Node);
+                    it = m_Proxies.erase(it);
+                }
+                else
+                    ++it;
+            }
+        }
+
+        {
+            LUMOS_PROFILE_SCOPE("Remove Separated Pairs");
+            for(uint32_t i = 0; i < m_Pairs.size();)
+            {
+                const ProxyPair& pair = m_Pairs[i];
+                if(Overlaps(m_Nodes[pair.NodeA].Box, m_Nodes[pair.NodeB].Box))
+                {
+                    i++;
+                    continue;
+                }
+
+                m_PairLookup.erase(PairKey(pair.NodeA, pair.NodeB));
+                m_Pairs[i] = m_Pairs.back();
+                m_Pairs.pop_back();
+                if(i < m_Pairs.size())
+                    m_PairLookup[PairKey(m_Pairs[i].NodeA, m_Pairs[i].NodeB)] = i;
+            }
+        }
+
+        {
+            LUMOS_PROFILE_SCOPE("Query Moved Proxies");
+            for(int32_t node : m_MovedNodes)
+            {
+                Query(m_Nodes[node].Box, [this, node](int32_t other)
+                    {
+                        if(other != node)
+                            AddPair(node, other);
+                        return true;
+                    });
+            }
+        }
+
+        collisionPairs.reserve(collisionPairs.size() + m_Pairs.size());
+        for(const ProxyPair& pair : m_Pairs)
+        {
+            RigidBody3D* bodyA = m_Nodes[pair.NodeA].Body;
+            RigidBody3D* bodyB = m_Nodes[pair.NodeB].Body;
+
+            // Skip pairs of two at rest/static objects
+            if(IsInactive(bodyA) && IsInactive(bodyB))
+                continue;
+
+            CollisionPair cp;
+            cp.pObjectA = bodyA;
+            cp.pObjectB = bodyB;
+            collisionPairs.push_back(cp);
+        }
+    }
+
+    void DynamicAABBTreeBroadphase::AddPair(int32_t nodeA, int32_t nodeB)
+    {
+        RigidBody3D* bodyA = m_Nodes[nodeA].Body;
+        RigidBody3D* bodyB = m_Nodes[nodeB].Body;
+        if(bodyA->GetIsStatic() && bodyB->GetIsStatic())
+            return;
+
+        const uint64_t key = PairKey(nodeA, nodeB);
+        if(m_PairLookup.find(key) != m_PairLookup.end())
+            return;
+
+        // Keep a consistent order within the pair regardless of which proxy moved
+        if(nodeA > nodeB)
+            std::swap(nodeA, nodeB);
+
+        m_PairLookup[key] = static_cast<uint32_t>(m_Pairs.size());
+        m_Pairs.push_back({ nodeA, nodeB });
+
+        CollisionPair cp;
+        cp.pObjectA = m_Nodes[nodeA].Body;
+        cp.pObjectB = m_Nodes[nodeB].Body;
+        m_NewPairs.push_back(cp);
+    }
+
+    template <typename Callback>
+    void DynamicAABBTreeBroadphase::Query(const Maths::BoundingBox& box, Callback callback) const
+    {
+        if(m_Root == NullNode)
+            return;
+
+        m_QueryStack.clear();
+        m_QueryStack.push_back(m_Root);
+
+        while(!m_QueryStack.empty())
+        {
+            const int32_t index = m_QueryStack.back();
+            m_QueryStack.pop_back();
+
+            const TreeNode& node = m_Nodes[index];
+            if(!Overlaps(node.Box, box))
+                continue;
+
+            if(node.IsLeaf())
+            {
+                if(!callback(index))
+                    return;
+            }
+            else
+            {
+                m_QueryStack.push_back(node.Child1);
+                m_QueryStack.push_back(node.Child2);
+            }
+        }
+    }
+
+    void DynamicAABBTreeBroadphase::QueryAABB(const Maths::BoundingBox& box, std::vector<RigidBody3D*>& results) const
+    {
+        LUMOS_PROFILE_FUNCTION();
+        Query(box, [this, &results](int32_t node)
+            {
+                results.push_back(m_Nodes[node].Body);
+                return true;
+            });
+    }
+
+    void DynamicAABBTreeBroadphase::RayCast(const Maths::Ray& ray, float maxDistance, std::vector<RigidBody3D*>& results) const
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(m_Root == NullNode)
+            return;
+
+        std::vector<std::pair<float, RigidBody3D*>> hits;
+        m_QueryStack.clear();
+        m_QueryStack.push_back(m_Root);
+
+        while(!m_QueryStack.empty())
+        {
+            const int32_t index = m_QueryStack.back();
+            m_QueryStack.pop_back();
+
+            const TreeNode& node = m_Nodes[index];
+            if(ray.HitDistance(node.Box) > maxDistance)
+                continue;
+
+            if(node.IsLeaf())
+            {
+                // Fat AABB was hit, check against the tight one
+                const float distance = ray.HitDistance(node.Body->GetWorldSpaceAABB());
+                if(distance <= maxDistance)
+                    hits.emplace_back(distance, node.Body);
+            }
+            else
+            {
+                m_QueryStack.push_back(node.Child1);
+                m_QueryStack.push_back(node.Child2);
+            }
+        }
+
+        std::sort(hits.begin(), hits.end(), [](const std::pair<float, RigidBody3D*>& a, const std::pair<float, RigidBody3D*>& b)
+            { return a.first < b.first; });
+
+        for(auto& hit : hits)
+            results.push_back(hit.second);
+    }
+
+    int32_t DynamicAABBTreeBroadphase::CreateProxy(RigidBody3D* body)
+    {
+        const int32_t node = AllocateNode();
+        m_Nodes[node].Body = body;
+        m_Nodes[node].Box = FattenAABB(body->GetWorldSpaceAABB(), Maths::Vector3(0.0f));
+        m_Nodes[node].Height = 0;
+
+        InsertLeaf(node);
+        m_MovedNodes.push_back(node);
+        return node;
+    }
+
+    void DynamicAABBTreeBroadphase::DestroyProxy(int32_t node)
+    {
+        for(uint32_t i = 0; i < m_Pairs.size();)
+        {
+            if(m_Pairs[i].NodeA != node && m_Pairs[i].NodeB != node)
+            {
+                i++;
+                continue;
+            }
+
+            m_PairLookup.erase(PairKey(m_Pairs[i].NodeA, m_Pairs[i].NodeB));
+            m_Pairs[i] = m_Pairs.back();
+            m_Pairs.pop_back();
+            if(i < m_Pairs.size())
+                m_PairLookup[PairKey(m_Pairs[i].NodeA, m_Pairs[i].NodeB)] = i;
+        }
+
+        m_MovedNodes.erase(std::remove(m_MovedNodes.begin(), m_MovedNodes.end(), node), m_MovedNodes.end());
+
+        RemoveLeaf(node);
+        FreeNode(node);
+    }
+
+    bool DynamicAABBTreeBroadphase::MoveProxy(int32_t node, const Maths::BoundingBox& box, const Maths::Vector3& displacement)
+    {
+        if(m_Nodes[node].Box.IsInside(box) == Maths::INSIDE)
+            return false;
+
+        RemoveLeaf(node);
+        m_Nodes[node].Box = FattenAABB(box, displacement);
+        InsertLeaf(node);
+        return true;
+    }
+
+    Maths::BoundingBox DynamicAABBTreeBroadphase::FattenAABB(const Maths::BoundingBox& box, const Maths::Vector3& displacement) const
+    {
+        const Maths::Vector3 margin(m_AABBMargin);
+        Maths::BoundingBox fat(box.min_ - margin, box.max_ + margin);
+
+        // Extend in the direction of travel so fast bodies don't need reinserting every step
+        (displacement.x < 0.0f ? fat.min_.x : fat.max_.x) += displacement.x;
+        (displacement.y < 0.0f ? fat.min_.y : fat.max_.y) += displacement.y;
+        (displacement.z < 0.0f ? fat.min_.z : fat.max_.z) += displacement.z;
+
+        return fat;
+    }
+
+    int32_t DynamicAABBTreeBroadphase::AllocateNode()
+    {
+        if(m_FreeList == NullNode)
+        {
+            m_Nodes.emplace_back();
+            return static_cast<int32_t>(m_Nodes.size() - 1);
+        }
+
+        const int32_t node = m_FreeList;
+        m_FreeList = m_Nodes[node].Parent;
+        m_Nodes[node] = TreeNode();
+        return node;
+    }
+
+    void DynamicAABBTreeBroadphase::FreeNode(int32_t node)
+    {
+        m_Nodes[node].Body = nullptr;
+        m_Nodes[node].Height = -1;
+        m_Nodes[node].Parent = m_FreeList;
+        m_FreeList = node;
+    }
+
+    void DynamicAABBTreeBroadphase::InsertLeaf(int32_t leaf)
+    {
+        if(m_Root == NullNode)
+        {
+            m_Root = leaf;
+            m_Nodes[m_Root].Parent = NullNode;
+            return;
+        }
+
+        // Find the best sibling by descending towards the smallest increase in surface area
+        const Maths::BoundingBox leafBox = m_Nodes[leaf].Box;
+        int32_t index = m_Root;
+
+        while(!m_Nodes[index].IsLeaf())
+        {
+            const TreeNode& node = m_Nodes[index];
+            const float area = SurfaceArea(node.Box);
+            const float combinedArea = SurfaceArea(Combine(node.Box, leafBox));
+
+            // Cost of creating a new parent for this node and the new leaf
+            const float cost = 2.0f * combinedArea;
+            // Minimum cost of pushing the leaf further down the tree
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto childCost = [&](int32_t child)
+            {
+                const float newArea = SurfaceArea(Combine(m_Nodes[child].Box, leafBox));
+                if(m_Nodes[child].IsLeaf())
+                    return newArea + inheritanceCost;
+                return newArea - SurfaceArea(m_Nodes[child].Box) + inheritanceCost;
+            };
+
+            const float cost1 = childCost(node.Child1);
+            const float cost2 = childCost(node.Child2);
+
+            if(cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? node.Child1 : node.Child2;
+        }
+
+        const int32_t sibling = index;
+        const int32_t oldParent = m_Nodes[sibling].Parent;
+        const int32_t newParent = AllocateNode();
+
+        m_Nodes[newParent].Parent = oldParent;
+        m_Nodes[newParent].Box = Combine(leafBox, m_Nodes[sibling].Box);
+        m_Nodes[newParent].Height = m_Nodes[sibling].Height + 1;
+        m_Nodes[newParent].Child1 = sibling;
+        m_Nodes[newParent].Child2 = leaf;
+        m_Nodes[sibling].Parent = newParent;
+        m_Nodes[leaf].Parent = newParent;
+
+        if(oldParent == NullNode)
+            m_Root = newParent;
+        else if(m_Nodes[oldParent].Child1 == sibling)
+            m_Nodes[oldParent].Child1 = newParent;
+        else
+            m_Nodes[oldParent].Child2 = newParent;
+
+        // Refit and rebalance the ancestors
+        index = m_Nodes[leaf].Parent;
+        while(index != NullNode)
+        {
+            index = Balance(index);
+
+            TreeNode& node = m_Nodes[index];
+            node.Height = 1 + Maths::Max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+            node.Box = Combine(m_Nodes[node.Child1].Box, m_Nodes[node.Child2].Box);
+
+            index = node.Parent;
+        }
+    }
+
+    void DynamicAABBTreeBroadphase::RemoveLeaf(int32_t leaf)
+    {
+        if(leaf == m_Root)
+        {
+            m_Root = NullNode;
+            return;
+        }
+
+        const int32_t parent = m_Nodes[leaf].Parent;
+        const int32_t grandParent = m_Nodes[parent].Parent;
+        const int32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+        FreeNode(parent);
+
+        if(grandParent == NullNode)
+        {
+            m_Root = sibling;
+            m_Nodes[sibling].Parent = NullNode;
+            return;
+        }
+
+        // Replace the parent with the sibling and refit the ancestors
+        if(m_Nodes[grandParent].Child1 == parent)
+            m_Nodes[grandParent].Child1 = sibling;
+        else
+            m_Nodes[grandParent].Child2 = sibling;
+        m_Nodes[sibling].Parent = grandParent;
+
+        int32_t index = grandParent;
+        while(index != NullNode)
+        {
+            index = Balance(index);
+
+            TreeNode& node = m_Nodes[index];
+            node.Height = 1 + Maths::Max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+            node.Box = Combine(m_Nodes[node.Child1].Box, m_Nodes[node.Child2].Box);
+
+            index = node.Parent;
+        }
+    }
+
+    int32_t DynamicAABBTreeBroadphase::Balance(int32_t iA)
+    {
+        // Rotate the taller child up if the subtree is unbalanced, returns the new root of the subtree
+        TreeNode& A = m_Nodes[iA];
+        if(A.IsLeaf() || A.Height < 2)
+            return iA;
+
+        const int32_t iB = A.Child1;
+        const int32_t iC = A.Child2;
+        const int32_t balance = m_Nodes[iC].Height - m_Nodes[iB].Height;
+
+        auto rotate = [this, iA](int32_t iUp, int32_t iStay)
+        {
+            TreeNode& A = m_Nodes[iA];
+            TreeNode& up = m_Nodes[iUp];
+            const int32_t iF = up.Child1;
+            const int32_t iG = up.Child2;
+
+            // Swap A and the child being rotated up
+            up.Child1 = iA;
+            up.Parent = A.Parent;
+            A.Parent = iUp;
+
+            if(up.Parent == NullNode)
+                m_Root = iUp;
+            else if(m_Nodes[up.Parent].Child1 == iA)
+                m_Nodes[up.Parent].Child1 = iUp;
+            else
+                m_Nodes[up.Parent].Child2 = iUp;
+
+            // Keep the taller grandchild on the rotated node
+            const bool keepF = m_Nodes[iF].Height > m_Nodes[iG].Height;
+            const int32_t iKeep = keepF ? iF : iG;
+            const int32_t iMove = keepF ? iG : iF;
+
+            up.Child2 = iKeep;
+            if(A.Child1 == iUp)
+                A.Child1 = iMove;
+            else
+                A.Child2 = iMove;
+            m_Nodes[iMove].Parent = iA;
+
+            A.Box = Combine(m_Nodes[iStay].Box, m_Nodes[iMove].Box);
+            up.Box = Combine(A.Box, m_Nodes[iKeep].Box);
+
+            A.Height = 1 + Maths::Max(m_Nodes[iStay].Height, m_Nodes[iMove].Height);
+            up.Height = 1 + Maths::Max(A.Height, m_Nodes[iKeep].Height);
+
+            return iUp;
+        };
+
+        if(balance > 1)
+            return rotate(iC, iB);
+        if(balance < -1)
+            return rotate(iB, iC);
+
+        return iA;
+    }
+
+    void DynamicAABBTreeBroadphase::DebugDraw()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        for(const TreeNode& node : m_Nodes)
+        {
+            if(node.Height < 0)
+                continue;
+
+            if(node.IsLeaf())
+                DebugRenderer::DebugDraw(node.Box, Maths::Vector4(0.2f, 0.8f, 0.2f, 1.0f), false, 0.02f);
+            else
+                DebugRenderer::DebugDraw(node.Box, Maths::Vector4(0.8f, 0.8f, 0.8f, 0.4f), false, 0.02f);
+        }
+    }
+}
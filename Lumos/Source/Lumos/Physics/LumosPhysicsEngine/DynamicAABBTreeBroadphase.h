@@ -0,0 +1,97 @@
+#pragma once
+#include "Broadphase.h"
+#include "Maths/Maths.h"
+
+namespace Lumos
+{
+    namespace Maths
+    {
+        class Ray;
+    }
+
+    // Incremental broadphase built on a dynamic bounding volume tree.
+    // Each body is a leaf with a fattened AABB, leaves are only reinserted when the body moves out of it,
+    // and only reinserted leaves query the tree for overlaps. Overlapping pairs persist between steps
+    // until their fat AABBs separate, so a mostly static scene costs almost nothing per step.
+    class LUMOS_EXPORT DynamicAABBTreeBroadphase : public Broadphase
+    {
+    public:
+        explicit DynamicAABBTreeBroadphase(float aabbMargin = 0.1f, float displacementMultiplier = 2.0f);
+        virtual ~DynamicAABBTreeBroadphase();
+
+        void FindPotentialCollisionPairs(RigidBody3D** objects, uint32_t objectCount, std::vector<CollisionPair>& collisionPairs) override;
+        void DebugDraw() override;
+
+        // Bodies whose fat AABB overlaps the box
+        void QueryAABB(const Maths::BoundingBox& box, std::vector<RigidBody3D*>& results) const;
+
+        // Bodies whose world space AABB is hit by the ray within maxDistance, closest first
+        void RayCast(const Maths::Ray& ray, float maxDistance, std::vector<RigidBody3D*>& results) const;
+
+        // Pairs that started overlapping during the last call to FindPotentialCollisionPairs
+        const std::vector<CollisionPair>& GetNewPairs() const { return m_NewPairs; }
+
+        uint32_t GetProxyCount() const { return static_cast<uint32_t>(m_Proxies.size()); }
+        uint32_t GetPairCount() const { return static_cast<uint32_t>(m_Pairs.size()); }
+        int32_t GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].Height; }
+
+    private:
+        static const int32_t NullNode = -1;
+
+        struct TreeNode
+        {
+            Maths::BoundingBox Box;
+            RigidBody3D* Body = nullptr;
+            int32_t Parent = NullNode; // Next free node when in the free list
+            int32_t Child1 = NullNode;
+            int32_t Child2 = NullNode;
+            int32_t Height = -1; // -1 when free, 0 for leaves
+
+            bool IsLeaf() const { return Child1 == NullNode; }
+        };
+
+        struct Proxy
+        {
+            int32_t Node;
+            uint32_t LastSeen;
+        };
+
+        struct ProxyPair
+        {
+            int32_t NodeA;
+            int32_t NodeB;
+        };
+
+        int32_t AllocateNode();
+        void FreeNode(int32_t node);
+        void InsertLeaf(int32_t leaf);
+        void RemoveLeaf(int32_t leaf);
+        int32_t Balance(int32_t node);
+
+        int32_t CreateProxy(RigidBody3D* body);
+        void DestroyProxy(int32_t node);
+        bool MoveProxy(int32_t node, const Maths::BoundingBox& box, const Maths::Vector3& displacement);
+        Maths::BoundingBox FattenAABB(const Maths::BoundingBox& box, const Maths::Vector3& displacement) const;
+
+        void AddPair(int32_t nodeA, int32_t nodeB);
+
+        template <typename Callback>
+        void Query(const Maths::BoundingBox& box, Callback callback) const;
+
+        float m_AABBMargin;
+        float m_DisplacementMultiplier;
+
+        std::vector<TreeNode> m_Nodes;
+        int32_t m_Root = NullNode;
+        int32_t m_FreeList = NullNode;
+
+        std::unordered_map<RigidBody3D*, Proxy> m_Proxies;
+        uint32_t m_Frame = 0;
+
+        std::vector<int32_t> m_MovedNodes;
+        std::vector<ProxyPair> m_Pairs;
+        std::unordered_map<uint64_t, uint32_t> m_PairLookup; // Pair key -> index into m_Pairs
+        std::vector<CollisionPair> m_NewPairs;
+        mutable std::vector<int32_t> m_QueryStack;
+    };
+}
@@ -11,7 +11,6 @@ namespace Lumos
     {
         m_HalfDimensions = Maths::Vector3(0.5f, 0.5f, 0.5f);
         m_Type = CollisionShapeType::CollisionHull;
-        m_Axes.resize(3);
     }
 
     HullCollisionShape::~HullCollisionShape()
@@ -47,8 +46,6 @@ namespace Lumos
             m_Hull->AddFace(normal, 3, vertexIdx);
         }
 
-        m_Edges.resize(m_Hull->GetNumEdges());
-
         vertexBuffer->ReleasePointer();
         mesh->GetIndexBuffer()->ReleasePointer();
     }
@@ -68,20 +65,18 @@ namespace Lumos
         return inertia;
     }
 
-    std::vector<Maths::Vector3>& HullCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject)
+    void HullCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject, std::vector<Maths::Vector3>& out_axes) const
     {
         LUMOS_PROFILE_FUNCTION();
         {
             Maths::Matrix3 objOrientation = currentObject->GetOrientation().RotationMatrix();
-            m_Axes[0] = (objOrientation * Maths::Vector3(1.0f, 0.0f, 0.0f)); //X - Axis
-            m_Axes[1] = (objOrientation * Maths::Vector3(0.0f, 1.0f, 0.0f)); //Y - Axis
-            m_Axes[2] = (objOrientation * Maths::Vector3(0.0f, 0.0f, 1.0f)); //Z - Axis
+            out_axes.push_back(objOrientation * Maths::Vector3(1.0f, 0.0f, 0.0f)); //X - Axis
+            out_axes.push_back(objOrientation * Maths::Vector3(0.0f, 1.0f, 0.0f)); //Y - Axis
+            out_axes.push_back(objOrientation * Maths::Vector3(0.0f, 0.0f, 1.0f)); //Z - Axis
         }
-
-        return m_Axes;
     }
 
-    std::vector<CollisionEdge>& HullCollisionShape::GetEdges(const RigidBody3D* currentObject)
+    void HullCollisionShape::GetEdges(const RigidBody3D* currentObject, std::vector<CollisionEdge>& out_edges) const
     {
         LUMOS_PROFILE_FUNCTION();
         {
@@ -92,10 +87,9 @@ namespace Lumos
                 Maths::Vector3 A = transform * m_Hull->GetVertex(edge.vStart).pos;
                 Maths::Vector3 B = transform * m_Hull->GetVertex(edge.vEnd).pos;
 
-                m_Edges[i] = { A, B };
+                out_edges.emplace_back(A, B);
             }
         }
-        return m_Edges;
     }
 
     void HullCollisionShape::GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Maths::Vector3& axis, Maths::Vector3* out_min, Maths::Vector3* out_max) const
@@ -152,6 +146,8 @@ namespace Lumos
 
         if(best_face)
         {
+            LUMOS_ASSERT(best_face->vert_ids.size() <= ReferencePolygon::MaxFaceVertices, "Hull face has more vertices than ReferencePolygon can hold");
+
             for(int vertIdx : best_face->vert_ids)
             {
                 const HullVertex& vertex = m_Hull->GetVertex(vertIdx);
@@ -169,6 +165,8 @@ namespace Lumos
 
             refPolygon.AdjacentPlanes[refPolygon.PlaneCount++] = { planeNrml, planeDist };
 
+            LUMOS_ASSERT(best_face->edge_ids.size() < ReferencePolygon::MaxAdjacentPlanes, "Hull face has more adjacent planes than ReferencePolygon can hold");
+
             for(int edgeIdx : best_face->edge_ids)
             {
                 const HullEdge& edge = m_Hull->GetEdge(edgeIdx);
@@ -23,8 +23,8 @@ namespace Lumos
         //Collision Shape Functionality
         virtual Maths::Matrix3 BuildInverseInertia(float invMass) const override;
 
-        virtual std::vector<Maths::Vector3>& GetCollisionAxes(const RigidBody3D* currentObject) override;
-        virtual std::vector<CollisionEdge>& GetEdges(const RigidBody3D* currentObject) override;
+        virtual void GetCollisionAxes(const RigidBody3D* currentObject, std::vector<Maths::Vector3>& out_axes) const override;
+        virtual void GetEdges(const RigidBody3D* currentObject, std::vector<CollisionEdge>& out_edges) const override;
 
         virtual void GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Maths::Vector3& axis, Maths::Vector3* out_min, Maths::Vector3* out_max) const override;
         virtual void GetIncidentReferencePolygon(const RigidBody3D* currentObject,
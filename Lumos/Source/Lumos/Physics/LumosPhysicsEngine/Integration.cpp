@@ -1,8 +1,115 @@
 #include "Precompiled.h"
 #include "Integration.h"
+#include "RigidBodyStore.h"
 
 namespace Lumos
 {
+    namespace
+    {
+        // One float per body lane, SSE when available
+        struct Float4
+        {
+#ifdef LUMOS_SSE
+            __m128 v;
+
+            static Float4 Load(const float* p) { return { _mm_loadu_ps(p) }; }
+            static Float4 Set(float f) { return { _mm_set1_ps(f) }; }
+            void Store(float* p) const { _mm_storeu_ps(p, v); }
+
+            friend Float4 operator+(Float4 a, Float4 b) { return { _mm_add_ps(a.v, b.v) }; }
+            friend Float4 operator-(Float4 a, Float4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+            friend Float4 operator*(Float4 a, Float4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+            friend Float4 operator/(Float4 a, Float4 b) { return { _mm_div_ps(a.v, b.v) }; }
+
+            static Float4 Sqrt(Float4 a) { return { _mm_sqrt_ps(a.v) }; }
+            static Float4 Greater(Float4 a, Float4 b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+            static Float4 Select(Float4 mask, Float4 a, Float4 b) { return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) }; }
+            static bool Any(Float4 mask) { return _mm_movemask_ps(mask.v) != 0; }
+#else
+            float v[4];
+
+            static Float4 Load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+            static Float4 Set(float f) { return { { f, f, f, f } }; }
+            void Store(float* p) const
+            {
+                for(int i = 0; i < 4; i++)
+                    p[i] = v[i];
+            }
+
+#define FLOAT4_OP(op)                                    \
+    friend Float4 operator op(Float4 a, Float4 b)        \
+    {                                                    \
+        return { { a.v[0] op b.v[0], a.v[1] op b.v[1],   \
+            a.v[2] op b.v[2], a.v[3] op b.v[3] } };      \
+    }
+            FLOAT4_OP(+)
+            FLOAT4_OP(-)
+            FLOAT4_OP(*)
+            FLOAT4_OP(/)
+#undef FLOAT4_OP
+
+            static Float4 Sqrt(Float4 a) { return { { sqrtf(a.v[0]), sqrtf(a.v[1]), sqrtf(a.v[2]), sqrtf(a.v[3]) } }; }
+            static Float4 Greater(Float4 a, Float4 b)
+            {
+                return { { a.v[0] > b.v[0] ? 1.0f : 0.0f, a.v[1] > b.v[1] ? 1.0f : 0.0f, a.v[2] > b.v[2] ? 1.0f : 0.0f, a.v[3] > b.v[3] ? 1.0f : 0.0f } };
+            }
+            static Float4 Select(Float4 mask, Float4 a, Float4 b)
+            {
+                return { { mask.v[0] != 0.0f ? a.v[0] : b.v[0], mask.v[1] != 0.0f ? a.v[1] : b.v[1], mask.v[2] != 0.0f ? a.v[2] : b.v[2], mask.v[3] != 0.0f ? a.v[3] : b.v[3] } };
+            }
+            static bool Any(Float4 mask) { return mask.v[0] != 0.0f || mask.v[1] != 0.0f || mask.v[2] != 0.0f || mask.v[3] != 0.0f; }
+#endif
+        };
+
+        struct Vector3x4
+        {
+            Float4 x, y, z;
+
+            static Vector3x4 Load(const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z, uint32_t index)
+            {
+                return { Float4::Load(&x[index]), Float4::Load(&y[index]), Float4::Load(&z[index]) };
+            }
+
+            void Store(std::vector<float>& outX, std::vector<float>& outY, std::vector<float>& outZ, uint32_t index) const
+            {
+                x.Store(&outX[index]);
+                y.Store(&outY[index]);
+                z.Store(&outZ[index]);
+            }
+
+            Vector3x4 operator+(const Vector3x4& rhs) const { return { x + rhs.x, y + rhs.y, z + rhs.z }; }
+            Vector3x4 operator*(Float4 rhs) const { return { x * rhs, y * rhs, z * rhs }; }
+
+            static Vector3x4 Select(Float4 mask, const Vector3x4& a, const Vector3x4& b)
+            {
+                return { Float4::Select(mask, a.x, b.x), Float4::Select(mask, a.y, b.y), Float4::Select(mask, a.z, b.z) };
+            }
+        };
+
+        struct Quaternionx4
+        {
+            Float4 w, x, y, z;
+
+            // q + (angularVelocity * halfDt) * q, then renormalised
+            Quaternionx4 Integrate(const Vector3x4& angularVelocity, Float4 halfDt) const
+            {
+                const Vector3x4 v = angularVelocity * halfDt;
+
+                Quaternionx4 result;
+                result.w = w - (x * v.x + y * v.y + z * v.z);
+                result.x = x + (w * v.x + v.y * z - v.z * y);
+                result.y = y + (w * v.y + v.z * x - v.x * z);
+                result.z = z + (w * v.z + v.x * y - v.y * x);
+
+                const Float4 length = Float4::Sqrt(result.w * result.w + result.x * result.x + result.y * result.y + result.z * result.z);
+                result.w = result.w / length;
+                result.x = result.x / length;
+                result.y = result.y / length;
+                result.z = result.z / length;
+                return result;
+            }
+        };
+    }
 
     void Integration::RK2(State& state, float t, float dt)
     {
@@ -56,4 +163,98 @@ namespace Lumos
         return output;
     }
 
-}
\ No newline at end of file
+
+    template <IntegrationType Type>
+    void Integration::IntegrateLanes(RigidBodyStore& store, uint32_t firstLane, uint32_t lastLane, float dt, float damping, const Maths::Vector3& gravity)
+    {
+        const Float4 zero = Float4::Set(0.0f);
+        const Float4 timeStep = Float4::Set(dt);
+        const Float4 halfTimeStep = Float4::Set(dt * 0.5f);
+        const Float4 halfTimeStepSq = Float4::Set(dt * dt * 0.5f);
+        const Float4 dampingFactor = Float4::Set(damping);
+        const Vector3x4 gravityStep = { Float4::Set(gravity.x * dt), Float4::Set(gravity.y * dt), Float4::Set(gravity.z * dt) };
+        const Vector3x4 noGravity = { zero, zero, zero };
+
+        for(uint32_t lane = firstLane; lane < lastLane; lane++)
+        {
+            const uint32_t i = lane * RigidBodyStore::LaneWidth;
+
+            const Float4 active = Float4::Greater(Float4::Load(&store.Active[i]), zero);
+            if(!Float4::Any(active))
+                continue;
+
+            const Vector3x4 position = Vector3x4::Load(store.PositionX, store.PositionY, store.PositionZ, i);
+            const Vector3x4 velocity = Vector3x4::Load(store.VelocityX, store.VelocityY, store.VelocityZ, i);
+            const Vector3x4 acceleration = Vector3x4::Load(store.AccelerationX, store.AccelerationY, store.AccelerationZ, i);
+            const Vector3x4 angularVelocity = Vector3x4::Load(store.AngularVelocityX, store.AngularVelocityY, store.AngularVelocityZ, i);
+            const Vector3x4 angularAcceleration = Vector3x4::Load(store.AngularAccelerationX, store.AngularAccelerationY, store.AngularAccelerationZ, i);
+            const Quaternionx4 orientation = { Float4::Load(&store.OrientationW[i]), Float4::Load(&store.OrientationX[i]), Float4::Load(&store.OrientationY[i]), Float4::Load(&store.OrientationZ[i]) };
+
+            // Apply gravity
+            const Float4 hasMass = Float4::Greater(Float4::Load(&store.InverseMass[i]), zero);
+            Vector3x4 newVelocity = velocity + Vector3x4::Select(hasMass, gravityStep, noGravity);
+
+            Vector3x4 newPosition;
+            Vector3x4 newAngularVelocity;
+            Quaternionx4 newOrientation;
+
+            if constexpr(Type == IntegrationType::EXPLICIT_EULER)
+            {
+                // Position and orientation use the velocities from the start of the step
+                newPosition = position + newVelocity * timeStep;
+                newVelocity = (newVelocity + acceleration * timeStep) * dampingFactor;
+
+                newOrientation = orientation.Integrate(angularVelocity, halfTimeStep);
+                newAngularVelocity = (angularVelocity + angularAcceleration * timeStep) * dampingFactor;
+            }
+            else if constexpr(Type == IntegrationType::SEMI_IMPLICIT_EULER)
+            {
+                // Velocities first, position and orientation use the updated ones
+                newVelocity = (newVelocity + acceleration * timeStep) * dampingFactor;
+                newPosition = position + newVelocity * timeStep;
+
+                newAngularVelocity = (angularVelocity + angularAcceleration * timeStep) * dampingFactor;
+                newOrientation = orientation.Integrate(newAngularVelocity, halfTimeStep);
+            }
+            else
+            {
+                // Acceleration is constant over the step, so RK2 and RK4 both reduce to the exact solution
+                newPosition = position + newVelocity * timeStep + acceleration * halfTimeStepSq;
+                newVelocity = (newVelocity + acceleration * timeStep) * dampingFactor;
+
+                newAngularVelocity = (angularVelocity + angularAcceleration * timeStep) * dampingFactor;
+                newOrientation = orientation.Integrate(newAngularVelocity, halfTimeStep);
+            }
+
+            // Inactive lanes keep their values
+            Vector3x4::Select(active, newPosition, position).Store(store.PositionX, store.PositionY, store.PositionZ, i);
+            Vector3x4::Select(active, newVelocity, velocity).Store(store.VelocityX, store.VelocityY, store.VelocityZ, i);
+            Vector3x4::Select(active, newAngularVelocity, angularVelocity).Store(store.AngularVelocityX, store.AngularVelocityY, store.AngularVelocityZ, i);
+
+            Float4::Select(active, newOrientation.w, orientation.w).Store(&store.OrientationW[i]);
+            Float4::Select(active, newOrientation.x, orientation.x).Store(&store.OrientationX[i]);
+            Float4::Select(active, newOrientation.y, orientation.y).Store(&store.OrientationY[i]);
+            Float4::Select(active, newOrientation.z, orientation.z).Store(&store.OrientationZ[i]);
+        }
+    }
+
+    void Integration::IntegrateBodies(IntegrationType type, RigidBodyStore& store, uint32_t firstLane, uint32_t lastLane, float dt, float damping, const Maths::Vector3& gravity)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        switch(type)
+        {
+        case IntegrationType::EXPLICIT_EULER:
+            IntegrateLanes<IntegrationType::EXPLICIT_EULER>(store, firstLane, lastLane, dt, damping, gravity);
+            break;
+        case IntegrationType::SEMI_IMPLICIT_EULER:
+            IntegrateLanes<IntegrationType::SEMI_IMPLICIT_EULER>(store, firstLane, lastLane, dt, damping, gravity);
+            break;
+        case IntegrationType::RUNGE_KUTTA_2:
+            IntegrateLanes<IntegrationType::RUNGE_KUTTA_2>(store, firstLane, lastLane, dt, damping, gravity);
+            break;
+        case IntegrationType::RUNGE_KUTTA_4:
+            IntegrateLanes<IntegrationType::RUNGE_KUTTA_4>(store, firstLane, lastLane, dt, damping, gravity);
+            break;
+        }
+    }
+}
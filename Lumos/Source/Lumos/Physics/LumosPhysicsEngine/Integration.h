@@ -4,6 +4,15 @@
 
 namespace Lumos
 {
+    struct RigidBodyStore;
+
+    enum class LUMOS_EXPORT IntegrationType
+    {
+        EXPLICIT_EULER = 0,
+        SEMI_IMPLICIT_EULER,
+        RUNGE_KUTTA_2,
+        RUNGE_KUTTA_4
+    };
 
     class LUMOS_EXPORT Integration
     {
@@ -26,5 +35,13 @@ namespace Lumos
         static void RK4(State& state, float t, float dt);
 
         static Derivative Evaluate(State& initial, float dt, float t, const Derivative& derivative);
+
+        // Integrates active bodies in lanes [firstLane, lastLane) of the store, 4 bodies per lane.
+        // Dispatches once to an integrator specialised for the integration type
+        static void IntegrateBodies(IntegrationType type, RigidBodyStore& store, uint32_t firstLane, uint32_t lastLane, float dt, float damping, const Maths::Vector3& gravity);
+
+    private:
+        template <IntegrationType Type>
+        static void IntegrateLanes(RigidBodyStore& store, uint32_t firstLane, uint32_t lastLane, float dt, float damping, const Maths::Vector3& gravity);
     };
 }
@@ -5,6 +5,8 @@
 #include "Core/OS/Window.h"
 
 #include "Integration.h"
+#include "CuboidCollisionShape.h"
+#include "DynamicAABBTreeBroadphase.h"
 #include "Constraint.h"
 #include "Utilities/TimeStep.h"
 #include "Core/JobSystem.h"
@@ -16,9 +18,7 @@
 
 #include <imgui/imgui.h>
 
-#define THREAD_RIGID_BODY_UPDATE
 #define THREAD_APPLY_IMPULSES
-#define THREAD_NARROWPHASE
 
 namespace Lumos
 {
@@ -37,6 +37,8 @@ namespace Lumos
         m_RigidBodys.reserve(100);
         m_BroadphaseCollisionPairs.reserve(1000);
         m_Manifolds.reserve(100);
+
+        BuildTaskGraph();
     }
 
     void LumosPhysicsEngine::SetDefaults()
@@ -54,6 +56,7 @@ namespace Lumos
         m_RigidBodys.clear();
         m_Constraints.clear();
         m_Manifolds.clear();
+        m_PreviousManifolds.clear();
 
         CollisionDetection::Release();
     }
@@ -160,280 +163,512 @@ namespace Lumos
             {
                 LUMOS_PROFILE_SCOPE("Physics::Set Transforms");
 
+                // Only bodies that moved since their transform was last set, sleeping and static bodies are skipped
                 for(auto entity : group)
                 {
                     const auto& [phys, trans] = group.get<Physics3DComponent, Maths::Transform>(entity);
+                    RigidBody3D* body = phys.GetRigidBody().get();
+                    if(!body->m_TransformDirty)
+                        continue;
 
-                    trans.SetLocalPosition(phys.GetRigidBody()->GetPosition());
-                    trans.SetLocalOrientation(phys.GetRigidBody()->GetOrientation());
+                    trans.SetLocalPosition(body->GetPosition());
+                    trans.SetLocalOrientation(body->GetOrientation());
+                    body->m_TransformDirty = false;
                 };
             }
             m_Constraints.clear();
         }
     }
 
+    void LumosPhysicsEngine::BuildTaskGraph()
+    {
+        auto broadphase = m_TaskGraph.AddTask("Broadphase", [this]()
+            { BroadPhaseCollisions(); });
+
+        // World space transforms and collision features are built once per body here instead of once per pair in the
+        // narrowphase. GetWorldSpaceTransform rebuilds lazily, so refreshing it here leaves later tasks only reading it
+        auto updateCollisionCaches = m_TaskGraph.AddParallelTask(
+            "Update Collision Caches", [this]()
+            { return static_cast<uint32_t>(m_RigidBodys.size()); },
+            128, [this](JobDispatchArgs args)
+            {
+                RigidBody3D* body = m_RigidBodys[args.jobIndex];
+                body->GetWorldSpaceTransform();
+                body->UpdateCollisionCache();
+            });
+
+        // Each job group writes to its own scratch buffer, no locking while manifolds are built
+        const uint32_t narrowphaseGroupSize = 128;
+        auto narrowphase = m_TaskGraph.AddParallelTask(
+            "Narrowphase", [this, narrowphaseGroupSize]()
+            {
+                const uint32_t pairCount = static_cast<uint32_t>(m_BroadphaseCollisionPairs.size());
+                m_NarrowphaseGroupCount = System::JobSystem::DispatchGroupCount(pairCount, narrowphaseGroupSize);
+                if(m_NarrowphaseGroups.size() < m_NarrowphaseGroupCount)
+                    m_NarrowphaseGroups.resize(m_NarrowphaseGroupCount);
+                return pairCount;
+            },
+            narrowphaseGroupSize, [this](JobDispatchArgs args)
+            { NarrowPhaseCollision(m_BroadphaseCollisionPairs[args.jobIndex], m_NarrowphaseGroups[args.groupID]); });
+
+        auto mergeManifolds = m_TaskGraph.AddTask("Merge Manifolds", [this]()
+            { MergeManifolds(); });
+
+        // Constraints don't depend on the narrowphase, so they are prepared while it runs.
+        // They run after the collision caches, which refresh the world transforms they read
+        auto preSolveConstraints = m_TaskGraph.AddTask("PreSolve Constraints", [this]()
+            { PreSolveConstraints(); });
+
+        auto preSolveManifolds = m_TaskGraph.AddTask("PreSolve Manifolds", [this]()
+            { PreSolveManifolds(); });
+
+        auto batchConstraints = m_TaskGraph.AddTask("Batch Constraints", [this]()
+            { BatchConstraints(); });
+
+        auto applyImpulses = m_TaskGraph.AddTask("Apply Impulses", [this]()
+            { ApplyImpulses(); });
+
+        // Each job integrates a chunk of SIMD lanes
+        const uint32_t lanesPerJob = 16;
+        auto integrate = m_TaskGraph.AddParallelTask(
+            "Update Rigid Bodies", [this, lanesPerJob]()
+            {
+                m_BodyStore.Resize(static_cast<uint32_t>(m_RigidBodys.size()));
+                return (m_BodyStore.GetLaneCount() + lanesPerJob - 1) / lanesPerJob;
+            },
+            1, [this, lanesPerJob](JobDispatchArgs args)
+            {
+                const uint32_t firstLane = args.jobIndex * lanesPerJob;
+                UpdateRigidBodies(firstLane, Maths::Min(firstLane + lanesPerJob, m_BodyStore.GetLaneCount()));
+            });
+
+        auto updateIslands = m_TaskGraph.AddTask("Update Islands", [this]()
+            { UpdateIslands(); });
+
+        m_TaskGraph.AddDependency(broadphase, updateCollisionCaches);
+        m_TaskGraph.AddDependency(updateCollisionCaches, narrowphase);
+        m_TaskGraph.AddDependency(updateCollisionCaches, preSolveConstraints);
+        m_TaskGraph.AddDependency(narrowphase, mergeManifolds);
+        m_TaskGraph.AddDependency(mergeManifolds, preSolveManifolds);
+        m_TaskGraph.AddDependency(mergeManifolds, batchConstraints);
+        m_TaskGraph.AddDependency(batchConstraints, applyImpulses);
+        m_TaskGraph.AddDependency(preSolveManifolds, applyImpulses);
+        m_TaskGraph.AddDependency(preSolveConstraints, applyImpulses);
+        m_TaskGraph.AddDependency(applyImpulses, integrate);
+        m_TaskGraph.AddDependency(integrate, updateIslands);
+    }
+
     void LumosPhysicsEngine::UpdatePhysics()
     {
+        LUMOS_PROFILE_FUNCTION();
+
+        // Keep last step's manifolds around to warm start the new ones
+        std::swap(m_Manifolds, m_PreviousManifolds);
         m_Manifolds.clear();
 
-        //Check for collisions
-        BroadPhaseCollisions();
-        NarrowPhaseCollisions();
+        //Collisions, constraint solving and integration
+        m_TaskGraph.Run();
+    }
+
+    void LumosPhysicsEngine::UpdateRigidBodies(uint32_t firstLane, uint32_t lastLane)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const uint32_t first = firstLane * RigidBodyStore::LaneWidth;
+        const uint32_t last = Maths::Min(lastLane * RigidBodyStore::LaneWidth, m_BodyStore.GetCount());
+
+        for(uint32_t i = first; i < last; i++)
+            m_BodyStore.Gather(i, m_RigidBodys[i]);
 
-        //Solve collision constraints
-        SolveConstraints();
+        Integration::IntegrateBodies(m_IntegrationType, m_BodyStore, firstLane, lastLane, s_UpdateTimestep, m_DampingFactor, m_Gravity);
 
-        //Update movement
-        UpdateRigidBodys();
+        for(uint32_t i = first; i < last; i++)
+            m_BodyStore.Scatter(i, m_RigidBodys[i]);
     }
 
-    void LumosPhysicsEngine::UpdateRigidBodys()
+    void LumosPhysicsEngine::BroadPhaseCollisions()
     {
-#ifdef THREAD_RIGID_BODY_UPDATE
-        LUMOS_PROFILE_SCOPE("Thread Update Rigid Body");
-        System::JobSystem::Context jobSystemContext;
-        System::JobSystem::Dispatch(jobSystemContext, static_cast<uint32_t>(m_RigidBodys.size()), 128, [&](JobDispatchArgs args)
-            { UpdateRigidBody(m_RigidBodys[args.jobIndex]); });
-
-        System::JobSystem::Wait(jobSystemContext);
-#else
-        LUMOS_PROFILE_SCOPE("Update Rigid Body");
-
-        for(int i = 0; i < m_RigidBodys.size(); i++)
-            UpdateRigidBody(m_RigidBodys[i]);
-#endif
+        LUMOS_PROFILE_FUNCTION();
+        m_BroadphaseCollisionPairs.clear();
+        if(m_BroadphaseDetection)
+            m_BroadphaseDetection->FindPotentialCollisionPairs(m_RigidBodys.data(), (uint32_t)m_RigidBodys.size(), m_BroadphaseCollisionPairs);
     }
 
-    void LumosPhysicsEngine::UpdateRigidBody(RigidBody3D* obj) const
+    void LumosPhysicsEngine::NarrowPhaseCollision(CollisionPair& cp, NarrowphaseGroup& output)
     {
-        LUMOS_PROFILE_FUNCTION();
-        if(!obj->GetIsStatic() && obj->IsAwake())
-        {
-            const float damping = m_DampingFactor;
+        auto shapeA = cp.pObjectA->GetCollisionShape();
+        auto shapeB = cp.pObjectB->GetCollisionShape();
 
-            // Apply gravity
-            if(obj->m_InvMass > 0.0f)
-                obj->m_LinearVelocity += m_Gravity * s_UpdateTimestep;
+        if(shapeA && shapeB)
+        {
+            CollisionData colData;
 
-            switch(m_IntegrationType)
+            // Detects if the objects are colliding - Seperating Axis Theorem
+            if(CollisionDetection::Get().CheckCollision(cp.pObjectA, cp.pObjectB, shapeA.get(), shapeB.get(), &colData))
             {
-            case IntegrationType::EXPLICIT_EULER:
-            {
-                // Update position
-                obj->m_Position += obj->m_LinearVelocity * s_UpdateTimestep;
+                // Build full collision manifold that will also handle the collision
+                // response between the two objects in the solver stage
+                Manifold& manifold = output.Manifolds.emplace_back();
+                manifold.Initiate(cp.pObjectA, cp.pObjectB);
+
+                // Construct contact points that form the perimeter of the collision manifold
+                int32_t manifoldIndex = static_cast<int32_t>(output.Manifolds.size()) - 1;
+                if(!CollisionDetection::Get().BuildCollisionManifold(cp.pObjectA, cp.pObjectB, shapeA.get(), shapeB.get(), colData, &manifold))
+                {
+                    output.Manifolds.pop_back();
+                    manifoldIndex = -1;
+                }
+
+                output.Collisions.push_back({ cp.pObjectA, cp.pObjectB, manifoldIndex });
+            }
+        }
+    }
 
-                // Update linear velocity (v = u + at)
-                obj->m_LinearVelocity += obj->m_Force * obj->m_InvMass * s_UpdateTimestep;
+    void LumosPhysicsEngine::MergeManifolds()
+    {
+        LUMOS_PROFILE_FUNCTION();
 
-                // Linear velocity damping
-                obj->m_LinearVelocity = obj->m_LinearVelocity * damping;
+        size_t manifoldCount = 0;
+        for(uint32_t group = 0; group < m_NarrowphaseGroupCount; group++)
+            manifoldCount += m_NarrowphaseGroups[group].Manifolds.size();
 
-                // Update orientation
-                obj->m_Orientation = obj->m_Orientation + ((obj->m_AngularVelocity * s_UpdateTimestep * 0.5f) * obj->m_Orientation);
-                obj->m_Orientation.Normalise();
+        m_Manifolds.reserve(m_Manifolds.size() + manifoldCount);
+        for(uint32_t group = 0; group < m_NarrowphaseGroupCount; group++)
+        {
+            auto& output = m_NarrowphaseGroups[group];
+            for(auto& collision : output.Collisions)
+            {
+                // Check to see if any of the objects have collision callbacks that dont
+                // want the objects to physically collide
+                const bool okA = collision.BodyA->FireOnCollisionEvent(collision.BodyA, collision.BodyB);
+                const bool okB = collision.BodyB->FireOnCollisionEvent(collision.BodyB, collision.BodyA);
 
-                // Update angular velocity
-                obj->m_AngularVelocity += obj->m_InvInertia * obj->m_Torque * s_UpdateTimestep;
+                if(!okA || !okB || collision.ManifoldIndex < 0)
+                    continue;
 
-                // Angular velocity damping
-                obj->m_AngularVelocity = obj->m_AngularVelocity * damping;
+                Manifold& manifold = m_Manifolds.emplace_back(output.Manifolds[collision.ManifoldIndex]);
 
-                break;
+                // Fire callback
+                collision.BodyA->FireOnCollisionManifoldCallback(collision.BodyA, collision.BodyB, &manifold);
+                collision.BodyB->FireOnCollisionManifoldCallback(collision.BodyB, collision.BodyA, &manifold);
             }
 
-            case IntegrationType::SEMI_IMPLICIT_EULER:
-            {
-                // Update linear velocity (v = u + at)
-                obj->m_LinearVelocity += obj->m_LinearVelocity * obj->m_InvMass * s_UpdateTimestep;
+            output.Manifolds.clear();
+            output.Collisions.clear();
+        }
 
-                // Linear velocity damping
-                obj->m_LinearVelocity = obj->m_LinearVelocity * damping;
+        m_NarrowphaseGroupCount = 0;
+    }
 
-                // Update position
-                obj->m_Position += obj->m_LinearVelocity * s_UpdateTimestep;
+    void LumosPhysicsEngine::PreSolveManifolds()
+    {
+        LUMOS_PROFILE_FUNCTION();
 
-                // Update angular velocity
-                obj->m_AngularVelocity += obj->m_InvInertia * obj->m_Torque * s_UpdateTimestep;
+        m_WarmStartedContacts = 0;
+        m_ContactCount = 0;
 
-                // Angular velocity damping
-                obj->m_AngularVelocity = obj->m_AngularVelocity * damping;
+        if(m_WarmStarting)
+        {
+            LUMOS_PROFILE_SCOPE("Match Contacts");
+            m_ManifoldCache.clear();
+            for(uint32_t i = 0; i < m_PreviousManifolds.size(); i++)
+                m_ManifoldCache[{ m_PreviousManifolds[i].NodeA(), m_PreviousManifolds[i].NodeB() }] = i;
 
-                // Update orientation
-                obj->m_Orientation = obj->m_Orientation + ((obj->m_AngularVelocity * s_UpdateTimestep * 0.5f) * obj->m_Orientation);
-                obj->m_Orientation.Normalise();
+            for(Manifold& m : m_Manifolds)
+            {
+                auto it = m_ManifoldCache.find({ m.NodeA(), m.NodeB() });
+                if(it != m_ManifoldCache.end())
+                    m.WarmStartFrom(m_PreviousManifolds[it->second]);
 
-                break;
+                m_WarmStartedContacts += m.GetWarmStartedCount();
             }
+        }
 
-            case IntegrationType::RUNGE_KUTTA_2:
-            {
-                // RK2 integration for linear motion
-                Integration::State state = { obj->m_Position, obj->m_LinearVelocity, obj->m_Force * obj->m_InvMass };
-                Integration::RK2(state, 0.0f, s_UpdateTimestep);
+        for(Manifold& m : m_Manifolds)
+        {
+            m.PreSolverStep(s_UpdateTimestep);
+            m_ContactCount += m.GetContactCount();
+        }
+    }
 
-                obj->m_Position = state.position;
-                obj->m_LinearVelocity = state.velocity;
+    void LumosPhysicsEngine::PreSolveConstraints()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        for(Constraint* c : m_Constraints)
+            c->PreSolverStep(s_UpdateTimestep);
+    }
 
-                // Linear velocity damping
-                obj->m_LinearVelocity = obj->m_LinearVelocity * damping;
+    void LumosPhysicsEngine::BatchConstraints()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const uint32_t manifoldCount = static_cast<uint32_t>(m_Manifolds.size());
+        const uint32_t itemCount = manifoldCount + static_cast<uint32_t>(m_Constraints.size());
+        const uint32_t serialBatch = SOLVER_MAX_BATCHES;
 
-                // Update angular velocity
-                obj->m_AngularVelocity += obj->m_InvInertia * obj->m_Torque * s_UpdateTimestep;
+        m_SolverItemBatches.resize(itemCount);
+        m_SolverBatchOffsets.assign(SOLVER_MAX_BATCHES + 2, 0);
+        m_BodyBatches.clear();
 
-                // Angular velocity damping
-                obj->m_AngularVelocity = obj->m_AngularVelocity * damping;
+        // Static bodies ignore velocity changes, so any number of batches can share them
+        auto bodyBatches = [this](RigidBody3D* body) -> uint64_t*
+        {
+            return (body && !body->GetIsStatic()) ? &m_BodyBatches[body] : nullptr;
+        };
 
-                // Update orientation
-                obj->m_Orientation = obj->m_Orientation + ((obj->m_AngularVelocity * s_UpdateTimestep * 0.5f) * obj->m_Orientation);
-                obj->m_Orientation.Normalise();
+        for(uint32_t i = 0; i < itemCount; i++)
+        {
+            RigidBody3D* bodyA;
+            RigidBody3D* bodyB;
 
-                break;
+            if(i < manifoldCount)
+            {
+                bodyA = m_Manifolds[i].NodeA();
+                bodyB = m_Manifolds[i].NodeB();
             }
-
-            case IntegrationType::RUNGE_KUTTA_4:
+            else
             {
-                // RK4 integration for linear motion
-                Integration::State state = { obj->m_Position, obj->m_LinearVelocity, obj->m_Force * obj->m_InvMass };
-                Integration::RK4(state, 0.0f, s_UpdateTimestep);
-                obj->m_Position = state.position;
-                obj->m_LinearVelocity = state.velocity;
+                bodyA = m_Constraints[i - manifoldCount]->GetBodyA();
+                bodyB = m_Constraints[i - manifoldCount]->GetBodyB();
+            }
 
-                // Linear velocity damping
-                obj->m_LinearVelocity = obj->m_LinearVelocity * damping;
+            // Constraints between sleeping (or static) bodies belong to a sleeping island, skip them entirely
+            const bool awakeA = bodyA && !bodyA->GetIsStatic() && bodyA->IsAwake();
+            const bool awakeB = bodyB && !bodyB->GetIsStatic() && bodyB->IsAwake();
+            if((bodyA || bodyB) && !awakeA && !awakeB)
+            {
+                m_SolverItemBatches[i] = ~0u;
+                continue;
+            }
 
-                // Update angular velocity
-                obj->m_AngularVelocity += obj->m_InvInertia * obj->m_Torque * s_UpdateTimestep;
+            uint32_t batch = serialBatch;
 
-                // Angular velocity damping
-                obj->m_AngularVelocity = obj->m_AngularVelocity * damping;
+            // Constraints that don't report their bodies can't be batched safely
+            if(bodyA || bodyB)
+            {
+                uint64_t* batchesA = bodyBatches(bodyA);
+                uint64_t* batchesB = bodyBatches(bodyB);
+                const uint64_t used = (batchesA ? *batchesA : 0) | (batchesB ? *batchesB : 0);
 
-                // Update orientation
-                obj->m_Orientation = obj->m_Orientation + ((obj->m_AngularVelocity * s_UpdateTimestep * 0.5f) * obj->m_Orientation);
-                obj->m_Orientation.Normalise();
+                // First batch neither body is in yet
+                batch = 0;
+                while(batch < SOLVER_MAX_BATCHES && (used & (uint64_t(1) << batch)))
+                    batch++;
 
-                break;
-            }
+                if(batch < SOLVER_MAX_BATCHES)
+                {
+                    if(batchesA)
+                        *batchesA |= uint64_t(1) << batch;
+                    if(batchesB)
+                        *batchesB |= uint64_t(1) << batch;
+                }
             }
 
-            // Mark cached world transform and AABB as invalid
-            obj->m_wsTransformInvalidated = true;
-            obj->m_wsAabbInvalidated = true;
+            m_SolverItemBatches[i] = batch;
+            m_SolverBatchOffsets[batch + 1]++;
+        }
+
+        for(uint32_t batch = 1; batch < m_SolverBatchOffsets.size(); batch++)
+            m_SolverBatchOffsets[batch] += m_SolverBatchOffsets[batch - 1];
 
-            obj->RestTest();
+        // Stable counting sort so batches keep manifold / constraint order
+        std::vector<uint32_t> insert(m_SolverBatchOffsets.begin(), m_SolverBatchOffsets.end() - 1);
+        m_SolverItems.resize(m_SolverBatchOffsets.back());
+        for(uint32_t i = 0; i < itemCount; i++)
+        {
+            if(m_SolverItemBatches[i] != ~0u)
+                m_SolverItems[insert[m_SolverItemBatches[i]]++] = i;
         }
     }
 
-    void LumosPhysicsEngine::BroadPhaseCollisions()
+    void LumosPhysicsEngine::UpdateIslands()
     {
         LUMOS_PROFILE_FUNCTION();
-        m_BroadphaseCollisionPairs.clear();
-        if(m_BroadphaseDetection)
-            m_BroadphaseDetection->FindPotentialCollisionPairs(m_RigidBodys.data(), (uint32_t)m_RigidBodys.size(), m_BroadphaseCollisionPairs);
-    }
 
-    void LumosPhysicsEngine::NarrowPhaseCollisions()
-    {
-        LUMOS_PROFILE_FUNCTION();
-        if(m_BroadphaseCollisionPairs.empty())
-            return;
-#ifdef THREAD_NARROWPHASE
-        System::JobSystem::Context jobSystemContext;
-        System::JobSystem::Dispatch(jobSystemContext, static_cast<uint32_t>(m_BroadphaseCollisionPairs.size()), 128, [&](JobDispatchArgs args)
-#else
-        for(auto& cp : m_BroadphaseCollisionPairs)
-#endif
+        m_IslandBodies.clear();
+        m_IslandParents.clear();
+
+        auto inIsland = [this](RigidBody3D* body)
+        {
+            return body->m_IslandIndex < m_IslandBodies.size() && m_IslandBodies[body->m_IslandIndex] == body;
+        };
+
+        // Static bodies don't join islands, otherwise everything touching the ground would be one island.
+        // A body asleep in an island brings the whole island with it, unlinked so it can be regrouped
+        auto addBody = [&](RigidBody3D* body)
+        {
+            if(!body || body->GetIsStatic() || inIsland(body))
+                return;
+
+            const uint32_t first = static_cast<uint32_t>(m_IslandBodies.size());
+            RigidBody3D* member = body;
+            do
             {
-#ifdef THREAD_NARROWPHASE
-                CollisionPair& cp = m_BroadphaseCollisionPairs[args.jobIndex];
-#endif
-                auto shapeA = cp.pObjectA->GetCollisionShape();
-                auto shapeB = cp.pObjectB->GetCollisionShape();
+                RigidBody3D* next = member->m_IslandNext;
+                member->m_IslandPrev = member;
+                member->m_IslandNext = member;
+                member->m_IslandIndex = static_cast<uint32_t>(m_IslandBodies.size());
+
+                m_IslandBodies.push_back(member);
+                m_IslandParents.push_back(first);
+                member = next;
+            } while(member != body);
+        };
+
+        m_SleepingBodyCount = 0;
+        for(RigidBody3D* body : m_RigidBodys)
+        {
+            if(body->GetIsStatic())
+                continue;
 
-                if(shapeA && shapeB)
+            if(body->IsAwake())
+                addBody(body);
+            else
+                m_SleepingBodyCount++;
+        }
+
+        // Sleeping bodies touching an awake one join its island
+        auto addPair = [&](RigidBody3D* bodyA, RigidBody3D* bodyB)
+        {
+            if((bodyA && inIsland(bodyA)) || (bodyB && inIsland(bodyB)))
+            {
+                addBody(bodyA);
+                addBody(bodyB);
+            }
+        };
+
+        for(Manifold& m : m_Manifolds)
+            addPair(m.NodeA(), m.NodeB());
+
+        for(Constraint* c : m_Constraints)
+            addPair(c->GetBodyA(), c->GetBodyB());
+
+        const uint32_t bodyCount = static_cast<uint32_t>(m_IslandBodies.size());
+        m_IslandAwake.assign(bodyCount, 0);
+
+        auto find = [this](uint32_t index)
+        {
+            while(m_IslandParents[index] != index)
+            {
+                m_IslandParents[index] = m_IslandParents[m_IslandParents[index]];
+                index = m_IslandParents[index];
+            }
+            return index;
+        };
+
+        auto unite = [&](RigidBody3D* bodyA, RigidBody3D* bodyB)
+        {
+            if(!bodyA || !bodyB || !inIsland(bodyA) || !inIsland(bodyB))
+                return;
+
+            const uint32_t a = find(bodyA->m_IslandIndex);
+            const uint32_t b = find(bodyB->m_IslandIndex);
+            if(a != b)
+                m_IslandParents[Maths::Max(a, b)] = Maths::Min(a, b);
+        };
+
+        for(Manifold& m : m_Manifolds)
+            unite(m.NodeA(), m.NodeB());
+
+        for(Constraint* c : m_Constraints)
+            unite(c->GetBodyA(), c->GetBodyB());
+
+        // An island stays awake if any of its bodies is still moving, or was woken by a collision
+        for(uint32_t i = 0; i < bodyCount; i++)
+        {
+            if(!m_IslandBodies[i]->CanSleep())
+                m_IslandAwake[find(i)] = 1;
+        }
+
+        m_AwakeIslandCount = 0;
+
+        for(uint32_t i = 0; i < bodyCount; i++)
+        {
+            RigidBody3D* body = m_IslandBodies[i];
+            const uint32_t root = find(i);
+
+            if(m_IslandAwake[root])
+            {
+                if(root == i)
+                    m_AwakeIslandCount++;
+
+                if(!body->IsAwake())
+                {
+                    body->SetIsAtRest(false);
+                    m_SleepingBodyCount--;
+                }
+            }
+            else
+            {
+                // Linked into the root's list, waking any member next step finds the rest
+                if(root != i)
                 {
-                    CollisionData colData;
+                    RigidBody3D* rootBody = m_IslandBodies[root];
+                    body->m_IslandPrev = rootBody;
+                    body->m_IslandNext = rootBody->m_IslandNext;
+                    rootBody->m_IslandNext->m_IslandPrev = body;
+                    rootBody->m_IslandNext = body;
+                }
 
-                    // Detects if the objects are colliding - Seperating Axis Theorem
-                    if(CollisionDetection::Get().CheckCollision(cp.pObjectA, cp.pObjectB, shapeA.get(), shapeB.get(), &colData))
-                    {
-                        // Check to see if any of the objects have collision callbacks that dont
-                        // want the objects to physically collide
-                        const bool okA = cp.pObjectA->FireOnCollisionEvent(cp.pObjectA, cp.pObjectB);
-                        const bool okB = cp.pObjectB->FireOnCollisionEvent(cp.pObjectB, cp.pObjectA);
-
-                        if(okA && okB)
-                        {
-                            // Build full collision manifold that will also handle the collision
-                            // response between the two objects in the solver stage
-                            m_ManifoldLock.lock();
-                            Manifold& manifold = m_Manifolds.emplace_back();
-                            manifold.Initiate(cp.pObjectA, cp.pObjectB);
-
-                            // Construct contact points that form the perimeter of the collision manifold
-                            if(CollisionDetection::Get().BuildCollisionManifold(cp.pObjectA, cp.pObjectB, shapeA.get(), shapeB.get(), colData, &manifold))
-                            {
-                                // Fire callback
-                                cp.pObjectA->FireOnCollisionManifoldCallback(cp.pObjectA, cp.pObjectB, &manifold);
-                                cp.pObjectB->FireOnCollisionManifoldCallback(cp.pObjectB, cp.pObjectA, &manifold);
-                            }
-                            else
-                            {
-                                m_Manifolds.pop_back();
-                            }
-
-                            m_ManifoldLock.unlock();
-                        }
-                    }
+                if(body->IsAwake())
+                {
+                    body->m_LinearVelocity = Maths::Vector3(0.0f);
+                    body->m_AngularVelocity = Maths::Vector3(0.0f);
+                    body->SetIsAtRest(true);
+                    m_SleepingBodyCount++;
                 }
             }
-#ifdef THREAD_NARROWPHASE
-        );
+        }
+    }
 
-        System::JobSystem::Wait(jobSystemContext);
-#endif
+    void LumosPhysicsEngine::SolveConstraint(uint32_t index)
+    {
+        const uint32_t manifoldCount = static_cast<uint32_t>(m_Manifolds.size());
+        if(index < manifoldCount)
+            m_Manifolds[index].ApplyImpulse();
+        else
+            m_Constraints[index - manifoldCount]->ApplyImpulse();
     }
 
-    void LumosPhysicsEngine::SolveConstraints()
+    void LumosPhysicsEngine::ApplyImpulses()
     {
         LUMOS_PROFILE_FUNCTION();
 
-        {
-            LUMOS_PROFILE_SCOPE("Solve Manifolds");
+        // Small batches aren't worth the dispatch overhead
+        const uint32_t minParallelBatchSize = 128;
 
-            for(Manifold& m : m_Manifolds)
-                m.PreSolverStep(s_UpdateTimestep);
-        }
+        // Start from last step's impulses, skipping manifolds of sleeping islands that aren't solved
+        if(m_WarmStarting)
         {
-            LUMOS_PROFILE_SCOPE("Solve Constraints");
-
-            for(Constraint* c : m_Constraints)
-                c->PreSolverStep(s_UpdateTimestep);
+            const uint32_t manifoldCount = static_cast<uint32_t>(m_Manifolds.size());
+            for(uint32_t item : m_SolverItems)
+            {
+                if(item < manifoldCount)
+                    m_Manifolds[item].WarmStart();
+            }
         }
 
+        for(uint32_t i = 0; i < m_SolverIterations; i++)
         {
-            LUMOS_PROFILE_SCOPE("Apply Impulses");
+            for(uint32_t batch = 0; batch <= SOLVER_MAX_BATCHES; batch++)
+            {
+                const uint32_t offset = m_SolverBatchOffsets[batch];
+                const uint32_t count = m_SolverBatchOffsets[batch + 1] - offset;
+
+                if(count == 0)
+                    continue;
+
 #ifdef THREAD_APPLY_IMPULSES
-            System::JobSystem::Context jobSystemContext;
-            System::JobSystem::Dispatch(jobSystemContext, static_cast<uint32_t>(SOLVER_ITERATIONS), 128, [&](JobDispatchArgs args)
-#else
-            for(int i = 0; i < SOLVER_ITERATIONS; i++)
-#endif
+                if(batch < SOLVER_MAX_BATCHES && count >= minParallelBatchSize)
                 {
-                    for(
-                        Manifold& m : m_Manifolds)
-                    {
-                        m.ApplyImpulse();
-                    }
-
-                    for(Constraint* c : m_Constraints)
-                    {
-                        c->ApplyImpulse();
-                    }
+                    System::JobSystem::Context jobSystemContext;
+                    System::JobSystem::Dispatch(jobSystemContext, count, 64, [this, offset](JobDispatchArgs args)
+                        { SolveConstraint(m_SolverItems[offset + args.jobIndex]); });
+                    System::JobSystem::Wait(jobSystemContext);
+                    continue;
                 }
-#ifdef THREAD_APPLY_IMPULSES
-            );
-            System::JobSystem::Wait(jobSystemContext);
 #endif
+                for(uint32_t item = offset; item < offset + count; item++)
+                    SolveConstraint(m_SolverItems[item]);
+            }
         }
     }
 
@@ -442,6 +677,70 @@ namespace Lumos
         m_Constraints.clear();
     }
 
+    void LumosPhysicsEngine::Benchmark(uint32_t boxCount, uint32_t stepCount)
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        LumosPhysicsEngine engine;
+        engine.SetBroadphase(CreateSharedRef<DynamicAABBTreeBroadphase>());
+        std::vector<UniqueRef<RigidBody3D>> bodies;
+
+        {
+            RigidBody3DProperties properties;
+            properties.Position = Maths::Vector3(0.0f, -0.5f, 0.0f);
+            properties.Static = true;
+            properties.Shape = CreateSharedRef<CuboidCollisionShape>(Maths::Vector3(100.0f, 0.5f, 100.0f));
+            bodies.push_back(CreateUniqueRef<RigidBody3D>(properties));
+            bodies.back()->SetInverseMass(0.0f);
+        }
+
+        // Columns of boxes, slightly overlapping so every layer is in contact from the first step
+        const uint32_t layers = 10;
+        const uint32_t columns = Maths::Max(1U, static_cast<uint32_t>(ceilf(sqrtf(float(boxCount) / float(layers)))));
+        auto boxShape = CreateSharedRef<CuboidCollisionShape>(Maths::Vector3(0.5f));
+
+        for(uint32_t i = 0; i < boxCount; i++)
+        {
+            const uint32_t column = i / layers;
+            const uint32_t layer = i % layers;
+
+            RigidBody3DProperties properties;
+            properties.Position = Maths::Vector3(float(column % columns) * 1.05f, 0.49f + float(layer) * 0.99f, float(column / columns) * 1.05f);
+            properties.Shape = boxShape;
+            bodies.push_back(CreateUniqueRef<RigidBody3D>(properties));
+        }
+
+        engine.SetPaused(false);
+        for(auto& body : bodies)
+            engine.m_RigidBodys.push_back(body.get());
+
+        const uint32_t taskCount = engine.m_TaskGraph.GetTaskCount();
+        std::vector<float> taskTimes(taskCount, 0.0f);
+        float totalTime = 0.0f;
+        uint64_t pairCount = 0;
+        uint64_t contactCount = 0;
+
+        for(uint32_t step = 0; step < stepCount; step++)
+        {
+            auto start = Timer::Now();
+            engine.UpdatePhysics();
+            totalTime += Timer::Duration(start, Timer::Now(), 1000.0f);
+
+            for(uint32_t task = 0; task < taskCount; task++)
+                taskTimes[task] += engine.m_TaskGraph.GetTaskTime(task);
+
+            pairCount += engine.m_BroadphaseCollisionPairs.size();
+            contactCount += engine.m_ContactCount;
+        }
+
+        LUMOS_LOG_INFO("Physics Benchmark : {0} boxes, {1} steps, {2} pairs, {3} contacts per step", boxCount, stepCount, pairCount / stepCount, contactCount / stepCount);
+        LUMOS_LOG_INFO("{0:<24} {1:.3f}ms", "Step", totalTime / stepCount);
+        for(uint32_t task = 0; task < taskCount; task++)
+            LUMOS_LOG_INFO("{0:<24} {1:.3f}ms", engine.m_TaskGraph.GetTaskName(task), taskTimes[task] / stepCount);
+
+        engine.m_RigidBodys.clear();
+    }
+
     std::string IntegrationTypeToString(IntegrationType type)
     {
         switch(type)
@@ -492,6 +791,40 @@ namespace Lumos
         ImGui::PopItemWidth();
         ImGui::NextColumn();
 
+        ImGui::AlignTextToFramePadding();
+        ImGui::TextUnformatted("Awake Islands / Sleeping Bodies");
+        ImGui::NextColumn();
+        ImGui::PushItemWidth(-1);
+        ImGui::Text("%u / %u", m_AwakeIslandCount, m_SleepingBodyCount);
+        ImGui::PopItemWidth();
+        ImGui::NextColumn();
+
+        ImGui::AlignTextToFramePadding();
+        ImGui::TextUnformatted("Contacts (Warm Started)");
+        ImGui::NextColumn();
+        ImGui::PushItemWidth(-1);
+        ImGui::Text("%u (%u)", m_ContactCount, m_WarmStartedContacts);
+        ImGui::PopItemWidth();
+        ImGui::NextColumn();
+
+        ImGui::AlignTextToFramePadding();
+        ImGui::TextUnformatted("Warm Starting");
+        ImGui::NextColumn();
+        ImGui::PushItemWidth(-1);
+        ImGui::Checkbox("##Warm Starting", &m_WarmStarting);
+        ImGui::PopItemWidth();
+        ImGui::NextColumn();
+
+        ImGui::AlignTextToFramePadding();
+        ImGui::TextUnformatted("Solver Iterations");
+        ImGui::NextColumn();
+        ImGui::PushItemWidth(-1);
+        int solverIterations = static_cast<int>(m_SolverIterations);
+        if(ImGui::SliderInt("##Solver Iterations", &solverIterations, 1, 50))
+            m_SolverIterations = static_cast<uint32_t>(solverIterations);
+        ImGui::PopItemWidth();
+        ImGui::NextColumn();
+
         ImGui::AlignTextToFramePadding();
         ImGui::TextUnformatted("Paused");
         ImGui::NextColumn();
@@ -546,6 +879,13 @@ namespace Lumos
 
         ImGui::Columns(1);
         ImGui::Separator();
+
+        if(ImGui::TreeNode("Task Graph"))
+        {
+            m_TaskGraph.OnImGui();
+            ImGui::TreePop();
+        }
+
         ImGui::PopStyleVar();
     }
 
@@ -3,22 +3,18 @@
 #include "Utilities/TSingleton.h"
 #include "RigidBody3D.h"
 #include "Manifold.h"
+#include "Integration.h"
+#include "RigidBodyStore.h"
 #include "Broadphase.h"
 #include "Scene/ISystem.h"
 #include "Scene/Scene.h"
+#include "Core/TaskGraph.h"
 
 namespace Lumos
 {
 
-#define SOLVER_ITERATIONS 20
-
-    enum class LUMOS_EXPORT IntegrationType
-    {
-        EXPLICIT_EULER = 0,
-        SEMI_IMPLICIT_EULER,
-        RUNGE_KUTTA_2,
-        RUNGE_KUTTA_4
-    };
+#define SOLVER_ITERATIONS 6
+#define SOLVER_MAX_BATCHES 64
 
     enum PhysicsDebugFlags : uint32_t
     {
@@ -117,6 +113,9 @@ namespace Lumos
 
         void ClearConstraints();
 
+        //Steps a pile of boxes without a scene and logs the average time of each stage
+        static void Benchmark(uint32_t boxCount = 1000, uint32_t stepCount = 300);
+
         void OnImGui() override;
         void OnDebugDraw() override;
 
@@ -136,15 +135,49 @@ namespace Lumos
         //Handles broadphase collision detection
         void BroadPhaseCollisions();
 
-        //Handles narrowphase collision detection
-        void NarrowPhaseCollisions();
+        //A colliding pair found by a narrowphase job, its callbacks are fired later by MergeManifolds
+        struct NarrowphaseCollision
+        {
+            RigidBody3D* BodyA;
+            RigidBody3D* BodyB;
+            int32_t ManifoldIndex; // Into the group's manifolds, -1 if no manifold could be built
+        };
+
+        //Scratch output of each narrowphase job group
+        struct NarrowphaseGroup
+        {
+            std::vector<Manifold> Manifolds;
+            std::vector<NarrowphaseCollision> Collisions;
+        };
 
-        //Updates all Rigid Body position, orientation, velocity etc (default method uses symplectic euler integration)
-        void UpdateRigidBodys();
-        void UpdateRigidBody(RigidBody3D* obj) const;
+        //Handles narrowphase collision detection for a single broadphase pair, recording any collision to output.
+        //Runs on workers, so no collision callbacks are fired here
+        void NarrowPhaseCollision(CollisionPair& cp, NarrowphaseGroup& output);
+
+        //Fires the collision callbacks of each narrowphase group on this thread and appends the accepted manifolds
+        //to m_Manifolds in group order, so the result matches broadphase pair order
+        void MergeManifolds();
+
+        //Updates position, orientation and velocity of the bodies in lanes [firstLane, lastLane) of m_BodyStore,
+        //gathering them from m_RigidBodys and writing back the awake ones
+        void UpdateRigidBodies(uint32_t firstLane, uint32_t lastLane);
 
         //Solves all engine constraints (constraints and manifolds)
-        void SolveConstraints();
+        void PreSolveManifolds();
+        void PreSolveConstraints();
+        void ApplyImpulses();
+
+        //Splits manifolds and constraints into batches that share no dynamic bodies (greedy graph colouring)
+        //so each batch can be solved in parallel while iterations still run in sequence
+        void BatchConstraints();
+        void SolveConstraint(uint32_t index);
+
+        //Groups awake bodies, and sleeping islands they touch, into islands connected by manifolds or constraints.
+        //Islands sleep and wake as a whole, untouched sleeping islands cost nothing here
+        void UpdateIslands();
+
+        //Builds the per step task graph : broadphase -> narrowphase -> presolve -> solve -> integrate
+        void BuildTaskGraph();
 
     protected:
         bool m_IsPaused;
@@ -153,17 +186,47 @@ namespace Lumos
         float m_DampingFactor;
 
         std::vector<RigidBody3D*> m_RigidBodys;
+        RigidBodyStore m_BodyStore;
         std::vector<CollisionPair> m_BroadphaseCollisionPairs;
 
         std::vector<Constraint*> m_Constraints; // Misc constraints between pairs of objects
         std::vector<Manifold> m_Manifolds; // Contact constraints between pairs of objects
-        std::mutex m_ManifoldsMutex;
+        std::vector<NarrowphaseGroup> m_NarrowphaseGroups;
+        uint32_t m_NarrowphaseGroupCount = 0;
+
+        // Last step's manifolds by body pair, their accumulated impulses warm start matching contacts
+        struct BodyPairHash
+        {
+            size_t operator()(const std::pair<RigidBody3D*, RigidBody3D*>& pair) const
+            {
+                const size_t a = std::hash<RigidBody3D*>()(pair.first);
+                return a ^ (std::hash<RigidBody3D*>()(pair.second) + 0x9e3779b9 + (a << 6) + (a >> 2));
+            }
+        };
+        std::vector<Manifold> m_PreviousManifolds;
+        std::unordered_map<std::pair<RigidBody3D*, RigidBody3D*>, uint32_t, BodyPairHash> m_ManifoldCache;
+        uint32_t m_SolverIterations = SOLVER_ITERATIONS;
+        uint32_t m_WarmStartedContacts = 0;
+        uint32_t m_ContactCount = 0;
+        bool m_WarmStarting = true;
+
+        std::vector<uint32_t> m_SolverItems; // Manifold index, or manifold count + constraint index, sorted by batch
+        std::vector<uint32_t> m_SolverBatchOffsets; // Start of each batch in m_SolverItems. Last batch is solved serially
+        std::vector<uint32_t> m_SolverItemBatches;
+        std::unordered_map<RigidBody3D*, uint64_t> m_BodyBatches;
+
+        std::vector<RigidBody3D*> m_IslandBodies;
+        std::vector<uint32_t> m_IslandParents;
+        std::vector<uint8_t> m_IslandAwake;
+        uint32_t m_AwakeIslandCount = 0;
+        uint32_t m_SleepingBodyCount = 0;
 
         SharedRef<Broadphase> m_BroadphaseDetection;
         IntegrationType m_IntegrationType;
 
         uint32_t m_DebugDrawFlags = 0;
-        std::mutex m_ManifoldLock;
+
+        System::TaskGraph m_TaskGraph;
 
         bool m_MultipleUpdates = true;
         static float s_UpdateTimestep;
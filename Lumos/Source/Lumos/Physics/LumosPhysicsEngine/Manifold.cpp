@@ -38,6 +38,21 @@ namespace Lumos
         }
     }
 
+    void Manifold::ApplyContactImpulse(const Maths::Vector3& impulse, const Maths::Vector3& r1, const Maths::Vector3& r2) const
+    {
+        m_pNodeA->SetLinearVelocity(m_pNodeA->GetLinearVelocity()
+            + impulse * m_pNodeA->GetInverseMass());
+        m_pNodeB->SetLinearVelocity(m_pNodeB->GetLinearVelocity()
+            - impulse * m_pNodeB->GetInverseMass());
+
+        m_pNodeA->SetAngularVelocity(m_pNodeA->GetAngularVelocity()
+            + m_pNodeA->GetInverseInertia()
+                * Maths::Vector3::Cross(r1, impulse));
+        m_pNodeB->SetAngularVelocity(m_pNodeB->GetAngularVelocity()
+            - m_pNodeB->GetInverseInertia()
+                * Maths::Vector3::Cross(r2, impulse));
+    }
+
     void Manifold::SolveContactPoint(ContactPoint& c) const
     {
         LUMOS_PROFILE_FUNCTION();
@@ -56,15 +71,6 @@ namespace Lumos
 
         // Collision Resolution
         {
-            const float constraintMass = (m_pNodeA->GetInverseMass()
-                                             + m_pNodeB->GetInverseMass())
-                + Maths::Vector3::Dot(normal,
-                    Maths::Vector3::Cross(m_pNodeA->GetInverseInertia()
-                            * Maths::Vector3::Cross(r1, normal),
-                        r1)
-                        + Maths::Vector3::Cross(m_pNodeB->GetInverseInertia()
-                                * Maths::Vector3::Cross(r2, normal),
-                            r2));
             // Baumgarte Offset ( Adds energy to the System to counter
             // slight solving errors that accumulate over time
             // called as �constraint drift �)
@@ -82,72 +88,40 @@ namespace Lumos
             }
 
             float b_real = Maths::Max(b, c.elatisity_term + b * 0.2f);
-            float jn = -(Maths::Vector3::Dot(dv, normal) + b_real) / constraintMass;
+            float jn = -(Maths::Vector3::Dot(dv, normal) + b_real) / c.contactMass;
 
             //jn = min(jn, 0.0f);
             float oldSumImpulseContact = c.sumImpulseContact;
             c.sumImpulseContact = Maths::Min(c.sumImpulseContact + jn, 0.0f);
             jn = c.sumImpulseContact - oldSumImpulseContact;
 
-            m_pNodeA->SetLinearVelocity(m_pNodeA->GetLinearVelocity()
-                + normal * (jn * m_pNodeA->GetInverseMass()));
-            m_pNodeB->SetLinearVelocity(m_pNodeB->GetLinearVelocity()
-                - normal * (jn * m_pNodeB->GetInverseMass()));
-
-            m_pNodeA->SetAngularVelocity(m_pNodeA->GetAngularVelocity()
-                + m_pNodeA->GetInverseInertia()
-                    * Maths::Vector3::Cross(r1, normal * jn));
-            m_pNodeB->SetAngularVelocity(m_pNodeB->GetAngularVelocity()
-                - m_pNodeB->GetInverseInertia()
-                    * Maths::Vector3::Cross(r2, normal * jn));
+            ApplyContactImpulse(normal * jn, r1, r2);
         }
         // Friction
         {
-            Maths::Vector3 tangent = dv - normal * Maths::Vector3::Dot(dv, normal);
-            float tangent_len = tangent.Length();
-
-            if(tangent_len > 0.001f)
-            {
-                tangent = tangent * (1.0f / tangent_len);
-
-                float frictionalMass = (m_pNodeA->GetInverseMass()
-                                           + m_pNodeB->GetInverseMass())
-                    + Maths::Vector3::Dot(tangent,
-                        Maths::Vector3::Cross(m_pNodeA->GetInverseInertia()
-                                * Maths::Vector3::Cross(r1, tangent),
-                            r1)
-                            + Maths::Vector3::Cross(m_pNodeB->GetInverseInertia()
-                                    * Maths::Vector3::Cross(r2, tangent),
-                                r2));
-
-                float frictionCoef = sqrtf(m_pNodeA->GetFriction()
-                    * m_pNodeB->GetFriction());
+            // Solved along two fixed axes so the accumulated impulses stay meaningful between steps
+            v0 = m_pNodeA->GetLinearVelocity() + Maths::Vector3::Cross(m_pNodeA->GetAngularVelocity(), r1);
+            v1 = m_pNodeB->GetLinearVelocity() + Maths::Vector3::Cross(m_pNodeB->GetAngularVelocity(), r2);
+            dv = v0 - v1;
 
-                float jt = -1 * frictionCoef * Maths::Vector3::Dot(dv, tangent)
-                    / frictionalMass;
+            float frictionCoef = sqrtf(m_pNodeA->GetFriction()
+                * m_pNodeB->GetFriction());
 
-                // Clamp friction to never apply more force than the main collision
-                // resolution force
+            // Clamp friction to never apply more force than the main collision
+            // resolution force
+            float maxJt = frictionCoef * c.sumImpulseContact;
 
-                float oldImpulseTangent = c.sumImpulseFriction;
-                float maxJt = frictionCoef * c.sumImpulseContact;
+            float jt = -1 * Maths::Vector3::Dot(dv, c.tangent) / c.frictionMass;
+            float oldImpulseTangent = c.sumImpulseFriction;
+            c.sumImpulseFriction = Maths::Min(Maths::Max(oldImpulseTangent + jt, maxJt), -maxJt);
+            jt = c.sumImpulseFriction - oldImpulseTangent;
 
-                c.sumImpulseFriction = Maths::Min(Maths::Max(oldImpulseTangent + jt, maxJt), -maxJt);
+            float jt2 = -1 * Maths::Vector3::Dot(dv, c.tangent2) / c.frictionMass2;
+            float oldImpulseTangent2 = c.sumImpulseFriction2;
+            c.sumImpulseFriction2 = Maths::Min(Maths::Max(oldImpulseTangent2 + jt2, maxJt), -maxJt);
+            jt2 = c.sumImpulseFriction2 - oldImpulseTangent2;
 
-                jt = c.sumImpulseFriction - oldImpulseTangent;
-
-                m_pNodeA->SetLinearVelocity(m_pNodeA->GetLinearVelocity()
-                    + tangent * (jt * m_pNodeA->GetInverseMass()));
-                m_pNodeB->SetLinearVelocity(m_pNodeB->GetLinearVelocity()
-                    - tangent * (jt * m_pNodeB->GetInverseMass()));
-
-                m_pNodeA->SetAngularVelocity(m_pNodeA->GetAngularVelocity()
-                    + m_pNodeA->GetInverseInertia()
-                        * Maths::Vector3::Cross(r1, tangent * jt));
-                m_pNodeB->SetAngularVelocity(m_pNodeB->GetAngularVelocity()
-                    - m_pNodeB->GetInverseInertia()
-                        * Maths::Vector3::Cross(r2, tangent * jt));
-            }
+            ApplyContactImpulse(c.tangent * jt + c.tangent2 * jt2, r1, r2);
         }
     }
 
@@ -165,9 +139,35 @@ namespace Lumos
     {
         LUMOS_PROFILE_FUNCTION();
 
-        //Reset total impulse forces computed this physics timestep
-        contact.sumImpulseContact = 0.0f;
-        contact.sumImpulseFriction = 0.0f;
+        //Reset total impulse forces unless they were carried over from the previous step
+        if(!contact.warmStarted)
+        {
+            contact.sumImpulseContact = 0.0f;
+            contact.sumImpulseFriction = 0.0f;
+            contact.sumImpulseFriction2 = 0.0f;
+        }
+
+        //Fixed friction basis perpendicular to the normal
+        const Maths::Vector3& normal = contact.collisionNormal;
+        if(Maths::Abs(normal.x) >= 0.57735f)
+            contact.tangent = Maths::Vector3(normal.y, -normal.x, 0.0f);
+        else
+            contact.tangent = Maths::Vector3(0.0f, normal.z, -normal.y);
+        contact.tangent.Normalise();
+        contact.tangent2 = Maths::Vector3::Cross(normal, contact.tangent);
+
+        //Effective mass along each axis, constant for the rest of the step
+        auto effectiveMass = [&](const Maths::Vector3& axis)
+        {
+            return (m_pNodeA->GetInverseMass() + m_pNodeB->GetInverseMass())
+                + Maths::Vector3::Dot(axis,
+                    Maths::Vector3::Cross(m_pNodeA->GetInverseInertia() * Maths::Vector3::Cross(contact.relPosA, axis), contact.relPosA)
+                        + Maths::Vector3::Cross(m_pNodeB->GetInverseInertia() * Maths::Vector3::Cross(contact.relPosB, axis), contact.relPosB));
+        };
+
+        contact.contactMass = effectiveMass(normal);
+        contact.frictionMass = effectiveMass(contact.tangent);
+        contact.frictionMass2 = effectiveMass(contact.tangent2);
 
         // Compute Elasticity Term - must be computed prior to solving
         // ANY constraints otherwise the objects velocities may have
@@ -202,6 +202,77 @@ namespace Lumos
         }
     }
 
+    void Manifold::WarmStartFrom(const Manifold& previous)
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        // Bodies swapped order, the stored impulses don't line up with this manifold's normals
+        if(previous.m_pNodeA != m_pNodeA || previous.m_pNodeB != m_pNodeB)
+            return;
+
+        // Contacts have no stable feature ids, so match by proximity on both bodies in local space
+        for(uint32_t i = 0; i < m_ContactCount; i++)
+        {
+            ContactPoint& contact = m_vContacts[i];
+            float closestDistSq = persistentThresholdSq;
+            int32_t closest = -1;
+
+            for(uint32_t j = 0; j < previous.m_ContactCount; j++)
+            {
+                const ContactPoint& old = previous.m_vContacts[j];
+                if(Maths::Vector3::Dot(old.collisionNormal, contact.collisionNormal) < 0.95f)
+                    continue;
+
+                const Maths::Vector3 da = old.localPosA - contact.localPosA;
+                const Maths::Vector3 db = old.localPosB - contact.localPosB;
+                const float distSq = Maths::Max(Maths::Vector3::Dot(da, da), Maths::Vector3::Dot(db, db));
+
+                if(distSq < closestDistSq)
+                {
+                    closestDistSq = distSq;
+                    closest = static_cast<int32_t>(j);
+                }
+            }
+
+            if(closest < 0)
+                continue;
+
+            const ContactPoint& old = previous.m_vContacts[closest];
+            contact.sumImpulseContact = old.sumImpulseContact;
+            contact.sumImpulseFriction = old.sumImpulseFriction;
+            contact.sumImpulseFriction2 = old.sumImpulseFriction2;
+            contact.warmStarted = true;
+        }
+    }
+
+    void Manifold::WarmStart()
+    {
+        LUMOS_PROFILE_FUNCTION();
+
+        if(m_pNodeA->GetInverseMass() + m_pNodeB->GetInverseMass() == 0.0f)
+            return;
+
+        for(uint32_t i = 0; i < m_ContactCount; i++)
+        {
+            const ContactPoint& c = m_vContacts[i];
+            if(!c.warmStarted)
+                continue;
+
+            ApplyContactImpulse(c.collisionNormal * c.sumImpulseContact + c.tangent * c.sumImpulseFriction + c.tangent2 * c.sumImpulseFriction2, c.relPosA, c.relPosB);
+        }
+    }
+
+    uint32_t Manifold::GetWarmStartedCount() const
+    {
+        uint32_t count = 0;
+        for(uint32_t i = 0; i < m_ContactCount; i++)
+        {
+            if(m_vContacts[i].warmStarted)
+                count++;
+        }
+        return count;
+    }
+
     void Manifold::AddContact(const Maths::Vector3& globalOnA, const Maths::Vector3& globalOnB, const Maths::Vector3& _normal, const float& _penetration)
     {
         LUMOS_PROFILE_FUNCTION();
@@ -214,6 +285,8 @@ namespace Lumos
         ContactPoint contact;
         contact.relPosA = r1;
         contact.relPosB = r2;
+        contact.localPosA = m_pNodeA->GetOrientation().Conjugate() * r1;
+        contact.localPosB = m_pNodeB->GetOrientation().Conjugate() * r2;
         contact.collisionNormal = _normal;
         contact.collisionPenetration = _penetration;
         contact.elatisity_term = 1.0f;
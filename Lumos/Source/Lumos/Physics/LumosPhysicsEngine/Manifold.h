@@ -13,12 +13,23 @@ namespace Lumos
     {
         float sumImpulseContact = 0.0f;
         float sumImpulseFriction = 0.0f;
+        float sumImpulseFriction2 = 0.0f;
         float elatisity_term = 0.0f;
         float collisionPenetration = 0.0f;
 
+        //Effective masses along the normal and friction axes, computed in PreSolverStep
+        float contactMass = 0.0f;
+        float frictionMass = 0.0f;
+        float frictionMass2 = 0.0f;
+
         Maths::Vector3 collisionNormal;
+        Maths::Vector3 tangent; //Friction axes perpendicular to the collision normal
+        Maths::Vector3 tangent2;
         Maths::Vector3 relPosA; //Position relative to objectA
         Maths::Vector3 relPosB; //Position relative to objectB
+        Maths::Vector3 localPosA; //Position in objectA's local space, used to match contacts between steps
+        Maths::Vector3 localPosB;
+        bool warmStarted = false;
     };
 #define MAX_CONTACT_POINTS 8
 
@@ -34,6 +45,12 @@ namespace Lumos
         //Called whenever a new collision contact between A & B are found
         void AddContact(const Maths::Vector3& globalOnA, const Maths::Vector3& globalOnB, const Maths::Vector3& _normal, const float& _penetration);
 
+        //Copies accumulated impulses from last step's manifold of the same pair onto matching contacts
+        void WarmStartFrom(const Manifold& previous);
+
+        //Applies the copied impulses so the solver starts from last step's solution
+        void WarmStart();
+
         //Sequentially solves each contact constraint
         void ApplyImpulse();
         void PreSolverStep(float dt);
@@ -51,9 +68,13 @@ namespace Lumos
             return m_pNodeB;
         }
 
+        uint32_t GetContactCount() const { return m_ContactCount; }
+        uint32_t GetWarmStartedCount() const;
+
     protected:
         void SolveContactPoint(ContactPoint& c) const;
         void UpdateConstraint(ContactPoint& c);
+        void ApplyContactImpulse(const Maths::Vector3& impulse, const Maths::Vector3& r1, const Maths::Vector3& r2) const;
 
     protected:
         RigidBody3D* m_pNodeA;
@@ -14,6 +14,7 @@ namespace Lumos
         class BoundingBox;
     }
 
+    // Rebuilds the tree from every body each step, sleeping ones included. The secondary broadphase skips pairs of resting bodies
     class LUMOS_EXPORT OctreeBroadphase : public Broadphase
     {
     public:
@@ -17,9 +17,6 @@ namespace Lumos
         {
             ConstructPyramidHull();
         }
-
-        m_Axes.resize(5);
-        m_Edges.resize(m_PyramidHull->GetNumEdges());
     }
 
     PyramidCollisionShape::PyramidCollisionShape(const Maths::Vector3& halfdims)
@@ -48,9 +45,6 @@ namespace Lumos
         {
             ConstructPyramidHull();
         }
-
-        m_Axes.resize(5);
-        m_Edges.resize(m_PyramidHull->GetNumEdges());
     }
 
     PyramidCollisionShape::~PyramidCollisionShape()
@@ -71,7 +65,7 @@ namespace Lumos
         return inertia;
     }
 
-    std::vector<CollisionEdge>& PyramidCollisionShape::GetEdges(const RigidBody3D* currentObject)
+    void PyramidCollisionShape::GetEdges(const RigidBody3D* currentObject, std::vector<CollisionEdge>& out_edges) const
     {
         LUMOS_PROFILE_FUNCTION();
         {
@@ -82,27 +76,22 @@ namespace Lumos
                 Maths::Vector3 A = transform * m_PyramidHull->GetVertex(edge.vStart).pos;
                 Maths::Vector3 B = transform * m_PyramidHull->GetVertex(edge.vEnd).pos;
 
-                m_Edges[i] = { A, B };
+                out_edges.emplace_back(A, B);
             }
         }
-        return m_Edges;
     }
 
-    std::vector<Maths::Vector3>& PyramidCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject)
+    void PyramidCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject, std::vector<Maths::Vector3>& out_axes) const
     {
         LUMOS_PROFILE_FUNCTION();
         {
-            m_Axes.clear();
-            m_Axes.resize(5);
             const Maths::Matrix3 objOrientation = currentObject->GetOrientation().RotationMatrix();
-            m_Axes[0] = (objOrientation * m_Normals[0]);
-            m_Axes[1] = (objOrientation * m_Normals[1]);
-            m_Axes[2] = (objOrientation * m_Normals[2]);
-            m_Axes[3] = (objOrientation * m_Normals[3]);
-            m_Axes[4] = (objOrientation * m_Normals[4]);
+            out_axes.push_back(objOrientation * m_Normals[0]);
+            out_axes.push_back(objOrientation * m_Normals[1]);
+            out_axes.push_back(objOrientation * m_Normals[2]);
+            out_axes.push_back(objOrientation * m_Normals[3]);
+            out_axes.push_back(objOrientation * m_Normals[4]);
         }
-
-        return m_Axes;
     }
 
     void PyramidCollisionShape::GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Maths::Vector3& axis, Maths::Vector3* out_min, Maths::Vector3* out_max) const
@@ -41,6 +41,9 @@ namespace Lumos
 
     RigidBody3D::~RigidBody3D()
     {
+        // Leave the sleeping island, the rest of it still wakes together
+        m_IslandPrev->m_IslandNext = m_IslandNext;
+        m_IslandNext->m_IslandPrev = m_IslandPrev;
     }
 
     const Maths::BoundingBox& RigidBody3D::GetWorldSpaceAABB()
@@ -57,6 +60,11 @@ namespace Lumos
 
     void RigidBody3D::WakeUp()
     {
+        // Keep the island awake for a few steps, otherwise the low averaged velocity from before it slept
+        // would put it straight back to sleep
+        if(m_AtRest && m_RestVelocityThresholdSquared > 0.0f)
+            m_AverageSummedVelocity = Maths::Max(m_AverageSummedVelocity, m_RestVelocityThresholdSquared * 4.0f);
+
         SetIsAtRest(false);
     }
 
@@ -121,8 +129,52 @@ namespace Lumos
         const float v = m_LinearVelocity.LengthSquared() + m_AngularVelocity.LengthSquared();
         m_AverageSummedVelocity += ALPHA * (v - m_AverageSummedVelocity);
 
-        // Do test
-        SetIsAtRest(m_AverageSummedVelocity <= m_RestVelocityThresholdSquared);
+        // Sleeping is decided per island, see LumosPhysicsEngine::UpdateIslands
+    }
+
+    void RigidBody3D::UpdateCollisionCache()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(!m_CollisionCacheInvalidated)
+            return;
+
+        m_CollisionCacheInvalidated = false;
+
+        // Cleared rather than freed, so after the first step this only allocates if the shape grows
+        m_CollisionAxes.clear();
+        m_CollisionEdges.clear();
+        m_CollisionEdgeDirections.clear();
+
+        if(!m_CollisionShape)
+            return;
+
+        m_CollisionShape->GetCollisionAxes(this, m_CollisionAxes);
+        m_CollisionShape->GetEdges(this, m_CollisionEdges);
+
+        // Parallel edges produce the same edge/edge axes, so only one direction of each is kept.
+        // A cuboid's 12 edges reduce to 3 directions
+        const float epsilon = 0.0001f;
+        for(const CollisionEdge& edge : m_CollisionEdges)
+        {
+            Maths::Vector3 direction = edge.posB - edge.posA;
+            if(direction.LengthSquared() < epsilon)
+                continue;
+
+            direction.Normalise();
+
+            bool parallel = false;
+            for(const Maths::Vector3& existing : m_CollisionEdgeDirections)
+            {
+                if(abs(Maths::Vector3::Dot(direction, existing)) >= 1.0f - epsilon)
+                {
+                    parallel = true;
+                    break;
+                }
+            }
+
+            if(!parallel)
+                m_CollisionEdgeDirections.push_back(direction);
+        }
     }
 
     void RigidBody3D::DebugDraw(uint64_t flags) const
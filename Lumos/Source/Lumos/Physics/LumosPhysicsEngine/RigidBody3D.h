@@ -56,6 +56,7 @@ namespace Lumos
     class LUMOS_EXPORT RigidBody3D : public RigidBody
     {
         friend class LumosPhysicsEngine;
+        friend struct RigidBodyStore;
 
     public:
         RigidBody3D(const RigidBody3DProperties& properties = RigidBody3DProperties());
@@ -127,6 +128,8 @@ namespace Lumos
             m_Position = v;
             m_wsTransformInvalidated = true;
             m_wsAabbInvalidated = true;
+            m_CollisionCacheInvalidated = true;
+            m_TransformDirty = true;
             //m_AtRest = false;
         }
 
@@ -147,6 +150,8 @@ namespace Lumos
         {
             m_Orientation = v;
             m_wsTransformInvalidated = true;
+            m_CollisionCacheInvalidated = true;
+            m_TransformDirty = true;
             //m_AtRest = false;
         }
 
@@ -191,8 +196,24 @@ namespace Lumos
         }
 
         void AutoResizeBoundingBox();
+
+        //Updates the averaged velocity used to decide if the body's island can sleep
         void RestTest();
 
+        //True if the body has been slow enough for long enough to sleep. Islands only sleep when every body can
+        bool CanSleep() const
+        {
+            return m_RestVelocityThresholdSquared > 0.0f && m_AverageSummedVelocity <= m_RestVelocityThresholdSquared;
+        }
+
+        // Rebuilds the world space collision axes, edges and edge directions if the body moved since the last call.
+        // Called once per step before the narrowphase so every pair the body is in can share them
+        void UpdateCollisionCache();
+
+        const std::vector<Maths::Vector3>& GetCollisionAxes() const { return m_CollisionAxes; }
+        const std::vector<CollisionEdge>& GetCollisionEdges() const { return m_CollisionEdges; }
+        const std::vector<Maths::Vector3>& GetCollisionEdgeDirections() const { return m_CollisionEdgeDirections; } //!< Unique normalised edge directions
+
         virtual void DebugDraw(uint64_t flags) const;
 
         typedef std::function<void(RigidBody3D*, RigidBody3D*, Manifold*)> OnCollisionManifoldCallback;
@@ -206,6 +227,7 @@ namespace Lumos
         {
             m_CollisionShape = shape;
             m_InvInertia = m_CollisionShape->BuildInverseInertia(m_InvMass);
+            m_CollisionCacheInvalidated = true;
             AutoResizeBoundingBox();
         }
 
@@ -215,6 +237,7 @@ namespace Lumos
         {
             if(m_CollisionShape)
                 m_InvInertia = m_CollisionShape->BuildInverseInertia(m_InvMass);
+            m_CollisionCacheInvalidated = true;
             AutoResizeBoundingBox();
         }
 
@@ -268,6 +291,12 @@ namespace Lumos
         float m_RestVelocityThresholdSquared;
         float m_AverageSummedVelocity;
 
+        uint32_t m_IslandIndex = ~0u; //!< Index in the physics engine's island body list this step
+        RigidBody3D* m_IslandPrev = this; //!< Circular list through the sleeping island the body went to sleep with,
+        RigidBody3D* m_IslandNext = this; //!< so waking one body finds the rest. Points to itself outside an island
+        bool m_TransformDirty = true; //!< Position or orientation changed since it was last copied to the entity's Transform
+        bool m_CollisionCacheInvalidated = true; //!< World space collision axes and edges need rebuilding
+
         mutable Maths::Matrix4 m_wsTransform;
         Maths::BoundingBox m_localBoundingBox; //!< Model orientated bounding box in model space
         mutable bool m_wsAabbInvalidated; //!< Flag indicating if the cached world space transoformed AABB is invalid
@@ -288,6 +317,9 @@ namespace Lumos
 
         //<----------COLLISION------------>
         SharedRef<CollisionShape> m_CollisionShape;
+        std::vector<Maths::Vector3> m_CollisionAxes;
+        std::vector<CollisionEdge> m_CollisionEdges;
+        std::vector<Maths::Vector3> m_CollisionEdgeDirections;
         PhysicsCollisionCallback m_OnCollisionCallback;
         std::vector<OnCollisionManifoldCallback> m_onCollisionManifoldCallbacks; //!< Collision callbacks post manifold generation
     };
@@ -0,0 +1,84 @@
+#include "Precompiled.h"
+#include "RigidBodyStore.h"
+#include "RigidBody3D.h"
+
+namespace Lumos
+{
+    void RigidBodyStore::Resize(uint32_t bodyCount)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        m_Count = bodyCount;
+        const size_t size = size_t(GetLaneCount()) * LaneWidth;
+
+        for(auto* array : { &PositionX, &PositionY, &PositionZ, &VelocityX, &VelocityY, &VelocityZ,
+                &AccelerationX, &AccelerationY, &AccelerationZ, &AngularVelocityX, &AngularVelocityY, &AngularVelocityZ,
+                &AngularAccelerationX, &AngularAccelerationY, &AngularAccelerationZ,
+                &OrientationX, &OrientationY, &OrientationZ, &InverseMass })
+        {
+            array->resize(size, 0.0f);
+        }
+
+        // Padding lanes stay identity and inactive
+        OrientationW.resize(size, 1.0f);
+        Active.resize(size, 0.0f);
+        for(size_t i = bodyCount; i < size; i++)
+            Active[i] = 0.0f;
+    }
+
+    void RigidBodyStore::Gather(uint32_t index, const RigidBody3D* body)
+    {
+        const bool active = !body->GetIsStatic() && body->IsAwake();
+        Active[index] = active ? 1.0f : 0.0f;
+        if(!active)
+            return;
+
+        PositionX[index] = body->m_Position.x;
+        PositionY[index] = body->m_Position.y;
+        PositionZ[index] = body->m_Position.z;
+
+        VelocityX[index] = body->m_LinearVelocity.x;
+        VelocityY[index] = body->m_LinearVelocity.y;
+        VelocityZ[index] = body->m_LinearVelocity.z;
+
+        const Maths::Vector3 acceleration = body->m_Force * body->m_InvMass;
+        AccelerationX[index] = acceleration.x;
+        AccelerationY[index] = acceleration.y;
+        AccelerationZ[index] = acceleration.z;
+
+        AngularVelocityX[index] = body->m_AngularVelocity.x;
+        AngularVelocityY[index] = body->m_AngularVelocity.y;
+        AngularVelocityZ[index] = body->m_AngularVelocity.z;
+
+        const Maths::Vector3 angularAcceleration = body->m_InvInertia * body->m_Torque;
+        AngularAccelerationX[index] = angularAcceleration.x;
+        AngularAccelerationY[index] = angularAcceleration.y;
+        AngularAccelerationZ[index] = angularAcceleration.z;
+
+        OrientationW[index] = body->m_Orientation.w;
+        OrientationX[index] = body->m_Orientation.x;
+        OrientationY[index] = body->m_Orientation.y;
+        OrientationZ[index] = body->m_Orientation.z;
+
+        InverseMass[index] = body->m_InvMass;
+    }
+
+    bool RigidBodyStore::Scatter(uint32_t index, RigidBody3D* body) const
+    {
+        if(Active[index] == 0.0f)
+            return false;
+
+        body->m_Position = Maths::Vector3(PositionX[index], PositionY[index], PositionZ[index]);
+        body->m_LinearVelocity = Maths::Vector3(VelocityX[index], VelocityY[index], VelocityZ[index]);
+        body->m_AngularVelocity = Maths::Vector3(AngularVelocityX[index], AngularVelocityY[index], AngularVelocityZ[index]);
+        body->m_Orientation = Maths::Quaternion(OrientationW[index], OrientationX[index], OrientationY[index], OrientationZ[index]);
+
+        // Mark cached world transform and AABB as invalid
+        body->m_wsTransformInvalidated = true;
+        body->m_wsAabbInvalidated = true;
+        body->m_CollisionCacheInvalidated = true;
+        body->m_TransformDirty = true;
+
+        body->RestTest();
+        return true;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Maths/Maths.h"
+
+namespace Lumos
+{
+    class RigidBody3D;
+
+    // Structure of arrays copy of the rigid body state touched by integration.
+    // Bodies are gathered into lanes of 4 so the integrators can update four bodies per SSE instruction,
+    // arrays are padded to a whole number of lanes and padding is never active.
+    struct LUMOS_EXPORT RigidBodyStore
+    {
+        static const uint32_t LaneWidth = 4;
+
+        std::vector<float> PositionX, PositionY, PositionZ;
+        std::vector<float> VelocityX, VelocityY, VelocityZ;
+        std::vector<float> AccelerationX, AccelerationY, AccelerationZ; // Force * inverse mass
+        std::vector<float> AngularVelocityX, AngularVelocityY, AngularVelocityZ;
+        std::vector<float> AngularAccelerationX, AngularAccelerationY, AngularAccelerationZ; // Inverse inertia * torque
+        std::vector<float> OrientationW, OrientationX, OrientationY, OrientationZ;
+        std::vector<float> InverseMass;
+        std::vector<float> Active; // 1 for awake dynamic bodies, 0 for static, sleeping and padding
+
+        uint32_t GetCount() const { return m_Count; }
+        uint32_t GetLaneCount() const { return (m_Count + LaneWidth - 1) / LaneWidth; }
+
+        // Sizes every array for bodyCount bodies, rounded up to a whole lane
+        void Resize(uint32_t bodyCount);
+
+        // Copy a body's state into/out of slot index. Scatter only writes back active bodies and returns whether it did
+        void Gather(uint32_t index, const RigidBody3D* body);
+        bool Scatter(uint32_t index, RigidBody3D* body) const;
+
+    private:
+        uint32_t m_Count = 0;
+    };
+}
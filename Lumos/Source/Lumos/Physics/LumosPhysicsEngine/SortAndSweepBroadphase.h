@@ -6,6 +6,7 @@
 namespace Lumos
 {
 
+    // Sorts and sweeps every body each step, sleeping ones included. Only pairs of two resting or static bodies are skipped
     class LUMOS_EXPORT SortAndSweepBroadphase : public Broadphase
     {
     public:
@@ -39,17 +39,14 @@ namespace Lumos
         return inertia;
     }
 
-    std::vector<Maths::Vector3>& SphereCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject)
+    void SphereCollisionShape::GetCollisionAxes(const RigidBody3D* currentObject, std::vector<Maths::Vector3>& out_axes) const
     {
         /* There is infinite edges so handle seperately */
-        m_Axes.clear();
-        return m_Axes;
     }
 
-    std::vector<CollisionEdge>& SphereCollisionShape::GetEdges(const RigidBody3D* currentObject)
+    void SphereCollisionShape::GetEdges(const RigidBody3D* currentObject, std::vector<CollisionEdge>& out_edges) const
     {
         /* There is infinite edges on a sphere so handle seperately */
-        return m_Edges;
     }
 
     void SphereCollisionShape::GetMinMaxVertexOnAxis(const RigidBody3D* currentObject, const Maths::Vector3& axis, Maths::Vector3* out_min, Maths::Vector3* out_max) const
@@ -15,6 +15,16 @@ namespace Lumos
         virtual void ApplyImpulse() override;
         virtual void DebugDraw() const override;
 
+        RigidBody3D* GetBodyA() const override
+        {
+            return m_pObj1.get();
+        }
+
+        RigidBody3D* GetBodyB() const override
+        {
+            return m_pObj2.get();
+        }
+
     protected:
         SharedRef<RigidBody3D> m_pObj1;
         SharedRef<RigidBody3D> m_pObj2;
@@ -20,6 +20,16 @@ namespace Lumos
         virtual void ApplyImpulse() override;
         virtual void DebugDraw() const override;
 
+        RigidBody3D* GetBodyA() const override
+        {
+            return m_pObj1;
+        }
+
+        RigidBody3D* GetBodyB() const override
+        {
+            return m_pObj2;
+        }
+
     protected:
         RigidBody3D* m_pObj1;
         RigidBody3D* m_pObj2;
@@ -58,6 +58,7 @@ namespace Lumos
             {
                 auto soundNode = soundsView.get<SoundComponent>(entity).GetSoundNode();
                 soundNode->SetPosition(soundsView.get<Maths::Transform>(entity).GetWorldPosition());
+                soundNode->UpdateStreaming();
                 soundNode->OnUpdate(dt.GetElapsedMillis());
             }
         }
@@ -10,6 +10,7 @@ namespace Lumos
     {
     public:
         ALSound(const std::string& fileName, const std::string& format);
+        ALSound(const std::string& fileName, const AudioData& data);
         virtual ~ALSound();
 
         unsigned int GetBuffer() const
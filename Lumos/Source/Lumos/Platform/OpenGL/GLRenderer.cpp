@@ -225,6 +225,13 @@ namespace Lumos
             //GLCall(glDrawArrays(GLTools::DrawTypeToGL(type), start, count));
         }
 
+        void GLRenderer::DrawIndexedInstancedInternal(CommandBuffer* commandBuffer, const DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start) const
+        {
+            LUMOS_PROFILE_FUNCTION();
+            Engine::Get().Statistics().NumDrawCalls++;
+            GLCall(glDrawElementsInstanced(GLTools::DrawTypeToGL(type), count, GLTools::DataTypeToGL(DataType::UNSIGNED_INT), nullptr, instanceCount));
+        }
+
         void GLRenderer::BindDescriptorSetsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, uint32_t dynamicOffset, std::vector<Graphics::DescriptorSet*>& descriptorSets)
         {
             LUMOS_PROFILE_FUNCTION();
@@ -33,6 +33,7 @@ namespace Lumos
             void BindDescriptorSetsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, uint32_t dynamicOffset, std::vector<Graphics::DescriptorSet*>& descriptorSets) override;
             void DrawInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, DataType dataType, void* indices) const override;
             void DrawIndexedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start) const override;
+            void DrawIndexedInstancedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start) const override;
             void SetRenderModeInternal(RenderMode mode);
             void OnResize(uint32_t width, uint32_t height) override;
             void PresentInternal() override;
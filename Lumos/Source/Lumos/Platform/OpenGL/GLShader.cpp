@@ -375,6 +375,15 @@ namespace Lumos
             }
         }
 
+        void GLShader::BindPushConstant(Graphics::CommandBuffer* cmdBuffer, Graphics::Pipeline* pipeline, uint32_t index, const uint8_t* data)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            for(auto& member : m_PushConstants[index].m_Members)
+            {
+                SetUniform(member.type, const_cast<uint8_t*>(data), member.size, member.offset, member.fullName);
+            }
+        }
+
         bool GLShader::CreateLocations()
         {
             LUMOS_PROFILE_FUNCTION();
@@ -87,6 +87,7 @@ namespace Lumos
             }
             std::vector<PushConstant>& GetPushConstants() override { return m_PushConstants; }
             void BindPushConstants(Graphics::CommandBuffer* cmdBuffer, Graphics::Pipeline* pipeline) override;
+            void BindPushConstant(Graphics::CommandBuffer* cmdBuffer, Graphics::Pipeline* pipeline, uint32_t index, const uint8_t* data) override;
 
             DescriptorSetInfo GetDescriptorInfo(uint32_t index) override
             {
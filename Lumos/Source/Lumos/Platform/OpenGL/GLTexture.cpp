@@ -27,6 +27,7 @@ namespace Lumos
             m_Name = "";
             m_Parameters = parameters;
             m_LoadOptions = loadOptions;
+            isHDR = m_Parameters.format == TextureFormat::RGBA32 || m_Parameters.format == TextureFormat::RGB32;
             m_Handle = Load(data);
         }
 
@@ -92,6 +93,17 @@ namespace Lumos
             GLCall(glGenerateMipmap(GL_TEXTURE_2D));
         }
 
+        void GLTexture2D::SetData(const void* pixels, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t rowLength)
+        {
+            LUMOS_ASSERT(x + width <= m_Width && y + height <= m_Height, "Texture region out of bounds");
+
+            GLCall(glBindTexture(GL_TEXTURE_2D, m_Handle));
+            GLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength));
+            GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GLTools::TextureFormatToGL(m_Parameters.format, m_Parameters.srgb), GL_UNSIGNED_BYTE, pixels));
+            GLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+            GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+        }
+
         void GLTexture2D::Bind(uint32_t slot) const
         {
             GLCall(glActiveTexture(GL_TEXTURE0 + slot));
@@ -17,6 +17,7 @@ namespace Lumos
             void Unbind(uint32_t slot = 0) const override;
 
             virtual void SetData(const void* pixels) override;
+            virtual void SetData(const void* pixels, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t rowLength) override;
 
             virtual void* GetHandle() const override
             {
@@ -31,6 +32,10 @@ namespace Lumos
             {
                 return m_Height;
             }
+            inline TextureFormat GetFormat() const override
+            {
+                return m_Parameters.format;
+            }
 
             inline const std::string& GetName() const override
             {
@@ -41,6 +46,11 @@ namespace Lumos
                 return m_FileName;
             }
 
+            void SetFilepath(const std::string& filePath) override
+            {
+                m_FileName = filePath;
+            }
+
             void BuildTexture(TextureFormat internalformat, uint32_t width, uint32_t height, bool srgb, bool depth, bool samplerShadow) override;
 
             uint8_t* LoadTextureData();
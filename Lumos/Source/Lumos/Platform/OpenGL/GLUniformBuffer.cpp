@@ -57,31 +57,21 @@ namespace Lumos
             }
         }
 
-        void GLUniformBuffer::SetDynamicData(uint32_t size, uint32_t typeSize, const void* data)
+        void GLUniformBuffer::SetDynamicData(uint32_t size, uint32_t typeSize, const void* data, uint32_t offset)
         {
             LUMOS_PROFILE_FUNCTION();
+            LUMOS_ASSERT(offset + size <= m_Size, "Dynamic upload outside the uniform buffer");
+
+            // m_Size stays the allocation size, size is only the range written
             m_Data = (uint8_t*)data;
-            m_Size = size;
             m_Dynamic = true;
             m_DynamicTypeSize = typeSize;
 
-            GLvoid* p = nullptr;
-
             glBindBuffer(GL_UNIFORM_BUFFER, m_Handle);
 
-            if(size != m_Size)
-            {
-                LUMOS_PROFILE_SCOPE("glMapBuffer");
-                p = glMapBuffer(GL_UNIFORM_BUFFER, GL_WRITE_ONLY);
-                m_Size = size;
-
-                memcpy(p, m_Data, m_Size);
-                glUnmapBuffer(GL_UNIFORM_BUFFER);
-            }
-            else
             {
                 LUMOS_PROFILE_SCOPE("glBufferSubData");
-                glBufferSubData(GL_UNIFORM_BUFFER, 0, m_Size, m_Data);
+                glBufferSubData(GL_UNIFORM_BUFFER, offset, size, m_Data);
             }
         }
 
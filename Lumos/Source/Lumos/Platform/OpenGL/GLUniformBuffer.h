@@ -15,7 +15,7 @@ namespace Lumos
 
             void Init(uint32_t size, const void* data) override;
             void SetData(uint32_t size, const void* data) override;
-            void SetDynamicData(uint32_t size, uint32_t typeSize, const void* data) override;
+            void SetDynamicData(uint32_t size, uint32_t typeSize, const void* data, uint32_t offset = 0) override;
 
             void Bind(uint32_t slot, GLShader* shader, std::string& name);
 
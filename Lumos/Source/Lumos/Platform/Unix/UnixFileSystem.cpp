@@ -6,6 +6,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
 
 namespace Lumos
 {
@@ -101,20 +102,19 @@ namespace Lumos
         return success ? result : std::string();
     }
 
-    bool FileSystem::WriteFile(const std::string& path, uint8_t* buffer)
+    bool FileSystem::WriteFile(const std::string& path, uint8_t* buffer, uint32_t size)
     {
         FILE* file = fopen(path.c_str(), "wb");
-        if(file == NULL) //if file does not exist, create it
-        {
-            file = fopen(path.c_str(), "wb");
-        }
-        size_t size = 0;
+        if(file == NULL)
+            return false;
+
+        size_t written = 0;
         if(buffer)
         {
-            size = fwrite(buffer, 1, sizeof(buffer), file);
+            written = fwrite(buffer, 1, size, file);
         }
         fclose(file);
-        return size > 0;
+        return written == size && size > 0;
     }
 
     bool FileSystem::WriteTextFile(const std::string& path, const std::string& text)
@@ -128,4 +128,31 @@ namespace Lumos
         fclose(file);
         return size > 0;
     }
+
+    uint8_t* FileSystem::MapFile(const std::string& path, int64_t& size)
+    {
+        int file = open(path.c_str(), O_RDONLY);
+        if(file < 0)
+            return nullptr;
+
+        struct stat buffer;
+        if(fstat(file, &buffer) != 0 || buffer.st_size <= 0)
+        {
+            close(file);
+            return nullptr;
+        }
+
+        size = buffer.st_size;
+        void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+        // The mapping keeps the file open
+        close(file);
+        return data == MAP_FAILED ? nullptr : static_cast<uint8_t*>(data);
+    }
+
+    void FileSystem::UnmapFile(uint8_t* data, int64_t size)
+    {
+        if(data)
+            munmap(data, size);
+    }
 }
@@ -29,6 +29,7 @@ namespace Lumos
             void Flush(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
             void Invalidate(VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0);
             void SetUsage(VkBufferUsageFlags flags) { m_UsageFlags = flags; }
+            void* GetMapped() const { return m_Mapped; }
 
         protected:
             VkBuffer m_Buffer {};
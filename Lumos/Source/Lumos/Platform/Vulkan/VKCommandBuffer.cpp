@@ -67,10 +67,21 @@ namespace Lumos
             return true;
         }
 
+        bool VKCommandBuffer::InitWithOwnPool(bool primary)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            m_OwnedCommandPool = CreateSharedRef<VKCommandPool>(VKDevice::Get().GetPhysicalDevice()->GetGraphicsQueueFamilyIndex(), VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+            return Init(primary, m_OwnedCommandPool->GetHandle());
+        }
+
         void VKCommandBuffer::Unload()
         {
             LUMOS_PROFILE_FUNCTION();
-            vkFreeCommandBuffers(VKDevice::Get().GetDevice(), m_CommandPool, 1, &m_CommandBuffer);
+            if(m_CommandBuffer)
+                vkFreeCommandBuffers(VKDevice::Get().GetDevice(), m_CommandPool, 1, &m_CommandBuffer);
+
+            m_CommandBuffer = VK_NULL_HANDLE;
+            m_OwnedCommandPool.reset();
         }
 
         void VKCommandBuffer::BeginRecording()
@@ -140,6 +151,8 @@ namespace Lumos
             submitInfo.signalSemaphoreCount = signalSemaphoreCount;
             submitInfo.pSignalSemaphores = &signalSemaphore;
 
+            VKDevice::Get().GetUploadManager()->Flush();
+
             VK_CHECK_RESULT(vkQueueSubmit(VKDevice::Get().GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE));
             m_State = CommandBufferState::Submitted;
         }
@@ -6,6 +6,8 @@ namespace Lumos
 {
     namespace Graphics
     {
+        class VKCommandPool;
+
         enum class CommandBufferState : uint8_t
         {
             Idle,
@@ -23,6 +25,7 @@ namespace Lumos
 
             bool Init(bool primary) override;
             bool Init(bool primary, VkCommandPool commandPool);
+            bool InitWithOwnPool(bool primary) override;
             void Unload() override;
             void BeginRecording() override;
             void BeginRecordingSecondary(RenderPass* renderPass, Framebuffer* framebuffer) override;
@@ -46,6 +49,7 @@ namespace Lumos
         private:
             VkCommandBuffer m_CommandBuffer;
             VkCommandPool m_CommandPool;
+            SharedRef<VKCommandPool> m_OwnedCommandPool;
             bool m_Primary;
             CommandBufferState m_State;
         };
@@ -28,8 +28,16 @@ namespace Lumos
 
             VK_CHECK_RESULT(vkAllocateDescriptorSets(VKDevice::GetHandle(), &descriptorSetAllocateInfo, &m_DescriptorSet));
 
+            // Sampler arrays can hold more textures than MAX_IMAGE_INFOS
+            uint32_t imageInfoCount = 0;
+            for(auto& layoutInfo : static_cast<Graphics::VKShader*>(info.shader)->GetDescriptorLayout())
+            {
+                if(layoutInfo.setID == info.layoutIndex && layoutInfo.type == DescriptorType::IMAGE_SAMPLER)
+                    imageInfoCount += layoutInfo.count;
+            }
+
             m_BufferInfoPool = new VkDescriptorBufferInfo[MAX_BUFFER_INFOS];
-            m_ImageInfoPool = new VkDescriptorImageInfo[MAX_IMAGE_INFOS];
+            m_ImageInfoPool = new VkDescriptorImageInfo[Maths::Max(imageInfoCount, uint32_t(MAX_IMAGE_INFOS))];
             m_WriteDescriptorSetPool = new VkWriteDescriptorSet[MAX_WRITE_DESCTIPTORS];
 
             m_Shader = info.shader;
@@ -105,7 +113,7 @@ namespace Lumos
                         writeDescriptorSet.descriptorCount = imageInfo.textureCount;
 
                         m_WriteDescriptorSetPool[descriptorWritesCount] = writeDescriptorSet;
-                        imageIndex++;
+                        imageIndex += imageInfo.textureCount;
                         descriptorWritesCount++;
                     }
                     else
@@ -3,6 +3,7 @@
 #include "Core/Application.h"
 #include "Core/Version.h"
 #include "Core/StringUtilities.h"
+#include "Core/OS/FileSystem.h"
 
 #include "VKDevice.h"
 #include "VKRenderer.h"
@@ -101,6 +102,27 @@ namespace Lumos
                 }
             }
 
+            if(m_PhysicalDeviceProperties.apiVersion >= VK_API_VERSION_1_1 && IsExtensionSupported(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME))
+            {
+                VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+                indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+                VkPhysicalDeviceFeatures2 features2 = {};
+                features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features2.pNext = &indexingFeatures;
+                vkGetPhysicalDeviceFeatures2(m_PhysicalDevice, &features2);
+
+                m_DescriptorIndexing = indexingFeatures.shaderSampledImageArrayNonUniformIndexing && indexingFeatures.descriptorBindingPartiallyBound;
+            }
+
+            if(m_DescriptorIndexing)
+            {
+                const auto& limits = m_PhysicalDeviceProperties.limits;
+                caps.MaxBindlessTextures = std::min({ limits.maxPerStageDescriptorSamplers, limits.maxPerStageDescriptorSampledImages,
+                    limits.maxDescriptorSetSamplers, limits.maxDescriptorSetSampledImages });
+            }
+            LUMOS_LOG_INFO("Descriptor indexing : {0}", m_DescriptorIndexing ? "supported" : "not supported");
+
             // Queue families
             // Desired queues need to be requested upon logical device creation
             // Due to differing queue family configurations of Vulkan implementations this can be a bit tricky, especially if the application
@@ -112,6 +134,9 @@ namespace Lumos
             static const float defaultQueuePriority(0.0f);
 
             int requestedQueueTypes = VK_QUEUE_GRAPHICS_BIT; // | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
+#if LUMOS_VK_DEDICATED_TRANSFER_QUEUE
+            requestedQueueTypes |= VK_QUEUE_TRANSFER_BIT;
+#endif
             m_QueueFamilyIndices = GetQueueFamilyIndices(requestedQueueTypes);
 
             // Graphics queue
@@ -244,13 +269,67 @@ namespace Lumos
 
         uint32_t VKDevice::s_GraphicsQueueFamilyIndex = 0;
 
+        // Textures larger than this are staged through their own buffer
+        static const uint32_t UploadStagingBufferSize = 64 * 1024 * 1024;
+
+        // Written in front of the driver's cache data to detect truncated or corrupt files
+        struct PipelineCacheFileHeader
+        {
+            uint32_t magic;
+            uint32_t padding = 0;
+            uint64_t dataSize;
+            uint64_t dataHash;
+        };
+
+        static const uint32_t PipelineCacheMagic = 0x4C50434B; // LPCK
+
+        // Layout of VK_PIPELINE_CACHE_HEADER_VERSION_ONE, found at the start of every pipeline cache
+        struct PipelineCacheHeaderVersionOne
+        {
+            uint32_t headerSize;
+            uint32_t headerVersion;
+            uint32_t vendorID;
+            uint32_t deviceID;
+            uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        };
+
+        static uint64_t HashPipelineCacheData(const uint8_t* data, uint64_t size)
+        {
+            // FNV-1a
+            uint64_t hash = 14695981039346656037ull;
+            for(uint64_t i = 0; i < size; i++)
+            {
+                hash ^= data[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        static bool IsPipelineCacheCompatible(const uint8_t* data, uint64_t size, const VkPhysicalDeviceProperties& properties)
+        {
+            if(size < sizeof(PipelineCacheHeaderVersionOne))
+                return false;
+
+            PipelineCacheHeaderVersionOne header;
+            memcpy(&header, data, sizeof(PipelineCacheHeaderVersionOne));
+
+            return header.headerSize >= sizeof(PipelineCacheHeaderVersionOne)
+                && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+                && header.vendorID == properties.vendorID
+                && header.deviceID == properties.deviceID
+                && memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        }
+
         VKDevice::VKDevice()
         {
         }
 
         VKDevice::~VKDevice()
         {
+            m_UploadManager.reset();
             m_CommandPool.reset();
+
+            SavePipelineCache();
             vkDestroyPipelineCache(m_Device, m_PipelineCache, VK_NULL_HANDLE);
 
 #ifdef USE_VMA_ALLOCATOR
@@ -280,6 +359,15 @@ namespace Lumos
                 m_EnableDebugMarkers = true;
             }
 
+            VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+            indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+            if(m_PhysicalDevice->SupportsDescriptorIndexing())
+            {
+                deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+                indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+                indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+            }
+
 #if defined(LUMOS_PLATFORM_MACOS) || defined(LUMOS_PLATFORM_IOS)
             // https://vulkan.lunarg.com/doc/view/1.2.162.0/mac/1.2-extensions/vkspec.html#VUID-VkDeviceCreateInfo-pProperties-04451
             if(m_PhysicalDevice->IsExtensionSupported("VK_KHR_portability_subset"))
@@ -297,6 +385,8 @@ namespace Lumos
             deviceCI.ppEnabledExtensionNames = deviceExtensions.data();
             deviceCI.pEnabledFeatures = &physicalDeviceFeatures;
             deviceCI.enabledLayerCount = 0;
+            if(m_PhysicalDevice->SupportsDescriptorIndexing())
+                deviceCI.pNext = &indexingFeatures;
 
             auto result = vkCreateDevice(m_PhysicalDevice->GetVulkanPhysicalDevice(), &deviceCI, VK_NULL_HANDLE, &m_Device);
             if(result != VK_SUCCESS)
@@ -308,6 +398,10 @@ namespace Lumos
             vkGetDeviceQueue(m_Device, m_PhysicalDevice->m_QueueFamilyIndices.Graphics, 0, &m_GraphicsQueue);
             vkGetDeviceQueue(m_Device, m_PhysicalDevice->m_QueueFamilyIndices.Graphics, 0, &m_PresentQueue);
 
+            const int32_t transferFamily = m_PhysicalDevice->m_QueueFamilyIndices.Transfer;
+            if(transferFamily >= 0 && transferFamily != m_PhysicalDevice->m_QueueFamilyIndices.Graphics)
+                vkGetDeviceQueue(m_Device, transferFamily, 0, &m_TransferQueue);
+
 #ifdef USE_VMA_ALLOCATOR
             VmaAllocatorCreateInfo allocatorInfo = {};
             allocatorInfo.physicalDevice = m_PhysicalDevice->GetVulkanPhysicalDevice();
@@ -350,15 +444,81 @@ namespace Lumos
 
             CreateTracyContext();
             CreatePipelineCache();
+
+            m_UploadManager = CreateUniqueRef<VKUploadManager>(UploadStagingBufferSize, m_PhysicalDevice->GetGraphicsQueueFamilyIndex(), m_PhysicalDevice->GetTransferQueueFamilyIndex(), m_GraphicsQueue, m_TransferQueue);
+            if(m_UploadManager->UsesTransferQueue())
+                LUMOS_LOG_INFO("[VULKAN] Uploading textures on a dedicated transfer queue");
+
             return VK_SUCCESS;
         }
 
         void VKDevice::CreatePipelineCache()
         {
+            LUMOS_PROFILE_FUNCTION();
+            m_PipelineCachePath = Application::Get().GetProjectRoot() + "VulkanPipelineCache.bin";
+
+            // Cache data from another GPU, driver or a truncated write is discarded and the cache starts empty
+            std::vector<uint8_t> cacheData;
+            const int64_t fileSize = FileSystem::GetFileSize(m_PipelineCachePath);
+            if(fileSize > int64_t(sizeof(PipelineCacheFileHeader)))
+            {
+                uint8_t* fileData = FileSystem::ReadFile(m_PipelineCachePath);
+                if(fileData)
+                {
+                    PipelineCacheFileHeader fileHeader;
+                    memcpy(&fileHeader, fileData, sizeof(PipelineCacheFileHeader));
+
+                    const uint8_t* data = fileData + sizeof(PipelineCacheFileHeader);
+                    const uint64_t dataSize = uint64_t(fileSize) - sizeof(PipelineCacheFileHeader);
+
+                    if(fileHeader.magic == PipelineCacheMagic && fileHeader.dataSize == dataSize && fileHeader.dataHash == HashPipelineCacheData(data, dataSize)
+                        && IsPipelineCacheCompatible(data, dataSize, m_PhysicalDevice->GetProperties()))
+                        cacheData.assign(data, data + dataSize);
+                    else
+                        LUMOS_LOG_WARN("[VULKAN] Discarding pipeline cache {0}, it was written by a different device or driver", m_PipelineCachePath);
+
+                    delete[] fileData;
+                }
+            }
+
             VkPipelineCacheCreateInfo pipelineCacheCI {};
             pipelineCacheCI.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
             pipelineCacheCI.pNext = NULL;
-            vkCreatePipelineCache(m_Device, &pipelineCacheCI, VK_NULL_HANDLE, &m_PipelineCache);
+            pipelineCacheCI.initialDataSize = cacheData.size();
+            pipelineCacheCI.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+            if(vkCreatePipelineCache(m_Device, &pipelineCacheCI, VK_NULL_HANDLE, &m_PipelineCache) != VK_SUCCESS && !cacheData.empty())
+            {
+                pipelineCacheCI.initialDataSize = 0;
+                pipelineCacheCI.pInitialData = nullptr;
+                vkCreatePipelineCache(m_Device, &pipelineCacheCI, VK_NULL_HANDLE, &m_PipelineCache);
+            }
+            else if(!cacheData.empty())
+                LUMOS_LOG_INFO("[VULKAN] Loaded pipeline cache : {0} bytes", cacheData.size());
+        }
+
+        void VKDevice::SavePipelineCache()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            if(m_PipelineCache == VK_NULL_HANDLE || m_PipelineCachePath.empty())
+                return;
+
+            size_t dataSize = 0;
+            if(vkGetPipelineCacheData(m_Device, m_PipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+                return;
+
+            std::vector<uint8_t> fileData(sizeof(PipelineCacheFileHeader) + dataSize);
+            if(vkGetPipelineCacheData(m_Device, m_PipelineCache, &dataSize, fileData.data() + sizeof(PipelineCacheFileHeader)) != VK_SUCCESS)
+                return;
+
+            PipelineCacheFileHeader fileHeader;
+            fileHeader.magic = PipelineCacheMagic;
+            fileHeader.dataSize = dataSize;
+            fileHeader.dataHash = HashPipelineCacheData(fileData.data() + sizeof(PipelineCacheFileHeader), dataSize);
+            memcpy(fileData.data(), &fileHeader, sizeof(PipelineCacheFileHeader));
+
+            if(!FileSystem::WriteFile(m_PipelineCachePath, fileData.data(), static_cast<uint32_t>(sizeof(PipelineCacheFileHeader) + dataSize)))
+                LUMOS_LOG_WARN("[VULKAN] Failed to write pipeline cache {0}", m_PipelineCachePath);
         }
 
         void VKDevice::CreateTracyContext()
@@ -3,6 +3,7 @@
 #include "VK.h"
 #include "VKContext.h"
 #include "VKCommandPool.h"
+#include "VKUploadManager.h"
 
 #ifdef USE_VMA_ALLOCATOR
 #ifdef LUMOS_DEBUG
@@ -29,6 +30,13 @@ namespace Lumos
             ~VKPhysicalDevice();
 
             bool IsExtensionSupported(const std::string& extensionName) const;
+
+            // Non-uniform indexing into sampler arrays and partially bound arrays, used by bindless batching
+            bool SupportsDescriptorIndexing() const
+            {
+                return m_DescriptorIndexing;
+            }
+
             uint32_t GetMemoryTypeIndex(uint32_t typeBits, VkMemoryPropertyFlags properties) const;
 
             VkPhysicalDevice GetVulkanPhysicalDevice() const
@@ -39,6 +47,10 @@ namespace Lumos
             {
                 return m_QueueFamilyIndices.Graphics;
             }
+            int32_t GetTransferQueueFamilyIndex()
+            {
+                return m_QueueFamilyIndices.Transfer;
+            }
             VkPhysicalDeviceProperties GetProperties() const
             {
                 return m_PhysicalDeviceProperties;
@@ -64,6 +76,7 @@ namespace Lumos
             VkPhysicalDeviceFeatures m_Features;
             VkPhysicalDeviceProperties m_PhysicalDeviceProperties;
             VkPhysicalDeviceMemoryProperties m_MemoryProperties;
+            bool m_DescriptorIndexing = false;
 
             friend class VKDevice;
         };
@@ -78,6 +91,9 @@ namespace Lumos
 
             bool Init();
             void CreatePipelineCache();
+
+            // Writes the pipeline cache to the project directory so the next launch can skip shader compilation
+            void SavePipelineCache();
             void CreateTracyContext();
 
             VkDevice GetDevice() const
@@ -102,6 +118,11 @@ namespace Lumos
                 return m_PresentQueue;
             };
 
+            VKUploadManager* GetUploadManager() const
+            {
+                return m_UploadManager.get();
+            }
+
             const SharedRef<VKCommandPool>& GetCommandPool() const
             {
                 return m_CommandPool;
@@ -136,12 +157,15 @@ namespace Lumos
 
             VkQueue m_GraphicsQueue;
             VkQueue m_PresentQueue;
-            VkPipelineCache m_PipelineCache;
+            VkQueue m_TransferQueue = VK_NULL_HANDLE;
+            VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
+            std::string m_PipelineCachePath;
             VkDescriptorPool m_DescriptorPool;
             VkPhysicalDeviceFeatures m_EnabledFeatures;
 
             SharedRef<VKCommandPool> m_CommandPool;
             SharedRef<VKPhysicalDevice> m_PhysicalDevice;
+            UniqueRef<VKUploadManager> m_UploadManager;
 
             bool m_EnableDebugMarkers = false;
 
@@ -6,6 +6,7 @@
 #include "VKTools.h"
 #include "VKPipeline.h"
 #include "Core/Engine.h"
+#include "Graphics/Renderers/Renderer2D.h"
 
 namespace Lumos
 {
@@ -20,8 +21,10 @@ namespace Lumos
             m_RendererTitle = "Vulkan";
 
             // Pool sizes
-            std::array<VkDescriptorPoolSize, 5> pool_sizes = {
+            // Bindless Renderer2D batches take MAX_BINDLESS_TEXTURES combined image samplers each
+            std::array<VkDescriptorPoolSize, 6> pool_sizes = {
                 VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_SAMPLER, 100 },
+                VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 100 + 16 * MAX_BINDLESS_TEXTURES },
                 VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 100 },
                 VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 100 },
                 VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 100 },
@@ -134,6 +137,9 @@ namespace Lumos
             uint32_t numDynamicDescriptorSets = 0;
             uint32_t numDesciptorSets = 0;
 
+            // Local, draws can be recorded on several threads at once
+            VkDescriptorSet vkDescriptorSets[16];
+
             for(auto descriptorSet : descriptorSets)
             {
                 if(descriptorSet)
@@ -142,13 +148,13 @@ namespace Lumos
                     if(vkDesSet->GetIsDynamic())
                         numDynamicDescriptorSets++;
 
-                    m_DescriptorSetPool[numDesciptorSets] = vkDesSet->GetDescriptorSet();
+                    vkDescriptorSets[numDesciptorSets] = vkDesSet->GetDescriptorSet();
 
                     numDesciptorSets++;
                 }
             }
 
-            vkCmdBindDescriptorSets(static_cast<Graphics::VKCommandBuffer*>(cmdBuffer)->GetHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, static_cast<Graphics::VKPipeline*>(pipeline)->GetPipelineLayout(), 0, numDesciptorSets, m_DescriptorSetPool, numDynamicDescriptorSets, &dynamicOffset);
+            vkCmdBindDescriptorSets(static_cast<Graphics::VKCommandBuffer*>(cmdBuffer)->GetHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, static_cast<Graphics::VKPipeline*>(pipeline)->GetPipelineLayout(), 0, numDesciptorSets, vkDescriptorSets, numDynamicDescriptorSets, &dynamicOffset);
         }
 
         void VKRenderer::DrawIndexedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start) const
@@ -158,6 +164,13 @@ namespace Lumos
             vkCmdDrawIndexed(static_cast<VKCommandBuffer*>(commandBuffer)->GetHandle(), count, 1, 0, 0, 0);
         }
 
+        void VKRenderer::DrawIndexedInstancedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start) const
+        {
+            LUMOS_PROFILE_FUNCTION();
+            Engine::Get().Statistics().NumDrawCalls++;
+            vkCmdDrawIndexed(static_cast<VKCommandBuffer*>(commandBuffer)->GetHandle(), count, instanceCount, 0, 0, 0);
+        }
+
         void VKRenderer::DrawInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, DataType datayType, void* indices) const
         {
             LUMOS_PROFILE_FUNCTION();
@@ -165,6 +178,44 @@ namespace Lumos
             vkCmdDraw(static_cast<VKCommandBuffer*>(commandBuffer)->GetHandle(), count, 1, 0, 0);
         }
 
+        static void ResourceUsageToVK(uint32_t usage, bool write, VkPipelineStageFlags& stages, VkAccessFlags& access)
+        {
+            if(usage & RESOURCE_USAGE_COLOUR_ATTACHMENT)
+            {
+                stages |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+                access |= write ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            }
+
+            if(usage & RESOURCE_USAGE_DEPTH_ATTACHMENT)
+            {
+                stages |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+                access |= write ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+            }
+
+            if(usage & RESOURCE_USAGE_SHADER_READ)
+            {
+                stages |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+                access |= write ? 0 : VK_ACCESS_SHADER_READ_BIT;
+            }
+        }
+
+        void VKRenderer::ResourceBarrierInternal(CommandBuffer* commandBuffer, uint32_t srcUsage, uint32_t dstUsage)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            VkPipelineStageFlags srcStages = 0, dstStages = 0;
+            VkMemoryBarrier barrier {};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+
+            // Only writes need to be made available, the earlier reads just have to finish
+            ResourceUsageToVK(srcUsage, true, srcStages, barrier.srcAccessMask);
+            ResourceUsageToVK(dstUsage, false, dstStages, barrier.dstAccessMask);
+
+            if(!srcStages || !dstStages)
+                return;
+
+            vkCmdPipelineBarrier(static_cast<VKCommandBuffer*>(commandBuffer)->GetHandle(), srcStages, dstStages, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+
         void VKRenderer::MakeDefault()
         {
             CreateFunc = CreateFuncVulkan;
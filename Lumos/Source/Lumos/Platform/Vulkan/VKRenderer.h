@@ -47,7 +47,9 @@ namespace Lumos
 
             void BindDescriptorSetsInternal(Graphics::Pipeline* pipeline, Graphics::CommandBuffer* cmdBuffer, uint32_t dynamicOffset, std::vector<Graphics::DescriptorSet*>& descriptorSets) override;
             void DrawIndexedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t start) const override;
+            void DrawIndexedInstancedInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, uint32_t instanceCount, uint32_t start) const override;
             void DrawInternal(CommandBuffer* commandBuffer, DrawType type, uint32_t count, DataType datayType, void* indices) const override;
+            void ResourceBarrierInternal(CommandBuffer* commandBuffer, uint32_t srcUsage, uint32_t dstUsage) override;
 
             const VkDescriptorPool& GetDescriptorPool() const
             {
@@ -68,7 +70,6 @@ namespace Lumos
             uint32_t m_Width, m_Height;
 
             VkDescriptorPool m_DescriptorPool;
-            VkDescriptorSet m_DescriptorSetPool[16];
         };
     }
 }
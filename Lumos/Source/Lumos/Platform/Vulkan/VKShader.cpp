@@ -468,8 +468,11 @@ namespace Lumos
                     uint32_t binding = comp.get_decoration(u.id, spv::DecorationBinding);
                     auto& type = comp.get_type(u.type_id);
 
+                    // Blocks named *Dynamic are bound with a dynamic offset, e.g. into a UniformBufferAllocator
+                    const auto descriptorType = StringUtilities::EndsWith(comp.get_name(u.base_type_id), "Dynamic") ? Graphics::DescriptorType::UNIFORM_BUFFER_DYNAMIC : Graphics::DescriptorType::UNIFORM_BUFFER;
+
                     SHADER_LOG(LUMOS_LOG_INFO("Found UBO {0} at set = {1}, binding = {2}", u.name.c_str(), set, binding));
-                    m_DescriptorLayoutInfo.push_back({ Graphics::DescriptorType::UNIFORM_BUFFER, file.first, binding, set, type.array.size() ? uint32_t(type.array[0]) : 1 });
+                    m_DescriptorLayoutInfo.push_back({ descriptorType, file.first, binding, set, type.array.size() ? uint32_t(type.array[0]) : 1 });
 
                     auto& bufferType = comp.get_type(u.base_type_id);
                     auto bufferSize = comp.get_declared_struct_size(bufferType);
@@ -482,7 +485,7 @@ namespace Lumos
                     descriptor.name = u.name;
                     descriptor.offset = 0;
                     descriptor.shaderType = file.first;
-                    descriptor.type = Graphics::DescriptorType::UNIFORM_BUFFER;
+                    descriptor.type = descriptorType;
                     descriptor.buffer = nullptr;
 
                     for(int i = 0; i < memberCount; i++)
@@ -583,9 +586,10 @@ namespace Lumos
 
             for(auto& descriptorLayout : GetDescriptorLayout())
             {
+                // Sets are not always declared in order, e.g. a vertex stage using sets 0 and 2 before the fragment stage's set 1
                 if(layouts.size() < descriptorLayout.setID + 1)
                 {
-                    layouts.emplace_back();
+                    layouts.resize(descriptorLayout.setID + 1);
                 }
 
                 layouts[descriptorLayout.setID].push_back(descriptorLayout);
@@ -594,7 +598,9 @@ namespace Lumos
             for(auto& l : layouts)
             {
                 std::vector<VkDescriptorSetLayoutBinding> setLayoutBindings;
+                std::vector<VkDescriptorBindingFlagsEXT> bindingFlags;
                 setLayoutBindings.reserve(l.size());
+                bindingFlags.reserve(l.size());
 
                 for(uint32_t i = 0; i < l.size(); i++)
                 {
@@ -607,13 +613,23 @@ namespace Lumos
                     setLayoutBinding.descriptorCount = info.count;
 
                     setLayoutBindings.push_back(setLayoutBinding);
+
+                    // Arrays such as batched textures are only written up to the number in use
+                    bindingFlags.push_back(info.count > 1 ? VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT : 0);
                 }
 
+                VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCI {};
+                bindingFlagsCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+                bindingFlagsCI.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+                bindingFlagsCI.pBindingFlags = bindingFlags.data();
+
                 // Pipeline layout
                 VkDescriptorSetLayoutCreateInfo descriptorLayoutCI {};
                 descriptorLayoutCI.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
                 descriptorLayoutCI.bindingCount = static_cast<uint32_t>(setLayoutBindings.size());
                 descriptorLayoutCI.pBindings = setLayoutBindings.data();
+                if(VKDevice::Get().GetPhysicalDevice()->SupportsDescriptorIndexing())
+                    descriptorLayoutCI.pNext = &bindingFlagsCI;
 
                 VkDescriptorSetLayout layout;
                 vkCreateDescriptorSetLayout(VKDevice::Get().GetDevice(), &descriptorLayoutCI, VK_NULL_HANDLE, &layout);
@@ -668,6 +684,13 @@ namespace Lumos
             }
         }
 
+        void VKShader::BindPushConstant(Graphics::CommandBuffer* cmdBuffer, Graphics::Pipeline* pipeline, uint32_t index, const uint8_t* data)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            const auto& pc = m_PushConstants[index];
+            vkCmdPushConstants(static_cast<Graphics::VKCommandBuffer*>(cmdBuffer)->GetHandle(), static_cast<Graphics::VKPipeline*>(pipeline)->GetPipelineLayout(), VKTools::ShaderTypeToVK(pc.shaderStage), 0, pc.size, data);
+        }
+
         VkPipelineShaderStageCreateInfo* VKShader::GetShaderStages() const
         {
             return m_ShaderStages;
@@ -65,6 +65,7 @@ namespace Lumos
             const std::vector<DescriptorLayoutInfo>& GetDescriptorLayout() const { return m_DescriptorLayoutInfo; }
             const std::vector<VkDescriptorSetLayout>& GetDescriptorLayouts() const { return m_DescriptorSetLayouts; }
             void BindPushConstants(Graphics::CommandBuffer* cmdBuffer, Graphics::Pipeline* pipeline) override;
+            void BindPushConstant(Graphics::CommandBuffer* cmdBuffer, Graphics::Pipeline* pipeline, uint32_t index, const uint8_t* data) override;
 
             static void PreProcess(const std::string& source, std::map<ShaderType, std::string>* sources);
             static void ReadShaderFile(const std::vector<std::string>& lines, std::map<ShaderType, std::string>* shaders);
@@ -299,6 +299,8 @@ namespace Lumos
 
             frameData.RenderFence->Reset();
 
+            VKDevice::Get().GetUploadManager()->Flush();
+
             {
                 LUMOS_PROFILE_SCOPE("vkQueueSubmit");
                 VK_CHECK_RESULT(vkQueueSubmit(VKDevice::Get().GetGraphicsQueue(), 1, &submitInfo, frameData.RenderFence->GetHandle()));
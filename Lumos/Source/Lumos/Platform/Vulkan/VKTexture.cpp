@@ -187,6 +187,10 @@ namespace Lumos
 
         VKTexture2D::~VKTexture2D()
         {
+            // The image may still be the destination of a pending upload
+            if(m_UploadBatch)
+                VKDevice::Get().GetUploadManager()->Wait(m_UploadBatch);
+
             if(m_TextureSampler)
                 vkDestroySampler(VKDevice::GetHandle(), m_TextureSampler, nullptr);
 
@@ -235,6 +239,7 @@ namespace Lumos
             m_Height = height;
             m_Handle = 0;
             m_DeleteImage = true;
+            m_Writable = false;
             m_MipLevels = 1;
 
 #ifdef USE_VMA_ALLOCATOR
@@ -249,120 +254,55 @@ namespace Lumos
             UpdateDescriptor();
         }
 
-        void VKTexture2D::UpdateDescriptor()
+        void VKTexture2D::SetData(const void* pixels)
         {
-            m_Descriptor.sampler = m_TextureSampler;
-            m_Descriptor.imageView = m_TextureImageView;
-            m_Descriptor.imageLayout = m_ImageLayout;
+            SetData(pixels, 0, 0, m_Width, m_Height, m_Width);
         }
 
-        void GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t texWidth, int32_t texHeight, uint32_t mipLevels)
+        void VKTexture2D::SetData(const void* pixels, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t rowLength)
         {
-            VkFormatProperties formatProperties;
-            vkGetPhysicalDeviceFormatProperties(VKDevice::Get().GetGPU(), imageFormat, &formatProperties);
-
-            if(!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+            LUMOS_PROFILE_FUNCTION();
+            if(!m_Writable)
             {
-                LUMOS_LOG_ERROR("Texture image format does not support linear blitting!");
+                LUMOS_LOG_WARN("Texture {0} was not created with pixel data and cannot be written", m_Name);
+                return;
             }
 
-            VkCommandBuffer commandBuffer = VKTools::BeginSingleTimeCommands();
-
-            VkImageMemoryBarrier barrier {};
-            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            barrier.image = image;
-            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.subresourceRange.baseArrayLayer = 0;
-            barrier.subresourceRange.layerCount = 1;
-            barrier.subresourceRange.levelCount = 1;
+            LUMOS_ASSERT(x + width <= m_Width && y + height <= m_Height, "Texture region out of bounds");
 
-            int32_t mipWidth = texWidth;
-            int32_t mipHeight = texHeight;
+            const uint32_t texelSize = GetStrideFromFormat(m_Parameters.format);
 
-            for(uint32_t i = 1; i < mipLevels; i++)
-            {
-                barrier.subresourceRange.baseMipLevel = i - 1;
-                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-
-                vkCmdPipelineBarrier(commandBuffer,
-                    VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    0,
-                    0,
-                    nullptr,
-                    0,
-                    nullptr,
-                    1,
-                    &barrier);
-
-                VkImageBlit blit {};
-                blit.srcOffsets[0] = { 0, 0, 0 };
-                blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-                blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                blit.srcSubresource.mipLevel = i - 1;
-                blit.srcSubresource.baseArrayLayer = 0;
-                blit.srcSubresource.layerCount = 1;
-                blit.dstOffsets[0] = { 0, 0, 0 };
-                blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
-                blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                blit.dstSubresource.mipLevel = i;
-                blit.dstSubresource.baseArrayLayer = 0;
-                blit.dstSubresource.layerCount = 1;
-
-                vkCmdBlitImage(commandBuffer,
-                    image,
-                    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                    image,
-                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    1,
-                    &blit,
-                    VK_FILTER_LINEAR);
-
-                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-                barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-                barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-                vkCmdPipelineBarrier(commandBuffer,
-                    VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                    0,
-                    0,
-                    nullptr,
-                    0,
-                    nullptr,
-                    1,
-                    &barrier);
-
-                if(mipWidth > 1)
-                    mipWidth /= 2;
-                if(mipHeight > 1)
-                    mipHeight /= 2;
-            }
+            VkBufferImageCopy region = {};
+            region.bufferRowLength = rowLength;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = 0;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = { int32_t(x), int32_t(y), 0 };
+            region.imageExtent = { width, height, 1 };
 
-            barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            VKImageUpload upload;
+            upload.image = m_TextureImage;
+            upload.format = VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb);
+            upload.data = pixels;
+            upload.size = ((height - 1) * rowLength + width) * texelSize;
+            upload.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            upload.texelSize = texelSize;
+            upload.width = m_Width;
+            upload.height = m_Height;
+            upload.mipLevels = m_MipLevels;
+            upload.regions = &region;
+            upload.regionCount = 1;
+            upload.generateMips = m_MipLevels > 1;
 
-            vkCmdPipelineBarrier(commandBuffer,
-                VK_PIPELINE_STAGE_TRANSFER_BIT,
-                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                0,
-                0,
-                nullptr,
-                0,
-                nullptr,
-                1,
-                &barrier);
+            m_UploadBatch = VKDevice::Get().GetUploadManager()->UploadImage(upload);
+        }
 
-            VKTools::EndSingleTimeCommands(commandBuffer);
+        void VKTexture2D::UpdateDescriptor()
+        {
+            m_Descriptor.sampler = m_TextureSampler;
+            m_Descriptor.imageView = m_TextureImageView;
+            m_Descriptor.imageLayout = m_ImageLayout;
         }
 
         bool VKTexture2D::Load()
@@ -374,7 +314,9 @@ namespace Lumos
                 pixels = Lumos::LoadImageFromFile(m_FileName, &m_Width, &m_Height, &bits);
             else
             {
-                bits = 32;
+                // Source data is RGBA8 unless the caller passed a wider format, such as decoded HDR floats
+                const uint32_t stride = GetStrideFromFormat(m_Parameters.format);
+                bits = stride >= 4 ? stride * 8 : 32;
                 pixels = m_Data;
             }
 
@@ -392,25 +334,38 @@ namespace Lumos
 
             m_MipLevels = static_cast<uint32_t>(std::floor(std::log2(Maths::Max(m_Width, m_Height)))) + 1;
 
-            VKBuffer* stagingBuffer = new VKBuffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, static_cast<uint32_t>(imageSize), pixels);
-
-            if(m_Data == nullptr)
-                delete[] pixels;
 #ifdef USE_VMA_ALLOCATOR
             Graphics::CreateImage(m_Width, m_Height, m_MipLevels, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory, 1, 0, m_Allocation);
 #else
             Graphics::CreateImage(m_Width, m_Height, m_MipLevels, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory, 1, 0);
 #endif
 
-            VKTools::TransitionImageLayout(m_TextureImage, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_MipLevels);
-            VKTools::CopyBufferToImage(stagingBuffer->GetBuffer(), m_TextureImage, static_cast<uint32_t>(m_Width), static_cast<uint32_t>(m_Height));
+            VkBufferImageCopy region = {};
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = 0;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageExtent = { m_Width, m_Height, 1 };
+
+            VKImageUpload upload;
+            upload.image = m_TextureImage;
+            upload.format = VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb);
+            upload.data = pixels;
+            upload.size = static_cast<uint32_t>(imageSize);
+            upload.texelSize = bits / 8;
+            upload.width = m_Width;
+            upload.height = m_Height;
+            upload.mipLevels = m_MipLevels;
+            upload.regions = &region;
+            upload.regionCount = 1;
+            upload.generateMips = true;
+
+            m_UploadBatch = VKDevice::Get().GetUploadManager()->UploadImage(upload);
             m_ImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            ;
-            VKTools::TransitionImageLayout(m_TextureImage, VKTools::TextureFormatToVK(m_Parameters.format), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_MipLevels);
-
-            delete stagingBuffer;
+            m_Writable = true;
 
-            GenerateMipmaps(m_TextureImage, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), m_Width, m_Height, m_MipLevels);
+            if(m_Data == nullptr)
+                delete[] pixels;
 
             return true;
         }
@@ -454,6 +409,10 @@ namespace Lumos
 
         VKTextureCube::~VKTextureCube()
         {
+            // The image may still be the destination of a pending upload
+            if(m_UploadBatch)
+                VKDevice::Get().GetUploadManager()->Wait(m_UploadBatch);
+
             if(m_TextureSampler)
                 vkDestroySampler(VKDevice::GetHandle(), m_TextureSampler, nullptr);
 
@@ -555,21 +514,12 @@ namespace Lumos
                 }
             }
 
-            VKBuffer* stagingBuffer = new VKBuffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, static_cast<uint32_t>(size), allData);
-
-            if(m_Data == nullptr)
-            {
-                delete[] allData;
-                allData = nullptr;
-            }
 #ifdef USE_VMA_ALLOCATOR
             Graphics::CreateImage(faceWidths[0], faceHeights[0], m_NumMips, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory, 6, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT, m_Allocation);
 #else
             Graphics::CreateImage(faceWidths[0], faceHeights[0], m_NumMips, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), VK_IMAGE_TYPE_2D, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_TextureImage, m_TextureImageMemory, 6, VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT);
 #endif
 
-            VkCommandBuffer cmdBuffer = VKTools::BeginSingleTimeCommands();
-
             //// Setup buffer copy regions for each face including all of it's miplevels
             std::vector<VkBufferImageCopy> bufferCopyRegions;
             uint32_t offset = 0;
@@ -595,47 +545,26 @@ namespace Lumos
                 }
             }
 
-            // Image barrier for optimal image (target)
-            // Set initial layout for all array layers (faces) of the optimal (target) tiled texture
-            VkImageSubresourceRange subresourceRange = {};
-            subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            subresourceRange.baseMipLevel = 0;
-            subresourceRange.levelCount = m_NumMips;
-            subresourceRange.layerCount = 6;
-
-            VKTools::SetImageLayout(
-                cmdBuffer,
-                m_TextureImage,
-                VK_IMAGE_LAYOUT_UNDEFINED,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                subresourceRange);
-
-            // Copy the cube map faces from the staging buffer to the optimal tiled image
-            vkCmdCopyBufferToImage(
-                cmdBuffer,
-                stagingBuffer->GetBuffer(),
-                m_TextureImage,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                static_cast<uint32_t>(bufferCopyRegions.size()),
-                bufferCopyRegions.data());
-
-            // Change texture image layout to shader read after all faces have been copied
+            // Copy the cube map faces with all their levels, then transition every face for sampling
+            VKImageUpload upload;
+            upload.image = m_TextureImage;
+            upload.format = VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb);
+            upload.data = allData;
+            upload.size = static_cast<uint32_t>(size);
+            upload.texelSize = bits / 8;
+            upload.width = faceWidths[0];
+            upload.height = faceHeights[0];
+            upload.mipLevels = m_NumMips;
+            upload.layerCount = 6;
+            upload.regions = bufferCopyRegions.data();
+            upload.regionCount = static_cast<uint32_t>(bufferCopyRegions.size());
+
+            m_UploadBatch = VKDevice::Get().GetUploadManager()->UploadImage(upload);
             m_ImageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-            VKTools::SetImageLayout(
-                cmdBuffer,
-                m_TextureImage,
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                m_ImageLayout,
-                subresourceRange);
-
-            VKTools::EndSingleTimeCommands(cmdBuffer);
-
             m_TextureSampler = Graphics::CreateTextureSampler(VK_FILTER_LINEAR, VK_FILTER_LINEAR, 0.0f, static_cast<float>(m_NumMips), true, VKDevice::Get().GetPhysicalDevice()->GetProperties().limits.maxSamplerAnisotropy, VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLER_ADDRESS_MODE_REPEAT);
             m_TextureImageView = Graphics::CreateImageView(m_TextureImage, VKTools::TextureFormatToVK(m_Parameters.format, m_Parameters.srgb), m_NumMips, VK_IMAGE_VIEW_TYPE_CUBE, VK_IMAGE_ASPECT_COLOR_BIT, 6);
 
-            delete stagingBuffer;
-
             for(uint32_t m = 0; m < mips; m++)
             {
                 for(uint32_t f = 0; f < 6; f++)
@@ -24,7 +24,9 @@ namespace Lumos
             void Bind(uint32_t slot = 0) const override {};
             void Unbind(uint32_t slot = 0) const override {};
 
-            virtual void SetData(const void* pixels) override {};
+            // Replaces texels and regenerates the mips. Only textures created from pixels or a file can be written
+            void SetData(const void* pixels) override;
+            void SetData(const void* pixels, uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t rowLength) override;
 
             virtual void* GetHandle() const override
             {
@@ -39,6 +41,10 @@ namespace Lumos
             {
                 return m_Height;
             }
+            inline TextureFormat GetFormat() const override
+            {
+                return m_Parameters.format;
+            }
 
             uint32_t GetMipMapLevels() const override
             {
@@ -59,6 +65,11 @@ namespace Lumos
                 m_Name = name;
             }
 
+            void SetFilepath(const std::string& filePath) override
+            {
+                m_FileName = filePath;
+            }
+
             void BuildTexture(TextureFormat internalformat, uint32_t width, uint32_t height, bool srgb, bool depth, bool samplerShadow) override;
 
             const VkDescriptorImageInfo* GetDescriptor() const
@@ -120,6 +131,8 @@ namespace Lumos
 
             VkImage m_TextureImage {};
             VkImageLayout m_ImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+            uint64_t m_UploadBatch = 0;
+            bool m_Writable = false;
             VkDeviceMemory m_TextureImageMemory {};
             VkImageView m_TextureImageView;
             VkSampler m_TextureSampler {};
@@ -214,6 +227,7 @@ namespace Lumos
 
             VkImage m_TextureImage {};
             VkImageLayout m_ImageLayout;
+            uint64_t m_UploadBatch = 0;
             VkDeviceMemory m_TextureImageMemory {};
             VkImageView m_TextureImageView {};
             VkSampler m_TextureSampler {};
@@ -92,6 +92,9 @@ namespace Lumos
         {
             VK_CHECK_RESULT(vkEndCommandBuffer(commandBuffer));
 
+            // Pending uploads must reach the queue before any work that may read them
+            VKDevice::Get().GetUploadManager()->Flush();
+
             VkSubmitInfo submitInfo;
             submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
             submitInfo.commandBufferCount = 1;
@@ -35,11 +35,11 @@ namespace Lumos
             VKBuffer::UnMap();
         }
 
-        void VKUniformBuffer::SetDynamicData(uint32_t size, uint32_t typeSize, const void* data)
+        void VKUniformBuffer::SetDynamicData(uint32_t size, uint32_t typeSize, const void* data, uint32_t offset)
         {
             VKBuffer::Map();
-            memcpy(m_Mapped, data, size);
-            VKBuffer::Flush(size);
+            memcpy(static_cast<uint8_t*>(m_Mapped) + offset, data, size);
+            VKBuffer::Flush(size, offset);
             VKBuffer::UnMap();
         }
 
@@ -21,7 +21,7 @@ namespace Lumos
             void Init(uint32_t size, const void* data) override;
 
             void SetData(uint32_t size, const void* data) override;
-            void SetDynamicData(uint32_t size, uint32_t typeSize, const void* data) override;
+            void SetDynamicData(uint32_t size, uint32_t typeSize, const void* data, uint32_t offset = 0) override;
 
             VkBuffer* GetBuffer() { return &m_Buffer; }
             VkDeviceMemory* GetMemory() { return &m_Memory; }
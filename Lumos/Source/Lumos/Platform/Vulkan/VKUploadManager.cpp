@@ -0,0 +1,399 @@
+#include "Precompiled.h"
+#include "VKUploadManager.h"
+#include "VKDevice.h"
+#include "VKBuffer.h"
+#include "VKFence.h"
+#include "VKCommandPool.h"
+#include "VKTools.h"
+#include "Maths/MathsUtilities.h"
+
+#include <numeric>
+
+namespace Lumos
+{
+    namespace Graphics
+    {
+        static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+        {
+            return ((value + alignment - 1) / alignment) * alignment;
+        }
+
+        static void ImageBarrier(VkCommandBuffer commandBuffer, VkImage image, const VkImageSubresourceRange& range,
+            VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+            VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage,
+            uint32_t srcQueueFamily = VK_QUEUE_FAMILY_IGNORED, uint32_t dstQueueFamily = VK_QUEUE_FAMILY_IGNORED)
+        {
+            VkImageMemoryBarrier barrier {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.oldLayout = oldLayout;
+            barrier.newLayout = newLayout;
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstAccessMask = dstAccess;
+            barrier.srcQueueFamilyIndex = srcQueueFamily;
+            barrier.dstQueueFamilyIndex = dstQueueFamily;
+            barrier.image = image;
+            barrier.subresourceRange = range;
+
+            vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+
+        VKUploadManager::VKUploadManager(uint32_t stagingBufferSize, int32_t graphicsQueueFamily, int32_t transferQueueFamily, VkQueue graphicsQueue, VkQueue transferQueue)
+            : m_StagingSize(stagingBufferSize)
+            , m_GraphicsQueueFamily(uint32_t(graphicsQueueFamily))
+            , m_GraphicsQueue(graphicsQueue)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            m_StagingBuffer = new VKBuffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, stagingBufferSize, nullptr);
+            m_StagingBuffer->Map();
+            m_StagingData = static_cast<uint8_t*>(m_StagingBuffer->GetMapped());
+
+            m_GraphicsCommandPool = CreateSharedRef<VKCommandPool>(graphicsQueueFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+#if LUMOS_VK_DEDICATED_TRANSFER_QUEUE
+            if(transferQueue != VK_NULL_HANDLE && transferQueueFamily >= 0 && transferQueueFamily != graphicsQueueFamily)
+            {
+                m_TransferQueue = transferQueue;
+                m_TransferQueueFamily = uint32_t(transferQueueFamily);
+                m_TransferCommandPool = CreateSharedRef<VKCommandPool>(transferQueueFamily, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+            }
+#endif
+
+            for(auto& batch : m_Batches)
+            {
+                VkCommandBufferAllocateInfo allocInfo = {};
+                allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+                allocInfo.commandPool = m_GraphicsCommandPool->GetHandle();
+                allocInfo.commandBufferCount = 1;
+                VK_CHECK_RESULT(vkAllocateCommandBuffers(VKDevice::Get().GetDevice(), &allocInfo, &batch.graphicsCommands));
+
+                if(m_TransferQueue)
+                {
+                    allocInfo.commandPool = m_TransferCommandPool->GetHandle();
+                    VK_CHECK_RESULT(vkAllocateCommandBuffers(VKDevice::Get().GetDevice(), &allocInfo, &batch.transferCommands));
+
+                    VkSemaphoreCreateInfo semaphoreInfo = {};
+                    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+                    VK_CHECK_RESULT(vkCreateSemaphore(VKDevice::Get().GetDevice(), &semaphoreInfo, nullptr, &batch.transferSemaphore));
+                }
+
+                batch.fence = CreateSharedRef<VKFence>(false);
+            }
+        }
+
+        VKUploadManager::~VKUploadManager()
+        {
+            WaitIdle();
+
+            for(auto& batch : m_Batches)
+            {
+                vkFreeCommandBuffers(VKDevice::Get().GetDevice(), m_GraphicsCommandPool->GetHandle(), 1, &batch.graphicsCommands);
+
+                if(batch.transferCommands)
+                    vkFreeCommandBuffers(VKDevice::Get().GetDevice(), m_TransferCommandPool->GetHandle(), 1, &batch.transferCommands);
+
+                if(batch.transferSemaphore)
+                    vkDestroySemaphore(VKDevice::Get().GetDevice(), batch.transferSemaphore, nullptr);
+
+                batch.fence.reset();
+            }
+
+            m_GraphicsCommandPool.reset();
+            m_TransferCommandPool.reset();
+
+            m_StagingBuffer->UnMap();
+            delete m_StagingBuffer;
+        }
+
+        uint64_t VKUploadManager::UploadImage(const VKImageUpload& upload)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            // Buffer to image copies must start on a multiple of both the texel size and 4
+            VkBuffer source;
+            VkDeviceSize sourceOffset;
+            Stage(upload.data, upload.size, std::lcm(upload.texelSize, 4u), source, sourceOffset);
+
+            Batch& batch = GetRecordingBatch();
+
+            const bool rewrite = upload.oldLayout != VK_IMAGE_LAYOUT_UNDEFINED;
+            const bool useTransferQueue = m_TransferQueue && !rewrite;
+            VkCommandBuffer copyCommands = useTransferQueue ? batch.transferCommands : batch.graphicsCommands;
+
+            VkImageSubresourceRange range = {};
+            range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            range.baseMipLevel = 0;
+            range.levelCount = upload.mipLevels;
+            range.baseArrayLayer = 0;
+            range.layerCount = upload.layerCount;
+
+            if(rewrite)
+                ImageBarrier(copyCommands, upload.image, range, upload.oldLayout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+            else
+                ImageBarrier(copyCommands, upload.image, range, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+            std::vector<VkBufferImageCopy> regions(upload.regions, upload.regions + upload.regionCount);
+            for(auto& region : regions)
+                region.bufferOffset += sourceOffset;
+
+            vkCmdCopyBufferToImage(copyCommands, source, upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+
+            if(useTransferQueue)
+            {
+                // Hand the image over to the graphics queue, which generates the mips and transitions it for sampling
+                ImageBarrier(batch.transferCommands, upload.image, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    VK_ACCESS_TRANSFER_WRITE_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TransferQueueFamily, m_GraphicsQueueFamily);
+                ImageBarrier(batch.graphicsCommands, upload.image, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    0, VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, m_TransferQueueFamily, m_GraphicsQueueFamily);
+            }
+
+            if(upload.generateMips && upload.mipLevels > 1)
+                RecordMipChain(batch.graphicsCommands, upload);
+            else
+                ImageBarrier(batch.graphicsCommands, upload.image, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+            return batch.id;
+        }
+
+        void VKUploadManager::RecordMipChain(VkCommandBuffer commandBuffer, const VKImageUpload& upload)
+        {
+            VkFormatProperties formatProperties;
+            vkGetPhysicalDeviceFormatProperties(VKDevice::Get().GetGPU(), upload.format, &formatProperties);
+
+            if(!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
+            {
+                LUMOS_LOG_ERROR("Texture image format does not support linear blitting!");
+            }
+
+            VkImageSubresourceRange range = {};
+            range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            range.levelCount = 1;
+            range.baseArrayLayer = 0;
+            range.layerCount = upload.layerCount;
+
+            int32_t mipWidth = int32_t(upload.width);
+            int32_t mipHeight = int32_t(upload.height);
+
+            for(uint32_t i = 1; i < upload.mipLevels; i++)
+            {
+                range.baseMipLevel = i - 1;
+                ImageBarrier(commandBuffer, upload.image, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+                VkImageBlit blit {};
+                blit.srcOffsets[0] = { 0, 0, 0 };
+                blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+                blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                blit.srcSubresource.mipLevel = i - 1;
+                blit.srcSubresource.baseArrayLayer = 0;
+                blit.srcSubresource.layerCount = upload.layerCount;
+                blit.dstOffsets[0] = { 0, 0, 0 };
+                blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
+                blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                blit.dstSubresource.mipLevel = i;
+                blit.dstSubresource.baseArrayLayer = 0;
+                blit.dstSubresource.layerCount = upload.layerCount;
+
+                vkCmdBlitImage(commandBuffer, upload.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, upload.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+                ImageBarrier(commandBuffer, upload.image, range, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+                if(mipWidth > 1)
+                    mipWidth /= 2;
+                if(mipHeight > 1)
+                    mipHeight /= 2;
+            }
+
+            range.baseMipLevel = upload.mipLevels - 1;
+            ImageBarrier(commandBuffer, upload.image, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+        }
+
+        void VKUploadManager::Stage(const void* data, uint32_t size, uint32_t alignment, VkBuffer& buffer, VkDeviceSize& offset)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            if(size > m_StagingSize)
+            {
+                VKBuffer* overflowBuffer = new VKBuffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, size, data);
+                GetRecordingBatch().overflowBuffers.push_back(overflowBuffer);
+
+                buffer = overflowBuffer->GetBuffer();
+                offset = 0;
+                return;
+            }
+
+            while(true)
+            {
+                const uint64_t ringStart = m_StagingHead - m_StagingHead % m_StagingSize;
+                uint64_t start = ringStart + AlignUp(m_StagingHead - ringStart, alignment);
+
+                // Allocations never straddle the end of the ring
+                if(start - ringStart + size > m_StagingSize)
+                    start = ringStart + m_StagingSize;
+
+                if(start + size - m_StagingTail <= m_StagingSize)
+                {
+                    m_StagingHead = start + size;
+                    offset = start % m_StagingSize;
+                    break;
+                }
+
+                // Out of staging memory, wait for the oldest batch in flight to release its range
+                if(RetireOldest())
+                    continue;
+
+                // Only the batch being recorded is holding staging memory
+                Batch& batch = m_Batches[m_CurrentBatch];
+                if(batch.recording)
+                {
+                    Submit(batch);
+                    continue;
+                }
+
+                // Nothing is in flight, restart from the beginning of the ring
+                m_StagingHead = m_StagingTail = ringStart + m_StagingSize;
+            }
+
+            memcpy(m_StagingData + offset, data, size);
+#ifdef USE_VMA_ALLOCATOR
+            // Without VMA the staging memory is host coherent
+            m_StagingBuffer->Flush(size, offset);
+#endif
+            buffer = m_StagingBuffer->GetBuffer();
+        }
+
+        VKUploadManager::Batch& VKUploadManager::GetRecordingBatch()
+        {
+            Batch& batch = m_Batches[m_CurrentBatch];
+            if(batch.recording)
+                return batch;
+
+            // Batches are used in turn, so a submitted batch here is the oldest one in flight
+            if(batch.submitted)
+                Retire(batch);
+
+            VkCommandBufferBeginInfo beginInfo = {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+            VK_CHECK_RESULT(vkBeginCommandBuffer(batch.graphicsCommands, &beginInfo));
+            if(m_TransferQueue)
+                VK_CHECK_RESULT(vkBeginCommandBuffer(batch.transferCommands, &beginInfo));
+
+            batch.id = m_NextBatchId++;
+            batch.recording = true;
+            return batch;
+        }
+
+        void VKUploadManager::Submit(Batch& batch)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            LUMOS_ASSERT(batch.recording, "Submitting an upload batch that is not recording");
+
+            VK_CHECK_RESULT(vkEndCommandBuffer(batch.graphicsCommands));
+            batch.stagingEnd = m_StagingHead;
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &batch.graphicsCommands;
+
+            VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            if(m_TransferQueue)
+            {
+                VK_CHECK_RESULT(vkEndCommandBuffer(batch.transferCommands));
+
+                VkSubmitInfo transferSubmitInfo = {};
+                transferSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+                transferSubmitInfo.commandBufferCount = 1;
+                transferSubmitInfo.pCommandBuffers = &batch.transferCommands;
+                transferSubmitInfo.signalSemaphoreCount = 1;
+                transferSubmitInfo.pSignalSemaphores = &batch.transferSemaphore;
+                VK_CHECK_RESULT(vkQueueSubmit(m_TransferQueue, 1, &transferSubmitInfo, VK_NULL_HANDLE));
+
+                submitInfo.waitSemaphoreCount = 1;
+                submitInfo.pWaitSemaphores = &batch.transferSemaphore;
+                submitInfo.pWaitDstStageMask = &waitStage;
+            }
+
+            // Later submissions to the graphics queue are ordered after these copies by the barriers recorded with them
+            VK_CHECK_RESULT(vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, batch.fence->GetHandle()));
+
+            batch.recording = false;
+            batch.submitted = true;
+            m_CurrentBatch = (m_CurrentBatch + 1) % BatchCount;
+        }
+
+        void VKUploadManager::Retire(Batch& batch)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            if(!batch.fence->IsSignaled())
+                batch.fence->Wait();
+            batch.fence->Reset();
+
+            for(auto overflowBuffer : batch.overflowBuffers)
+                delete overflowBuffer;
+            batch.overflowBuffers.clear();
+
+            m_StagingTail = Maths::Max(m_StagingTail, batch.stagingEnd);
+            m_CompletedBatchId = Maths::Max(m_CompletedBatchId, batch.id);
+            batch.submitted = false;
+        }
+
+        bool VKUploadManager::RetireOldest()
+        {
+            Batch* oldest = nullptr;
+            for(auto& batch : m_Batches)
+            {
+                if(batch.submitted && (!oldest || batch.id < oldest->id))
+                    oldest = &batch;
+            }
+
+            if(!oldest)
+                return false;
+
+            Retire(*oldest);
+            return true;
+        }
+
+        void VKUploadManager::Flush()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            Batch& batch = m_Batches[m_CurrentBatch];
+            if(batch.recording)
+                Submit(batch);
+
+            for(auto& submittedBatch : m_Batches)
+            {
+                if(submittedBatch.submitted && submittedBatch.fence->IsSignaled())
+                    Retire(submittedBatch);
+            }
+        }
+
+        void VKUploadManager::Wait(uint64_t batchId)
+        {
+            LUMOS_PROFILE_FUNCTION();
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            Batch& batch = m_Batches[m_CurrentBatch];
+            if(batch.recording && batch.id <= batchId)
+                Submit(batch);
+
+            while(m_CompletedBatchId < batchId && RetireOldest())
+            {
+            }
+        }
+
+        void VKUploadManager::WaitIdle()
+        {
+            Wait(m_NextBatchId - 1);
+        }
+    }
+}
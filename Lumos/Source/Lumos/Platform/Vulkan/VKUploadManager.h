@@ -0,0 +1,122 @@
+#pragma once
+#include "VK.h"
+
+#include <mutex>
+
+// Copies are recorded on a transfer only queue family when the GPU has one, and handed over to the graphics queue for
+// mip generation. Off by default, all uploads are then recorded on the graphics queue
+#ifndef LUMOS_VK_DEDICATED_TRANSFER_QUEUE
+#define LUMOS_VK_DEDICATED_TRANSFER_QUEUE 0
+#endif
+
+namespace Lumos
+{
+    namespace Graphics
+    {
+        class VKBuffer;
+        class VKFence;
+        class VKCommandPool;
+
+        struct VKImageUpload
+        {
+            VkImage image = VK_NULL_HANDLE;
+            VkFormat format = VK_FORMAT_UNDEFINED;
+            const void* data = nullptr;
+            uint32_t size = 0;
+            uint32_t texelSize = 4;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t mipLevels = 1;
+            uint32_t layerCount = 1;
+
+            // Images already sampled by submitted frames are in SHADER_READ_ONLY_OPTIMAL. Their copy waits for those
+            // fragment shader reads, so it is recorded on the graphics queue
+            VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+            // Buffer offsets are relative to data
+            const VkBufferImageCopy* regions = nullptr;
+            uint32_t regionCount = 0;
+
+            // Levels after the first are blitted from level 0 instead of copied
+            bool generateMips = false;
+        };
+
+        // Batches texture uploads instead of submitting and idling the queue for each one.
+        // Source data is copied into a persistently mapped staging ring, and the copies are recorded into the current batch's
+        // command buffers. Recorded batches are submitted before any other work reaches the graphics queue, and their
+        // staging memory is reclaimed once the batch's fence has signalled.
+        class VKUploadManager
+        {
+        public:
+            VKUploadManager(uint32_t stagingBufferSize, int32_t graphicsQueueFamily, int32_t transferQueueFamily, VkQueue graphicsQueue, VkQueue transferQueue);
+            ~VKUploadManager();
+
+            VKUploadManager(VKUploadManager const&) = delete;
+            VKUploadManager& operator=(VKUploadManager const&) = delete;
+
+            // Uploads to every layer and level of the image and leaves it in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+            // Returns the batch the upload was recorded in
+            uint64_t UploadImage(const VKImageUpload& upload);
+
+            // Submits the recorded uploads and reclaims staging memory from completed batches
+            void Flush();
+
+            // Blocks until the batch has completed, submitting it first if it is still being recorded
+            void Wait(uint64_t batch);
+            void WaitIdle();
+
+            bool UsesTransferQueue() const { return m_TransferQueue != VK_NULL_HANDLE; }
+
+        private:
+            static const uint32_t BatchCount = 4;
+
+            struct Batch
+            {
+                uint64_t id = 0;
+                VkCommandBuffer graphicsCommands = VK_NULL_HANDLE;
+                VkCommandBuffer transferCommands = VK_NULL_HANDLE;
+                VkSemaphore transferSemaphore = VK_NULL_HANDLE;
+                SharedRef<VKFence> fence;
+
+                // Staging ring position after the batch's last allocation
+                uint64_t stagingEnd = 0;
+
+                // Uploads larger than the staging ring get their own buffer, freed when the batch completes
+                std::vector<VKBuffer*> overflowBuffers;
+
+                bool recording = false;
+                bool submitted = false;
+            };
+
+            Batch& GetRecordingBatch();
+            void Submit(Batch& batch);
+            void Retire(Batch& batch);
+            bool RetireOldest();
+
+            void Stage(const void* data, uint32_t size, uint32_t alignment, VkBuffer& buffer, VkDeviceSize& offset);
+            void RecordMipChain(VkCommandBuffer commandBuffer, const VKImageUpload& upload);
+
+            std::mutex m_Mutex;
+
+            VKBuffer* m_StagingBuffer = nullptr;
+            uint8_t* m_StagingData = nullptr;
+            uint64_t m_StagingSize = 0;
+
+            // Positions only ever increase, the ring offset is the position modulo the ring size
+            uint64_t m_StagingHead = 0;
+            uint64_t m_StagingTail = 0;
+
+            uint32_t m_GraphicsQueueFamily = 0;
+            uint32_t m_TransferQueueFamily = 0;
+            VkQueue m_GraphicsQueue = VK_NULL_HANDLE;
+            VkQueue m_TransferQueue = VK_NULL_HANDLE;
+            SharedRef<VKCommandPool> m_GraphicsCommandPool;
+            SharedRef<VKCommandPool> m_TransferCommandPool;
+
+            Batch m_Batches[BatchCount];
+            uint32_t m_CurrentBatch = 0;
+            uint64_t m_NextBatchId = 1;
+            uint64_t m_CompletedBatchId = 0;
+        };
+    }
+}
@@ -94,22 +94,44 @@ namespace Lumos
         return success ? result : std::string();
     }
 
-    bool FileSystem::WriteFile(const std::string& path, uint8_t* buffer)
+    bool FileSystem::WriteFile(const std::string& path, uint8_t* buffer, uint32_t size)
     {
-        const HANDLE file = CreateFile(path.c_str(), GENERIC_WRITE, NULL, nullptr, CREATE_NEW | OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        const HANDLE file = CreateFile(path.c_str(), GENERIC_WRITE, NULL, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
         if(file == INVALID_HANDLE_VALUE)
             return false;
 
-        const int64_t size = GetFileSizeInternal(file);
         DWORD written;
-        const bool result = ::WriteFile(file, buffer, static_cast<DWORD>(size), &written, nullptr) != 0;
+        const bool result = ::WriteFile(file, buffer, static_cast<DWORD>(size), &written, nullptr) != 0 && written == size;
         CloseHandle(file);
         return result;
     }
 
     bool FileSystem::WriteTextFile(const std::string& path, const std::string& text)
     {
-        return WriteFile(path, (uint8_t*)&text[0]);
+        return WriteFile(path, (uint8_t*)&text[0], static_cast<uint32_t>(text.size()));
+    }
+
+    uint8_t* FileSystem::MapFile(const std::string& path, int64_t& size)
+    {
+        const HANDLE file = CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file == INVALID_HANDLE_VALUE)
+            return nullptr;
+
+        size = GetFileSizeInternal(file);
+        const HANDLE mapping = size > 0 ? CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+        // The view keeps the file and mapping open
+        if(mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return static_cast<uint8_t*>(data);
+    }
+
+    void FileSystem::UnmapFile(uint8_t* data, int64_t size)
+    {
+        if(data)
+            UnmapViewOfFile(data);
     }
 }
 
@@ -12,6 +12,7 @@
 #include "Physics/LumosPhysicsEngine/SortAndSweepBroadphase.h"
 #include "Physics/LumosPhysicsEngine/BruteForceBroadphase.h"
 #include "Physics/LumosPhysicsEngine/OctreeBroadphase.h"
+#include "Physics/LumosPhysicsEngine/DynamicAABBTreeBroadphase.h"
 #include "Physics/LumosPhysicsEngine/LumosPhysicsEngine.h"
 #include "Physics/LumosPhysicsEngine/SphereCollisionShape.h"
 #include "Physics/LumosPhysicsEngine/CuboidCollisionShape.h"
@@ -78,7 +79,7 @@ namespace Lumos
         //Default physics setup
         Application::Get().GetSystem<LumosPhysicsEngine>()->SetDampingFactor(0.999f);
         Application::Get().GetSystem<LumosPhysicsEngine>()->SetIntegrationType(IntegrationType::RUNGE_KUTTA_4);
-        Application::Get().GetSystem<LumosPhysicsEngine>()->SetBroadphase(Lumos::CreateSharedRef<OctreeBroadphase>(5, 5, Lumos::CreateSharedRef<SortAndSweepBroadphase>()));
+        Application::Get().GetSystem<LumosPhysicsEngine>()->SetBroadphase(Lumos::CreateSharedRef<DynamicAABBTreeBroadphase>());
 
         LuaManager::Get().OnInit(this);
     }
@@ -134,6 +135,32 @@ namespace Lumos
         }
     }
 
+    void Scene::UpdateStreaming()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        auto& registry = m_EntityManager->GetRegistry();
+
+        auto group = registry.group<Graphics::Model>(entt::get<Maths::Transform>);
+        for(auto entity : group)
+        {
+            const auto& [model, trans] = group.get<Graphics::Model, Maths::Transform>(entity);
+            const Maths::Vector3 position = trans.GetWorldPosition();
+
+            if(model.IsStreaming())
+            {
+                model.SetStreamingPosition(position);
+                model.UpdateStreaming();
+            }
+
+            for(auto& mesh : model.GetMeshes())
+            {
+                auto& material = mesh->GetMaterial();
+                if(material && material->IsStreaming())
+                    material->SetStreamingPosition(position);
+            }
+        }
+    }
+
     void Scene::OnEvent(Event& e)
     {
         LUMOS_PROFILE_FUNCTION();
@@ -96,12 +96,17 @@ namespace Lumos
 
         void UpdateSceneGraph();
 
+        // Passes model and material world positions to their streaming requests and adds the meshes of
+        // models that finished streaming. Runs every frame, also while the scene is paused in the editor
+        void UpdateStreaming();
+
         void DuplicateEntity(Entity entity);
         void DuplicateEntity(Entity entity, Entity parent);
         Entity CreateEntity();
         Entity CreateEntity(const std::string& name);
 
         EntityManager* GetEntityManager() { return m_EntityManager.get(); }
+        SceneGraph* GetSceneGraph() { return m_SceneGraph.get(); }
 
         void SetHasCppClass(bool value)
         {
@@ -0,0 +1,486 @@
+#include "Precompiled.h"
+#include "SceneFile.h"
+#include "Scene.h"
+#include "SceneGraph.h"
+#include "Scene/EntityManager.h"
+#include "Scene/Component/Components.h"
+#include "Scene/Component/SoundComponent.h"
+#include "Scripting/Lua/LuaScriptComponent.h"
+#include "Graphics/Camera/Camera.h"
+#include "Graphics/Sprite.h"
+#include "Graphics/AnimatedSprite.h"
+#include "Graphics/Light.h"
+#include "Graphics/Model.h"
+#include "Graphics/Environment.h"
+#include "Audio/AudioManager.h"
+#include "Maths/Transform.h"
+#include "Core/OS/FileSystem.h"
+#include "Core/StringUtilities.h"
+
+#include <cereal/types/polymorphic.hpp>
+#include <cereal/archives/binary.hpp>
+#include <entt/entity/registry.hpp>
+#include <entt/core/hashed_string.hpp>
+
+namespace Lumos
+{
+    namespace
+    {
+        const char Magic[4] = { 'L', 'S', 'C', 'N' };
+
+        // Chunk data and raw component arrays start on this boundary, so they can be used in place
+        const uint64_t ChunkAlignment = 16;
+
+        uint64_t Align(uint64_t offset)
+        {
+            return (offset + ChunkAlignment - 1) & ~(ChunkAlignment - 1);
+        }
+
+        uint32_t ChunkID(const char* name)
+        {
+            return static_cast<uint32_t>(entt::hashed_string::value(name));
+        }
+
+        // Lets cereal read from the mapped file without copying the chunk
+        class MemoryStreamBuffer : public std::streambuf
+        {
+        public:
+            MemoryStreamBuffer(const uint8_t* data, uint64_t size)
+            {
+                char* begin = reinterpret_cast<char*>(const_cast<uint8_t*>(data));
+                setg(begin, begin, begin + size);
+            }
+        };
+
+        struct ChunkWriter
+        {
+            std::vector<SceneFile::ChunkHeader> chunks;
+            std::vector<uint8_t> data; // Offsets are relative to the start of the chunk data until the file is assembled
+
+            uint8_t* Add(uint32_t id, SceneFile::ChunkFormat format, uint32_t count, uint32_t elementSize, uint64_t size)
+            {
+                SceneFile::ChunkHeader chunk;
+                chunk.id = id;
+                chunk.format = format;
+                chunk.count = count;
+                chunk.elementSize = elementSize;
+                chunk.offset = Align(data.size());
+                chunk.size = size;
+
+                data.resize(chunk.offset + size, 0);
+                chunks.push_back(chunk);
+                return data.data() + chunk.offset;
+            }
+        };
+
+        // Component chunks start with the entities owning each component, followed by the components in the same order
+        template <typename T>
+        void WriteRawChunk(ChunkWriter& writer, uint32_t id, entt::registry& registry)
+        {
+            static_assert(std::is_trivially_copyable_v<T> && !std::is_empty_v<T>, "Raw chunks need trivially copyable components");
+
+            auto view = registry.view<T>();
+            const uint32_t count = static_cast<uint32_t>(view.size());
+            const uint64_t componentOffset = Align(count * sizeof(entt::entity));
+
+            uint8_t* data = writer.Add(id, SceneFile::ChunkFormat::Raw, count, sizeof(T), componentOffset + uint64_t(count) * sizeof(T));
+            if(count == 0)
+                return;
+
+            memcpy(data, view.data(), count * sizeof(entt::entity));
+            memcpy(data + componentOffset, view.raw(), count * sizeof(T));
+        }
+
+        template <typename T>
+        bool ReadRawChunk(const SceneFile::ChunkHeader& chunk, const uint8_t* data, entt::registry& registry, const std::atomic<bool>& cancelled)
+        {
+            const uint64_t componentOffset = Align(chunk.count * sizeof(entt::entity));
+
+            if(chunk.elementSize != sizeof(T))
+            {
+                LUMOS_LOG_WARN("Scene file component size {0} does not match this build's {1}", chunk.elementSize, sizeof(T));
+                return false;
+            }
+
+            if(chunk.format != SceneFile::ChunkFormat::Raw || componentOffset + uint64_t(chunk.count) * sizeof(T) > chunk.size)
+                return false;
+
+            auto entities = reinterpret_cast<const entt::entity*>(data);
+            auto components = reinterpret_cast<const T*>(data + componentOffset);
+            registry.insert<T>(entities, entities + chunk.count, components, components + chunk.count);
+            return true;
+        }
+
+        template <typename T>
+        void WriteArchiveChunk(ChunkWriter& writer, uint32_t id, entt::registry& registry)
+        {
+            auto view = registry.view<T>();
+            const uint32_t count = static_cast<uint32_t>(view.size());
+
+            std::ostringstream storage;
+            {
+                // output finishes flushing its contents when it goes out of scope
+                cereal::BinaryOutputArchive output { storage };
+                for(uint32_t i = 0; i < count; i++)
+                    output(view.raw()[i]);
+            }
+
+            const std::string archive = storage.str();
+            const uint64_t archiveOffset = Align(count * sizeof(entt::entity));
+
+            uint8_t* data = writer.Add(id, SceneFile::ChunkFormat::Archive, count, 0, archiveOffset + archive.size());
+            if(count == 0)
+                return;
+
+            memcpy(data, view.data(), count * sizeof(entt::entity));
+            memcpy(data + archiveOffset, archive.data(), archive.size());
+        }
+
+        template <typename T>
+        bool ReadArchiveChunk(const SceneFile::ChunkHeader& chunk, const uint8_t* data, entt::registry& registry, const std::atomic<bool>& cancelled)
+        {
+            const uint64_t archiveOffset = Align(chunk.count * sizeof(entt::entity));
+
+            if(chunk.format != SceneFile::ChunkFormat::Archive || archiveOffset > chunk.size)
+                return false;
+
+            auto entities = reinterpret_cast<const entt::entity*>(data);
+
+            MemoryStreamBuffer buffer(data + archiveOffset, chunk.size - archiveOffset);
+            std::istream stream(&buffer);
+            cereal::BinaryInputArchive input(stream);
+
+            for(uint32_t i = 0; i < chunk.count; i++)
+            {
+                if(cancelled)
+                    return false;
+
+                T component;
+                input(component);
+                registry.emplace<T>(entities[i], std::move(component));
+            }
+
+            return true;
+        }
+
+        struct ComponentChunk
+        {
+            const char* name;
+            void (*write)(ChunkWriter& writer, uint32_t id, entt::registry& registry);
+            bool (*read)(const SceneFile::ChunkHeader& chunk, const uint8_t* data, entt::registry& registry, const std::atomic<bool>& cancelled);
+        };
+
+        template <typename T>
+        ComponentChunk RawChunk(const char* name)
+        {
+            return { name, &WriteRawChunk<T>, &ReadRawChunk<T> };
+        }
+
+        template <typename T>
+        ComponentChunk ArchiveChunk(const char* name)
+        {
+            return { name, &WriteArchiveChunk<T>, &ReadArchiveChunk<T> };
+        }
+
+        // Raw chunks store these components' memory as is. Changing one changes the file format, so update its size here
+        // and bump SceneFile::Version
+        static_assert(sizeof(Maths::Transform) == 188, "Transform layout changed, bump SceneFile::Version");
+        static_assert(sizeof(Hierarchy) == 16, "Hierarchy layout changed, bump SceneFile::Version");
+        static_assert(sizeof(ActiveComponent) == 1, "ActiveComponent layout changed, bump SceneFile::Version");
+        static_assert(sizeof(Listener) == 1, "Listener layout changed, bump SceneFile::Version");
+
+        // Names are hashed into chunk ids, changing one makes files written before unable to load that component
+        const ComponentChunk ComponentChunks[] = {
+            RawChunk<Maths::Transform>("Transform"),
+            RawChunk<Hierarchy>("Hierarchy"),
+            RawChunk<ActiveComponent>("Active"),
+            RawChunk<Listener>("Listener"),
+            ArchiveChunk<NameComponent>("Name"),
+            ArchiveChunk<Camera>("Camera"),
+            ArchiveChunk<LuaScriptComponent>("LuaScript"),
+            ArchiveChunk<Graphics::Model>("Model"),
+            ArchiveChunk<Graphics::Light>("Light"),
+            ArchiveChunk<Physics3DComponent>("Physics3D"),
+            ArchiveChunk<Graphics::Environment>("Environment"),
+            ArchiveChunk<Graphics::Sprite>("Sprite"),
+            ArchiveChunk<Physics2DComponent>("Physics2D"),
+            ArchiveChunk<DefaultCameraController>("DefaultCameraController"),
+            ArchiveChunk<Graphics::AnimatedSprite>("AnimatedSprite"),
+            ArchiveChunk<SoundComponent>("Sound")
+        };
+
+        const ComponentChunk* FindComponentChunk(uint32_t id)
+        {
+            for(auto& component : ComponentChunks)
+            {
+                if(ChunkID(component.name) == id)
+                    return &component;
+            }
+
+            return nullptr;
+        }
+    }
+
+    bool SceneFile::Write(Scene* scene, const std::string& filePath)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        std::string sceneName = scene->GetSceneName();
+        std::string path = filePath;
+        path += StringUtilities::RemoveSpaces(sceneName);
+        path += std::string(".lscn");
+
+        auto& registry = scene->GetRegistry();
+        ChunkWriter writer;
+
+        {
+            std::ostringstream storage;
+            {
+                cereal::BinaryOutputArchive output { storage };
+                output(*scene);
+            }
+
+            const std::string archive = storage.str();
+            memcpy(writer.Add(ChunkID("Scene"), ChunkFormat::Archive, 1, 0, archive.size()), archive.data(), archive.size());
+        }
+
+        // Every entity slot including destroyed ones, so identifiers and versions are restored as saved
+        const uint32_t entityCount = static_cast<uint32_t>(registry.size());
+        uint8_t* entities = writer.Add(ChunkID("Entities"), ChunkFormat::Raw, entityCount, sizeof(entt::entity), uint64_t(entityCount) * sizeof(entt::entity));
+        if(entityCount > 0)
+            memcpy(entities, registry.data(), entityCount * sizeof(entt::entity));
+
+        for(auto& component : ComponentChunks)
+            component.write(writer, ChunkID(component.name), registry);
+
+        Header header;
+        memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.chunkCount = static_cast<uint32_t>(writer.chunks.size());
+        header.reserved = 0;
+
+        const uint64_t dataOffset = Align(sizeof(Header) + writer.chunks.size() * sizeof(ChunkHeader));
+        std::vector<uint8_t> file(dataOffset + writer.data.size(), 0);
+
+        memcpy(file.data(), &header, sizeof(Header));
+        for(size_t i = 0; i < writer.chunks.size(); i++)
+        {
+            ChunkHeader chunk = writer.chunks[i];
+            chunk.offset += dataOffset;
+            memcpy(file.data() + sizeof(Header) + i * sizeof(ChunkHeader), &chunk, sizeof(ChunkHeader));
+        }
+
+        memcpy(file.data() + dataOffset, writer.data.data(), writer.data.size());
+
+        if(!FileSystem::WriteFile(path, file.data(), static_cast<uint32_t>(file.size())))
+        {
+            LUMOS_LOG_ERROR("Failed to write scene file {0}", path);
+            return false;
+        }
+
+        LUMOS_LOG_INFO("Scene saved - {0}", path);
+        return true;
+    }
+
+    bool SceneFile::Convert(Scene* scene, const std::string& filePath, bool binary)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        std::string sceneName = scene->GetSceneName();
+        std::string path = filePath;
+        path += StringUtilities::RemoveSpaces(sceneName);
+        path += binary ? std::string(".bin") : std::string(".lsn");
+
+        if(!FileSystem::FileExists(path))
+        {
+            LUMOS_LOG_ERROR("No saved scene file found {0}", path);
+            return false;
+        }
+
+        scene->Deserialise(filePath, binary);
+        return Write(scene, filePath);
+    }
+
+    SceneFileReader::SceneFileReader(Scene* scene)
+        : m_Scene(scene)
+    {
+    }
+
+    SceneFileReader::~SceneFileReader()
+    {
+        if(m_Status == Status::Loading)
+        {
+            m_Scene->GetEntityManager()->Clear();
+            Finish(Status::Cancelled);
+        }
+
+        Close();
+    }
+
+    bool SceneFileReader::Open(const std::string& filePath)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(m_Status == Status::Loading)
+            Finish(Status::Cancelled);
+
+        std::string sceneName = m_Scene->GetSceneName();
+        std::string path = filePath;
+        path += StringUtilities::RemoveSpaces(sceneName);
+        path += std::string(".lscn");
+
+        m_Status = Status::Failed;
+        m_Data = FileSystem::MapFile(path, m_Size);
+
+        if(!m_Data)
+        {
+            LUMOS_LOG_ERROR("No saved scene file found {0}", path);
+            return false;
+        }
+
+        SceneFile::Header header;
+        if(m_Size < int64_t(sizeof(header)) || memcmp(m_Data, Magic, sizeof(Magic)) != 0)
+        {
+            LUMOS_LOG_WARN("{0} is not a scene file", path);
+            Close();
+            return false;
+        }
+
+        memcpy(&header, m_Data, sizeof(header));
+
+        if(header.version != SceneFile::Version)
+        {
+            LUMOS_LOG_WARN("Scene file {0} is version {1}, this build reads version {2}", path, header.version, SceneFile::Version);
+            Close();
+            return false;
+        }
+
+        if(sizeof(header) + uint64_t(header.chunkCount) * sizeof(SceneFile::ChunkHeader) > uint64_t(m_Size))
+        {
+            LUMOS_LOG_WARN("Scene file {0} is truncated", path);
+            Close();
+            return false;
+        }
+
+        m_Chunks = reinterpret_cast<const SceneFile::ChunkHeader*>(m_Data + sizeof(header));
+        m_ChunkCount = header.chunkCount;
+        m_NextChunk = 0;
+        m_EntitiesLoaded = false;
+        m_Cancelled = false;
+        m_Status = Status::Loading;
+
+        // Hierarchy links are loaded as saved, they must not be relinked as each component is added
+        m_Scene->GetEntityManager()->Clear();
+        m_Scene->GetSceneGraph()->DisableOnConstruct(true, m_Scene->GetRegistry());
+
+        return true;
+    }
+
+    SceneFileReader::Status SceneFileReader::LoadNextChunk()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        if(m_Status != Status::Loading)
+            return m_Status;
+
+        if(m_Cancelled)
+        {
+            m_Scene->GetEntityManager()->Clear();
+            return Finish(Status::Cancelled);
+        }
+
+        if(m_NextChunk == m_ChunkCount)
+            return Finish(Status::Done);
+
+        const SceneFile::ChunkHeader& chunk = m_Chunks[m_NextChunk++];
+        auto& registry = m_Scene->GetRegistry();
+        bool result = chunk.offset + chunk.size <= uint64_t(m_Size);
+
+        if(result)
+        {
+            try
+            {
+                const uint8_t* data = m_Data + chunk.offset;
+
+                if(chunk.id == ChunkID("Scene"))
+                {
+                    MemoryStreamBuffer buffer(data, chunk.size);
+                    std::istream stream(&buffer);
+                    cereal::BinaryInputArchive input(stream);
+                    input(*m_Scene);
+                }
+                else if(chunk.id == ChunkID("Entities"))
+                {
+                    result = chunk.count * sizeof(entt::entity) <= chunk.size;
+                    if(result)
+                    {
+                        auto entities = reinterpret_cast<const entt::entity*>(data);
+                        registry.assign(entities, entities + chunk.count);
+                        m_EntitiesLoaded = true;
+                    }
+                }
+                else if(auto component = FindComponentChunk(chunk.id))
+                {
+                    result = m_EntitiesLoaded && component->read(chunk, data, registry, m_Cancelled);
+                }
+                else
+                {
+                    LUMOS_LOG_WARN("Skipping unknown scene file chunk {0}", chunk.id);
+                }
+            }
+            catch(const cereal::Exception& e)
+            {
+                LUMOS_LOG_ERROR("Failed to read scene file chunk {0} : {1}", chunk.id, e.what());
+                result = false;
+            }
+        }
+
+        if(m_Cancelled)
+        {
+            m_Scene->GetEntityManager()->Clear();
+            return Finish(Status::Cancelled);
+        }
+
+        if(!result)
+        {
+            LUMOS_LOG_ERROR("Invalid scene file chunk {0}", chunk.id);
+            m_Scene->GetEntityManager()->Clear();
+            return Finish(Status::Failed);
+        }
+
+        if(m_NextChunk == m_ChunkCount)
+            return Finish(Status::Done);
+
+        return Status::Loading;
+    }
+
+    SceneFileReader::Status SceneFileReader::LoadAll()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        while(LoadNextChunk() == Status::Loading)
+        {
+        }
+
+        return m_Status;
+    }
+
+    float SceneFileReader::GetProgress() const
+    {
+        if(m_Status == Status::Done)
+            return 1.0f;
+
+        return m_ChunkCount > 0 ? float(m_NextChunk) / float(m_ChunkCount) : 0.0f;
+    }
+
+    SceneFileReader::Status SceneFileReader::Finish(Status status)
+    {
+        m_Scene->GetSceneGraph()->DisableOnConstruct(false, m_Scene->GetRegistry());
+        Close();
+        m_Status = status;
+        return status;
+    }
+
+    void SceneFileReader::Close()
+    {
+        FileSystem::UnmapFile(m_Data, m_Size);
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Chunks = nullptr;
+    }
+}
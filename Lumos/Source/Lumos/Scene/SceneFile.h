@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+
+namespace Lumos
+{
+    class Scene;
+
+    // Versioned binary scene file (.lscn), a table of chunks with one chunk per component type.
+    // Trivially copyable components are stored as raw arrays and inserted into the registry straight from the
+    // memory mapped file, the others are stored as cereal binary archives
+    class LUMOS_EXPORT SceneFile
+    {
+    public:
+        // Bump when a raw component's layout changes. Files of another version are rejected and the .lsn is loaded instead
+        static const uint32_t Version = 2;
+
+        struct Header
+        {
+            char magic[4];
+            uint32_t version;
+            uint32_t chunkCount;
+            uint32_t reserved;
+        };
+
+        enum class ChunkFormat : uint32_t
+        {
+            Raw,
+            Archive
+        };
+
+        struct ChunkHeader
+        {
+            uint32_t id; // Hashed name of the chunk's component type
+            ChunkFormat format;
+            uint32_t count;
+            uint32_t elementSize; // Size of a raw component, checked against the loading build's
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        // Writes the scene to filePath + scene name + ".lscn", like Scene::Serialise
+        static bool Write(Scene* scene, const std::string& filePath);
+
+        // Loads an existing .lsn or cereal .bin scene from filePath and writes it as a scene file next to it
+        static bool Convert(Scene* scene, const std::string& filePath, bool binary);
+    };
+
+    // Loads a scene file one chunk at a time, so loading can be spread over frames and cancelled
+    class LUMOS_EXPORT SceneFileReader
+    {
+    public:
+        enum class Status
+        {
+            Loading,
+            Done,
+            Failed,
+            Cancelled
+        };
+
+        explicit SceneFileReader(Scene* scene);
+        ~SceneFileReader();
+
+        // Maps the file and clears the scene, filePath is resolved like Scene::Deserialise
+        bool Open(const std::string& filePath);
+
+        Status LoadNextChunk();
+        Status LoadAll();
+
+        // Safe to call from any thread, the scene is cleared by the next LoadNextChunk
+        void Cancel() { m_Cancelled = true; }
+
+        float GetProgress() const;
+        Status GetStatus() const { return m_Status; }
+
+    private:
+        void Close();
+        Status Finish(Status status);
+
+        Scene* m_Scene = nullptr;
+        uint8_t* m_Data = nullptr;
+        int64_t m_Size = 0;
+
+        const SceneFile::ChunkHeader* m_Chunks = nullptr;
+        uint32_t m_ChunkCount = 0;
+        uint32_t m_NextChunk = 0;
+        bool m_EntitiesLoaded = false;
+
+        Status m_Status = Status::Failed;
+        std::atomic<bool> m_Cancelled = false;
+    };
+}
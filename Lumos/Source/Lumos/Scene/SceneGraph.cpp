@@ -1,6 +1,7 @@
 #include "Precompiled.h"
 #include "SceneGraph.h"
 #include "Maths/Transform.h"
+#include "Core/JobSystem.h"
 
 DISABLE_WARNING_PUSH
 DISABLE_WARNING_CONVERSION_TO_SMALLER_TYPE
@@ -9,6 +10,15 @@ DISABLE_WARNING_POP
 
 namespace Lumos
 {
+    namespace
+    {
+        // Stored in the registry context so hierarchy changes made through the static Hierarchy functions are seen
+        struct SceneGraphState
+        {
+            bool dirty = true;
+        };
+    }
+
     Hierarchy::Hierarchy(entt::entity p)
         : m_Parent(p)
     {
@@ -34,62 +44,132 @@ namespace Lumos
         registry.on_construct<Hierarchy>().connect<&Hierarchy::OnConstruct>();
         registry.on_update<Hierarchy>().connect<&Hierarchy::OnUpdate>();
         registry.on_destroy<Hierarchy>().connect<&Hierarchy::OnDestroy>();
+
+        registry.on_construct<Hierarchy>().connect<&SceneGraph::MarkHierarchyDirty>();
+        registry.on_update<Hierarchy>().connect<&SceneGraph::MarkHierarchyDirty>();
+        registry.on_destroy<Hierarchy>().connect<&SceneGraph::MarkHierarchyDirty>();
+
+        // Nodes point at transforms, which move when the pool grows or shrinks
+        registry.on_construct<Maths::Transform>().connect<&SceneGraph::MarkHierarchyDirty>();
+        registry.on_destroy<Maths::Transform>().connect<&SceneGraph::MarkHierarchyDirty>();
+    }
+
+    void SceneGraph::MarkHierarchyDirty(entt::registry& registry, entt::entity entity)
+    {
+        registry.ctx_or_set<SceneGraphState>().dirty = true;
     }
 
     void SceneGraph::Update(entt::registry& registry)
     {
         LUMOS_PROFILE_FUNCTION();
-        auto nonHierarchyView = registry.view<Maths::Transform>(entt::exclude<Hierarchy>);
+        auto& state = registry.ctx_or_set<SceneGraphState>();
+        const bool updateAll = state.dirty;
 
-        for(auto entity : nonHierarchyView)
+        if(state.dirty)
         {
-            registry.get<Maths::Transform>(entity).SetWorldMatrix(Maths::Matrix4());
+            RebuildHierarchy(registry);
+            state.dirty = false;
         }
 
-        auto view = registry.view<Maths::Transform, Hierarchy>();
-        for(auto entity : view)
+        for(size_t level = 0; level + 1 < m_LevelOffsets.size(); level++)
         {
-            const auto hierarchy = registry.try_get<Hierarchy>(entity);
-            if(hierarchy && hierarchy->Parent() == entt::null)
+            const uint32_t first = m_LevelOffsets[level];
+            const uint32_t count = m_LevelOffsets[level + 1] - first;
+
+            if(count <= UpdateGroupSize)
             {
-                //Recursively update children
-                UpdateTransform(entity, registry);
+                for(uint32_t i = first; i < first + count; i++)
+                    UpdateNode(i, updateAll);
+                continue;
             }
+
+            // Nodes of a level only read their parents from the level above
+            System::JobSystem::Context ctx;
+            System::JobSystem::Dispatch(ctx, count, UpdateGroupSize, [this, first, updateAll](JobDispatchArgs args)
+                                        { UpdateNode(first + args.jobIndex, updateAll); });
+            System::JobSystem::Wait(ctx);
+        }
+    }
+
+    void SceneGraph::UpdateNode(uint32_t index, bool updateAll)
+    {
+        Node& node = m_Nodes[index];
+        const bool parentChanged = node.parent >= 0 && m_Changed[node.parent];
+
+        if(!updateAll && !parentChanged && !node.transform->IsDirty() && !node.transform->HasUpdated())
+        {
+            m_Changed[index] = 0;
+            return;
         }
+
+        if(node.parent >= 0)
+            node.transform->SetWorldMatrix(m_Nodes[node.parent].transform->GetAffineWorldMatrix());
+        else
+            node.transform->SetWorldMatrix(Maths::Matrix3x4::IDENTITY);
+
+        node.transform->SetHasUpdated(false);
+        m_Changed[index] = 1;
     }
 
-    void SceneGraph::UpdateTransform(entt::entity entity, entt::registry& registry)
+    void SceneGraph::RebuildHierarchy(entt::registry& registry)
     {
         LUMOS_PROFILE_FUNCTION();
-        auto hierarchyComponent = registry.try_get<Hierarchy>(entity);
-        if(hierarchyComponent)
+        m_Nodes.clear();
+        m_LevelOffsets.clear();
+
+        struct PendingNode
+        {
+            entt::entity entity;
+            int32_t parent;
+            uint32_t depth;
+        };
+
+        // Breadth first from the roots, so nodes end up sorted by depth and after their parent
+        std::vector<PendingNode> queue;
+
+        auto nonHierarchyView = registry.view<Maths::Transform>(entt::exclude<Hierarchy>);
+        for(auto entity : nonHierarchyView)
+            queue.push_back({ entity, -1, 0 });
+
+        auto hierarchyView = registry.view<Hierarchy>();
+        for(auto entity : hierarchyView)
+        {
+            if(hierarchyView.get<Hierarchy>(entity).Parent() == entt::null)
+                queue.push_back({ entity, -1, 0 });
+        }
+
+        uint32_t currentDepth = 0;
+        for(size_t i = 0; i < queue.size(); i++)
         {
-            auto transform = registry.try_get<Maths::Transform>(entity);
+            const PendingNode pending = queue[i];
+            int32_t nodeIndex = -1;
+
+            // Children of an entity without a transform are treated as roots
+            auto transform = registry.try_get<Maths::Transform>(pending.entity);
             if(transform)
             {
-                if(hierarchyComponent->Parent() != entt::null)
-                {
-                    auto parentTransform = registry.try_get<Maths::Transform>(hierarchyComponent->Parent());
-                    if(parentTransform)
-                    {
-                        transform->SetWorldMatrix(parentTransform->GetWorldMatrix());
-                    }
-                }
-                else
+                if(m_Nodes.empty() || pending.depth != currentDepth)
                 {
-                    transform->SetWorldMatrix(Maths::Matrix4());
+                    m_LevelOffsets.push_back(static_cast<uint32_t>(m_Nodes.size()));
+                    currentDepth = pending.depth;
                 }
+
+                nodeIndex = static_cast<int32_t>(m_Nodes.size());
+                m_Nodes.push_back({ transform, pending.parent });
             }
 
-            entt::entity child = hierarchyComponent->First();
+            auto hierarchy = registry.try_get<Hierarchy>(pending.entity);
+            entt::entity child = hierarchy ? hierarchy->First() : entt::null;
             while(child != entt::null)
             {
-                auto hierarchyComponent = registry.try_get<Hierarchy>(child);
-                auto next = hierarchyComponent ? hierarchyComponent->Next() : entt::null;
-                UpdateTransform(child, registry);
-                child = next;
+                queue.push_back({ child, nodeIndex, pending.depth + 1 });
+                auto childHierarchy = registry.try_get<Hierarchy>(child);
+                child = childHierarchy ? childHierarchy->Next() : entt::null;
             }
         }
+
+        m_LevelOffsets.push_back(static_cast<uint32_t>(m_Nodes.size()));
+        m_Changed.assign(m_Nodes.size(), 0);
     }
 
     void Hierarchy::Reparent(entt::entity entity, entt::entity parent, entt::registry& registry, Hierarchy& hierarchy)
@@ -106,6 +186,8 @@ namespace Lumos
             hierarchy.m_Parent = parent;
             Hierarchy::OnConstruct(registry, entity);
         }
+
+        SceneGraph::MarkHierarchyDirty(registry, entity);
     }
 
     bool Hierarchy::Compare(const entt::registry& registry, const entt::entity rhs) const
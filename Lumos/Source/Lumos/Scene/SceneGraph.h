@@ -11,6 +11,10 @@
 
 namespace Lumos
 {
+    namespace Maths
+    {
+        class Transform;
+    }
 
     class DefaultCameraController
     {
@@ -210,6 +214,8 @@ namespace Lumos
         }
     };
 
+    // Keeps transforms in a flat array sorted by hierarchy depth, rebuilt only when entities or the hierarchy change.
+    // Update recomputes the world matrices of transforms whose local matrix or parent changed, one depth level at a time
     class SceneGraph
     {
     public:
@@ -221,6 +227,25 @@ namespace Lumos
         void DisableOnConstruct(bool disable, entt::registry& registry);
 
         void Update(entt::registry& registry);
-        void UpdateTransform(entt::entity entity, entt::registry& registry);
+
+        // Rebuilds the flat hierarchy and updates every transform on the next Update
+        static void MarkHierarchyDirty(entt::registry& registry, entt::entity entity);
+
+    private:
+        // Levels smaller than this are updated on the calling thread
+        static const uint32_t UpdateGroupSize = 256;
+
+        struct Node
+        {
+            Maths::Transform* transform;
+            int32_t parent; // Index of the parent's node, -1 for roots
+        };
+
+        void RebuildHierarchy(entt::registry& registry);
+        void UpdateNode(uint32_t index, bool updateAll);
+
+        std::vector<Node> m_Nodes;
+        std::vector<uint8_t> m_Changed; // Whether a node's world matrix changed this update, read by its children
+        std::vector<uint32_t> m_LevelOffsets; // First node of each depth level, followed by the node count
     };
 }
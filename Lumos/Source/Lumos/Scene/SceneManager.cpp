@@ -3,12 +3,14 @@
 
 #include "Physics/B2PhysicsEngine/B2PhysicsEngine.h"
 #include "Scene.h"
+#include "SceneFile.h"
 #include "Core/Application.h"
 #include "Scene.h"
 #include "Physics/LumosPhysicsEngine/LumosPhysicsEngine.h"
 #include "Core/OS/FileSystem.h"
 #include "Core/VFS.h"
 #include "Core/StringUtilities.h"
+#include "Graphics/Renderers/RenderGraph.h"
 
 namespace Lumos
 {
@@ -22,6 +24,7 @@ namespace Lumos
     SceneManager::~SceneManager()
     {
         m_SceneIdx = 0;
+        m_SceneFileReader.reset();
 
         if(m_CurrentScene)
         {
@@ -70,6 +73,16 @@ namespace Lumos
 
     void SceneManager::ApplySceneSwitch()
     {
+        if(m_SceneFileReader)
+        {
+            // A switch queued while loading abandons the load, it is applied once the reader has stopped
+            if(m_SwitchingScenes)
+                m_SceneFileReader->Cancel();
+
+            UpdateSceneLoad();
+            return;
+        }
+
         if(m_SwitchingScenes == false)
         {
             if(m_CurrentScene)
@@ -101,18 +114,65 @@ namespace Lumos
 
         m_SceneIdx = m_QueuedSceneIndex;
         m_CurrentScene = m_vpAllScenes[m_QueuedSceneIndex].get();
+        m_SwitchingScenes = false;
 
         //Initialise new scene
         app.GetSystem<LumosPhysicsEngine>()->SetDefaults();
         app.GetSystem<B2PhysicsEngine>()->SetDefaults();
         app.GetSystem<LumosPhysicsEngine>()->SetPaused(false);
 
+        // Scene files load without parsing over the next frames, the text scene is used when there is none or it is rejected
+        std::string physicalPath;
+        if(Lumos::VFS::Get()->ResolvePhysicalPath("//Scenes/" + m_CurrentScene->GetSceneName() + ".lscn", physicalPath))
+        {
+            auto newPath = StringUtilities::RemoveName(physicalPath);
+            m_SceneFileReader = CreateUniqueRef<SceneFileReader>(m_CurrentScene);
+            if(m_SceneFileReader->Open(newPath))
+                return;
+
+            LUMOS_LOG_WARN("[SceneManager] - Could not open the scene file for {0}, loading the text scene instead", m_CurrentScene->GetSceneName());
+            m_SceneFileReader.reset();
+        }
+
+        LoadTextScene();
+        FinishSceneSwitch();
+    }
+
+    void SceneManager::UpdateSceneLoad()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        const SceneFileReader::Status status = m_SceneFileReader->LoadNextChunk();
+        if(status == SceneFileReader::Status::Loading)
+            return;
+
+        m_SceneFileReader.reset();
+
+        if(status == SceneFileReader::Status::Failed)
+        {
+            LUMOS_LOG_WARN("[SceneManager] - Scene file for {0} could not be loaded, loading the text scene instead", m_CurrentScene->GetSceneName());
+            LoadTextScene();
+        }
+        else if(status == SceneFileReader::Status::Cancelled)
+        {
+            LUMOS_LOG_INFO("[SceneManager] - Cancelled loading scene : {0}", m_CurrentScene->GetSceneName());
+        }
+
+        FinishSceneSwitch();
+    }
+
+    void SceneManager::LoadTextScene()
+    {
         std::string physicalPath;
         if(Lumos::VFS::Get()->ResolvePhysicalPath("//Scenes/" + m_CurrentScene->GetSceneName() + ".lsn", physicalPath))
         {
             auto newPath = StringUtilities::RemoveName(physicalPath);
             m_CurrentScene->Deserialise(newPath, false);
         }
+    }
+
+    void SceneManager::FinishSceneSwitch()
+    {
+        auto& app = Application::Get();
 
         auto screenSize = app.GetWindowSize();
         m_CurrentScene->SetScreenSize(static_cast<uint32_t>(screenSize.x), static_cast<uint32_t>(screenSize.y));
@@ -120,11 +180,23 @@ namespace Lumos
         if(app.GetEditorState() == EditorState::Play)
             m_CurrentScene->OnInit();
 
+        if(app.GetRenderGraph())
+            app.GetRenderGraph()->OnNewScene(m_CurrentScene);
+
         Application::Get().OnNewScene(m_CurrentScene);
 
         LUMOS_LOG_INFO("[SceneManager] - Scene switched to : {0}", m_CurrentScene->GetSceneName().c_str());
+    }
 
-        m_SwitchingScenes = false;
+    float SceneManager::GetSceneLoadProgress() const
+    {
+        return m_SceneFileReader ? m_SceneFileReader->GetProgress() : 1.0f;
+    }
+
+    void SceneManager::CancelSceneLoad()
+    {
+        if(m_SceneFileReader)
+            m_SceneFileReader->Cancel();
     }
 
     std::vector<std::string> SceneManager::GetSceneNames()
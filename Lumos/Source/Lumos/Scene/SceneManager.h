@@ -3,6 +3,7 @@
 namespace Lumos
 {
     class Scene;
+    class SceneFileReader;
 
     class LUMOS_EXPORT SceneManager
     {
@@ -51,9 +52,20 @@ namespace Lumos
         }
         bool GetSwitchingScene() const
         {
-            return m_SwitchingScenes;
+            return m_SwitchingScenes || IsLoadingScene();
         }
 
+        // Scene files are loaded one chunk per ApplySceneSwitch, so a large scene is spread over frames
+        bool IsLoadingScene() const
+        {
+            return m_SceneFileReader.get() != nullptr;
+        }
+
+        float GetSceneLoadProgress() const;
+
+        // Stops loading the scene file, the scene is left empty. Switching scenes while loading also cancels it
+        void CancelSceneLoad();
+
         void EnqueueSceneFromFile(const std::string& filePath);
         void EnqueueScene(Scene* scene);
 
@@ -85,6 +97,11 @@ namespace Lumos
         std::vector<std::string> m_SceneFilePathsToLoad;
 
     private:
+        void UpdateSceneLoad();
+        void LoadTextScene();
+        void FinishSceneSwitch();
+
+        UniqueRef<SceneFileReader> m_SceneFileReader;
         bool m_SwitchingScenes = false;
         int m_QueuedSceneIndex = -1;
         NONCOPYABLE(SceneManager)
@@ -0,0 +1,120 @@
+#include "Precompiled.h"
+#include "AssetManager.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/Material.h"
+#include "Core/StringUtilities.h"
+
+namespace Lumos
+{
+    TextureLibrary::TextureLibrary()
+    {
+        m_LoadFunc = Load;
+        m_SizeFunc = GetSize;
+    }
+
+    TextureLibrary::~TextureLibrary()
+    {
+    }
+
+    SharedRef<Graphics::Texture2D> TextureLibrary::GetTexture(const std::string& filePath, Graphics::TextureParameters parameters, Graphics::TextureLoadOptions loadOptions)
+    {
+        return GetResource(filePath, [&parameters, &loadOptions](const std::string& path, SharedRef<Graphics::Texture2D>& texture)
+            {
+                texture = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(path, path, parameters, loadOptions));
+                return texture != nullptr;
+            });
+    }
+
+    bool TextureLibrary::Load(const std::string& filePath, SharedRef<Graphics::Texture2D>& texture)
+    {
+        texture = SharedRef<Graphics::Texture2D>(Graphics::Texture2D::CreateFromFile(filePath, filePath));
+        return texture != nullptr;
+    }
+
+    uint64_t TextureLibrary::GetSize(const SharedRef<Graphics::Texture2D>& texture)
+    {
+        // The mip chain adds a third
+        const uint64_t size = uint64_t(texture->GetWidth()) * texture->GetHeight() * Graphics::Texture::GetStrideFromFormat(texture->GetFormat());
+        return texture->GetMipMapLevels() > 1 ? size + size / 3 : size;
+    }
+
+    MeshLibrary::MeshLibrary()
+    {
+        m_SizeFunc = GetSize;
+    }
+
+    MeshLibrary::~MeshLibrary()
+    {
+    }
+
+    void MeshLibrary::SetModelMeshCount(const std::string& modelPath, uint32_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ModelMeshCounts[modelPath] = count;
+    }
+
+    uint32_t MeshLibrary::GetModelMeshCount(const std::string& modelPath)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto found = m_ModelMeshCounts.find(modelPath);
+        return found != m_ModelMeshCounts.end() ? found->second : 0;
+    }
+
+    std::string MeshLibrary::GetModelMeshID(const std::string& modelPath, uint32_t index)
+    {
+        return modelPath + ":" + StringUtilities::ToString(index);
+    }
+
+    uint64_t MeshLibrary::GetSize(const SharedRef<Graphics::Mesh>& mesh)
+    {
+        uint64_t size = 0;
+
+        if(mesh->GetVertexBuffer())
+            size += mesh->GetVertexBuffer()->GetSize();
+        if(mesh->GetIndexBuffer())
+            size += uint64_t(mesh->GetIndexBuffer()->GetCount()) * sizeof(uint32_t);
+
+        return size;
+    }
+
+    MaterialLibrary::MaterialLibrary()
+    {
+        m_SizeFunc = GetSize;
+    }
+
+    MaterialLibrary::~MaterialLibrary()
+    {
+    }
+
+    std::string MaterialLibrary::GetModelMaterialID(const std::string& modelPath, uint32_t index)
+    {
+        return modelPath + ":Material" + StringUtilities::ToString(index);
+    }
+
+    uint64_t MaterialLibrary::GetSize(const SharedRef<Graphics::Material>& material)
+    {
+        // Textures are counted by the TextureLibrary
+        return sizeof(Graphics::MaterialProperties);
+    }
+
+    SoundLibrary::SoundLibrary()
+    {
+        m_LoadFunc = Load;
+        m_SizeFunc = GetSize;
+    }
+
+    SoundLibrary::~SoundLibrary()
+    {
+    }
+
+    bool SoundLibrary::Load(const std::string& filePath, SharedRef<Sound>& sound)
+    {
+        sound = SharedRef<Sound>(Sound::Create(filePath, StringUtilities::GetFilePathExtension(filePath)));
+        return sound != nullptr;
+    }
+
+    uint64_t SoundLibrary::GetSize(const SharedRef<Sound>& sound)
+    {
+        return static_cast<uint64_t>(sound->GetSize());
+    }
+}
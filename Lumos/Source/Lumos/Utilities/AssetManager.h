@@ -4,10 +4,19 @@
 #include "Core/Engine.h"
 #include "Audio/Sound.h"
 #include "Graphics/RHI/Shader.h"
+#include "Graphics/RHI/Texture.h"
 #include "Utilities/TSingleton.h"
 
+#include <mutex>
+
 namespace Lumos
 {
+    namespace Graphics
+    {
+        class Mesh;
+        class Material;
+    }
+
     template <typename T>
     class ResourceManager
     {
@@ -21,66 +30,78 @@ namespace Lumos
             float timeSinceReload;
             float lastAccessed;
             ResourceHandle data;
+            uint64_t size;
             bool onDisk;
         };
 
+        struct Stats
+        {
+            uint32_t resourceCount = 0;
+            uint64_t residentBytes = 0;
+            uint64_t memoryBudget = 0;
+        };
+
         typedef std::unordered_map<IDType, Resource> MapType;
 
         typedef std::function<bool(const IDType&, ResourceHandle&)> LoadFunc;
         typedef std::function<void(ResourceHandle&)> ReleaseFunc;
         typedef std::function<bool(const IDType&, ResourceHandle&)> ReloadFunc;
         typedef std::function<IDType(const ResourceHandle&)> GetIdFunc;
+        typedef std::function<uint64_t(const ResourceHandle&)> GetSizeFunc;
 
         ResourceHandle GetResource(const IDType& name)
         {
-            typename MapType::iterator itr = m_NameResourceMap.find(name);
-            if(itr != m_NameResourceMap.end())
-            {
-                itr->second.lastAccessed = Engine::GetTimeStep().GetElapsedSeconds();
-                return itr->second.data;
-            }
+            return GetResource(name, m_LoadFunc);
+        }
 
-            ResourceHandle resourceData;
-            if(!m_LoadFunc(name, resourceData))
+        // Loads with load instead of the manager's load function, for resources that need their own parameters.
+        // Loading happens outside the lock, if two threads load the same resource the first one stored is kept
+        ResourceHandle GetResource(const IDType& name, const LoadFunc& load)
+        {
+            ResourceHandle resourceData = FindResource(name);
+            if(resourceData)
+                return resourceData;
+
+            if(!load || !load(name, resourceData))
             {
                 LUMOS_LOG_ERROR("Resource Manager could not load resource name {0} of type {1}", name, typeid(T).name());
                 return ResourceHandle(nullptr);
             }
 
-            Resource newResource;
-            newResource.data = resourceData;
-            newResource.timeSinceReload = 0;
-            newResource.onDisk = true;
-            newResource.lastAccessed = Engine::GetTimeStep().GetElapsedSeconds();
-
-            m_NameResourceMap.emplace(name, newResource);
-
-            return resourceData;
+            return Insert(name, resourceData, true);
         }
 
         ResourceHandle GetResource(const ResourceHandle& data)
         {
-            IDType newId = m_GetIdFunc(data);
+            return AddResource(m_GetIdFunc(data), data);
+        }
 
-            typename MapType::iterator itr = m_NameResourceMap.find(newId);
-            if(itr == m_NameResourceMap.end())
-            {
-                ResourceHandle resourceData = data;
+        // Stores a resource created in memory, returns the resident resource if the name is already taken
+        ResourceHandle AddResource(const IDType& name, const ResourceHandle& data)
+        {
+            return Insert(name, data, false);
+        }
 
-                Resource newResource;
-                newResource.data = resourceData;
-                newResource.timeSinceReload = 0;
-                newResource.onDisk = false;
-                m_NameResourceMap.emplace(newId, newResource);
+        // Returns nullptr if the resource is not resident
+        ResourceHandle FindResource(const IDType& name)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
 
-                return resourceData;
-            }
+            typename MapType::iterator itr = m_NameResourceMap.find(name);
+            if(itr == m_NameResourceMap.end())
+                return ResourceHandle(nullptr);
 
+            itr->second.lastAccessed = Engine::GetTimeStep().GetElapsedSeconds();
             return itr->second.data;
         }
 
         void Destroy()
         {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if(!m_ReleaseFunc)
+                return;
+
             typename MapType::iterator itr = m_NameResourceMap.begin();
             while(itr != m_NameResourceMap.end())
             {
@@ -89,22 +110,52 @@ namespace Lumos
             }
         }
 
+        // Drops resources only the manager still references once they expire, and least recently used
+        // first while the resident size is over the memory budget
         void Update(const float elapsedMilliseconds)
         {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
             typename MapType::iterator itr = m_NameResourceMap.begin();
 
             float now = Engine::GetTimeStep().GetElapsedSeconds();
             while(itr != m_NameResourceMap.end())
             {
                 if(itr->second.data.GetCounter()->GetReferenceCount() == 1 && m_ExpirationTime < (now - itr->second.lastAccessed))
-                    itr = m_NameResourceMap.erase(itr);
+                    itr = Erase(itr);
                 else
                     ++itr;
             }
+
+            if(m_MemoryBudget == 0 || m_ResidentBytes <= m_MemoryBudget)
+                return;
+
+            std::vector<typename MapType::iterator> unused;
+            for(itr = m_NameResourceMap.begin(); itr != m_NameResourceMap.end(); ++itr)
+            {
+                if(itr->second.data.GetCounter()->GetReferenceCount() == 1)
+                    unused.push_back(itr);
+            }
+
+            std::sort(unused.begin(), unused.end(), [](const typename MapType::iterator& a, const typename MapType::iterator& b)
+                { return a->second.lastAccessed < b->second.lastAccessed; });
+
+            for(auto& resource : unused)
+            {
+                if(m_ResidentBytes <= m_MemoryBudget)
+                    break;
+
+                Erase(resource);
+            }
         }
 
         bool ReloadResources()
         {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            if(!m_ReloadFunc)
+                return false;
+
             typename MapType::iterator itr = m_NameResourceMap.begin();
             while(itr != m_NameResourceMap.end())
             {
@@ -120,6 +171,8 @@ namespace Lumos
 
         bool ResourceExists(const IDType& name)
         {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
             typename MapType::iterator itr = m_NameResourceMap.find(name);
             return itr != m_NameResourceMap.end();
         }
@@ -129,17 +182,67 @@ namespace Lumos
             return GetResource(name);
         }
 
+        Stats GetStats()
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            Stats stats;
+            stats.resourceCount = static_cast<uint32_t>(m_NameResourceMap.size());
+            stats.residentBytes = m_ResidentBytes;
+            stats.memoryBudget = m_MemoryBudget;
+            return stats;
+        }
+
+        // Zero disables the budget, resources still referenced elsewhere are never evicted
+        void SetMemoryBudget(uint64_t bytes) { m_MemoryBudget = bytes; }
+        uint64_t GetMemoryBudget() const { return m_MemoryBudget; }
+
+        void SetExpirationTime(float seconds) { m_ExpirationTime = seconds; }
+        float GetExpirationTime() const { return m_ExpirationTime; }
+
         LoadFunc& LoadFunction() { return m_LoadFunc; }
         ReleaseFunc& ReleaseFunction() { return m_ReleaseFunc; }
         ReloadFunc& ReloadFunction() { return m_ReloadFunc; }
+        GetSizeFunc& SizeFunction() { return m_SizeFunc; }
 
     protected:
+        ResourceHandle Insert(const IDType& name, const ResourceHandle& data, bool onDisk)
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            typename MapType::iterator itr = m_NameResourceMap.find(name);
+            if(itr != m_NameResourceMap.end())
+                return itr->second.data;
+
+            Resource newResource;
+            newResource.data = data;
+            newResource.timeSinceReload = 0;
+            newResource.onDisk = onDisk;
+            newResource.lastAccessed = Engine::GetTimeStep().GetElapsedSeconds();
+            newResource.size = m_SizeFunc && data ? m_SizeFunc(data) : 0;
+
+            m_ResidentBytes += newResource.size;
+            m_NameResourceMap.emplace(name, newResource);
+
+            return data;
+        }
+
+        typename MapType::iterator Erase(typename MapType::iterator itr)
+        {
+            m_ResidentBytes -= itr->second.size;
+            return m_NameResourceMap.erase(itr);
+        }
+
         MapType m_NameResourceMap = {};
         LoadFunc m_LoadFunc;
         ReleaseFunc m_ReleaseFunc;
         ReloadFunc m_ReloadFunc;
         GetIdFunc m_GetIdFunc;
+        GetSizeFunc m_SizeFunc;
         float m_ExpirationTime = 3.0f;
+        uint64_t m_MemoryBudget = 0;
+        uint64_t m_ResidentBytes = 0;
+        std::mutex m_Mutex;
     };
 
     class ShaderLibrary : public ResourceManager<Graphics::Shader>
@@ -160,4 +263,58 @@ namespace Lumos
             return true;
         }
     };
+
+    // Textures loaded from files, keyed by file path. Loaders share textures through it instead of keeping their own lists
+    class TextureLibrary : public ResourceManager<Graphics::Texture2D>
+    {
+    public:
+        TextureLibrary();
+        ~TextureLibrary();
+
+        // The first load of a file decides its parameters
+        SharedRef<Graphics::Texture2D> GetTexture(const std::string& filePath, Graphics::TextureParameters parameters, Graphics::TextureLoadOptions loadOptions = Graphics::TextureLoadOptions());
+
+        static bool Load(const std::string& filePath, SharedRef<Graphics::Texture2D>& texture);
+        static uint64_t GetSize(const SharedRef<Graphics::Texture2D>& texture);
+    };
+
+    // Meshes loaded from model files, keyed by GetModelMeshID. Models loading the same file share the buffers
+    class MeshLibrary : public ResourceManager<Graphics::Mesh>
+    {
+    public:
+        MeshLibrary();
+        ~MeshLibrary();
+
+        // Number of meshes the model file was loaded with, a model is only reused while all of them are resident
+        void SetModelMeshCount(const std::string& modelPath, uint32_t count);
+        uint32_t GetModelMeshCount(const std::string& modelPath);
+
+        static std::string GetModelMeshID(const std::string& modelPath, uint32_t index);
+        static uint64_t GetSize(const SharedRef<Graphics::Mesh>& mesh);
+
+    private:
+        std::unordered_map<std::string, uint32_t> m_ModelMeshCounts;
+    };
+
+    // Materials created by the model loaders, keyed by GetModelMaterialID with the file's own material index.
+    // The loaders look them up before creating them, so models of the same file share them
+    class MaterialLibrary : public ResourceManager<Graphics::Material>
+    {
+    public:
+        MaterialLibrary();
+        ~MaterialLibrary();
+
+        static std::string GetModelMaterialID(const std::string& modelPath, uint32_t index);
+        static uint64_t GetSize(const SharedRef<Graphics::Material>& material);
+    };
+
+    class SoundLibrary : public ResourceManager<Sound>
+    {
+    public:
+        SoundLibrary();
+        ~SoundLibrary();
+
+        static bool Load(const std::string& filePath, SharedRef<Sound>& sound);
+        static uint64_t GetSize(const SharedRef<Sound>& sound);
+    };
 }
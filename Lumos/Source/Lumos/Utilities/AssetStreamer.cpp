@@ -0,0 +1,355 @@
+#include "Precompiled.h"
+#include "AssetStreamer.h"
+#include "Graphics/Material.h"
+#include "Graphics/Model.h"
+#include "Audio/Sound.h"
+#include "Utilities/LoadImage.h"
+#include "Core/StringUtilities.h"
+#include "Core/Application.h"
+
+namespace Lumos
+{
+    StreamedAsset::StreamedAsset(const std::string& filePath)
+        : m_FilePath(filePath)
+        , m_Position(0.0f)
+    {
+    }
+
+    namespace Graphics
+    {
+        StreamedTexture::StreamedTexture(const std::string& filePath, TextureParameters parameters, TextureLoadOptions loadOptions)
+            : StreamedAsset(filePath)
+            , m_Parameters(parameters)
+            , m_LoadOptions(loadOptions)
+        {
+        }
+
+        StreamedTexture::~StreamedTexture()
+        {
+            delete[] m_Pixels;
+        }
+
+        SharedRef<Texture2D> StreamedTexture::GetTexture() const
+        {
+            return m_State == State::Ready ? m_Texture : Material::GetDefaultTexture();
+        }
+
+        bool StreamedTexture::Decode()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            m_Pixels = LoadImageFromFile(m_FilePath, &m_Width, &m_Height, &m_Bits, &m_IsHDR);
+            return m_Pixels != nullptr;
+        }
+
+        bool StreamedTexture::Finalize()
+        {
+            LUMOS_PROFILE_FUNCTION();
+
+            // HDR images decode to 32 bit float RGBA, which BitsToTextureFormat maps to RGBA32
+            m_Parameters.format = Texture::BitsToTextureFormat(m_Bits);
+            Texture2D* texture = Texture2D::CreateFromSource(m_Width, m_Height, m_Pixels, m_Parameters, m_LoadOptions);
+
+            delete[] m_Pixels;
+            m_Pixels = nullptr;
+
+            if(!texture)
+                return false;
+
+            texture->SetName(m_FilePath);
+            texture->SetFilepath(m_FilePath);
+
+            m_Texture = Application::Get().GetTextureLibrary()->AddResource(m_FilePath, SharedRef<Texture2D>(texture));
+            return true;
+        }
+
+        uint64_t StreamedTexture::GetUploadSize() const
+        {
+            return uint64_t(m_Width) * m_Height * m_Bits / 8;
+        }
+
+        StreamedModel::StreamedModel(const std::string& filePath)
+            : StreamedAsset(filePath)
+        {
+        }
+
+        StreamedModel::~StreamedModel()
+        {
+            for(auto& texture : m_Textures)
+                delete[] texture.Pixels;
+        }
+
+        bool StreamedModel::Decode()
+        {
+            LUMOS_PROFILE_FUNCTION();
+            m_File = Model::ParseFile(m_FilePath);
+            if(m_File.get() == nullptr)
+                return false;
+
+            // The loaders fetch these from the TextureLibrary, so decode them here rather than on the render thread
+            auto& textureLibrary = Application::Get().GetTextureLibrary();
+            for(uint32_t i = 0; i < static_cast<uint32_t>(m_File->Textures.size()); i++)
+            {
+                const auto& filePath = m_File->Textures[i].FilePath;
+
+                // Shared between materials, or already resident
+                auto decoded = std::find_if(m_Textures.begin(), m_Textures.end(), [this, &filePath](const DecodedTexture& texture)
+                    { return m_File->Textures[texture.FileIndex].FilePath == filePath; });
+                if(decoded != m_Textures.end() || textureLibrary->FindResource(filePath))
+                    continue;
+
+                DecodedTexture texture = { i };
+                texture.Pixels = LoadImageFromFile(filePath, &texture.Width, &texture.Height, &texture.Bits, &texture.IsHDR);
+
+                // A missing texture is left to the loader, as it was before streaming
+                if(texture.Pixels)
+                    m_Textures.push_back(texture);
+            }
+
+            return true;
+        }
+
+        bool StreamedModel::Finalize()
+        {
+            LUMOS_PROFILE_FUNCTION();
+
+            auto& textureLibrary = Application::Get().GetTextureLibrary();
+            for(auto& decoded : m_Textures)
+            {
+                const auto& file = m_File->Textures[decoded.FileIndex];
+                TextureParameters parameters = file.Parameters;
+                parameters.format = Texture::BitsToTextureFormat(decoded.Bits);
+
+                Texture2D* texture = Texture2D::CreateFromSource(decoded.Width, decoded.Height, decoded.Pixels, parameters, file.LoadOptions);
+                delete[] decoded.Pixels;
+                decoded.Pixels = nullptr;
+
+                if(!texture)
+                    continue;
+
+                texture->SetName(file.FilePath);
+                texture->SetFilepath(file.FilePath);
+                textureLibrary->AddResource(file.FilePath, SharedRef<Texture2D>(texture));
+            }
+            m_Textures.clear();
+
+            Model model;
+            model.CreateMeshes(*m_File, m_FilePath);
+            m_File.reset();
+
+            m_Meshes = model.GetMeshes();
+            return !m_Meshes.empty();
+        }
+
+        uint64_t StreamedModel::GetUploadSize() const
+        {
+            uint64_t size = m_File->GetSize();
+            for(auto& texture : m_Textures)
+                size += uint64_t(texture.Width) * texture.Height * texture.Bits / 8;
+            return size;
+        }
+    }
+
+    StreamedSound::StreamedSound(const std::string& filePath)
+        : StreamedAsset(filePath)
+    {
+    }
+
+    StreamedSound::~StreamedSound()
+    {
+        delete[] m_Data.Data;
+    }
+
+    SharedRef<Sound> StreamedSound::GetSound() const
+    {
+        return m_State == State::Ready ? m_Sound : nullptr;
+    }
+
+    bool StreamedSound::Decode()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        m_Data = Sound::LoadData(m_FilePath, StringUtilities::GetFilePathExtension(m_FilePath));
+        return m_Data.Data != nullptr;
+    }
+
+    bool StreamedSound::Finalize()
+    {
+        LUMOS_PROFILE_FUNCTION();
+        Sound* sound = Sound::Create(m_FilePath, m_Data);
+        if(!sound)
+            return false;
+
+        // The sound owns the samples now
+        m_Data.Data = nullptr;
+
+        m_Sound = Application::Get().GetSoundLibrary()->AddResource(m_FilePath, SharedRef<Sound>(sound));
+        return true;
+    }
+
+    uint64_t StreamedSound::GetUploadSize() const
+    {
+        return m_Data.Size;
+    }
+
+    AssetStreamer::~AssetStreamer()
+    {
+        // Decode jobs write into the requests
+        System::JobSystem::Wait(m_Context);
+    }
+
+    template <typename T>
+    SharedRef<T> AssetStreamer::FindRequest(const std::string& filePath)
+    {
+        auto found = m_RequestsByPath.find(filePath);
+        if(found == m_RequestsByPath.end() || !dynamic_cast<T*>(found->second))
+            return nullptr;
+
+        for(auto& request : m_Requests)
+        {
+            if(request.get() == found->second)
+                return SharedRef<T>(request);
+        }
+
+        return nullptr;
+    }
+
+    void AssetStreamer::AddRequest(const SharedRef<StreamedAsset>& request)
+    {
+        m_Requests.push_back(request);
+        m_RequestsByPath[request->m_FilePath] = request.get();
+    }
+
+    SharedRef<Graphics::StreamedTexture> AssetStreamer::LoadTexture(const std::string& filePath, Graphics::TextureParameters parameters, Graphics::TextureLoadOptions loadOptions)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto pending = FindRequest<Graphics::StreamedTexture>(filePath);
+        if(pending)
+            return pending;
+
+        auto request = CreateSharedRef<Graphics::StreamedTexture>(filePath, parameters, loadOptions);
+
+        // Already resident, nothing to stream
+        request->m_Texture = Application::Get().GetTextureLibrary()->FindResource(filePath);
+        if(request->m_Texture)
+        {
+            request->m_State = StreamedAsset::State::Ready;
+            return request;
+        }
+
+        AddRequest(request);
+        return request;
+    }
+
+    SharedRef<Graphics::StreamedModel> AssetStreamer::LoadModel(const std::string& physicalPath)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto pending = FindRequest<Graphics::StreamedModel>(physicalPath);
+        if(pending)
+            return pending;
+
+        auto request = CreateSharedRef<Graphics::StreamedModel>(physicalPath);
+        AddRequest(request);
+        return request;
+    }
+
+    SharedRef<StreamedSound> AssetStreamer::LoadSound(const std::string& filePath)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        auto pending = FindRequest<StreamedSound>(filePath);
+        if(pending)
+            return pending;
+
+        auto request = CreateSharedRef<StreamedSound>(filePath);
+
+        // Already resident, nothing to stream
+        request->m_Sound = Application::Get().GetSoundLibrary()->FindResource(filePath);
+        if(request->m_Sound)
+        {
+            request->m_State = StreamedAsset::State::Ready;
+            return request;
+        }
+
+        AddRequest(request);
+        return request;
+    }
+
+    void AssetStreamer::Update(const Maths::Vector3& cameraPosition)
+    {
+        LUMOS_PROFILE_FUNCTION();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if(m_Requests.empty())
+            return;
+
+        std::sort(m_Requests.begin(), m_Requests.end(), [&cameraPosition](const SharedRef<StreamedAsset>& a, const SharedRef<StreamedAsset>& b)
+            { return (a->m_Position - cameraPosition).LengthSquared() < (b->m_Position - cameraPosition).LengthSquared(); });
+
+        uint64_t uploaded = 0;
+
+        for(auto& request : m_Requests)
+        {
+            switch(request->m_State)
+            {
+            case StreamedAsset::State::Queued:
+            {
+                // Only the streamer still holds it, nothing is waiting for the asset anymore
+                if(request.GetCounter()->GetReferenceCount() == 1)
+                {
+                    request->m_State = StreamedAsset::State::Failed;
+                    break;
+                }
+
+                if(m_Decoding >= MaxDecoding)
+                    break;
+
+                m_Decoding++;
+                request->m_State = StreamedAsset::State::Decoding;
+
+                StreamedAsset* pending = request.get();
+                System::JobSystem::Execute(m_Context, [this, pending](JobDispatchArgs args)
+                    {
+                        pending->m_State = pending->Decode() ? StreamedAsset::State::Decoded : StreamedAsset::State::Failed;
+                        m_Decoding--;
+                    });
+                break;
+            }
+            case StreamedAsset::State::Decoded:
+            {
+                if(uploaded > 0 && uploaded >= m_UploadBudget)
+                    break;
+
+                uploaded += request->GetUploadSize();
+                request->m_State = request->Finalize() ? StreamedAsset::State::Ready : StreamedAsset::State::Failed;
+
+                if(request->m_State == StreamedAsset::State::Failed)
+                    LUMOS_LOG_WARN("Failed to stream {0}", request->m_FilePath);
+                break;
+            }
+            default:
+                break;
+            }
+        }
+
+        auto finished = std::remove_if(m_Requests.begin(), m_Requests.end(), [this](const SharedRef<StreamedAsset>& request)
+            {
+                if(!request->IsFinished())
+                    return false;
+
+                m_RequestsByPath.erase(request->m_FilePath);
+                return true;
+            });
+
+        m_Requests.erase(finished, m_Requests.end());
+    }
+
+    uint32_t AssetStreamer::GetPendingCount()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return static_cast<uint32_t>(m_Requests.size());
+    }
+}
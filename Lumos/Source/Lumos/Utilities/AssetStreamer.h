@@ -0,0 +1,190 @@
+#pragma once
+#include "Maths/Maths.h"
+#include "Graphics/RHI/Texture.h"
+#include "Audio/AudioData.h"
+#include "Core/JobSystem.h"
+#include "Utilities/TSingleton.h"
+
+#include <mutex>
+
+namespace Lumos
+{
+    class Sound;
+    class AssetStreamer;
+
+    namespace Graphics
+    {
+        class Mesh;
+        class ModelFile;
+    }
+
+    // An asset loaded by the AssetStreamer. Decode reads the file on a JobSystem worker,
+    // Finalize creates its GPU or audio resources on the render thread
+    class LUMOS_EXPORT StreamedAsset
+    {
+        friend class AssetStreamer;
+
+    public:
+        enum class State : uint32_t
+        {
+            Queued,
+            Decoding,
+            Decoded,
+            Ready,
+            Failed
+        };
+
+        StreamedAsset(const std::string& filePath);
+        virtual ~StreamedAsset() = default;
+
+        const std::string& GetFilePath() const { return m_FilePath; }
+
+        State GetState() const { return m_State; }
+        bool IsReady() const { return m_State == State::Ready; }
+        bool IsFinished() const { return m_State == State::Ready || m_State == State::Failed; }
+
+        // Requests closest to the camera are decoded and finalised first
+        void SetPosition(const Maths::Vector3& position) { m_Position = position; }
+
+    protected:
+        // Worker thread, must not create GPU or audio resources
+        virtual bool Decode() = 0;
+
+        // Render thread, called once Decode has succeeded
+        virtual bool Finalize() = 0;
+
+        // Bytes Finalize uploads, counted against the frame's upload budget
+        virtual uint64_t GetUploadSize() const = 0;
+
+        std::string m_FilePath;
+        Maths::Vector3 m_Position;
+        std::atomic<State> m_State = State::Queued;
+    };
+
+    namespace Graphics
+    {
+        // Handle to a streamed texture. GetTexture returns a placeholder until the texture is ready
+        class LUMOS_EXPORT StreamedTexture : public StreamedAsset
+        {
+            friend class Lumos::AssetStreamer;
+
+        public:
+            StreamedTexture(const std::string& filePath, TextureParameters parameters, TextureLoadOptions loadOptions);
+            ~StreamedTexture();
+
+            SharedRef<Texture2D> GetTexture() const;
+
+        protected:
+            bool Decode() override;
+            bool Finalize() override;
+            uint64_t GetUploadSize() const override;
+
+        private:
+            TextureParameters m_Parameters;
+            TextureLoadOptions m_LoadOptions;
+            SharedRef<Texture2D> m_Texture;
+
+            // Written by the decode job, read on the render thread once the state is Decoded
+            uint8_t* m_Pixels = nullptr;
+            uint32_t m_Width = 0;
+            uint32_t m_Height = 0;
+            uint32_t m_Bits = 0;
+            bool m_IsHDR = false;
+        };
+
+        // Handle to a streamed model file. The file and its material textures are decoded on a worker,
+        // its meshes and textures are created on the render thread and registered in the asset libraries
+        class LUMOS_EXPORT StreamedModel : public StreamedAsset
+        {
+        public:
+            StreamedModel(const std::string& filePath);
+            ~StreamedModel();
+
+            // Empty until the model is ready
+            const std::vector<SharedRef<Mesh>>& GetMeshes() const { return m_Meshes; }
+
+        protected:
+            bool Decode() override;
+            bool Finalize() override;
+            uint64_t GetUploadSize() const override;
+
+        private:
+            struct DecodedTexture
+            {
+                uint32_t FileIndex; // Into the file's textures
+                uint8_t* Pixels;
+                uint32_t Width;
+                uint32_t Height;
+                uint32_t Bits;
+                bool IsHDR;
+            };
+
+            UniqueRef<ModelFile> m_File;
+            std::vector<DecodedTexture> m_Textures;
+            std::vector<SharedRef<Mesh>> m_Meshes;
+        };
+    }
+
+    // Handle to a streamed sound. GetSound returns null until the sound is ready
+    class LUMOS_EXPORT StreamedSound : public StreamedAsset
+    {
+        friend class AssetStreamer;
+
+    public:
+        StreamedSound(const std::string& filePath);
+        ~StreamedSound();
+
+        SharedRef<Sound> GetSound() const;
+
+    protected:
+        bool Decode() override;
+        bool Finalize() override;
+        uint64_t GetUploadSize() const override;
+
+    private:
+        AudioData m_Data = AudioData();
+        SharedRef<Sound> m_Sound;
+    };
+
+    // Decodes asset files on JobSystem workers and creates their resources on the render thread,
+    // a few per frame and closest to the camera first. Created assets are shared through the asset libraries
+    class LUMOS_EXPORT AssetStreamer : public ThreadSafeSingleton<AssetStreamer>
+    {
+        friend class TSingleton<AssetStreamer>;
+        friend class ThreadSafeSingleton<AssetStreamer>;
+
+    public:
+        // Decode jobs in flight at once, so workers stay free for the frame's own jobs
+        static const uint32_t MaxDecoding = 4;
+
+        // Each returns the pending request if the file is already streaming
+        SharedRef<Graphics::StreamedTexture> LoadTexture(const std::string& filePath, Graphics::TextureParameters parameters = Graphics::TextureParameters(), Graphics::TextureLoadOptions loadOptions = Graphics::TextureLoadOptions());
+        SharedRef<Graphics::StreamedModel> LoadModel(const std::string& physicalPath);
+        SharedRef<StreamedSound> LoadSound(const std::string& filePath);
+
+        // Called once per frame on the render thread. Starts decode jobs and finalises decoded
+        // assets until the frame's upload budget is spent
+        void Update(const Maths::Vector3& cameraPosition);
+
+        // Bytes of texture, vertex and sample data uploaded per frame, at least one asset is finalised each frame
+        void SetUploadBudget(uint64_t bytes) { m_UploadBudget = bytes; }
+        uint64_t GetUploadBudget() const { return m_UploadBudget; }
+
+        uint32_t GetPendingCount();
+
+    private:
+        AssetStreamer() = default;
+        ~AssetStreamer();
+
+        template <typename T>
+        SharedRef<T> FindRequest(const std::string& filePath);
+        void AddRequest(const SharedRef<StreamedAsset>& request);
+
+        std::vector<SharedRef<StreamedAsset>> m_Requests;
+        std::unordered_map<std::string, StreamedAsset*> m_RequestsByPath;
+        std::atomic<uint32_t> m_Decoding = 0;
+        uint64_t m_UploadBudget = 16 * 1024 * 1024;
+        System::JobSystem::Context m_Context;
+        std::mutex m_Mutex;
+    };
+}